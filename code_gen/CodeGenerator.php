@@ -133,6 +133,24 @@ class CodeGenerator {
 			$this->writeCode($handle, $lines);
 		}
 		
+		// instructions go through this handler when the function is being profiled
+		$lines = array();
+		if($compiler == "GCC") {
+			$lines[] =		"label_PROFILE:";
+		} else {
+			$lines[] =		"case QB_PROFILE_HANDLER:";
+		}
+		$lines[] =			"{";
+		$lines[] =				"handler = qb_profile_instruction(cxt, ip);";
+		if($compiler == "GCC") {
+			$lines[] = 			"goto *handler;";
+		} else {
+			$lines[] = 			"break;";
+		}
+		$lines[] =			"}";
+		$lines[] =			"";
+		$this->writeCode($handle, $lines);
+		
 		$lines = array();
 		if($compiler == "MSVC") {
 			$lines[] = 			"default:";
@@ -146,6 +164,7 @@ class CodeGenerator {
 				$name = $handler->getName();
 				$lines[] = 		"op_handlers[QB_$name] = &&label_$name;";
 			}
+			$lines[] = 		"profile_handler = &&label_PROFILE;";
 			$lines[] = 	"}";
 		}
 		$this->writeCode($handle, $lines);
@@ -155,6 +174,7 @@ class CodeGenerator {
 		$lines[] = 	"";
 		if($compiler == "GCC") {
 			$lines[] = 	"void *op_handlers[QB_OPCODE_COUNT];";
+			$lines[] = 	"void *profile_handler;";
 		}
 		$this->writeCode($handle, $lines);
 	}
@@ -252,6 +272,52 @@ class CodeGenerator {
 		$this->writeCode($handle, $lines);
 	}
 	
+	public function writeMultithreadingThresholds($handle) {
+		$this->currentIndentationLevel = 0;
+
+		$lines = array();
+		$lines[] = "const qb_multithreading_threshold global_multithreading_threshold_info[] = {";
+		$count = 0;
+		foreach($this->handlers as $handler) {
+			if($handler->hasMultithreadingThreshold()) {
+				$name = $handler->getName();
+				$threshold = $handler->getMultithreadingThreshold();
+				$controller = ($handler->isDispatchedToThreads()) ? $handler->getControllerFunctionName() : "NULL";
+				$format = $handler->getInstructionFormat();
+				$types = array();
+				$sizes = array();
+				if(preg_match('/^[aA]+$/', $format)) {
+					// ops working on arrays of fixed-size elements can be timed on dummy data
+					for($i = 1; $i <= strlen($format); $i++) {
+						$size = $handler->getOperandSize($i);
+						if(!is_numeric($size)) {
+							$types = $sizes = array();
+							break;
+						}
+						$types[] = "QB_TYPE_" . $handler->getOperandType($i);
+						$sizes[] = $size;
+					}
+				} else if($handler->isReducedInThreads() && preg_match('/^a+[SE]$/', $format)) {
+					// so can reductions of whole arrays, with the threshold counting the elements going in
+					for($i = 1; $i <= strlen($format); $i++) {
+						$types[] = "QB_TYPE_" . $handler->getOperandType($i);
+						$sizes[] = 1;
+					}
+				}
+				$operandCount = count($sizes);
+				$typeList = ($types) ? implode(", ", $types) : "0";
+				$sizeList = ($sizes) ? implode(", ", $sizes) : "0";
+				$lines[] = "{	QB_$name, $threshold, $controller, $operandCount, { $typeList }, { $sizeList }	},";
+				$count++;
+			}
+		}
+		$lines[] = "};";
+		$lines[] = "";
+		$lines[] = "uint32_t global_multithreading_threshold_count = $count;";
+		$lines[] = "";
+		$this->writeCode($handle, $lines);
+	}
+
 	public function writeOpNames($handle) {
 		$this->currentIndentationLevel = 0;
 		
@@ -1143,6 +1209,9 @@ class CodeGenerator {
 			foreach($this->scalarAddressModes as $addressMode) {
 				$this->handlers[] = new ForkCount("FORK_CNT", "U32", $addressMode);
 			}
+			foreach($this->scalarAddressModes as $addressMode) {
+				$this->handlers[] = new ForkNext("FORK_NEXT", "U32", $addressMode);
+			}
 			$this->handlers[] = new Resume("RESUME");
 			$this->handlers[] = new Spoon("SPOON");
 		}
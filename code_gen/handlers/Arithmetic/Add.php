@@ -2,7 +2,7 @@
 
 class Add extends Handler {
 
-	use MultipleAddressMode, BinaryOperator, ExpressionReplication, NoUnsigned, Multithreaded;
+	use MultipleAddressMode, BinaryOperator, ExpressionReplication, NoUnsigned, Multithreaded, Vectorizable;
 
 	protected function getActionOnUnitData() {
 		return "res = op1 + op2;";
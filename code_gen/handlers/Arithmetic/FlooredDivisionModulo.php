@@ -2,7 +2,7 @@
 
 class FlooredDivisionModulo extends Handler {
 
-	use MultipleAddressMode, BinaryOperator, ExpressionReplication, Multithreaded;
+	use MultipleAddressMode, BinaryOperator, ExpressionReplication, Multithreaded, Vectorizable;
 
 	protected function getActionOnUnitData() {
 		$cType = $this->getOperandCType(1);
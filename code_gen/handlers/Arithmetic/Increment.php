@@ -2,7 +2,7 @@
 
 class Increment extends Handler {
 
-	use MultipleAddressMode, NullaryOperator, ExpressionReplication, NoUnsigned, Multithreaded;
+	use MultipleAddressMode, NullaryOperator, ExpressionReplication, NoUnsigned, Multithreaded, Vectorizable;
 
 	protected function getActionOnUnitData() {
 		return "++res;";
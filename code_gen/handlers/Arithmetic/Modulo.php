@@ -2,7 +2,7 @@
 
 class Modulo extends Handler {
 
-	use MultipleAddressMode, BinaryOperator, ExpressionReplication, Multithreaded;
+	use MultipleAddressMode, BinaryOperator, ExpressionReplication, Multithreaded, Vectorizable;
 
 	public function needsInterpreterContext() {
 		$type = $this->getOperandType(1);
@@ -2,7 +2,7 @@
 
 class Multiply extends Handler {
 
-	use MultipleAddressMode, BinaryOperator, ExpressionReplication, Multithreaded;
+	use MultipleAddressMode, BinaryOperator, ExpressionReplication, Multithreaded, Vectorizable;
 
 	protected function getActionOnUnitData() {
 		return "res = op1 * op2;";
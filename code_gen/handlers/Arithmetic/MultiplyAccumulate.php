@@ -2,7 +2,7 @@
 
 class MultiplyAccumulate extends Handler {
 
-	use MultipleAddressMode, TernaryOperator, ExpressionReplication, Multithreaded;
+	use MultipleAddressMode, TernaryOperator, ExpressionReplication, Multithreaded, Vectorizable;
 
 	protected function getActionOnUnitData() {
 		return "res = (op1 * op2) + op3;";
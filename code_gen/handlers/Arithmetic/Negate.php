@@ -2,7 +2,7 @@
 
 class Negate extends Handler {
 
-	use MultipleAddressMode, UnaryOperator, ExpressionReplication, NoUnsigned, Multithreaded;
+	use MultipleAddressMode, UnaryOperator, ExpressionReplication, NoUnsigned, Multithreaded, Vectorizable;
 	
 	protected function getActionOnUnitData() {
 		return "res = - op1;";
@@ -2,7 +2,9 @@
 
 class ArrayIntersectCount extends Handler {
 
-	use ScalarAddressMode, TernaryOperator, ArrayComparison;
+	use ScalarAddressMode, TernaryOperator, ArrayComparison, ArrayHashing {
+		ArrayHashing::getHelperFunctions insteadof ArrayComparison;
+	}
 	
 	public function getOperandType($i) {
 		switch($i) {
@@ -43,7 +45,23 @@ class ArrayIntersectCount extends Handler {
 		$lines[] = "$cType *op1_end = op1_ptr + op1_count;";
 		$lines[] = "$cType *op2_end = op2_ptr + op2_count, *op2_start = op2_ptr;";
 		$lines[] = "uint32_t count = 0;";
-		$lines[] = "if(op3 == 1) {";
+		$lines[] = "if({$this->getHashTableCondition("op2_count / op3")}) {";
+		$lines[] = 		$this->getHashTableAllocationCode("op2_count / op3");
+		$lines[] = 		"for(op2_ptr = op2_start; op2_ptr < op2_end; op2_ptr += op3) {";
+		$lines[] = 			$this->getHashTableSearchCode("op2_start", "op2_ptr", "op3");
+		$lines[] = 			"if(!found) {";
+		$lines[] = 				"buckets[bucket_index] = (uint32_t) (op2_ptr - op2_start) + 1;";
+		$lines[] = 			"}";
+		$lines[] = 		"}";
+		$lines[] = 		"while(op1_ptr < op1_end) {";
+		$lines[] = 			$this->getHashTableSearchCode("op2_start", "op1_ptr", "op3");
+		$lines[] = 			"if(found) {";
+		$lines[] = 				"count++;";
+		$lines[] = 			"}";
+		$lines[] = 			"op1_ptr += op3;";
+		$lines[] = 		"}";
+		$lines[] = 		$this->getHashTableReleaseCode();
+		$lines[] = "} else if(op3 == 1) {";
 		$lines[] = 		"while(op1_ptr < op1_end) {";
 		$lines[] = 			"int32_t found = FALSE;";
 		$lines[] = 			"for(op2_ptr = op2_start; op2_ptr < op2_end; op2_ptr++) {";							
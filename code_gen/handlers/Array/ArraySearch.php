@@ -2,7 +2,7 @@
 
 class ArraySearch extends Handler {
 
-	use MultipleAddressMode, BinaryOperator, NoUnsigned;
+	use MultipleAddressMode, BinaryOperator, NoUnsigned, MultithreadedReduction;
 
 	public function getOperandAddressMode($i) {
 		switch($i) {
@@ -62,6 +62,20 @@ class ArraySearch extends Handler {
 		$lines[] = "res = index;";
 		return $lines;
 	}
+
+	protected function getReductionCode() {
+		// take the first match, converting the index within the range to one within the whole array
+		$lines = array();
+		$lines[] = "uint32_t i;";
+		$lines[] = "res = -1;";
+		$lines[] = "for(i = 0; i < cxt->thread_count; i++) {";
+		$lines[] = 		"if(partial_results[i] != -1) {";
+		$lines[] = 			"res = partial_results[i] + i * chunk_size;";
+		$lines[] = 			"break;";
+		$lines[] = 		"}";
+		$lines[] = "}";
+		return $lines;
+	}
 }
 
 ?>
\ No newline at end of file
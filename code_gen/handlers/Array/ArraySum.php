@@ -2,7 +2,7 @@
 
 class ArraySum extends Handler {
 
-	use MultipleAddressMode, UnaryOperator, UnitResult;
+	use MultipleAddressMode, UnaryOperator, UnitResult, MultithreadedReduction;
 	
 	public function getOperandSize($i) {
 		switch($i) {
@@ -2,7 +2,7 @@
 
 class ArrayUnique extends Handler {
 
-	use ArrayAddressMode, BinaryOperator;
+	use ArrayAddressMode, BinaryOperator, ArrayHashing;
 
 	public function getOperandType($i) {
 		switch($i) {
@@ -29,9 +29,24 @@ class ArrayUnique extends Handler {
 	}
 	
 	public function getActionOnUnitData() {
+		$cType = $this->getOperandCType(1);
 		$lines = array();
 		$lines[] = "uint32_t i, j, k;";
-		$lines[] = "if(op2 == 1) {";
+		$lines[] = "if({$this->getHashTableCondition("op1_count / op2")}) {";
+		$lines[] = 		$this->getHashTableAllocationCode("op1_count / op2");
+		$lines[] = 		"for(i = 0; i < op1_count; i += op2) {";
+		$lines[] = 			"$cType *element = op1_ptr + i;";
+		$lines[] = 			$this->getHashTableSearchCode("op1_ptr", "element", "op2");
+		$lines[] = 			"if(!found) {";
+		$lines[] = 				"buckets[bucket_index] = i + 1;";
+		$lines[] = 				"for(k = 0; k < op2; k++) {";
+		$lines[] = 					"*res_ptr = element[k];";
+		$lines[] = 					"res_ptr++;";
+		$lines[] = 				"}";
+		$lines[] = 			"}";
+		$lines[] = 		"}";
+		$lines[] = 		$this->getHashTableReleaseCode();
+		$lines[] = "} else if(op2 == 1) {";
 		$lines[] = 		"for(i = 0; i < op1_count; i++) {";
 		$lines[] = 			"int32_t repeat = FALSE;";
 		$lines[] = 			"for(j = 0; j < i; j++) {";
@@ -2,7 +2,7 @@
 
 class ArrayUniqueCount extends Handler {
 
-	use ScalarAddressMode, BinaryOperator;
+	use ScalarAddressMode, BinaryOperator, ArrayHashing;
 
 	public function getOperandType($i) {
 		switch($i) {
@@ -29,10 +29,22 @@ class ArrayUniqueCount extends Handler {
 	}
 	
 	public function getActionOnUnitData() {
+		$cType = $this->getOperandCType(1);
 		$lines = array();
 		$lines[] = "uint32_t count = 0;";
 		$lines[] = "uint32_t i, j, k;";
-		$lines[] = "if(op2 == 1) {";
+		$lines[] = "if({$this->getHashTableCondition("op1_count / op2")}) {";
+		$lines[] = 		$this->getHashTableAllocationCode("op1_count / op2");
+		$lines[] = 		"for(i = 0; i < op1_count; i += op2) {";
+		$lines[] = 			"$cType *element = op1_ptr + i;";
+		$lines[] = 			$this->getHashTableSearchCode("op1_ptr", "element", "op2");
+		$lines[] = 			"if(!found) {";
+		$lines[] = 				"buckets[bucket_index] = i + 1;";
+		$lines[] = 				"count++;";
+		$lines[] = 			"}";
+		$lines[] = 		"}";
+		$lines[] = 		$this->getHashTableReleaseCode();
+		$lines[] = "} else if(op2 == 1) {";
 		$lines[] = 	"for(i = 0; i < op1_count; i++) {";
 		$lines[] = 		"int32_t repeat = FALSE;";
 		$lines[] = 		"for(j = 0; j < i; j++) {";
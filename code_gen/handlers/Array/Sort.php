@@ -3,7 +3,7 @@
 class Sort extends Handler {
 
 	use ArrayAddressMode, UnaryOperator, Slow;
-	
+
 	protected $direction = "ascending";
 
 	public function getOperandType($i) {
@@ -12,94 +12,489 @@ class Sort extends Handler {
 			case 2: return $this->operandType;
 		}
 	}
-	
+
 	public function getOperandAddressMode($i) {
 		switch($i) {
 			case 1: return "SCA";
 			case 2: return "ARR";
 		}
 	}
-	
+
 	public function getFunctionType() {
 		return "extern";
 	}
-	
+
 	public function getOperandSize($i) {
 		switch($i) {
 			case 1: return 1;
 			case 2: return "res_count";
 		}
 	}
-	
+
+	public function needsInterpreterContext() {
+		// large arrays are sorted in multiple threads
+		return true;
+	}
+
 	public function getHelperFunctions() {
 		$type = $this->getOperandType(2);
-		$cType = $this->getOperandCType(2);
-		$dir = $this->direction;
+		$functions = array();
+		if($type == "S08" || $type == "U08") {
+			$functions[] = $this->getCountingSortFunction();
+		} else {
+			$functions[] = $this->getInsertionSortFunction();
+			$functions[] = $this->getHeapSortFunction();
+			$functions[] = $this->getIntrosortFunction();
+			if($type[0] != 'F') {
+				$functions[] = $this->getRadixSortFunction();
+			}
+		}
+		$functions[] = $this->getRowHeapSortFunction();
+		$functions[] = $this->getRowSortFunction();
+		$functions[] = $this->getMergeFunction();
+		$functions[] = $this->getSortFunction();
+		return $functions;
+	}
+
+	// descending sorts get their own set of helper functions instead of reversing the ascending order afterward,
+	// so elements that compare as equal but aren't identical (0.0 and -0.0, NaN) keep their relative order
+	protected function getHelperFunctionName($name) {
+		$type = $this->getOperandType(2);
+		if($this->direction == "descending") {
+			return "qb_reverse_{$name}_$type";
+		} else {
+			return "qb_{$name}_$type";
+		}
+	}
 
-		if($this->direction == 'ascending') {
-			$a1 = "p1"; $a2 = "p2";
-			$b1 = "p2"; $b2 = "p3";
+	// return an expression that is true when $a goes before $b
+	protected function getPrecedenceExpression($a, $b) {
+		if($this->direction == "descending") {
+			return "$b < $a";
 		} else {
-			// swap the parameters around when we want descending order
-			$a1 = "p2"; $a2 = "p3";
-			$b1 = "p1"; $b2 = "p2";
+			return "$a < $b";
 		}
+	}
+
+	// return an expression that is true when row $a goes before row $b
+	protected function getRowPrecedenceExpression($a, $b) {
+		$type = $this->getOperandType(2);
+		$sign = ($this->direction == "descending") ? ">" : "<";
+		return "qb_compare_array_$type($a, width, $b, width) $sign 0";
+	}
 
-		$scalar_f = array(
-				"int qb_compare_{$dir}_{$type}(const void *p1, const void *p2) {",
-					"if(*(($cType *) $a1) < *(($cType *) $b1)) {",
-						"return -1;",
-					"} else if(*(($cType *) $a1) > *(($cType *) $b1)) {",
-						"return 1;",
+	// return an expression that maps an integer to an unsigned key with the same ordering
+	protected function getRadixKey($expr) {
+		$type = $this->getOperandType(2);
+		$bits = (int) substr($type, 1);
+		$uType = "uint{$bits}_t";
+		if($type[0] == 'S') {
+			$shift = $bits - 1;
+			return "($uType) $expr ^ (($uType) 1 << $shift)";
+		} else {
+			return "($uType) $expr";
+		}
+	}
+
+	protected function getInsertionSortFunction() {
+		$cType = $this->getOperandCType(2);
+		$insertionSort = $this->getHelperFunctionName("insertion_sort");
+		return array(
+			"int32_t $insertionSort($cType *elements, uint32_t count, uint32_t move_limit) {",
+				"uint32_t i, j, move_count = 0;",
+				"for(i = 1; i < count; i++) {",
+					"$cType value = elements[i];",
+					"for(j = i; j > 0 && {$this->getPrecedenceExpression("value", "elements[j - 1]")}; j--) {",
+						"elements[j] = elements[j - 1];",
+					"}",
+					"elements[j] = value;",
+					"move_count += i - j;",
+					"if(move_count > move_limit) {",
+						"return FALSE;",
+					"}",
+				"}",
+				"return TRUE;",
+			"}",
+		);
+	}
+
+	protected function getHeapSortFunction() {
+		$cType = $this->getOperandCType(2);
+		$heapSort = $this->getHelperFunctionName("heap_sort");
+		return array(
+			"void $heapSort($cType *elements, uint32_t count) {",
+				"uint32_t start = count / 2, end = count, root, child;",
+				"$cType value;",
+				"while(end > 1) {",
+					"if(start > 0) {",
+						"// build the heap",
+						"start--;",
+						"value = elements[start];",
+						"root = start;",
 					"} else {",
-						"return 0;",
+						"// move the element that goes last to the end",
+						"end--;",
+						"value = elements[end];",
+						"elements[end] = elements[0];",
+						"root = 0;",
 					"}",
+					"while((child = root * 2 + 1) < end) {",
+						"if(child + 1 < end && {$this->getPrecedenceExpression("elements[child]", "elements[child + 1]")}) {",
+							"child++;",
+						"}",
+						"if({$this->getPrecedenceExpression("value", "elements[child]")}) {",
+							"elements[root] = elements[child];",
+							"root = child;",
+						"} else {",
+							"break;",
+						"}",
+					"}",
+					"elements[root] = value;",
 				"}",
+			"}",
 		);
+	}
 
-		if(self::$compiler == 'MSVC') {
-			$vector_f = array(
-				"int qb_compare_{$dir}_{$type}_array(const void *p1, const void *p2, const void *p3) {",
-					"uint32_t len = *((const uint32_t *) p1);",
-					"return qb_compare_array_$type(($cType *) $a2, len, ($cType *) $b2, len);",
+	// pattern-defeating quicksort: comparisons are done with < only, so NaN is treated as equal to everything, as in PHP
+	protected function getIntrosortFunction() {
+		$cType = $this->getOperandCType(2);
+		$introsort = $this->getHelperFunctionName("introsort");
+		$insertionSort = $this->getHelperFunctionName("insertion_sort");
+		$heapSort = $this->getHelperFunctionName("heap_sort");
+		return array(
+			"void $introsort($cType *elements, uint32_t count, uint32_t bad_partition_limit) {",
+				"while(count > 24) {",
+					"uint32_t i = 0, j = count - 1, mid = count / 2, left_count, right_count;",
+					"int32_t already_partitioned = TRUE;",
+					"$cType pivot, temp;",
+					"// put the median of the first, middle and last element in the middle",
+					"if({$this->getPrecedenceExpression("elements[mid]", "elements[0]")}) {",
+						"temp = elements[mid];",
+						"elements[mid] = elements[0];",
+						"elements[0] = temp;",
+					"}",
+					"if({$this->getPrecedenceExpression("elements[j]", "elements[mid]")}) {",
+						"temp = elements[j];",
+						"elements[j] = elements[mid];",
+						"elements[mid] = temp;",
+						"if({$this->getPrecedenceExpression("elements[mid]", "elements[0]")}) {",
+							"temp = elements[mid];",
+							"elements[mid] = elements[0];",
+							"elements[0] = temp;",
+						"}",
+					"}",
+					"pivot = elements[mid];",
+					"// the scans stop at elements equal to the pivot (NaN included), so they can't run past the ends",
+					"while(1) {",
+						"while({$this->getPrecedenceExpression("elements[i]", "pivot")}) {",
+							"i++;",
+						"}",
+						"while({$this->getPrecedenceExpression("pivot", "elements[j]")}) {",
+							"j--;",
+						"}",
+						"if(i >= j) {",
+							"break;",
+						"}",
+						"temp = elements[i];",
+						"elements[i] = elements[j];",
+						"elements[j] = temp;",
+						"already_partitioned = FALSE;",
+						"i++;",
+						"j--;",
+					"}",
+					"left_count = j + 1;",
+					"right_count = count - left_count;",
+					"if(already_partitioned) {",
+						"// the range might be sorted already--see if insertion sort can finish it with a few moves",
+						"if($insertionSort(elements, left_count, 8) && $insertionSort(elements + left_count, right_count, 8)) {",
+							"return;",
+						"}",
+					"}",
+					"if(left_count < count / 8 || right_count < count / 8) {",
+						"// switch to heapsort if lopsided partitions keep happening",
+						"if(bad_partition_limit == 0) {",
+							"$heapSort(elements, count);",
+							"return;",
+						"}",
+						"bad_partition_limit--;",
+						"// swap some elements around to break up the pattern that's defeating the median-of-three",
+						"if(left_count >= 24) {",
+							"temp = elements[0];",
+							"elements[0] = elements[left_count / 4];",
+							"elements[left_count / 4] = temp;",
+							"temp = elements[left_count - 1];",
+							"elements[left_count - 1] = elements[left_count - left_count / 4];",
+							"elements[left_count - left_count / 4] = temp;",
+						"}",
+						"if(right_count >= 24) {",
+							"temp = elements[left_count];",
+							"elements[left_count] = elements[left_count + right_count / 4];",
+							"elements[left_count + right_count / 4] = temp;",
+							"temp = elements[count - 1];",
+							"elements[count - 1] = elements[count - right_count / 4];",
+							"elements[count - right_count / 4] = temp;",
+						"}",
+					"}",
+					"// recurse into the smaller side and loop on the larger one",
+					"if(left_count < right_count) {",
+						"$introsort(elements, left_count, bad_partition_limit);",
+						"elements += left_count;",
+						"count = right_count;",
+					"} else {",
+						"$introsort(elements + left_count, right_count, bad_partition_limit);",
+						"count = left_count;",
+					"}",
 				"}",
-			);
-		} else {
-			$vector_f = array(
-				"int qb_compare_{$dir}_{$type}_array(const void *p1, const void *p2, const void *p3) {",
-					"#if defined(BSD) || defined(__MACOSX__)",
-					"uint32_t len = *((const uint32_t *) p1);",
-					"return qb_compare_array_$type(($cType *) $a2, len, ($cType *) $b2, len);",
-					"#else",
-					"// the GNU version of qsort_r expects the extra parameter to come last",
-					"uint32_t len = *((const uint32_t *) p3);",
-					"return qb_compare_array_$type(($cType *) $a1, len, ($cType *) $b1, len);",
-					"#endif",
+				"$insertionSort(elements, count, 0xFFFFFFFF);",
+			"}",
+		);
+	}
+
+	protected function getCountingSortFunction() {
+		$type = $this->getOperandType(2);
+		$cType = $this->getOperandCType(2);
+		$key = $this->getRadixKey("elements[i]");
+		$value = ($type[0] == 'S') ? "($cType) (i ^ 0x80)" : "($cType) i";
+		$countingSort = $this->getHelperFunctionName("counting_sort");
+		// a descending sort goes through the counts backward
+		$loop = ($this->direction == "descending") ? "for(i = 256; i-- > 0; ) {" : "for(i = 0; i < 256; i++) {";
+		return array(
+			"void $countingSort($cType *elements, uint32_t count) {",
+				"uint32_t counts[256];",
+				"uint32_t i, j, k = 0;",
+				"memset(counts, 0, sizeof(counts));",
+				"for(i = 0; i < count; i++) {",
+					"counts[(uint8_t) ($key)]++;",
 				"}",
-			);
-		}
-		return array($scalar_f, $vector_f);
+				$loop,
+					"for(j = 0; j < counts[i]; j++) {",
+						"elements[k++] = $value;",
+					"}",
+				"}",
+			"}",
+		);
 	}
 
-	public function getActionOnUnitData() {
+	protected function getRadixSortFunction() {
 		$type = $this->getOperandType(2);
 		$cType = $this->getOperandCType(2);
-		$dir = $this->direction;
-		$lines = array();
+		$bits = (int) substr($type, 1);
+		$uType = "uint{$bits}_t";
+		$key = $this->getRadixKey("src[i]");
+		$firstKey = $this->getRadixKey("src[0]");
+		if($this->direction == "descending") {
+			// complementing the keys reverses their order
+			$key = "~($key)";
+			$firstKey = "~($firstKey)";
+		}
+		$radixSort = $this->getHelperFunctionName("radix_sort");
+		return array(
+			"int32_t $radixSort($cType *elements, uint32_t count) {",
+				"$cType *buffer = malloc(count * sizeof($cType));",
+				"$cType *src = elements, *dst = buffer, *temp;",
+				"uint32_t counts[256];",
+				"uint32_t shift, i;",
+				"if(!buffer) {",
+					"return FALSE;",
+				"}",
+				"// sort by each byte, starting from the least significant one",
+				"for(shift = 0; shift < $bits; shift += 8) {",
+					"uint32_t offset = 0;",
+					"memset(counts, 0, sizeof(counts));",
+					"for(i = 0; i < count; i++) {",
+						"$uType key = $key;",
+						"counts[(key >> shift) & 0xFF]++;",
+					"}",
+					"if(counts[(($uType) ($firstKey) >> shift) & 0xFF] == count) {",
+						"// the byte is the same in every element--skip the pass",
+						"continue;",
+					"}",
+					"for(i = 0; i < 256; i++) {",
+						"uint32_t digit_count = counts[i];",
+						"counts[i] = offset;",
+						"offset += digit_count;",
+					"}",
+					"for(i = 0; i < count; i++) {",
+						"$uType key = $key;",
+						"dst[counts[(key >> shift) & 0xFF]++] = src[i];",
+					"}",
+					"temp = src;",
+					"src = dst;",
+					"dst = temp;",
+				"}",
+				"if(src != elements) {",
+					"memcpy(elements, src, count * sizeof($cType));",
+				"}",
+				"free(buffer);",
+				"return TRUE;",
+			"}",
+		);
+	}
 
-		$lines[] = "if(op1 == 1) {";
-		$lines[] = 		"qsort(res_ptr, res_count, sizeof($cType) * 1, (void *) qb_compare_{$dir}_{$type});";
-		$lines[] = "} else {";
+	// used when there isn't enough memory for a merge sort
+	protected function getRowHeapSortFunction() {
+		$cType = $this->getOperandCType(2);
+		$rowHeapSort = $this->getHelperFunctionName("heap_sort_rows");
+		return array(
+			"void $rowHeapSort($cType *elements, uint32_t count, uint32_t width) {",
+				"uint32_t start = count / 2, end = count, root, child, k;",
+				"$cType *row1, *row2;",
+				"while(end > 1) {",
+					"if(start > 0) {",
+						"start--;",
+						"root = start;",
+					"} else {",
+						"end--;",
+						"row1 = elements;",
+						"row2 = elements + end * width;",
+						"for(k = 0; k < width; k++) {",
+							"$cType temp = row1[k];",
+							"row1[k] = row2[k];",
+							"row2[k] = temp;",
+						"}",
+						"root = 0;",
+					"}",
+					"while((child = root * 2 + 1) < end) {",
+						"if(child + 1 < end && {$this->getRowPrecedenceExpression("elements + child * width", "elements + (child + 1) * width")}) {",
+							"child++;",
+						"}",
+						"row1 = elements + root * width;",
+						"row2 = elements + child * width;",
+						"if({$this->getRowPrecedenceExpression("row1", "row2")}) {",
+							"for(k = 0; k < width; k++) {",
+								"$cType temp = row1[k];",
+								"row1[k] = row2[k];",
+								"row2[k] = temp;",
+							"}",
+							"root = child;",
+						"} else {",
+							"break;",
+						"}",
+					"}",
+				"}",
+			"}",
+		);
+	}
 
-		if(self::$compiler == 'MSVC') {
-			$lines[] = "qsort_s(res_ptr, res_count / op1, sizeof($cType) * op1, (void *) qb_compare_{$dir}_{$type}_array, &op1);";
+	protected function getRowSortFunction() {
+		$cType = $this->getOperandCType(2);
+		$rowSort = $this->getHelperFunctionName("sort_rows");
+		$rowHeapSort = $this->getHelperFunctionName("heap_sort_rows");
+		$merge = $this->getHelperFunctionName("merge");
+		return array(
+			"void $rowSort($cType *elements, uint32_t count, uint32_t width) {",
+				"$cType *buffer = malloc(count * width * sizeof($cType));",
+				"$cType *src = elements, *dst = buffer, *temp;",
+				"uint32_t run, i;",
+				"if(!buffer) {",
+					"$rowHeapSort(elements, count, width);",
+					"return;",
+				"}",
+				"// merge runs of doubling length, going back and forth between the array and the buffer",
+				"for(run = 1; run < count; run *= 2) {",
+					"for(i = 0; i < count; i += run * 2) {",
+						"uint32_t count1 = (count - i < run) ? count - i : run;",
+						"uint32_t count2 = (count - i - count1 < run) ? count - i - count1 : run;",
+						"$merge(src + i * width, count1, src + (i + count1) * width, count2, dst + i * width, width);",
+					"}",
+					"temp = src;",
+					"src = dst;",
+					"dst = temp;",
+				"}",
+				"if(src != elements) {",
+					"memcpy(elements, src, count * width * sizeof($cType));",
+				"}",
+				"free(buffer);",
+			"}",
+		);
+	}
+
+	protected function getMergeFunction() {
+		$cType = $this->getOperandCType(2);
+		$merge = $this->getHelperFunctionName("merge");
+		return array(
+			"void $merge(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width) {",
+				"$cType *p1 = elements1, *p2 = elements2, *p = result;",
+				"$cType *end1 = p1 + count1 * width, *end2 = p2 + count2 * width;",
+				"// take from the first range unless the element in the second goes before it, so the merge is stable",
+				"if(width == 1) {",
+					"while(p1 < end1 && p2 < end2) {",
+						"if({$this->getPrecedenceExpression("*p2", "*p1")}) {",
+							"*p++ = *p2++;",
+						"} else {",
+							"*p++ = *p1++;",
+						"}",
+					"}",
+				"} else {",
+					"while(p1 < end1 && p2 < end2) {",
+						"$cType **pp = ({$this->getRowPrecedenceExpression("p2", "p1")}) ? &p2 : &p1;",
+						"uint32_t k;",
+						"for(k = 0; k < width; k++) {",
+							"*p++ = *(*pp)++;",
+						"}",
+					"}",
+				"}",
+				"memcpy(p, p1, (end1 - p1) * sizeof($cType));",
+				"p += end1 - p1;",
+				"memcpy(p, p2, (end2 - p2) * sizeof($cType));",
+			"}",
+		);
+	}
+
+	// return the function that sorts a range of elements (or rows of elements)
+	// qb_dispatch_sort_to_threads() calls it on each chunk before merging the chunks with the merge function
+	protected function getSortFunction() {
+		$type = $this->getOperandType(2);
+		$sort = $this->getHelperFunctionName("sort");
+		$countingSort = $this->getHelperFunctionName("counting_sort");
+		$introsort = $this->getHelperFunctionName("introsort");
+		$radixSort = $this->getHelperFunctionName("radix_sort");
+		$rowSort = $this->getHelperFunctionName("sort_rows");
+		$lines = array();
+		$lines[] = "void $sort(void *elements, uint32_t count, uint32_t width) {";
+		if($type == "S08" || $type == "U08") {
+			$lines[] =		"if(width == 1) {";
+			$lines[] =			"$countingSort(elements, count);";
 		} else {
-			$lines[] = "#if defined(BSD) || defined(__MACOSX__)";
-			$lines[] = "qsort_r(res_ptr, res_count / op1, sizeof($cType) * op1, &op1, (void *) qb_compare_{$dir}_{$type}_array);";
-			$lines[] = "#else";
-			$lines[] = "qsort_r(res_ptr, res_count / op1, sizeof($cType) * op1, (void *) qb_compare_{$dir}_{$type}_array, &op1);";
-			$lines[] = "#endif";
+			$introsort = array(
+				"// allow log2(count) lopsided partitions before introsort gives up on quicksort",
+				"while((count >> bad_partition_limit) > 1) {",
+					"bad_partition_limit++;",
+				"}",
+				"$introsort(elements, count, bad_partition_limit);",
+			);
+			$lines[] =		"uint32_t bad_partition_limit = 0;";
+			$lines[] =		"if(width == 1) {";
+			if($type[0] == 'F') {
+				$lines[] =		$introsort;
+			} else {
+				$lines[] =		"// radix sort isn't worth it for short arrays and can't proceed without a buffer";
+				$lines[] =		"if(count < 256 || !$radixSort(elements, count)) {";
+				$lines[] =			$introsort;
+				$lines[] =		"}";
+			}
 		}
+		$lines[] =		"} else {";
+		$lines[] =			"$rowSort(elements, count, width);";
+		$lines[] =		"}";
+		$lines[] = "}";
+		return $lines;
+	}
+
+	// the op isn't split by a controller function, but its threshold still lives in the table so it can be tuned
+	public function hasMultithreadingThreshold() {
+		return true;
+	}
+
+	public function getActionOnUnitData() {
+		$cType = $this->getOperandCType(2);
+		$sort = $this->getHelperFunctionName("sort");
+		$merge = $this->getHelperFunctionName("merge");
+		$threshold = $this->getMultithreadingThresholdExpression();
+		$lines = array();
+		$lines[] = "uint32_t count = res_count / op1;";
+		$lines[] = "if(res_count < $threshold || !cxt->thread_count || !qb_dispatch_sort_to_threads(cxt, (void *) $sort, (void *) $merge, res_ptr, count, op1, sizeof($cType) * op1)) {";
+		$lines[] = 		"$sort(res_ptr, count, op1);";
 		$lines[] = "}";
 		return $lines;
 	}
@@ -2,7 +2,7 @@
 
 class BitwiseNot extends Handler {
 
-	use MultipleAddressMode, UnaryOperator, IntegerOnly, ExpressionReplication, NoUnsigned, Multithreaded;
+	use MultipleAddressMode, UnaryOperator, IntegerOnly, ExpressionReplication, NoUnsigned, Multithreaded, Vectorizable;
 	
 	protected function getActionOnUnitData() {
 		return "res = ~op1;";
@@ -2,7 +2,7 @@
 
 class BitwiseOr extends Handler {
 
-	use MultipleAddressMode, BinaryOperator, IntegerOnly, ExpressionReplication, NoUnsigned, Multithreaded;
+	use MultipleAddressMode, BinaryOperator, IntegerOnly, ExpressionReplication, NoUnsigned, Multithreaded, Vectorizable;
 
 	protected function getActionOnUnitData() {
 		return "res = op1 | op2;";
@@ -2,7 +2,7 @@
 
 class ShiftLeft extends Handler {
 
-	use MultipleAddressMode, BinaryOperator, ExpressionReplication, IntegerOnly, Multithreaded;
+	use MultipleAddressMode, BinaryOperator, ExpressionReplication, IntegerOnly, Multithreaded, Vectorizable;
 
 	protected function getActionOnUnitData() {
 		return "res = op1 << op2;";
@@ -39,7 +39,7 @@ class AccommodateIndex extends Handler {
 		$lines[] = "if(UNEXPECTED(!(op1 < op2))) {";
 		$lines[] =		"uint32_t new_size = op1 + 1;";
 		$lines[] =		"op2 = new_size;";
-		$lines[] = 		"qb_resize_segment(&cxt->function->local_storage->segments[op3], new_size * op4);";
+		$lines[] = 		"qb_resize_segment(&cxt->function->local_storage->segments[op3], (uint64_t) new_size * op4);";
 		$lines[] = "}";
 		return $lines;
 	}
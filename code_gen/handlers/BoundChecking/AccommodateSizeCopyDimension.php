@@ -88,7 +88,7 @@ class AccommodateSizeCopyDimension extends Handler {
 			$lines[] =	"op$k = op$i;";
 			$lines[] =	"op$m = op$j;";
 		}
-		$lines[] = 		"qb_resize_segment(&cxt->function->local_storage->segments[$segmentSelector], op1 * $elementSize);";
+		$lines[] = 		"qb_resize_segment(&cxt->function->local_storage->segments[$segmentSelector], (uint64_t) op1 * $elementSize);";
 		return $lines;
 	}
 }
@@ -49,7 +49,7 @@ class AccommodateSizeUpdateDimension extends Handler {
 		$lines[] =		"}";
 		$lines[] =		"op2 = new_size;";
 		$lines[] =		"op3 = new_dim;";
-		$lines[] = 		"qb_resize_segment(&cxt->function->local_storage->segments[op5], new_size * op6);";
+		$lines[] = 		"qb_resize_segment(&cxt->function->local_storage->segments[op5], (uint64_t) new_size * op6);";
 		$lines[] = "}";
 		return $lines;
 	}
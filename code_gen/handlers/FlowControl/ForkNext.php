@@ -0,0 +1,16 @@
+<?php
+
+class ForkNext extends Handler {
+
+	use MultipleAddressMode, UnaryOperator;
+	
+	public function needsInterpreterContext() {
+		return true;
+	}
+
+	protected function getActionOnUnitData() {
+		return "res = qb_get_next_fork_iteration(cxt, op1);";
+	}
+}
+
+?>
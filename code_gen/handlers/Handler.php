@@ -336,6 +336,16 @@ class Handler {
 		}
 	}	
 	
+	// return true if the instruction is sent to a dispatcher function, which can split it across threads
+	public function isDispatchedToThreads() {
+		return ($this->isMultipleData() && $this->isMultithreaded());
+	}
+
+	// return true if the instruction has an entry in the multithreading threshold table
+	public function hasMultithreadingThreshold() {
+		return $this->isDispatchedToThreads();
+	}
+
 	public function needsInterpreterContext() {
 		return false;
 	}
@@ -366,8 +376,13 @@ class Handler {
 		return false;
 	}
 
+	// return true if the instruction reduces arrays to a scalar and can have each thread reduce part of them
+	public function isReducedInThreads() {
+		return false;
+	}
+
 	public function needsInstructionStructure() {
-		if($this->isMultipleData() && $this->isMultithreaded()) {
+		if($this->isDispatchedToThreads()) {
 			return true;
 		} else if($this->runsInMainThread()) {
 			return true;
@@ -384,6 +399,11 @@ class Handler {
 	}
 	
 	public function getMultithreadingThreshold() {
+		return $this->lookUpMultithreadingThreshold($this->operandSize);
+	}
+
+	// return the threshold listed for the class and operand type at the given width
+	protected function lookUpMultithreadingThreshold($width) {
 		if(self::$multithreadingThresholds === null) {
 			$folder = dirname(__FILE__);
 			$path = "$folder/../threshold/multithreading_thresholds.txt";
@@ -412,7 +432,6 @@ class Handler {
 		if(is_array(self::$multithreadingThresholds)) {
 			$class = get_class($this);
 			$type = $this->operandType;
-			$width = $this->operandSize;
 			if(isset(self::$multithreadingThresholds[$class][$type][$width])) {
 				return self::$multithreadingThresholds[$class][$type][$width];
 			} else {
@@ -424,6 +443,13 @@ class Handler {
 		}
 	}
 	
+	// return the expression yielding the threshold at runtime
+	// the value from getMultithreadingThreshold() is only the default, since the table can be recalibrated
+	public function getMultithreadingThresholdExpression() {
+		$name = $this->getName();
+		return "global_multithreading_thresholds[QB_$name]";
+	}
+
 	public function performsWrapAround() {
 		if($this->addressMode == "ARR" && !$this->isOverridden('getActionOnMultipleData')) {
 			return true;
@@ -730,14 +756,14 @@ class Handler {
 		if($forDeclaration) {
 			$params[] = "uint32_t threshold";
 		} else {
-			$params[] = $this->getMultithreadingThreshold();
+			$params[] = $this->getMultithreadingThresholdExpression();
 		}
 		return implode(", ", $params);
 	}
 	
 	// return the body list of the dispatcher function
 	public function getDispatcherFunctionDefinition() {
-		if($this->isMultipleData() && $this->isMultithreaded()) {
+		if($this->isDispatchedToThreads()) {
 			$addressOperands = array();
 			$instr = $this->getInstructionStructure();
 			$dispatcherTypeDecl = "int32_t";
@@ -811,7 +837,7 @@ class Handler {
 	}
 	
 	// return the name of the controller function, which decides whether to use multithreading or not
-	protected function getControllerFunctionName() {
+	public function getControllerFunctionName() {
 		$parts = $this->getFunctionNameComponents("redirect");
 		if($this->addressMode == "ELE") {
 			array_splice($parts, -1, 0, "array_element");
@@ -836,7 +862,7 @@ class Handler {
 	
 	// return the body of the controller function
 	public function getControllerFunctionDefinition() {
-		if($this->isMultipleData() && $this->isMultithreaded()) {
+		if($this->isDispatchedToThreads()) {
 			$controllerTypeDecl = "void";
 			$controllerFunction = $this->getControllerFunctionName();
 			$controllerParameterList = $this->getControllerFunctionParameterList(true);
@@ -877,7 +903,7 @@ class Handler {
 	public function getAction() {
 		$functionType = $this->getHandlerFunctionType();
 		if($functionType) {	
-			if($this->isMultipleData() && $this->isMultithreaded()) {
+			if($this->isDispatchedToThreads()) {
 				// send instruction to the controller function, which will either
 				// (1) call the dispatcher function, which then calls the controller function again from different threads
 				// (2) call the handler function
@@ -1015,6 +1041,10 @@ class Handler {
 		// use bitwise AND here, just in case the compiler doesn't optimize correctly
 		$condition = implode(" && ", $operandCounts);
 		$lines[] = "if($condition) {";
+		$straightLoops = $this->getStraightLoopCode($expression, $operandSizeOverride);
+		if($straightLoops) {
+			$lines[] =	$straightLoops;
+		}
 		for($i = 1; $i <= $srcCount; $i++) {
 			$cType = $this->getOperandCType($i);
 			$operandSize = ($operandSizeOverride) ? $operandSizeOverride : $this->getOperandSize($i);
@@ -1048,10 +1078,90 @@ class Handler {
 			}
 		}
 		$lines[] = 		"}";	// end for
+		if($straightLoops) {
+			$lines[] =	"}";	// end else
+		}
 		$lines[] = "}"; 		// end if
 		return $lines;
 	}
 	
+	// return code for loops without wrap-around, used when each operand either has as many elements as the result 
+	// or is a single value being broadcast; the code ends with an else clause that leads into the wrap-around loop
+	protected function getStraightLoopCode($expression, $operandSizeOverride = false) {
+		if(!in_array('Vectorizable', class_uses($this)) || $operandSizeOverride) {
+			return null;
+		}
+		$srcCount = $this->getInputOperandCount();
+		$arrayOperands = array();
+		for($i = 1; $i <= $srcCount + 1; $i++) {
+			if($this->getOperandAddressMode($i) == "ARR") {
+				if($this->getOperandSize($i) != 1) {
+					return null;
+				}
+				if($i <= $srcCount) {
+					$arrayOperands[] = $i;
+				}
+			}
+		}
+		if(!$arrayOperands) {
+			return null;
+		}
+		$expression = array_linearize($expression);
+
+		// one loop where all operands are as long as the result, plus one loop for each operand that could be a scalar
+		$variants = array(array());
+		if(count($arrayOperands) > 1) {
+			foreach($arrayOperands as $i) {
+				$variants[] = array($i);
+			}
+		}
+		$lines = array();
+		foreach($variants as $index => $broadcastOperands) {
+			$conditions = array();
+			foreach($arrayOperands as $i) {
+				if(in_array($i, $broadcastOperands)) {
+					$conditions[] = "op{$i}_count == 1";
+				} else {
+					$conditions[] = "op{$i}_count == res_count";
+				}
+			}
+			foreach($arrayOperands as $i) {
+				if(!in_array($i, $broadcastOperands)) {
+					// the result can be the same array as an operand (e.g. $a += $b) but cannot partially overlap it;
+					// the pointers aren't restrict-qualified since the exact aliasing would make that undefined
+					$conditions[] = "QB_SEPARATE_OR_IDENTICAL(op{$i}_ptr, res_ptr, res_count)";
+				}
+			}
+			$condition = implode(" && ", $conditions);
+			if($index == 0) {
+				$lines[] = "if($condition) {";
+			} else {
+				$lines[] = "} else if($condition) {";
+			}
+			$cType = $this->getOperandCType($srcCount + 1);
+			$patterns = array('/\bres\b/');
+			$replacements = array("res_values[i]");
+			$lines[] =		"$cType *res_values = res_ptr;";
+			foreach($arrayOperands as $i) {
+				$cType = $this->getOperandCType($i);
+				$patterns[] = "/\bop{$i}\b/";
+				if(in_array($i, $broadcastOperands)) {
+					$lines[] =	"$cType op{$i}_value = op{$i}_ptr[0];";
+					$replacements[] = "op{$i}_value";
+				} else {
+					$lines[] =	"$cType *op{$i}_values = op{$i}_ptr;";
+					$replacements[] = "op{$i}_values[i]";
+				}
+			}
+			$lines[] =		"uint32_t i;";
+			$lines[] =		"for(i = 0; i < res_count; i++) {";
+			$lines[] =			preg_replace($patterns, $replacements, $expression);
+			$lines[] =		"}";
+		}
+		$lines[] = "} else {";
+		return $lines;
+	}
+	
 	protected function isOverridden($methodName) {
 		$child  = new ReflectionClass($this);
 		$method = $child->getMethod($methodName);
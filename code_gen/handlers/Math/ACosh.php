@@ -2,7 +2,7 @@
 
 class ACosh extends Handler {
 
-	use MultipleAddressMode, UnaryOperator, FloatingPointOnly, Multithreaded;
+	use MultipleAddressMode, UnaryOperator, FloatingPointOnly, Multithreaded, Vectorizable;
 	
 	protected function getActionOnUnitData() {
 		$type = $this->getOperandType(2);
@@ -2,7 +2,7 @@
 
 class ATan2 extends Handler {
 
-	use MultipleAddressMode, BinaryOperator, FloatingPointOnly, Multithreaded;
+	use MultipleAddressMode, BinaryOperator, FloatingPointOnly, Multithreaded, Vectorizable;
 	
 	protected function getActionOnUnitData() {
 		$type = $this->getOperandType(2);
@@ -2,7 +2,7 @@
 
 class Hypot extends Handler {
 
-	use MultipleAddressMode, BinaryOperator, FloatingPointOnly, Multithreaded;
+	use MultipleAddressMode, BinaryOperator, FloatingPointOnly, Multithreaded, Vectorizable;
 
 	protected function getActionOnUnitData() {
 		$type = $this->getOperandType(3);
@@ -2,7 +2,7 @@
 
 class IsInfinite extends Handler {
 
-	use MultipleAddressMode, UnaryOperator, FloatingPointOnly, Multithreaded;
+	use MultipleAddressMode, UnaryOperator, FloatingPointOnly, Multithreaded, Vectorizable;
 	
 	public function getOperandType($i) {
 		return ($i == 2) ? "I32" : $this->operandType;
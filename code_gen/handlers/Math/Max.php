@@ -2,7 +2,7 @@
 
 class Max extends Handler {
 
-	use MultipleAddressMode, BinaryOperator;
+	use MultipleAddressMode, BinaryOperator, Vectorizable;
 
 	protected function getActionOnUnitData() {
 		return "res = (op1 > op2) ? op1 : op2;";
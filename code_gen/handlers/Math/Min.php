@@ -2,7 +2,7 @@
 
 class Min extends Handler {
 
-	use MultipleAddressMode, BinaryOperator;
+	use MultipleAddressMode, BinaryOperator, Vectorizable;
 	
 	public function getInputOperandCount() {
 		return 2;
@@ -2,7 +2,7 @@
 
 class Mix extends Handler {
 
-	use MultipleAddressMode, TernaryOperator, FloatingPointOnly, Multithreaded;
+	use MultipleAddressMode, TernaryOperator, FloatingPointOnly, Multithreaded, Vectorizable;
 
 	protected function getActionOnUnitData() {
 		return "res = op1 * (1 - op3) + op2 * op3;";
@@ -2,7 +2,7 @@
 
 class Pow extends Handler {
 
-	use MultipleAddressMode, BinaryOperator, FloatingPointOnly, Multithreaded;
+	use MultipleAddressMode, BinaryOperator, FloatingPointOnly, Multithreaded, Vectorizable;
 
 	protected function getActionOnUnitData() {
 		$type = $this->getOperandType(3);
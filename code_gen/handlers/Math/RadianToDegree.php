@@ -2,7 +2,7 @@
 
 class RadianToDegree extends Handler {
 
-	use MultipleAddressMode, UnaryOperator, FloatingPointOnly, Multithreaded;
+	use MultipleAddressMode, UnaryOperator, FloatingPointOnly, Multithreaded, Vectorizable;
 
 	protected function getActionOnUnitData() {
 		$cType = $this->getOperandCType(2);
@@ -2,7 +2,7 @@
 
 class RoundToPrecision extends Handler {
 
-	use MultipleAddressMode, TernaryOperator, FloatingPointOnly;
+	use MultipleAddressMode, TernaryOperator, FloatingPointOnly, Vectorizable;
 
 	public function getOperandType($i) {
 		return ($i == 2 || $i == 3) ? "I32" : $this->operandType;
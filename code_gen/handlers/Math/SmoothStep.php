@@ -2,7 +2,7 @@
 
 class SmoothStep extends Handler {
 
-	use MultipleAddressMode, TernaryOperator, FloatingPointOnly, Multithreaded;
+	use MultipleAddressMode, TernaryOperator, FloatingPointOnly, Multithreaded, Vectorizable;
 	
 	protected function getActionOnUnitData() {
 		$cType = $this->getOperandCType(3);
@@ -2,8 +2,13 @@
 
 class DotProduct extends Handler {
 
-	use MultipleAddressMode, BinaryOperator, FloatingPointOnly, Multithreaded;
+	use MultipleAddressMode, BinaryOperator, FloatingPointOnly, Multithreaded, MultithreadedReduction;
 	
+	public function isReducedInThreads() {
+		// only a dot product of variable-width vectors can be long enough to split
+		return ($this->operandSize == "variable" && !$this->isMultipleData());
+	}
+
 	public function getInputOperandCount() {
 		if($this->operandSize == "variable") {
 			return 3;
@@ -88,6 +93,18 @@ class DotProduct extends Handler {
 		}
 		return $lines;
 	}
+
+	protected function getReductionCode() {
+		$cType = $this->getOperandCType(1);
+		$lines = array();
+		$lines[] = "uint32_t i;";
+		$lines[] = "$cType sum = 0;";
+		$lines[] = "for(i = 0; i < cxt->thread_count; i++) {";
+		$lines[] = 		"sum += partial_results[i];";
+		$lines[] = "}";
+		$lines[] = "res = sum;";
+		return $lines;
+	}
 }
 
 ?>
\ No newline at end of file
@@ -4,6 +4,8 @@ class MultiplyMatrixByMatrix extends Handler {
 
 	use ArrayAddressMode, BinaryOperator, MatrixConventionDependent, FloatingPointOnly, Multithreaded;
 	
+	protected $scalarExpressionOnly = false;
+
 	public function getInputOperandCount() {
 		if($this->operandSize == "variable") {
 			return 5;
@@ -67,6 +69,198 @@ class MultiplyMatrixByMatrix extends Handler {
 		}
 	}
 	
+	public function disableMultipleData() {
+		parent::disableMultipleData();
+		$this->scalarExpressionOnly = true;
+	}
+
+	public function restoreMultipleData() {
+		parent::restoreMultipleData();
+		$this->scalarExpressionOnly = false;
+	}
+
+	public function isDispatchedToThreads() {
+		if($this->operandSize == "variable") {
+			// a single large product is split along the columns of the result
+			return (!$this->multipleData && !$this->scalarExpressionOnly);
+		} else {
+			return parent::isDispatchedToThreads();
+		}
+	}
+
+	// number of multiply-adds (rows * inner dimension * columns) above which the cache-blocked kernel is used
+	protected function getBlockingThreshold() {
+		return 32768;
+	}
+
+	// number of multiply-adds above which a single product is split across threads
+	public function getMultithreadingThreshold() {
+		if($this->operandSize == "variable") {
+			return 262144;
+		} else {
+			return parent::getMultithreadingThreshold();
+		}
+	}
+
+	protected function getDispatcherFunctionName() {
+		if($this->operandSize == "variable") {
+			$instr = $this->getInstructionStructure();
+			return "qb_dispatch_matrix_columns_" . substr($instr, 15);
+		} else {
+			return parent::getDispatcherFunctionName();
+		}
+	}
+
+	protected function getDispatcherFunctionParameterList($forDeclaration) {
+		if($this->operandSize == "variable") {
+			$instr = $this->getInstructionStructure();
+			$params = array();
+			if($forDeclaration) {
+				$params[] = "qb_interpreter_context *__restrict cxt";
+				$params[] = "void *control_func";
+				$params[] = "$instr *__restrict instr";
+				$params[] = "uint32_t threshold";
+			} else {
+				$params[] = "cxt";
+				$params[] = $this->getControllerFunctionName();
+				$params[] = "($instr *) ip";
+				$params[] = $this->getMultithreadingThresholdExpression();
+			}
+			return implode(", ", $params);
+		} else {
+			return parent::getDispatcherFunctionParameterList($forDeclaration);
+		}
+	}
+
+	public function getDispatcherFunctionDefinition() {
+		if($this->operandSize == "variable") {
+			if($this->isDispatchedToThreads()) {
+				$instr = $this->getInstructionStructure();
+				$dispatcherFunction = $this->getDispatcherFunctionName();
+				$dispatcherParameterList = $this->getDispatcherFunctionParameterList(true);
+				$lines = array();
+				$lines[] = "int32_t $dispatcherFunction($dispatcherParameterList) {";
+				$lines[] =		"uint32_t matrix1_rows = ((uint32_t *) instr->operand3.data_pointer)[0];";
+				$lines[] =		"uint32_t matrix1_cols = ((uint32_t *) instr->operand4.data_pointer)[0];";
+				$lines[] =		"uint32_t matrix2_cols = ((uint32_t *) instr->operand5.data_pointer)[0];";
+				$lines[] =		"uint32_t thread_count = cxt->thread_count;";
+				$lines[] =		"if((uint64_t) matrix1_rows * matrix1_cols * matrix2_cols >= threshold && matrix2_cols >= thread_count) {";
+				$lines[] =			"USE_TSRM";
+				$lines[] =			"int32_t use_multithreading = TRUE;";
+				$lines[] =			"uint32_t op1_start = instr->operand1.index_pointer[0], op1_count = instr->operand1.count_pointer[0];";
+				$lines[] =			"uint32_t op2_start = instr->operand2.index_pointer[0], op2_count = instr->operand2.count_pointer[0];";
+				$lines[] =			"uint32_t res_start = instr->operand6.index_pointer[0], res_count = instr->operand6.count_pointer[0];";
+				$lines[] =			"if(instr->operand6.data_pointer == instr->operand1.data_pointer) {";
+				$lines[] =				"// every thread reads the whole of the first matrix";
+				$lines[] =				"if(!(res_start + res_count <= op1_start || op1_start + op1_count <= res_start)) {";
+				$lines[] =					"use_multithreading = FALSE;";
+				$lines[] =				"}";
+				$lines[] =			"}";
+				$lines[] =			"if(instr->operand6.data_pointer == instr->operand2.data_pointer) {";
+				$lines[] =				"// an overlapping product needs a temporary buffer, which can't be allocated in a worker thread";
+				$lines[] =				"if(!(res_start + res_count <= op2_start || op2_start + op2_count <= res_start)) {";
+				$lines[] =					"use_multithreading = FALSE;";
+				$lines[] =				"}";
+				$lines[] =			"}";
+				$lines[] =			"if(use_multithreading) {";
+				$lines[] =				"// create temporary instruction structures, each covering a range of columns in the result";
+				$lines[] =				"$instr new_instr_list[MAX_THREAD_COUNT];";
+				$lines[] =				"uint32_t new_indices[MAX_THREAD_COUNT][2];";
+				$lines[] =				"uint32_t new_counts[MAX_THREAD_COUNT][2];";
+				$lines[] =				"uint32_t new_column_counts[MAX_THREAD_COUNT];";
+				$lines[] =				"int8_t *new_ips[MAX_THREAD_COUNT];";
+				$lines[] =				"uint32_t chunk_size = matrix2_cols / thread_count;";
+				$lines[] =				"uint32_t i;";
+				$lines[] =				"for(i = 0; i < thread_count; i++) {";
+				$lines[] =					"$instr *new_instr = &new_instr_list[i];";
+				$lines[] =					"uint32_t column_start = i * chunk_size;";
+				$lines[] =					"new_column_counts[i] = (i == thread_count - 1) ? matrix2_cols - column_start : chunk_size;";
+				$lines[] =					"new_indices[i][0] = op2_start + column_start * matrix1_cols;";
+				$lines[] =					"new_counts[i][0] = new_column_counts[i] * matrix1_cols;";
+				$lines[] =					"new_indices[i][1] = res_start + column_start * matrix1_rows;";
+				$lines[] =					"new_counts[i][1] = new_column_counts[i] * matrix1_rows;";
+				$lines[] =					"new_instr->operand1 = instr->operand1;";
+				$lines[] =					"new_instr->operand2.data_pointer = instr->operand2.data_pointer;";
+				$lines[] =					"new_instr->operand2.index_pointer = &new_indices[i][0];";
+				$lines[] =					"new_instr->operand2.count_pointer = &new_counts[i][0];";
+				$lines[] =					"new_instr->operand3 = instr->operand3;";
+				$lines[] =					"new_instr->operand4 = instr->operand4;";
+				$lines[] =					"new_instr->operand5.data_pointer = &new_column_counts[i];";
+				$lines[] =					"new_instr->operand6.data_pointer = instr->operand6.data_pointer;";
+				$lines[] =					"new_instr->operand6.index_pointer = &new_indices[i][1];";
+				$lines[] =					"new_instr->operand6.count_pointer = &new_counts[i][1];";
+				$lines[] =					"new_ips[i] = (int8_t *) new_instr;";
+				$lines[] =				"}";
+				$lines[] =				"qb_dispatch_instruction_to_threads(cxt, control_func, new_ips, thread_count);";
+				$lines[] =				"return TRUE;";
+				$lines[] =			"}";
+				$lines[] =		"}";
+				$lines[] =		"return FALSE;";
+				$lines[] = "}";
+				return $lines;
+			}
+		} else {
+			return parent::getDispatcherFunctionDefinition();
+		}
+	}
+
+	public function getHelperFunctions() {
+		if($this->operandSize == "variable") {
+			$type = $this->getOperandType(1);
+			$cType = $this->getOperandCType(1);
+			$functions = array(
+				array(
+					"void qb_multiply_matrix_blocks_column_major_$type($cType *__restrict m1, $cType *__restrict m2, $cType *__restrict res, uint32_t m1_rows, uint32_t m1_cols, uint32_t m2_cols) {",
+						"uint32_t i, j, k, ii, jj, kk, i_end, j_end, k_end;",
+						"memset(res, 0, m1_rows * m2_cols * sizeof($cType));",
+						"// work on tiles small enough that the part of the first matrix in use stays in the cache",
+						"for(jj = 0; jj < m2_cols; jj += 64) {",
+							"j_end = (jj + 64 < m2_cols) ? jj + 64 : m2_cols;",
+							"for(kk = 0; kk < m1_cols; kk += 128) {",
+								"k_end = (kk + 128 < m1_cols) ? kk + 128 : m1_cols;",
+								"for(ii = 0; ii < m1_rows; ii += 64) {",
+									"i_end = (ii + 64 < m1_rows) ? ii + 64 : m1_rows;",
+									"// calculate four columns of the result at a time, so that each element loaded from the first matrix is used four times",
+									"for(j = jj; j + 4 <= j_end; j += 4) {",
+										"$cType *__restrict c0 = res + j * m1_rows;",
+										"$cType *__restrict c1 = c0 + m1_rows;",
+										"$cType *__restrict c2 = c1 + m1_rows;",
+										"$cType *__restrict c3 = c2 + m1_rows;",
+										"for(k = kk; k < k_end; k++) {",
+											"$cType *__restrict a = m1 + k * m1_rows;",
+											"$cType b0 = m2[j * m1_cols + k];",
+											"$cType b1 = m2[(j + 1) * m1_cols + k];",
+											"$cType b2 = m2[(j + 2) * m1_cols + k];",
+											"$cType b3 = m2[(j + 3) * m1_cols + k];",
+											"for(i = ii; i < i_end; i++) {",
+												"$cType a_i = a[i];",
+												"c0[i] += a_i * b0;",
+												"c1[i] += a_i * b1;",
+												"c2[i] += a_i * b2;",
+												"c3[i] += a_i * b3;",
+											"}",
+										"}",
+									"}",
+									"for(; j < j_end; j++) {",
+										"$cType *__restrict c0 = res + j * m1_rows;",
+										"for(k = kk; k < k_end; k++) {",
+											"$cType *__restrict a = m1 + k * m1_rows;",
+											"$cType b0 = m2[j * m1_cols + k];",
+											"for(i = ii; i < i_end; i++) {",
+												"c0[i] += a[i] * b0;",
+											"}",
+										"}",
+									"}",
+								"}",
+							"}",
+						"}",
+					"}",
+				),
+			);
+			return $functions;
+		}
+	}
+
 	public function getActionOnUnitData() {
 		$cType = $this->getOperandCType(1);
 		$order = $this->getMatrixConvention();
@@ -90,22 +284,37 @@ class MultiplyMatrixByMatrix extends Handler {
 				$lines[] = "memcpy(res_ptr, buffer, matrix1_rows * matrix2_cols * sizeof($cType));";
 				$lines[] = "free_alloca(buffer, use_heap);";
 			} else {
+				$type = $this->getOperandType(1);
+				$threshold = $this->getBlockingThreshold();
 				$lines[] = "ALLOCA_FLAG(use_heap)";
 				$lines[] = "uint32_t i, j, k, p, q, res_index = 0;";
 				$lines[] = "uint32_t matrix1_rows = op3, matrix1_cols = op4, matrix2_cols = op5;";
-				$lines[] = "$cType *__restrict buffer = do_alloca(matrix1_rows * matrix2_cols * sizeof($cType), use_heap);";
-				$lines[] = "for(i = 0, q = 0; i < matrix2_cols; ++i) {";
-				$lines[] = 		"for(j = 0; j < matrix1_rows; ++j) {";
-				$lines[] = 			"$cType dot_product = 0;";
-				$lines[] = 			"for(p = 0, k = 0; p < matrix1_cols; ++p, k += matrix1_rows) {";
-				$lines[] = 				"dot_product += op1_ptr[k + j] * op2_ptr[p + q];";
+				$lines[] = "uint32_t matrix1_size = matrix1_rows * matrix1_cols, matrix2_size = matrix1_cols * matrix2_cols, res_size = matrix1_rows * matrix2_cols;";
+				$lines[] = "$cType *__restrict buffer = res_ptr;";
+				$lines[] = "// write into the result directly unless it overlaps one of the operands";
+				$lines[] = "// (products split across threads never overlap, so the buffer is only allocated in the main thread)";
+				$lines[] = "int32_t overlapping = !((res_ptr + res_size <= op1_ptr || op1_ptr + matrix1_size <= res_ptr) && (res_ptr + res_size <= op2_ptr || op2_ptr + matrix2_size <= res_ptr));";
+				$lines[] = "if(overlapping) {";
+				$lines[] = 		"buffer = do_alloca(res_size * sizeof($cType), use_heap);";
+				$lines[] = "}";
+				$lines[] = "if((uint64_t) matrix1_rows * matrix1_cols * matrix2_cols >= $threshold) {";
+				$lines[] = 		"qb_multiply_matrix_blocks_column_major_$type(op1_ptr, op2_ptr, buffer, matrix1_rows, matrix1_cols, matrix2_cols);";
+				$lines[] = "} else {";
+				$lines[] = 		"for(i = 0, q = 0; i < matrix2_cols; ++i) {";
+				$lines[] = 			"for(j = 0; j < matrix1_rows; ++j) {";
+				$lines[] = 				"$cType dot_product = 0;";
+				$lines[] = 				"for(p = 0, k = 0; p < matrix1_cols; ++p, k += matrix1_rows) {";
+				$lines[] = 					"dot_product += op1_ptr[k + j] * op2_ptr[p + q];";
+				$lines[] = 				"}";
+				$lines[] = 				"buffer[res_index++] = dot_product;";
 				$lines[] = 			"}";
-				$lines[] = 			"buffer[res_index++] = dot_product;";
+				$lines[] = 			"q += matrix1_cols;";
 				$lines[] = 		"}";
-				$lines[] = 		"q += matrix1_cols;";
 				$lines[] = "}";
-				$lines[] = "memcpy(res_ptr, buffer, matrix1_rows * matrix2_cols * sizeof($cType));";
-				$lines[] = "free_alloca(buffer, use_heap);";
+				$lines[] = "if(overlapping) {";
+				$lines[] = 		"memcpy(res_ptr, buffer, res_size * sizeof($cType));";
+				$lines[] = 		"free_alloca(buffer, use_heap);";
+				$lines[] = "}";
 			}
 		} else {
 			if($order == "row-major") {
@@ -115,6 +115,7 @@ fwrite($handle, $include);
 fwrite($handle, "#include \"qb_interpreter_gcc.h\"\n");
 fwrite($handle, "\n");
 $generator->writeOpInfo($handle);
+$generator->writeMultithreadingThresholds($handle);
 $generator->writeOpNames($handle);
 $generator->writeNativeCodeTables($handle, 'GCC');
 
@@ -124,6 +125,7 @@ fwrite($handle, $include);
 fwrite($handle, "#include \"qb_interpreter_msvc.h\"\n");
 fwrite($handle, "\n");
 $generator->writeOpInfo($handle, 'MSVC');
+$generator->writeMultithreadingThresholds($handle);
 $generator->writeOpNames($handle, 'MSVC');
 $generator->writeNativeCodeTables($handle, 'MSVC');
 
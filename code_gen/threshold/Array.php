@@ -0,0 +1,507 @@
+<?php
+
+class ArrayMax_F32 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param float32[] $a
+	 * @local float32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = max($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayMax_F64 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param float64[] $a
+	 * @local float64 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = max($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayMax_S32 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param int32[] $a
+	 * @local int32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = max($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayMax_S64 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param int64[] $a
+	 * @local int64 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = max($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayMax_U32 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param uint32[] $a
+	 * @local uint32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = max($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayMax_U64 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param uint64[] $a
+	 * @local uint64 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = max($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayMin_F32 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param float32[] $a
+	 * @local float32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = min($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayMin_F64 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param float64[] $a
+	 * @local float64 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = min($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayMin_S32 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param int32[] $a
+	 * @local int32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = min($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayMin_S64 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param int64[] $a
+	 * @local int64 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = min($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayMin_U32 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param uint32[] $a
+	 * @local uint32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = min($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayMin_U64 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param uint64[] $a
+	 * @local uint64 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = min($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayProduct_F32 {
+	use SequentialInverses;
+
+	/**
+	 * @engine qb
+	 * @param float32[] $a
+	 * @local float32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_product($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayProduct_F64 {
+	use SequentialInverses;
+
+	/**
+	 * @engine qb
+	 * @param float64[] $a
+	 * @local float64 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_product($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayProduct_S32 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param int32[] $a
+	 * @local int32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_product($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayProduct_S64 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param int64[] $a
+	 * @local int64 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_product($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayProduct_U32 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param uint32[] $a
+	 * @local uint32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_product($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArrayProduct_U64 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param uint64[] $a
+	 * @local uint64 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_product($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArraySum_F32 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param float32[] $a
+	 * @local float32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_sum($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArraySum_F64 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param float64[] $a
+	 * @local float64 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_sum($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArraySum_S32 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param int32[] $a
+	 * @local int32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_sum($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArraySum_S64 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param int64[] $a
+	 * @local int64 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_sum($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArraySum_U32 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param uint32[] $a
+	 * @local uint32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_sum($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArraySum_U64 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param uint64[] $a
+	 * @local uint64 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_sum($a);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArraySearch_F32 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param float32[] $a
+	 * @local int32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_search($a, -1);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArraySearch_F64 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param float64[] $a
+	 * @local int32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_search($a, -1);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArraySearch_I32 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param int32[] $a
+	 * @local int32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_search($a, -1);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+class ArraySearch_I64 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param int64[] $a
+	 * @local int32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$s = time();
+		$r = array_search($a, -1);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
+?>
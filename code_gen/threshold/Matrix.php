@@ -191,6 +191,27 @@ class Distance_F32_X4 {
 	}
 }
 
+// a single dot product of two long vectors, listed with a width of zero
+class DotProduct_F32_X0 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param float32[] $a
+	 * @local float32[] $b
+	 * @local float32 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$b = $a + 3;
+		$s = time();
+		$r = dot($a, $b);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
 class DotProduct_F32_X2 {
 	use SequentialNumbers;
 
@@ -1120,6 +1141,27 @@ class Distance_F64_X4 {
 	}
 }
 
+// a single dot product of two long vectors, listed with a width of zero
+class DotProduct_F64_X0 {
+	use SequentialNumbers;
+
+	/**
+	 * @engine qb
+	 * @param float64[] $a
+	 * @local float64[] $b
+	 * @local float64 $r
+	 * @local float64 $(s|e)
+	 * @return float64
+	 */
+	function test($a) {
+		$b = $a + 3;
+		$s = time();
+		$r = dot($a, $b);
+		$e = time();
+		return ($e - $s);
+	}
+}
+
 class DotProduct_F64_X2 {
 	use SequentialNumbers;
 
@@ -77,6 +77,7 @@ trait Sampling {
 }
 
 require("Arithmetic.php");
+require("Array.php");
 require("Bitwise.php");
 require("ComplexNumber.php");
 require("Math.php");
@@ -0,0 +1,109 @@
+<?php
+
+trait ArrayHashing {
+
+	public function getHelperFunctions() {
+		$type = $this->getOperandType(1);
+		$cType = $this->getOperandCType(1);
+		if($type[0] == 'F') {
+			$width = substr($type, 1);
+			$functions = array(
+				array(
+					"uint32_t qb_hash_array_$type($cType *op1_ptr, uint32_t op1_count) {",
+						"uint64_t hash = 0;",
+						"uint32_t i;",
+						"for(i = 0; i < op1_count; i++) {",
+							"// adding zero turns -0 into +0, so that the two yield the same hash",
+							"$cType value = op1_ptr[i] + 0;",
+							"uint{$width}_t bits;",
+							"memcpy(&bits, &value, sizeof(bits));",
+							"hash = (hash ^ bits) * 0x9E3779B97F4A7C15ULL;",
+							"hash ^= hash >> 32;",
+						"}",
+						"return (uint32_t) hash;",
+					"}",
+				),
+			);
+		} else {
+			$functions = array(
+				array(
+					"uint32_t qb_hash_array_$type($cType *op1_ptr, uint32_t op1_count) {",
+						"uint64_t hash = 0;",
+						"uint32_t i;",
+						"for(i = 0; i < op1_count; i++) {",
+							"hash = (hash ^ (uint64_t) op1_ptr[i]) * 0x9E3779B97F4A7C15ULL;",
+							"hash ^= hash >> 32;",
+						"}",
+						"return (uint32_t) hash;",
+					"}",
+				),
+			);
+		}
+		return $functions;
+	}
+
+	// number of elements (scalars or tuples) above which a hash table is used instead of a nested scan
+	protected function getHashTableThreshold() {
+		return 32;
+	}
+
+	// number of elements above which a nested scan is used again, keeping the bucket count (twice 
+	// the element count) from overflowing and the table from filling up
+	protected function getHashTableLimit() {
+		return "0x10000000";
+	}
+
+	// return the condition under which a hash table is used
+	protected function getHashTableCondition($elementCount) {
+		$threshold = $this->getHashTableThreshold();
+		$limit = $this->getHashTableLimit();
+		return "$elementCount > $threshold && $elementCount <= $limit";
+	}
+
+	// return code allocating an open-addressing hash table for the given number of elements
+	// buckets hold offsets plus one (zero meaning empty) into the array being hashed
+	protected function getHashTableAllocationCode($elementCount) {
+		$lines = array();
+		$lines[] = "uint32_t bucket_count = 64, bucket_mask, bucket_index, n;";
+		$lines[] = "uint32_t *buckets;";
+		$lines[] = "int32_t found;";
+		$lines[] = "ALLOCA_FLAG(use_heap)";
+		$lines[] = "while(bucket_count < $elementCount * 2 && bucket_count < {$this->getHashTableLimit()} * 2) {";
+		$lines[] = 		"bucket_count <<= 1;";
+		$lines[] = "}";
+		$lines[] = "bucket_mask = bucket_count - 1;";
+		$lines[] = "buckets = do_alloca(bucket_count * sizeof(uint32_t), use_heap);";
+		$lines[] = "memset(buckets, 0, bucket_count * sizeof(uint32_t));";
+		return $lines;
+	}
+
+	// return code looking for the element in the hash table; afterward, bucket_index points to either
+	// the bucket holding the match or the empty bucket where the element should go
+	protected function getHashTableSearchCode($tableArray, $element, $width) {
+		$type = $this->getOperandType(1);
+		$cType = $this->getOperandCType(1);
+		$lines = array();
+		$lines[] = "bucket_index = qb_hash_array_$type($element, $width) & bucket_mask;";
+		$lines[] = "found = FALSE;";
+		$lines[] = "while(buckets[bucket_index]) {";
+		$lines[] = 		"$cType *other = $tableArray + (buckets[bucket_index] - 1);";
+		$lines[] = 		"for(n = 0; n < $width; n++) {";
+		$lines[] = 			"if(other[n] != {$element}[n]) {";
+		$lines[] = 				"break;";
+		$lines[] = 			"}";
+		$lines[] = 		"}";
+		$lines[] = 		"if(n == $width) {";
+		$lines[] = 			"found = TRUE;";
+		$lines[] = 			"break;";
+		$lines[] = 		"}";
+		$lines[] = 		"bucket_index = (bucket_index + 1) & bucket_mask;";
+		$lines[] = "}";
+		return $lines;
+	}
+
+	protected function getHashTableReleaseCode() {
+		return array("free_alloca(buckets, use_heap);");
+	}
+}
+
+?>
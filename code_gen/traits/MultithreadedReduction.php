@@ -0,0 +1,172 @@
+<?php
+
+// large reductions are split into ranges, with each thread reducing one range into a partial result
+// the partial results are then combined in the order of the threads, so the outcome doesn't depend on scheduling
+trait MultithreadedReduction {
+
+	public function isReducedInThreads() {
+		return !$this->isMultipleData();
+	}
+
+	public function isDispatchedToThreads() {
+		if($this->isReducedInThreads()) {
+			return ($this->getMultithreadingThreshold() != 0);
+		} else {
+			return parent::isDispatchedToThreads();
+		}
+	}
+
+	// the threshold is the number of elements reduced; ops with variable-length operands are listed with a width of zero
+	public function getMultithreadingThreshold() {
+		if($this->isReducedInThreads()) {
+			$width = is_int($this->operandSize) ? $this->operandSize : 0;
+			return $this->lookUpMultithreadingThreshold($width);
+		} else {
+			return parent::getMultithreadingThreshold();
+		}
+	}
+
+	// return code that combines the partial results into res
+	protected function getReductionCode() {
+		// reduce the partial results the same way as the original array
+		$handlerFunction = $this->getHandlerFunctionName();
+		return "$handlerFunction(partial_results, cxt->thread_count, &res);";
+	}
+
+	protected function getDispatcherFunctionName() {
+		if($this->isReducedInThreads()) {
+			$instr = $this->getInstructionStructure();
+			return "qb_dispatch_reduction_" . substr($instr, 15);
+		} else {
+			return parent::getDispatcherFunctionName();
+		}
+	}
+
+	protected function getDispatcherFunctionParameterList($forDeclaration) {
+		if($this->isReducedInThreads()) {
+			$instr = $this->getInstructionStructure();
+			$opCount = $this->getOperandCount();
+			$params = array();
+			if($forDeclaration) {
+				$params[] = "qb_interpreter_context *__restrict cxt";
+				$params[] = "void *control_func";
+				$params[] = "$instr *__restrict instr";
+				$params[] = "void *partial_results";
+				$params[] = "uint32_t partial_result_size";
+				$params[] = "uint32_t count";
+				$params[] = "uint32_t threshold";
+			} else {
+				$params[] = "cxt";
+				$params[] = $this->getControllerFunctionName();
+				$params[] = "($instr *) ip";
+				$params[] = "partial_results";
+				$params[] = "sizeof(" . $this->getOperandCType($opCount) . ")";
+				$params[] = $this->getOperandSize(1);
+				$params[] = $this->getMultithreadingThresholdExpression();
+			}
+			return implode(", ", $params);
+		} else {
+			return parent::getDispatcherFunctionParameterList($forDeclaration);
+		}
+	}
+
+	// return the dispatcher function, which returns the number of elements given to each thread or zero if the op isn't split
+	public function getDispatcherFunctionDefinition() {
+		if($this->isReducedInThreads()) {
+			if($this->isDispatchedToThreads()) {
+				$instr = $this->getInstructionStructure();
+				$dispatcherFunction = $this->getDispatcherFunctionName();
+				$dispatcherParameterList = $this->getDispatcherFunctionParameterList(true);
+				$srcCount = $this->getInputOperandCount();
+				$opCount = $this->getOperandCount();
+				// the number of elements is the size of the first array or is held in a scalar (e.g. the width of a dot product)
+				$length = $this->getOperandSize(1);
+				$arrayCount = 0;
+				for($i = 1; $i <= $srcCount; $i++) {
+					if($this->getOperandAddressMode($i) == "ARR") {
+						$arrayCount++;
+					}
+				}
+				$lines = array();
+				$lines[] = "uint32_t $dispatcherFunction($dispatcherParameterList) {";
+				$lines[] =		"uint32_t thread_count = cxt->thread_count;";
+				$lines[] =		"if(count >= threshold && count >= thread_count) {";
+				$lines[] =			"// create temporary instruction structures, each reducing a range of elements into one of the partial results";
+				$lines[] =			"$instr new_instr_list[MAX_THREAD_COUNT];";
+				$lines[] =			"uint32_t new_indices[MAX_THREAD_COUNT][$arrayCount];";
+				$lines[] =			"uint32_t new_counts[MAX_THREAD_COUNT];";
+				if($this->getOperandAddressMode($opCount) == "ELE") {
+					$lines[] =		"uint32_t result_index = 0;";
+				}
+				$lines[] =			"int8_t *new_ips[MAX_THREAD_COUNT];";
+				$lines[] =			"uint32_t chunk_size = count / thread_count;";
+				$lines[] =			"uint32_t i;";
+				$lines[] =			"for(i = 0; i < thread_count; i++) {";
+				$lines[] =				"$instr *new_instr = &new_instr_list[i];";
+				$lines[] =				"uint32_t start = i * chunk_size;";
+				$lines[] =				"new_counts[i] = (i == thread_count - 1) ? count - start : chunk_size;";
+				for($i = 1, $k = 0; $i <= $opCount; $i++) {
+					$addressMode = $this->getOperandAddressMode($i);
+					if($i > $srcCount) {
+						$lines[] =		"new_instr->operand{$i}.data_pointer = ((int8_t *) partial_results) + i * partial_result_size;";
+						if($addressMode == "ELE") {
+							$lines[] =	"new_instr->operand{$i}.index_pointer = &result_index;";
+						}
+					} else if($addressMode == "ARR") {
+						$lines[] =		"new_indices[i][$k] = instr->operand{$i}.index_pointer[0] + start;";
+						$lines[] = 		"new_instr->operand{$i}.data_pointer = instr->operand{$i}.data_pointer;";
+						$lines[] = 		"new_instr->operand{$i}.index_pointer = &new_indices[i][$k];";
+						$lines[] = 		"new_instr->operand{$i}.count_pointer = &new_counts[i];";
+						$k++;
+					} else if($length == "op{$i}") {
+						$lines[] = 		"new_instr->operand{$i}.data_pointer = &new_counts[i];";
+					} else {
+						$lines[] = 		"new_instr->operand{$i} = instr->operand{$i};";
+					}
+				}
+				$lines[] =				"new_ips[i] = (int8_t *) new_instr;";
+				$lines[] =			"}";
+				$lines[] =			"qb_dispatch_instruction_to_threads(cxt, control_func, new_ips, thread_count);";
+				$lines[] =			"return chunk_size;";
+				$lines[] =		"}";
+				$lines[] =		"return 0;";
+				$lines[] = "}";
+				return $lines;
+			}
+		} else {
+			return parent::getDispatcherFunctionDefinition();
+		}
+	}
+
+	public function getControllerFunctionDefinition() {
+		if($this->isReducedInThreads()) {
+			if($this->isDispatchedToThreads()) {
+				$opCount = $this->getOperandCount();
+				$cType = $this->getOperandCType($opCount);
+				$controllerFunction = $this->getControllerFunctionName();
+				$controllerParameterList = $this->getControllerFunctionParameterList(true);
+				$dispatcherFunction = $this->getDispatcherFunctionName();
+				$dispatcherParameterList = $this->getDispatcherFunctionParameterList(false);
+				$handlerFunction = $this->getHandlerFunctionName();
+				$handlerParameterList = $this->getHandlerFunctionParameterList(false);
+				$lines = array();
+				$lines[] = "void $controllerFunction($controllerParameterList) {";
+				$lines[] =		$this->getMacroDefinitions();
+				$lines[] =		"$cType partial_results[MAX_THREAD_COUNT];";
+				$lines[] =		"uint32_t chunk_size = (cxt->thread_count) ? $dispatcherFunction($dispatcherParameterList) : 0;";
+				$lines[] =		"if(chunk_size) {";
+				$lines[] =			$this->getReductionCode();
+				$lines[] =		"} else {";
+				$lines[] = 			"$handlerFunction($handlerParameterList);";
+				$lines[] =		"}";
+				$lines[] =		$this->getMacroUndefinitions();
+				$lines[] = "}";
+				return $lines;
+			}
+		} else {
+			return parent::getControllerFunctionDefinition();
+		}
+	}
+}
+
+?>
@@ -0,0 +1,9 @@
+<?php
+
+trait Vectorizable {
+
+	// emit straight loops, which the C compiler can vectorize, for cases where
+	// no wrap-around is needed (i.e. all operands are either as long as the result or scalars)
+}
+
+?>
\ No newline at end of file
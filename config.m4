@@ -13,6 +13,9 @@ PHP_ARG_WITH(avx, whether to use AVX instructions on x86 processors,
 PHP_ARG_WITH(cpu, whether to enable CPU-specific optimization,
 [  --with-cpu[=arch]         Enable optimization specific to CPU archecture], no, no)
 
+PHP_ARG_WITH(libtcc, whether to compile native code in-process with libtcc,
+[  --with-libtcc[=DIR]       Compile native code in-process with TinyCC's libtcc], no, no)
+
 if test "$PHP_QB" != "no"; then
   qb_cflags=""
 
@@ -37,6 +40,8 @@ if test "$PHP_QB" != "no"; then
     	qb_cflags="$qb_cflags -march=$PHP_CPU"
     fi
   fi
+  dnl let the compiler turn the straight element-wise loops into SIMD code, even without the flags above
+  qb_cflags="$qb_cflags -ftree-vectorize"
 
   AC_SEARCH_LIBS(exp,m,[ ])
 
@@ -90,6 +95,25 @@ if test "$PHP_QB" != "no"; then
     AC_MSG_RESULT([yes])
   fi
 
+  if test "$PHP_LIBTCC" != "no"; then
+    AC_MSG_CHECKING([for libtcc.h])
+    for i in $PHP_LIBTCC /usr/local /usr; do
+      if test -r $i/include/libtcc.h; then
+        LIBTCC_DIR=$i
+        AC_MSG_RESULT([found in $i])
+        break
+      fi
+    done
+    if test -z "$LIBTCC_DIR"; then
+      AC_MSG_RESULT([not found])
+      AC_MSG_ERROR([Please install TinyCC's libtcc])
+    fi
+    PHP_ADD_INCLUDE($LIBTCC_DIR/include)
+    PHP_ADD_LIBRARY_WITH_PATH(tcc, $LIBTCC_DIR/$PHP_LIBDIR, QB_SHARED_LIBADD)
+    PHP_ADD_LIBRARY(dl,, QB_SHARED_LIBADD)
+    AC_DEFINE(HAVE_LIBTCC,1,[ ])
+  fi
+
   PHP_SUBST(QB_SHARED_LIBADD)
   case $host_alias in
   *darwin*)
@@ -111,6 +135,7 @@ if test "$PHP_QB" != "no"; then
 	qb_encoder.c\
 	qb_exceptions.c\
 	qb_extractor.c\
+	qb_function_cache.c\
 	qb_function_inliner.c\
 	qb_interpreter.c\
 	qb_interpreter_debug.c\
@@ -121,8 +146,10 @@ if test "$PHP_QB" != "no"; then
 	qb_op_factories.c\
 	qb_parser.c\
 	qb_printer.c\
+	qb_profiler.c\
 	qb_storage.c\
 	qb_thread.c\
+	qb_threshold.c\
 	qb_translator_pbj.c\
 	qb_translator_php.c\
 	qb_types.c\
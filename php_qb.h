@@ -46,6 +46,17 @@ PHP_MINFO_FUNCTION(qb);
 
 PHP_FUNCTION(qb_compile);
 PHP_FUNCTION(qb_extract);
+PHP_FUNCTION(qb_get_multithreading_thresholds);
+PHP_FUNCTION(qb_calibrate_multithreading_thresholds);
+PHP_FUNCTION(qb_profile_start);
+PHP_FUNCTION(qb_profile_stop);
+PHP_FUNCTION(qb_profile_reset);
+PHP_FUNCTION(qb_profile_get_data);
+PHP_FUNCTION(qb_profile_dump);
+PHP_FUNCTION(qb_async);
+PHP_FUNCTION(qb_wait);
+PHP_FUNCTION(qb_done);
+PHP_FUNCTION(qb_map);
 
 /* 
   	Declare any global variables you may need between the BEGIN
@@ -472,6 +472,122 @@ static void qb_remove_generator_context(zend_generator *generator TSRMLS_DC) {
 }
 #endif
 
+static int le_qb_async_call;
+
+static void qb_add_async_call(qb_async_call *call TSRMLS_DC) {
+	uint32_t index = QB_G(async_call_count)++;
+	QB_G(async_calls) = erealloc(QB_G(async_calls), sizeof(qb_async_call *) * QB_G(async_call_count));
+	QB_G(async_calls)[index] = call;
+}
+
+static void qb_remove_async_call(qb_async_call *call TSRMLS_DC) {
+	uint32_t i;
+	for(i = 0; i < QB_G(async_call_count); i++) {
+		if(QB_G(async_calls)[i] == call) {
+			QB_G(async_call_count)--;
+			if(i != QB_G(async_call_count)) {
+				memmove(&QB_G(async_calls)[i], &QB_G(async_calls)[i + 1], sizeof(qb_async_call *) * (QB_G(async_call_count) - i));
+			}
+			if(QB_G(async_call_count) == 0) {
+				efree(QB_G(async_calls));
+				QB_G(async_calls) = NULL;
+			}
+			break;
+		}
+	}
+}
+
+static void qb_free_async_call(qb_async_call *call) {
+	if(call->return_value) {
+		zval_ptr_dtor(&call->return_value);
+	}
+	efree(call);
+}
+
+static void qb_finish_async_calls(TSRMLS_D) {
+	uint32_t i;
+	for(i = 0; i < QB_G(async_call_count); i++) {
+		qb_async_call *call = QB_G(async_calls)[i];
+		if(CG(unclean_shutdown)) {
+			qb_abandon_async_call(call TSRMLS_CC);
+		} else {
+			qb_finish_async_call(call TSRMLS_CC);
+		}
+		if(call->released) {
+			// the resource is gone already
+			qb_free_async_call(call);
+		}
+	}
+	if(QB_G(async_calls)) {
+		efree(QB_G(async_calls));
+		QB_G(async_calls) = NULL;
+		QB_G(async_call_count) = 0;
+	}
+}
+
+static void qb_destroy_async_call_resource(zend_rsrc_list_entry *rsrc TSRMLS_DC) {
+	qb_async_call *call = rsrc->ptr;
+	if(!call->finished && CG(unclean_shutdown)) {
+		// the function might never return--leave it to RSHUTDOWN, which stops the workers first
+		call->released = TRUE;
+		return;
+	}
+	qb_finish_async_call(call TSRMLS_CC);
+	qb_remove_async_call(call TSRMLS_CC);
+	qb_free_async_call(call);
+}
+
+static qb_function * qb_get_worker_function(zval *callable TSRMLS_DC) {
+	zend_fcall_info_cache fcc;
+	zend_function *zfunc = NULL;
+	zend_op_array *op_array;
+	qb_function *qfunc = NULL;
+#if !ZEND_ENGINE_2_2 && !ZEND_ENGINE_2_1
+	char *error = NULL;
+	if(zend_is_callable_ex(callable, NULL, 0, NULL, NULL, &fcc, &error TSRMLS_CC)) {
+		zfunc = fcc.function_handler;
+	}
+	if(error) {
+		efree(error);
+	}
+#else
+	if(zend_is_callable_ex(callable, 0, NULL, NULL, NULL, &fcc.function_handler, &fcc.object_pp TSRMLS_CC)) {
+		zfunc = fcc.function_handler;
+	}
+#endif
+	if(!zfunc) {
+		php_error_docref(NULL TSRMLS_CC, E_WARNING, "Argument 1 is not a valid callback");
+		return NULL;
+	}
+	if(zfunc->type == ZEND_USER_FUNCTION) {
+		op_array = &zfunc->op_array;
+		qfunc = QB_GET_FUNCTION(op_array);
+		if(!qfunc && QB_IS_COMPILED(op_array)) {
+			qb_compile_functions(op_array TSRMLS_CC);
+			qfunc = QB_GET_FUNCTION(op_array);
+		}
+	}
+	if(!qfunc) {
+		php_error_docref(NULL TSRMLS_CC, E_WARNING, "%s() is not a qb function", zfunc->common.function_name);
+		return NULL;
+	}
+	if(qfunc->flags & QB_FUNCTION_GENERATOR) {
+		php_error_docref(NULL TSRMLS_CC, E_WARNING, "%s() is a generator and cannot run in a worker thread", qfunc->name);
+		return NULL;
+	} else {
+		// variables from other scopes cannot be safely accessed while the script continues
+		uint32_t i;
+		for(i = qfunc->argument_count; i < qfunc->variable_count; i++) {
+			qb_variable *qvar = qfunc->variables[i];
+			if(qvar->flags & (QB_VARIABLE_CLASS_INSTANCE | QB_VARIABLE_CLASS | QB_VARIABLE_CLASS_CONSTANT | QB_VARIABLE_GLOBAL | QB_VARIABLE_LEXICAL)) {
+				php_error_docref(NULL TSRMLS_CC, E_WARNING, "%s() uses variables outside its scope and cannot run in a worker thread", qfunc->name);
+				return NULL;
+			}
+		}
+	}
+	return qfunc;
+}
+
 static void qb_scan_function(qb_build_context *cxt, zend_function *function, zend_class_entry *scope) {
 	zend_op_array *op_array = &function->op_array;
 	if(QB_IS_COMPILED(op_array)) {
@@ -507,9 +623,96 @@ static void qb_scan_class_table(qb_build_context *cxt, HashTable *class_table) {
 	}
 }
 
+static void qb_add_pending_function(zend_op_array *op_array TSRMLS_DC) {
+	qb_pending_function *f;
+	if(!QB_G(pending_functions)) {
+		qb_create_array((void **) &QB_G(pending_functions), &QB_G(pending_function_count), sizeof(qb_pending_function), 16);
+	}
+	f = qb_enlarge_array((void **) &QB_G(pending_functions), 1);
+	f->function_name_length = (uint32_t) strlen(op_array->function_name);
+	f->function_name = zend_str_tolower_dup(op_array->function_name, f->function_name_length);
+	if(op_array->scope) {
+		f->class_name_length = op_array->scope->name_length;
+		f->class_name = zend_str_tolower_dup(op_array->scope->name, f->class_name_length);
+	} else {
+		f->class_name_length = 0;
+		f->class_name = NULL;
+	}
+}
+
+static void qb_free_pending_function(qb_pending_function *f) {
+	efree(f->function_name);
+	if(f->class_name) {
+		efree(f->class_name);
+	}
+}
+
+static void qb_discard_pending_functions(TSRMLS_D) {
+	uint32_t i;
+	for(i = 0; i < QB_G(pending_function_count); i++) {
+		qb_free_pending_function(&QB_G(pending_functions)[i]);
+	}
+	QB_G(pending_function_count) = 0;
+}
+
+static void qb_scan_pending_functions(qb_build_context *cxt TSRMLS_DC) {
+	uint32_t i, remaining = 0;
+	for(i = 0; i < QB_G(pending_function_count); i++) {
+		qb_pending_function *f = &QB_G(pending_functions)[i];
+		HashTable *function_table = EG(function_table);
+		zend_class_entry *scope = NULL, **p_ce;
+		zend_function *zfunc;
+		if(f->class_name) {
+			if(zend_hash_find(EG(class_table), f->class_name, f->class_name_length + 1, (void **) &p_ce) == SUCCESS) {
+				scope = *p_ce;
+				function_table = &scope->function_table;
+			} else {
+				function_table = NULL;
+			}
+		}
+		if(function_table && zend_hash_find(function_table, f->function_name, f->function_name_length + 1, (void **) &zfunc) == SUCCESS) {
+			if(zfunc->type == ZEND_USER_FUNCTION) {
+				qb_scan_function(cxt, zfunc, scope);
+			}
+			qb_free_pending_function(f);
+		} else {
+			// the function or class hasn't been declared yet
+			QB_G(pending_functions)[remaining++] = *f;
+		}
+	}
+	QB_G(pending_function_count) = remaining;
+}
+
+static int32_t qb_find_function_tag(qb_build_context *cxt, zend_op_array *op_array) {
+	uint32_t i;
+	for(i = 0; i < cxt->function_tag_count; i++) {
+		qb_function_tag *tag = &cxt->function_tags[i];
+		if(tag->op_array->opcodes == op_array->opcodes) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static void qb_load_cached_functions(qb_build_context *cxt TSRMLS_DC) {
+	uint32_t i, remaining = 0;
+	for(i = 0; i < cxt->function_tag_count; i++) {
+		qb_function_tag *tag = &cxt->function_tags[i];
+		qb_function *qfunc = qb_load_cached_function(tag->op_array TSRMLS_CC);
+		if(qfunc) {
+			qb_attach_compiled_function(qfunc, tag->op_array TSRMLS_CC);
+		} else {
+			// keep it in the list of functions to be built
+			cxt->function_tags[remaining++] = *tag;
+		}
+	}
+	cxt->function_tag_count = remaining;
+}
+
 static int32_t qb_compile_functions(zend_op_array *op_array TSRMLS_DC) {
 	qb_build_context _build_cxt, *build_cxt = &_build_cxt;
 	int32_t result = FALSE;
+	int32_t scan_all = FALSE;
 
 	// make sure the main thread is initialized
 	if(QB_G(main_thread).type == QB_THREAD_UNINITIALIZED) {
@@ -519,17 +722,38 @@ static int32_t qb_compile_functions(zend_op_array *op_array TSRMLS_DC) {
 	qb_initialize_build_context(build_cxt TSRMLS_CC);
 	QB_G(build_context) = build_cxt;
 
-	qb_scan_function_table(build_cxt, EG(function_table), NULL);
-	qb_scan_class_table(build_cxt, EG(class_table));
-#ifdef ZEND_ACC_CLOSURE
 	if(op_array) {
+		// look only at the functions Zend has compiled since the last time
+		qb_scan_pending_functions(build_cxt TSRMLS_CC);
+#ifdef ZEND_ACC_CLOSURE
 		if(op_array->fn_flags & ZEND_ACC_CLOSURE) {
 			qb_scan_function(build_cxt, (zend_function *) op_array, NULL);
 		}
+#endif
+		if(!qb_find_function_tag(build_cxt, op_array)) {
+			// the function didn't pass through qb_zend_ext_op_array_handler() (it came from an opcode cache, for instance)
+			scan_all = TRUE;
+		}
+	} else {
+		scan_all = TRUE;
 	}
+	if(scan_all) {
+		// everything still pending will be picked up here
+		build_cxt->function_tag_count = 0;
+		qb_discard_pending_functions(TSRMLS_C);
+		qb_scan_function_table(build_cxt, EG(function_table), NULL);
+		qb_scan_class_table(build_cxt, EG(class_table));
+#ifdef ZEND_ACC_CLOSURE
+		if(op_array && (op_array->fn_flags & ZEND_ACC_CLOSURE)) {
+			qb_scan_function(build_cxt, (zend_function *) op_array, NULL);
+		}
 #endif
+	}
 	if(build_cxt->function_tag_count) {
-		qb_build(build_cxt);
+		qb_load_cached_functions(build_cxt TSRMLS_CC);
+		if(build_cxt->function_tag_count) {
+			qb_build(build_cxt);
+		}
 		result = TRUE;
 	}
 	qb_free_build_context(build_cxt);
@@ -548,6 +772,10 @@ int qb_user_opcode_handler(ZEND_OPCODE_HANDLER_ARGS) {
 	}
 	if(qfunc) {
 		op_array->fn_flags &= ~ZEND_ACC_INTERACTIVE; 
+#ifdef NATIVE_COMPILE_ENABLED
+		// switch to native code if the compiler has finished
+		qb_check_native_code_requests(TSRMLS_C);
+#endif
 		if(qfunc->flags & QB_FUNCTION_GENERATOR) {
 #ifdef ZEND_ACC_GENERATOR
 			zend_generator *generator = (zend_generator *) EG(return_value_ptr_ptr);
@@ -650,11 +878,23 @@ void qb_zend_ext_op_array_ctor(zend_op_array *op_array) {
 
 void qb_zend_ext_op_array_handler(zend_op_array *op_array) {
 	if(QB_IS_COMPILED(op_array)) {
+		int32_t named = (op_array->function_name != NULL);
 		TSRMLS_FETCH();
 		// OpCache in Zend 2.6 and above doesn't the optimization elsewhere
 		// turn on the flag to keep it from running
 		op_array->fn_flags |= ZEND_ACC_INTERACTIVE; 
 		qb_reenable_zend_optimizer(TSRMLS_C);
+
+#ifdef ZEND_ACC_CLOSURE
+		if(op_array->fn_flags & ZEND_ACC_CLOSURE) {
+			// closures are handed to qb_compile_functions() directly
+			named = FALSE;
+		}
+#endif
+		if(named) {
+			// remember the function, so the function and class tables don't need to be scanned
+			qb_add_pending_function(op_array TSRMLS_CC);
+		}
 	}
 }
 
@@ -684,6 +924,17 @@ ZEND_DECLARE_MODULE_GLOBALS(qb)
 const zend_function_entry qb_functions[] = {
 	PHP_FE(qb_compile,		NULL)
 	PHP_FE(qb_extract,		NULL)
+	PHP_FE(qb_get_multithreading_thresholds,		NULL)
+	PHP_FE(qb_calibrate_multithreading_thresholds,	NULL)
+	PHP_FE(qb_profile_start,		NULL)
+	PHP_FE(qb_profile_stop,			NULL)
+	PHP_FE(qb_profile_reset,		NULL)
+	PHP_FE(qb_profile_get_data,		NULL)
+	PHP_FE(qb_profile_dump,			NULL)
+	PHP_FE(qb_async,		NULL)
+	PHP_FE(qb_wait,			NULL)
+	PHP_FE(qb_done,			NULL)
+	PHP_FE(qb_map,			NULL)
 #ifdef PHP_FE_END
 	PHP_FE_END	/* Must be the last line in qb_functions[] */
 #else
@@ -800,17 +1051,27 @@ PHP_INI_BEGIN()
 	STD_PHP_INI_ENTRY("qb.compiler_path",    				"",		PHP_INI_SYSTEM, OnUpdatePath,	compiler_path,    				zend_qb_globals,	qb_globals)
 	STD_PHP_INI_ENTRY("qb.compiler_env_path",  				"",		PHP_INI_SYSTEM, OnUpdatePath,	compiler_env_path,  			zend_qb_globals,	qb_globals)
 	STD_PHP_INI_ENTRY("qb.native_code_cache_path",  		"",		PHP_INI_SYSTEM, OnUpdatePath,	native_code_cache_path,			zend_qb_globals,	qb_globals)
+	STD_PHP_INI_ENTRY("qb.native_code_prebuild_levels",		"",		PHP_INI_SYSTEM, OnUpdateString,	native_code_prebuild_levels,	zend_qb_globals,	qb_globals)
+	STD_PHP_INI_ENTRY("qb.bytecode_cache_path",  			"",		PHP_INI_SYSTEM, OnUpdatePath,	bytecode_cache_path,			zend_qb_globals,	qb_globals)
 	STD_PHP_INI_ENTRY("qb.execution_log_path",  			"",		PHP_INI_SYSTEM, OnUpdatePath,	execution_log_path,				zend_qb_globals,	qb_globals)
+	STD_PHP_INI_ENTRY("qb.threshold_cache_path",  			"",		PHP_INI_SYSTEM, OnUpdatePath,	threshold_cache_path,			zend_qb_globals,	qb_globals)
+	STD_PHP_INI_ENTRY("qb.profile_output_path",  			"",		PHP_INI_SYSTEM, OnUpdatePath,	profile_output_path,			zend_qb_globals,	qb_globals)
+	STD_PHP_INI_ENTRY("qb.machine_thread_token_path",		"",		PHP_INI_SYSTEM, OnUpdatePath,	machine_thread_token_path,		zend_qb_globals,	qb_globals)
+	STD_PHP_INI_BOOLEAN("qb.calibrate_thresholds",			"0",	PHP_INI_SYSTEM,	OnUpdateBool,	calibrate_thresholds,			zend_qb_globals,	qb_globals)
 
 	STD_PHP_INI_ENTRY("qb.thread_count",					"0",	PHP_INI_ALL, 	OnThreadCount,	thread_count,					zend_qb_globals,	qb_globals)
+	STD_PHP_INI_ENTRY("qb.machine_thread_limit",			"0",	PHP_INI_SYSTEM,	OnUpdateLong,	machine_thread_limit,			zend_qb_globals,	qb_globals)
 
 	STD_PHP_INI_BOOLEAN("qb.allow_bytecode_interpretation",	"1",	PHP_INI_ALL,	OnUpdateBool,	allow_bytecode_interpretation,	zend_qb_globals,	qb_globals)
 	STD_PHP_INI_BOOLEAN("qb.allow_debugger_inspection",		"1",	PHP_INI_ALL,	OnUpdateBool,	allow_debugger_inspection,		zend_qb_globals,	qb_globals)
 	STD_PHP_INI_BOOLEAN("qb.allow_debug_backtrace",			"0",	PHP_INI_ALL,	OnUpdateBool,	allow_debug_backtrace,			zend_qb_globals,	qb_globals)
     STD_PHP_INI_BOOLEAN("qb.debug_with_exact_type",			"0",	PHP_INI_ALL,	OnUpdateBool,	debug_with_exact_type,			zend_qb_globals,	qb_globals)
     STD_PHP_INI_BOOLEAN("qb.column_major_matrix",			"0",	PHP_INI_ALL,	OnUpdateBool,	column_major_matrix,			zend_qb_globals,	qb_globals)
+    STD_PHP_INI_BOOLEAN("qb.force_bound_checks",			"0",	PHP_INI_ALL,	OnUpdateBool,	force_bound_checks,			zend_qb_globals,	qb_globals)
 
 	STD_PHP_INI_BOOLEAN("qb.compile_to_native",				"0",	PHP_INI_ALL,	OnUpdateBool,	compile_to_native,				zend_qb_globals,	qb_globals)
+	STD_PHP_INI_BOOLEAN("qb.native_compile_in_background",	"1",	PHP_INI_ALL,	OnUpdateBool,	native_compile_in_background,	zend_qb_globals,	qb_globals)
+	STD_PHP_INI_BOOLEAN("qb.native_compile_in_process",		"0",	PHP_INI_ALL,	OnUpdateBool,	native_compile_in_process,		zend_qb_globals,	qb_globals)
     STD_PHP_INI_BOOLEAN("qb.show_opcodes",					"0",	PHP_INI_ALL,	OnUpdateBool,	show_opcodes,					zend_qb_globals,	qb_globals)
     STD_PHP_INI_BOOLEAN("qb.show_native_source",			"0",	PHP_INI_ALL,	OnUpdateBool,	show_native_source,				zend_qb_globals,	qb_globals)
     STD_PHP_INI_BOOLEAN("qb.show_compiler_errors",			"0",	PHP_INI_ALL,	OnUpdateBool,	show_compiler_errors,			zend_qb_globals,	qb_globals)
@@ -823,6 +1084,32 @@ PHP_INI_END()
  */
 static void php_qb_init_globals(zend_qb_globals *qb_globals)
 {
+#ifdef NATIVE_COMPILE_ENABLED
+	qb_globals->native_code_bundles = NULL;
+	qb_globals->native_code_bundle_count = 0;
+	qb_globals->native_procs = NULL;
+	qb_globals->native_proc_count = 0;
+#endif
+}
+/* }}} */
+
+/* {{{ php_qb_shutdown_globals
+ */
+static void php_qb_shutdown_globals(zend_qb_globals *qb_globals)
+{
+#ifdef NATIVE_COMPILE_ENABLED
+	uint32_t i;
+	for(i = 0; i < qb_globals->native_code_bundle_count; i++) {
+		qb_native_code_bundle *bundle = &qb_globals->native_code_bundles[i];
+		qb_free_native_code(bundle);
+	}
+	if(qb_globals->native_code_bundles) {
+		pefree(qb_globals->native_code_bundles, TRUE);
+	}
+	if(qb_globals->native_procs) {
+		pefree(qb_globals->native_procs, TRUE);
+	}
+#endif
 }
 /* }}} */
 
@@ -835,7 +1122,7 @@ int zend_shutdown_strtod(void);
  */
 PHP_MINIT_FUNCTION(qb)
 {
-	ZEND_INIT_MODULE_GLOBALS(qb, php_qb_init_globals, NULL);
+	ZEND_INIT_MODULE_GLOBALS(qb, php_qb_init_globals, php_qb_shutdown_globals);
 
 	REGISTER_INI_ENTRIES();
 
@@ -846,6 +1133,8 @@ PHP_MINIT_FUNCTION(qb)
 	REGISTER_LONG_CONSTANT("QB_PBJ_DETAILS",		QB_PBJ_DETAILS,			CONST_CS | CONST_PERSISTENT);
 	REGISTER_LONG_CONSTANT("QB_PBJ_DECLARATION",	QB_PBJ_DECLARATION,		CONST_CS | CONST_PERSISTENT);
 
+	le_qb_async_call = zend_register_list_destructors_ex(qb_destroy_async_call_resource, NULL, "qb async call", module_number);
+
 #ifdef VC6_MSVCRT
 	if(qb_get_vc6_msvcrt_functions() != SUCCESS) {
 		return FAILURE;
@@ -853,6 +1142,10 @@ PHP_MINIT_FUNCTION(qb)
 #endif
 
 	qb_install_user_opcode_handler();
+	qb_initialize_multithreading_thresholds();
+#ifdef NATIVE_COMPILE_ENABLED
+	qb_initialize_native_compiler();
+#endif
 
 #if ZEND_ENGINE_2_1
 	zend_startup_strtod();
@@ -868,6 +1161,13 @@ PHP_MSHUTDOWN_FUNCTION(qb)
 	UNREGISTER_INI_ENTRIES();
 
 	qb_free_thread_pool();
+#ifdef NATIVE_COMPILE_ENABLED
+	qb_free_native_compiler();
+#endif
+
+#ifndef ZTS
+	php_qb_shutdown_globals(&qb_globals);
+#endif
 
 #if ZEND_ENGINE_2_1
 	zend_shutdown_strtod();
@@ -906,18 +1206,31 @@ PHP_RINIT_FUNCTION(qb)
 	QB_G(source_file_count) = 0;
 	QB_G(compiled_functions) = NULL;
 	QB_G(compiled_function_count) = 0;
+	QB_G(pending_functions) = NULL;
+	QB_G(pending_function_count) = 0;
 #ifdef ZEND_ACC_GENERATOR
 	QB_G(generator_contexts) = NULL;
 	QB_G(generator_context_count) = 0;
 #endif
 #ifdef NATIVE_COMPILE_ENABLED
-	QB_G(native_code_bundles) = NULL;
-	QB_G(native_code_bundle_count) = 0;
+	QB_G(native_code_requests) = NULL;
+	QB_G(native_code_request_count) = 0;
+	QB_G(native_code_check_time) = 0;
 #endif
+	QB_G(async_calls) = NULL;
+	QB_G(async_call_count) = 0;
+	QB_G(function_profiles) = NULL;
+	QB_G(function_profile_count) = 0;
+
+	// profile every request when an output folder is given
+	QB_G(profiling) = (QB_G(profile_output_path)[0] != '\0');
 
 	if(qb_initialize_thread_pool(TSRMLS_C)) {
 		qb_initialize_main_thread(&QB_G(main_thread) TSRMLS_CC);
 		qb_add_workers(&QB_G(main_thread));
+
+		// use thresholds measured on this machine if they're available
+		qb_load_multithreading_thresholds(TSRMLS_C);
 	}
 	return SUCCESS;
 }
@@ -934,9 +1247,17 @@ PHP_RSHUTDOWN_FUNCTION(qb)
 			// bailing out of script--make sure threads are shutdown
 			qb_terminate_associated_workers(&QB_G(main_thread));
 		}
+		qb_finish_async_calls(TSRMLS_C);
 		qb_free_main_thread(&QB_G(main_thread));
 	}
 
+	if(QB_G(function_profiles)) {
+		if(QB_G(profile_output_path)[0]) {
+			qb_save_profile(TSRMLS_C);
+		}
+		qb_free_function_profiles(TSRMLS_C);
+	}
+
 	for(i = 0; i < QB_G(scope_count); i++) {
 		qb_import_scope *scope = QB_G(scopes)[i];
 		if(scope->type != QB_IMPORT_SCOPE_OBJECT) {
@@ -976,6 +1297,10 @@ PHP_RSHUTDOWN_FUNCTION(qb)
 		}
 		qb_destroy_array((void **) &QB_G(compiled_functions));
 	}
+	if(QB_G(pending_functions)) {
+		qb_discard_pending_functions(TSRMLS_C);
+		qb_destroy_array((void **) &QB_G(pending_functions));
+	}
 
 #ifdef ZEND_ACC_GENERATOR
 	for(i = 0; i < QB_G(generator_context_count); i++) {
@@ -985,11 +1310,9 @@ PHP_RSHUTDOWN_FUNCTION(qb)
 	}
 #endif
 #ifdef NATIVE_COMPILE_ENABLED
-	for(i = 0; i < QB_G(native_code_bundle_count); i++) {
-		qb_native_code_bundle *bundle = &QB_G(native_code_bundles)[i];
-		qb_free_native_code(bundle);
-	}
-	qb_destroy_array((void **) &QB_G(native_code_bundles));
+	// loaded native code stays for later requests (see php_qb_shutdown_globals)
+	// compilers still running in the background will leave the object files in the cache for the next request
+	qb_destroy_array((void **) &QB_G(native_code_requests));
 #endif
 	return SUCCESS;
 }
@@ -1002,6 +1325,7 @@ PHP_MINFO_FUNCTION(qb)
 	char buffer[256];
 	uint32_t i;
 	uint32_t cpu_count = qb_get_cpu_count();
+	long token_count, token_limit;
 	qb_diagnostics diag;
 	php_info_print_table_start();
 	php_info_print_table_header(2, "qb support", "enabled");
@@ -1030,6 +1354,17 @@ PHP_MINFO_FUNCTION(qb)
 
 	sprintf(buffer, "%u", cpu_count);
 	php_info_print_table_row(2, "CPU count", buffer);
+	if(qb_get_thread_token_status(&token_count, &token_limit)) {
+		if(token_count >= 0) {
+			sprintf(buffer, "%ld / %ld", token_count, token_limit);
+		} else {
+			sprintf(buffer, "%ld", token_limit);
+		}
+		php_info_print_table_row(2, "Machine thread tokens", buffer);
+	}
+#ifdef NATIVE_COMPILE_ENABLED
+	php_info_print_table_row(2, "Native code CPU level", qb_get_cpu_level_name(qb_get_cpu_level()));
+#endif
 
 	qb_run_diagnostics(&diag TSRMLS_CC);
 	php_info_print_table_colspan_header(2, "Diagnostics");
@@ -1053,6 +1388,8 @@ PHP_MINFO_FUNCTION(qb)
 		snprintf(buffer, sizeof(buffer), "%g million operations per second", round(diag.instruction_speeds[i] / 1000000));
 		php_info_print_table_row(2, test_types[i], buffer);
 	}
+	snprintf(buffer, sizeof(buffer), "%g thousand copies per second", round(diag.function_copy_speed / 1000));
+	php_info_print_table_row(2, "Function copy throughput", buffer);
 	php_info_print_table_end();
 
 	DISPLAY_INI_ENTRIES();
@@ -1096,3 +1433,183 @@ PHP_FUNCTION(qb_extract)
 }
 /* }}} */
 
+/* {{{ proto array qb_get_multithreading_thresholds(void)
+   Return the minimum sizes at which operations are split across threads */
+PHP_FUNCTION(qb_get_multithreading_thresholds)
+{
+	qb_get_multithreading_thresholds(return_value TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ proto array qb_calibrate_multithreading_thresholds(void)
+   Measure the multithreading thresholds on this machine */
+PHP_FUNCTION(qb_calibrate_multithreading_thresholds)
+{
+	if(qb_calibrate_multithreading_thresholds(TSRMLS_C)) {
+		if(QB_G(threshold_cache_path) && QB_G(threshold_cache_path)[0]) {
+			qb_save_multithreading_thresholds(TSRMLS_C);
+		}
+		qb_get_multithreading_thresholds(return_value TSRMLS_CC);
+	} else {
+		RETURN_FALSE
+	}
+}
+/* }}} */
+
+/* {{{ proto bool qb_profile_start(void)
+   Start recording the execution of qb functions */
+PHP_FUNCTION(qb_profile_start)
+{
+	QB_G(profiling) = TRUE;
+	RETURN_TRUE
+}
+/* }}} */
+
+/* {{{ proto bool qb_profile_stop(void)
+   Stop recording the execution of qb functions */
+PHP_FUNCTION(qb_profile_stop)
+{
+	QB_G(profiling) = FALSE;
+	RETURN_TRUE
+}
+/* }}} */
+
+/* {{{ proto bool qb_profile_reset(void)
+   Clear the numbers recorded so far */
+PHP_FUNCTION(qb_profile_reset)
+{
+	qb_reset_profile(TSRMLS_C);
+	RETURN_TRUE
+}
+/* }}} */
+
+/* {{{ proto array qb_profile_get_data(void)
+   Return the execution counts and cycles of profiled functions, per line and per instruction */
+PHP_FUNCTION(qb_profile_get_data)
+{
+	qb_get_profile_data(return_value TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ proto bool qb_profile_dump(string filename)
+   Save the profile in callgrind format */
+PHP_FUNCTION(qb_profile_dump)
+{
+	char *file_path;
+	int file_path_length;
+
+	if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "s", &file_path, &file_path_length) == FAILURE) {
+		return;
+	}
+	if(qb_dump_profile(file_path TSRMLS_CC)) {
+		RETURN_TRUE
+	} else {
+		RETURN_FALSE
+	}
+}
+/* }}} */
+
+/* {{{ proto resource qb_async(callable function [, mixed ...])
+   Start running a qb function in a worker thread */
+PHP_FUNCTION(qb_async)
+{
+	zval ***args;
+	int argc = ZEND_NUM_ARGS();
+	qb_function *qfunc;
+
+	if(argc < 1) {
+		WRONG_PARAM_COUNT;
+	}
+	args = safe_emalloc(argc, sizeof(zval **), 0);
+	if(zend_get_parameters_array_ex(argc, args) == FAILURE) {
+		efree(args);
+		WRONG_PARAM_COUNT;
+	}
+
+	qfunc = qb_get_worker_function(*args[0] TSRMLS_CC);
+	if(qfunc) {
+		qb_async_call *call = emalloc(sizeof(qb_async_call));
+		zval **arguments = NULL;
+		uint32_t argument_count = argc - 1, i;
+		if(argument_count > 0) {
+			// keep the values alive until the call is finished
+			arguments = safe_emalloc(argument_count, sizeof(zval *), 0);
+			for(i = 0; i < argument_count; i++) {
+				arguments[i] = *args[i + 1];
+				Z_ADDREF_P(arguments[i]);
+			}
+		}
+		if(qb_start_async_call(call, qfunc, arguments, argument_count TSRMLS_CC)) {
+			qb_add_async_call(call TSRMLS_CC);
+			ZEND_REGISTER_RESOURCE(return_value, call, le_qb_async_call);
+		} else {
+			efree(call);
+			RETVAL_FALSE;
+		}
+	} else {
+		RETVAL_FALSE;
+	}
+	efree(args);
+}
+/* }}} */
+
+/* {{{ proto mixed qb_wait(resource call)
+   Wait for a function started by qb_async() to finish and return its result */
+PHP_FUNCTION(qb_wait)
+{
+	zval *zcall;
+	qb_async_call *call;
+
+	if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "r", &zcall) == FAILURE) {
+		return;
+	}
+	ZEND_FETCH_RESOURCE(call, qb_async_call *, &zcall, -1, "qb async call", le_qb_async_call);
+
+	if(qb_finish_async_call(call TSRMLS_CC) && call->return_value) {
+		RETURN_ZVAL(call->return_value, 1, 0);
+	} else {
+		RETURN_NULL();
+	}
+}
+/* }}} */
+
+/* {{{ proto bool qb_done(resource call)
+   Check whether a function started by qb_async() has finished */
+PHP_FUNCTION(qb_done)
+{
+	zval *zcall;
+	qb_async_call *call;
+
+	if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "r", &zcall) == FAILURE) {
+		return;
+	}
+	ZEND_FETCH_RESOURCE(call, qb_async_call *, &zcall, -1, "qb async call", le_qb_async_call);
+
+	if(qb_is_async_call_completed(call)) {
+		RETURN_TRUE
+	} else {
+		RETURN_FALSE
+	}
+}
+/* }}} */
+
+/* {{{ proto array qb_map(callable function, array argument_sets)
+   Call a qb function once for each set of arguments, spreading the calls across threads */
+PHP_FUNCTION(qb_map)
+{
+	zval *callable, *argument_sets;
+	qb_function *qfunc;
+
+	if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "za", &callable, &argument_sets) == FAILURE) {
+		return;
+	}
+
+	qfunc = qb_get_worker_function(callable TSRMLS_CC);
+	if(qfunc) {
+		array_init(return_value);
+		qb_execute_map(qfunc, Z_ARRVAL_P(argument_sets), return_value TSRMLS_CC);
+	} else {
+		RETURN_FALSE
+	}
+}
+/* }}} */
@@ -135,8 +135,11 @@
 #include "qb_translator_php.h"
 #include "qb_translator_pbj.h"
 #include "qb_encoder.h"
+#include "qb_function_cache.h"
 #include "qb_thread.h"
 #include "qb_interpreter.h"
+#include "qb_threshold.h"
+#include "qb_profiler.h"
 #include "qb_build.h"
 #include "qb_native_compiler.h"
 #include "qb_printer.h"
@@ -161,16 +164,20 @@ struct qb_generator_context {
 ZEND_BEGIN_MODULE_GLOBALS(qb)
 	qb_main_thread main_thread;
 	long thread_count;
+	long machine_thread_limit;
 	long debug_fork_id;
 
 	zend_bool allow_bytecode_interpretation;
 	zend_bool allow_native_compilation;
 	zend_bool allow_memory_map;
 	zend_bool compile_to_native;
+	zend_bool native_compile_in_background;
+	zend_bool native_compile_in_process;
 	zend_bool allow_debugger_inspection;
 	zend_bool allow_debug_backtrace;
 	zend_bool debug_with_exact_type;
 	zend_bool column_major_matrix;
+	zend_bool force_bound_checks;
 
 	zend_bool show_opcodes;
 	zend_bool show_native_source;
@@ -180,7 +187,14 @@ ZEND_BEGIN_MODULE_GLOBALS(qb)
 	char *compiler_path;
 	char *compiler_env_path;
 	char *native_code_cache_path;
+	char *native_code_prebuild_levels;
+	char *bytecode_cache_path;
 	char *execution_log_path;
+	char *threshold_cache_path;
+	char *profile_output_path;
+	char *machine_thread_token_path;
+
+	zend_bool calibrate_thresholds;
 
 	qb_build_context *build_context;
 
@@ -201,6 +215,9 @@ ZEND_BEGIN_MODULE_GLOBALS(qb)
 	qb_function **compiled_functions;
 	uint32_t compiled_function_count;
 
+	qb_pending_function *pending_functions;
+	uint32_t pending_function_count;
+
 #if !ZEND_ENGINE_2_3 && !ZEND_ENGINE_2_2 && !ZEND_ENGINE_2_1
 	zend_literal static_zvals[8];
 #else
@@ -209,8 +226,15 @@ ZEND_BEGIN_MODULE_GLOBALS(qb)
 	uint32_t static_zval_index;
 
 #ifdef NATIVE_COMPILE_ENABLED
+	// loaded code is kept until the process exits
 	qb_native_code_bundle *native_code_bundles;
 	uint32_t native_code_bundle_count;
+	qb_native_proc_record *native_procs;
+	uint32_t native_proc_count;
+
+	qb_native_code_request *native_code_requests;
+	uint32_t native_code_request_count;
+	double native_code_check_time;
 #endif
 
 #ifdef ZEND_ACC_GENERATOR
@@ -218,7 +242,14 @@ ZEND_BEGIN_MODULE_GLOBALS(qb)
 	uint32_t generator_context_count;
 #endif
 
+	qb_async_call **async_calls;
+	uint32_t async_call_count;
+
 	double execution_start_time;
+
+	zend_bool profiling;
+	qb_function_profile **function_profiles;
+	uint32_t function_profile_count;
 ZEND_END_MODULE_GLOBALS(qb)
 
 #ifdef ZTS
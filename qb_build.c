@@ -295,6 +295,9 @@ void qb_generate_executables(qb_build_context *cxt) {
 			qb_dispatch_exceptions(TSRMLS_C);
 		}
 
+		// save the position-independent function so later requests can skip the build
+		qb_save_cached_function(encoder_cxt, compiler_cxt->compiled_function TSRMLS_CC);
+
 		// relocate the function now, so the base function won't be in the middle of relcoation while it's being copied
 		qb_relocate_function(compiler_cxt->compiled_function, TRUE);
 
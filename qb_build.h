@@ -23,6 +23,7 @@
 
 typedef struct qb_build_context				qb_build_context;
 typedef struct qb_function_tag				qb_function_tag;
+typedef struct qb_pending_function			qb_pending_function;
 typedef struct qb_function_dependencies		qb_function_dependencies;
 
 struct qb_build_context {
@@ -49,6 +50,14 @@ struct qb_function_tag {
 	zend_op_array *op_array;
 };
 
+// a tagged function compiled by Zend, recorded by name since the op_array gets copied when it's bound
+struct qb_pending_function {
+	char *class_name;
+	uint32_t class_name_length;
+	char *function_name;
+	uint32_t function_name_length;
+};
+
 struct qb_function_dependencies {
 	qb_function_declaration *declaration;
 	uint32_t index;
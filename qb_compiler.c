@@ -3391,7 +3391,11 @@ int32_t qb_execute_op(qb_compiler_context *cxt, void *factory, qb_primitive_type
 	qb_resolve_address_modes(compiler_cxt);
 	qb_initialize_encoder_context(encoder_cxt, compiler_cxt, FALSE TSRMLS_CC);
 	qb_set_instruction_offsets(encoder_cxt);
-	qb_encode_instruction_stream(encoder_cxt, instructions);
+	if(!qb_encode_instruction_stream(encoder_cxt, instructions)) {
+		qb_free_encoder_context(encoder_cxt);
+		free_alloca(target_op.operands, use_heap);
+		return FALSE;
+	}
 	qb_free_encoder_context(encoder_cxt);
 
 	qb_initialize_interpreter_context(interpreter_cxt, qfunc, NULL TSRMLS_CC);
@@ -4144,12 +4148,48 @@ void qb_run_diagnostic_loop(qb_compiler_context *cxt) {
 	qb_free_function(qfunc);
 }
 
+#define DIAGNOSTIC_COPY_ITERATION	20000
+
+float64_t qb_run_diagnostic_copy(qb_compiler_context *cxt) {
+	USE_TSRM
+	qb_function *qfunc;
+	qb_encoder_context _encoder_cxt, *encoder_cxt = &_encoder_cxt;
+	double start_time, end_time, duration;
+	uint32_t i;
+
+	qb_resolve_jump_targets(cxt);
+	qb_fuse_instructions(cxt, 1);
+	qb_assign_storage_space(cxt);
+	qb_resolve_address_modes(cxt);
+	qb_fuse_instructions(cxt, 2);
+	qb_resolve_reference_counts(cxt);
+
+	// encode the function the same way qb_build_functions() does, so copies are relocated through the same path
+	qb_initialize_encoder_context(encoder_cxt, cxt, TRUE TSRMLS_CC);
+	qfunc = qb_encode_function(encoder_cxt);
+	qb_free_encoder_context(encoder_cxt);
+	qb_relocate_function(qfunc, TRUE);
+
+	// time the creation of reentrance copies, which is what a recursive call costs
+	start_time = qb_get_high_res_timestamp();
+	for(i = 0; i < DIAGNOSTIC_COPY_ITERATION; i++) {
+		qb_function *copy = qb_create_function_copy(qfunc, TRUE);
+		qb_relocate_function(copy, TRUE);
+		qb_free_function(copy);
+	}
+	end_time = qb_get_high_res_timestamp();
+	duration = end_time - start_time;
+
+	qb_free_function(qfunc);
+	return (duration > 0) ? DIAGNOSTIC_COPY_ITERATION / duration : NAN;
+}
+
 int qb_run_diagnostics(qb_diagnostics *info TSRMLS_DC) {
 	qb_build_context _cxt, *cxt = &_cxt;
 	uint32_t i;
 
 	qb_initialize_build_context(cxt TSRMLS_CC);
-	cxt->compiler_contexts = emalloc(sizeof(qb_compiler_context *) * QB_DIAGNOSTIC_SPEED_TEST_COUNTS);
+	cxt->compiler_contexts = emalloc(sizeof(qb_compiler_context *) * (QB_DIAGNOSTIC_SPEED_TEST_COUNTS + 1));
 
 	for(i = 0; i < QB_DIAGNOSTIC_SPEED_TEST_COUNTS; i++) {
 		qb_compiler_context *compiler_cxt = cxt->compiler_contexts[cxt->compiler_context_count++] = emalloc(sizeof(qb_compiler_context));
@@ -4172,6 +4212,14 @@ int qb_run_diagnostics(qb_diagnostics *info TSRMLS_DC) {
 		info->instruction_speeds[i] = instruction_per_sec;
 	}
 
+	// measure how quickly a function can be copied and relocated, using the largest of the loops
+	{
+		qb_compiler_context *compiler_cxt = cxt->compiler_contexts[cxt->compiler_context_count++] = emalloc(sizeof(qb_compiler_context));
+		qb_initialize_compiler_context(compiler_cxt, cxt->pool, NULL, 0, 0 TSRMLS_CC);
+		qb_create_diagnostic_loop(compiler_cxt, QB_DIAGNOSTIC_VECTOR_MAC);
+		info->function_copy_speed = qb_run_diagnostic_copy(compiler_cxt);
+	}
+
 	qb_free_build_context(cxt);
 	return SUCCESS;
 }
@@ -167,6 +167,7 @@ enum qb_diagnostic_type {
 
 struct qb_diagnostics {
 	float64_t instruction_speeds[QB_DIAGNOSTIC_SPEED_TEST_COUNTS];
+	float64_t function_copy_speed;
 };
 
 enum {
@@ -37,6 +37,10 @@ static qb_op * qb_get_previous_op(qb_compiler_context *cxt, uint32_t index) {
 	qb_op *prev_qop = NULL;
 	uint32_t j;
 	for(j = index; j > 0; j--) {
+		if(cxt->ops[j]->flags & QB_OP_JUMP_TARGET) {
+			// the ops can't be combined when something jumps in between them
+			return NULL;
+		}
 		prev_qop = cxt->ops[j - 1];
 		if(prev_qop->opcode != QB_NOP) {
 			break;
@@ -50,6 +54,9 @@ static qb_op * qb_get_next_op(qb_compiler_context *cxt, uint32_t index) {
 	uint32_t j;
 	for(j = index; j < cxt->op_count - 1; j++) {
 		next_qop = cxt->ops[j + 1];
+		if(next_qop->flags & QB_OP_JUMP_TARGET) {
+			return NULL;
+		}
 		if(next_qop->opcode != QB_NOP) {
 			break;
 		}
@@ -454,10 +461,1839 @@ void qb_mark_op_reachability(qb_compiler_context *cxt, uint32_t start_index) {
 	}
 }
 
-void qb_fuse_instructions(qb_compiler_context *cxt, int32_t pass) {
+typedef struct qb_loop {
+	uint32_t header_index;
+	uint32_t end_index;
+	int8_t *body;
+	int8_t *window;
+	qb_op **preheader_ops;
+	uint32_t preheader_op_count;
+	uint32_t preheader_op_capacity;
+	qb_op **update_ops;
+	qb_op **updated_ops;
+	uint32_t update_op_count;
+	uint32_t update_op_capacity;
+	int32_t dimensions_changed;
+} qb_loop;
+
+static qb_address * qb_get_root_address(qb_address *address) {
+	while(address->source_address) {
+		address = address->source_address;
+	}
+	return address;
+}
+
+static int32_t qb_find_address_reference(qb_address *address, qb_address *target) {
+	while(address && !CONSTANT(address)) {
+		uint32_t i;
+		if(address == target) {
+			return TRUE;
+		}
+		if(address->array_index_address && qb_find_address_reference(address->array_index_address, target)) {
+			return TRUE;
+		}
+		if(address->dimension_count > 0) {
+			// the dimensions of an array are read as well
+			for(i = 0; i < address->dimension_count; i++) {
+				if(qb_find_address_reference(address->array_size_addresses[i], target) || qb_find_address_reference(address->dimension_addresses[i], target)) {
+					return TRUE;
+				}
+			}
+		}
+		address = address->source_address;
+	}
+	return FALSE;
+}
+
+static int32_t qb_is_address_referenced_by_op(qb_op *qop, qb_address *address) {
 	uint32_t i;
-	if(pass == 1) {
-		// opcodes are not address mode specific at this point
+	for(i = 0; i < qop->operand_count; i++) {
+		if(qop->operands[i].type == QB_OPERAND_ADDRESS) {
+			if(qb_find_address_reference(qop->operands[i].address, address)) {
+				return TRUE;
+			}
+		}
+	}
+	return FALSE;
+}
+
+static int32_t qb_is_address_written_by_op(qb_op *qop, qb_address *root_address) {
+	uint32_t i;
+	for(i = 0; i < qop->operand_count; i++) {
+		if(qop->operands[i].type == QB_OPERAND_ADDRESS) {
+			if(qb_is_operand_write_target(qop->opcode, i)) {
+				if(qb_get_root_address(qop->operands[i].address) == root_address) {
+					return TRUE;
+				}
+			}
+		}
+	}
+	return FALSE;
+}
+
+static int32_t qb_is_loop_barrier(qb_op *qop) {
+	switch(qop->opcode) {
+		case QB_RET:
+			return FALSE;
+		case QB_INTR:
+		case QB_FCALL_U32_U32_U32:
+		case QB_END_STATIC:
+		case QB_FORK_U32:
+		case QB_RESUME:
+		case QB_SPOON:
+		case QB_EXT_U32:
+		case QB_DBG_SYNC_U32:
+			return TRUE;
+		default:
+			return (qop->flags & QB_OP_EXIT) ? TRUE : FALSE;
+	}
+}
+
+static int32_t qb_is_hoistable_opcode(qb_opcode opcode) {
+	// only ops that can't fail or affect anything besides their result are moved
+	switch(opcode) {
+		case QB_ADD_I08_I08_I08:
+		case QB_ADD_I16_I16_I16:
+		case QB_ADD_I32_I32_I32:
+		case QB_ADD_I64_I64_I64:
+		case QB_ADD_F32_F32_F32:
+		case QB_ADD_F64_F64_F64:
+		case QB_SUB_I08_I08_I08:
+		case QB_SUB_I16_I16_I16:
+		case QB_SUB_I32_I32_I32:
+		case QB_SUB_I64_I64_I64:
+		case QB_SUB_F32_F32_F32:
+		case QB_SUB_F64_F64_F64:
+		case QB_MUL_S08_S08_S08:
+		case QB_MUL_U08_U08_U08:
+		case QB_MUL_S16_S16_S16:
+		case QB_MUL_U16_U16_U16:
+		case QB_MUL_S32_S32_S32:
+		case QB_MUL_U32_U32_U32:
+		case QB_MUL_S64_S64_S64:
+		case QB_MUL_U64_U64_U64:
+		case QB_MUL_F32_F32_F32:
+		case QB_MUL_F64_F64_F64:
+		case QB_NEG_I08_I08:
+		case QB_NEG_I16_I16:
+		case QB_NEG_I32_I32:
+		case QB_NEG_I64_I64:
+		case QB_NEG_F32_F32:
+		case QB_NEG_F64_F64:
+		case QB_BW_AND_I08_I08_I08:
+		case QB_BW_AND_I16_I16_I16:
+		case QB_BW_AND_I32_I32_I32:
+		case QB_BW_AND_I64_I64_I64:
+		case QB_BW_OR_I08_I08_I08:
+		case QB_BW_OR_I16_I16_I16:
+		case QB_BW_OR_I32_I32_I32:
+		case QB_BW_OR_I64_I64_I64:
+		case QB_BW_XOR_I08_I08_I08:
+		case QB_BW_XOR_I16_I16_I16:
+		case QB_BW_XOR_I32_I32_I32:
+		case QB_BW_XOR_I64_I64_I64:
+		case QB_SHL_S08_S08_S08:
+		case QB_SHL_U08_U08_U08:
+		case QB_SHL_S16_S16_S16:
+		case QB_SHL_U16_U16_U16:
+		case QB_SHL_S32_S32_S32:
+		case QB_SHL_U32_U32_U32:
+		case QB_SHL_S64_S64_S64:
+		case QB_SHL_U64_U64_U64:
+		case QB_SHR_S08_S08_S08:
+		case QB_SHR_U08_U08_U08:
+		case QB_SHR_S16_S16_S16:
+		case QB_SHR_U16_U16_U16:
+		case QB_SHR_S32_S32_S32:
+		case QB_SHR_U32_U32_U32:
+		case QB_SHR_S64_S64_S64:
+		case QB_SHR_U64_U64_U64:
+		case QB_EQ_I08_I08_I32:
+		case QB_EQ_I16_I16_I32:
+		case QB_EQ_I32_I32_I32:
+		case QB_EQ_I64_I64_I32:
+		case QB_EQ_F32_F32_I32:
+		case QB_EQ_F64_F64_I32:
+		case QB_NE_I08_I08_I32:
+		case QB_NE_I16_I16_I32:
+		case QB_NE_I32_I32_I32:
+		case QB_NE_I64_I64_I32:
+		case QB_NE_F32_F32_I32:
+		case QB_NE_F64_F64_I32:
+		case QB_LT_S08_S08_I32:
+		case QB_LT_S16_S16_I32:
+		case QB_LT_S32_S32_I32:
+		case QB_LT_S64_S64_I32:
+		case QB_LT_U08_U08_I32:
+		case QB_LT_U16_U16_I32:
+		case QB_LT_U32_U32_I32:
+		case QB_LT_U64_U64_I32:
+		case QB_LT_F32_F32_I32:
+		case QB_LT_F64_F64_I32:
+		case QB_LE_S08_S08_I32:
+		case QB_LE_S16_S16_I32:
+		case QB_LE_S32_S32_I32:
+		case QB_LE_S64_S64_I32:
+		case QB_LE_U08_U08_I32:
+		case QB_LE_U16_U16_I32:
+		case QB_LE_U32_U32_I32:
+		case QB_LE_U64_U64_I32:
+		case QB_LE_F32_F32_I32:
+		case QB_LE_F64_F64_I32:
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+static qb_op * qb_create_loop_op(qb_compiler_context *cxt, qb_opcode opcode, qb_address *address1, qb_address *address2, qb_address *address3, uint32_t line_id) {
+	qb_op *qop = qb_allocate_op(cxt->pool);
+	qop->opcode = opcode;
+	qop->flags = qb_get_op_flags(opcode);
+	qop->line_id = line_id;
+	qop->operand_count = 3;
+	qop->operands = qb_allocate_operands(cxt->pool, 3);
+	qop->operands[0].type = QB_OPERAND_ADDRESS;
+	qop->operands[0].address = address1;
+	qop->operands[1].type = QB_OPERAND_ADDRESS;
+	qop->operands[1].address = address2;
+	qop->operands[2].type = QB_OPERAND_ADDRESS;
+	qop->operands[2].address = address3;
+	return qop;
+}
+
+static void qb_add_preheader_op(qb_compiler_context *cxt, qb_loop *loop, qb_op *qop) {
+	if(loop->preheader_op_count == loop->preheader_op_capacity) {
+		loop->preheader_op_capacity += 16;
+		loop->preheader_ops = erealloc(loop->preheader_ops, sizeof(qb_op *) * loop->preheader_op_capacity);
+	}
+	loop->preheader_ops[loop->preheader_op_count++] = qop;
+}
+
+static void qb_move_op_to_preheader(qb_compiler_context *cxt, qb_loop *loop, qb_op *qop) {
+	qb_op *new_qop = qb_allocate_op(cxt->pool);
+	*new_qop = *qop;
+	new_qop->flags &= ~QB_OP_JUMP_TARGET;
+	qb_add_preheader_op(cxt, loop, new_qop);
+
+	// leave a nop behind, in case it's a jump target
+	qop->opcode = QB_NOP;
+	qop->operand_count = 0;
+	qop->operands = NULL;
+}
+
+static int32_t qb_find_loop(qb_compiler_context *cxt, qb_loop *loop) {
+	uint32_t h = loop->header_index;
+	uint32_t i, j;
+	int32_t changed;
+
+	// the loop consists of the header and the ops that can reach a backward jump to it 
+	// without passing through it
+	loop->body[h] = TRUE;
+	loop->end_index = h;
+	for(i = h; i < cxt->op_count; i++) {
+		qb_op *qop = cxt->ops[i];
+		for(j = 0; j < qop->jump_target_count; j++) {
+			if(qop->jump_target_indices[j] == h) {
+				loop->body[i] = TRUE;
+				loop->end_index = i;
+			}
+		}
+	}
+	do {
+		changed = FALSE;
+		for(i = cxt->op_count; i > 0; i--) {
+			uint32_t index = i - 1;
+			qb_op *qop = cxt->ops[index];
+			if(!loop->body[index] && qop->opcode != QB_RET && !(qop->flags & QB_OP_EXIT)) {
+				if(qop->jump_target_count > 0) {
+					for(j = 0; j < qop->jump_target_count; j++) {
+						uint32_t target_index = qop->jump_target_indices[j];
+						if(target_index != h && loop->body[target_index]) {
+							loop->body[index] = TRUE;
+							break;
+						}
+					}
+				} else if(i < cxt->op_count && i != h && loop->body[i]) {
+					loop->body[index] = TRUE;
+				}
+				if(loop->body[index]) {
+					if(index < h) {
+						// there's a way into the loop that doesn't go through the header
+						return FALSE;
+					}
+					if(index > loop->end_index) {
+						loop->end_index = index;
+					}
+					changed = TRUE;
+				}
+			}
+		}
+	} while(changed);
+
+	if(h > 0 && loop->body[h - 1]) {
+		// the preheader can't be placed in front of the header if the loop falls into it
+		qb_op *qop = cxt->ops[h - 1];
+		if(qop->jump_target_count == 0 && qop->opcode != QB_RET && !(qop->flags & QB_OP_EXIT)) {
+			return FALSE;
+		}
+	}
+
+	for(i = h; i <= loop->end_index; i++) {
+		if(loop->body[i]) {
+			qb_op *qop = cxt->ops[i];
+			if(qb_is_loop_barrier(qop)) {
+				return FALSE;
+			}
+			for(j = 0; j < qop->operand_count; j++) {
+				qb_operand *operand = &qop->operands[j];
+				if(operand->type == QB_OPERAND_ADDRESS) {
+					if(qb_is_operand_write_target(qop->opcode, j)) {
+						qb_address *root_address = qb_get_root_address(operand->address);
+						if(RESIZABLE(root_address) || VARIABLE_LENGTH(root_address)) {
+							loop->dimensions_changed = TRUE;
+						}
+					}
+				} else {
+					// ops that work on segments directly can change the size of arrays 
+					loop->dimensions_changed = TRUE;
+				}
+			}
+		}
+	}
+	return TRUE;
+}
+
+static int32_t qb_is_loop_invariant(qb_compiler_context *cxt, qb_loop *loop, qb_address *address) {
+	qb_address *root_address;
+	uint32_t i;
+	if(CONSTANT(address)) {
+		return TRUE;
+	}
+	if(address->mode != QB_ADDRESS_MODE_SCA || !SCALAR(address)) {
+		return FALSE;
+	}
+	root_address = qb_get_root_address(address);
+	if(loop->dimensions_changed && ((address->flags | root_address->flags) & QB_ADDRESS_DIMENSION)) {
+		return FALSE;
+	}
+	for(i = loop->header_index; i <= loop->end_index; i++) {
+		if(loop->body[i]) {
+			if(qb_is_address_written_by_op(cxt->ops[i], root_address)) {
+				return FALSE;
+			}
+		}
+	}
+	return TRUE;
+}
+
+static int32_t qb_is_loop_temporary(qb_address *address) {
+	// a temporary variable holding an intermediate value of an expression
+	// (not one that gets reused, like the condition of short-circuited expressions)
+	return TEMPORARY(address) && !CONSTANT(address) && !(address->flags & QB_ADDRESS_REUSED) && address->mode == QB_ADDRESS_MODE_SCA && SCALAR(address) && !address->source_address;
+}
+
+static int32_t qb_is_identical_op(qb_op *qop1, qb_op *qop2) {
+	uint32_t i;
+	if(qop1->opcode != qop2->opcode || qop1->operand_count != qop2->operand_count) {
+		return FALSE;
+	}
+	for(i = 0; i < qop1->operand_count; i++) {
+		if(qop1->operands[i].type != qop2->operands[i].type || qop1->operands[i].address != qop2->operands[i].address) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static int32_t qb_hoist_invariant_op(qb_compiler_context *cxt, qb_loop *loop, uint32_t index) {
+	qb_op *qop = cxt->ops[index];
+	qb_address *result_address;
+	uint32_t i;
+
+	if(!qb_is_hoistable_opcode(qop->opcode)) {
+		return FALSE;
+	}
+	result_address = qop->operands[qop->operand_count - 1].address;
+	if(!qb_is_loop_temporary(result_address)) {
+		return FALSE;
+	}
+	for(i = 0; i < qop->operand_count - 1; i++) {
+		qb_address *address = qop->operands[i].address;
+		if(address == result_address || !qb_is_loop_invariant(cxt, loop, address)) {
+			return FALSE;
+		}
+	}
+
+	// any other assignment to the temporary variable in the loop has to be the same calculation
+	for(i = loop->header_index; i <= loop->end_index; i++) {
+		if(loop->body[i] && i != index) {
+			qb_op *other_qop = cxt->ops[i];
+			if(qb_is_address_written_by_op(other_qop, result_address) && !qb_is_identical_op(qop, other_qop)) {
+				return FALSE;
+			}
+		}
+	}
+
+	// perform the calculation once, before the loop starts
+	qb_move_op_to_preheader(cxt, loop, qop);
+	for(i = loop->header_index; i <= loop->end_index; i++) {
+		if(loop->body[i] && i != index) {
+			qb_op *other_qop = cxt->ops[i];
+			if(other_qop->opcode != QB_NOP && qb_is_identical_op(loop->preheader_ops[loop->preheader_op_count - 1], other_qop)) {
+				other_qop->opcode = QB_NOP;
+				other_qop->operand_count = 0;
+				other_qop->operands = NULL;
+			}
+		}
+	}
+	return TRUE;
+}
+
+static int32_t qb_get_induction_step(qb_compiler_context *cxt, qb_op *qop, qb_address *address, int64_t *p_step) {
+	switch(qop->opcode) {
+		case QB_INC_I32:
+		case QB_INC_I64: {
+			if(qop->operands[0].address == address) {
+				*p_step = 1;
+				return TRUE;
+			}
+		}	break;
+		case QB_DEC_I32:
+		case QB_DEC_I64: {
+			if(qop->operands[0].address == address) {
+				*p_step = -1;
+				return TRUE;
+			}
+		}	break;
+		case QB_ADD_I32_I32_I32:
+		case QB_ADD_I64_I64_I64: {
+			if(qop->operands[2].address == address) {
+				if(qop->operands[0].address == address && CONSTANT(qop->operands[1].address)) {
+					*p_step = qb_get_constant_value(cxt, qop->operands[1].address);
+					return TRUE;
+				} else if(qop->operands[1].address == address && CONSTANT(qop->operands[0].address)) {
+					*p_step = qb_get_constant_value(cxt, qop->operands[0].address);
+					return TRUE;
+				}
+			}
+		}	break;
+		case QB_SUB_I32_I32_I32:
+		case QB_SUB_I64_I64_I64: {
+			if(qop->operands[2].address == address && qop->operands[0].address == address && CONSTANT(qop->operands[1].address)) {
+				*p_step = -qb_get_constant_value(cxt, qop->operands[1].address);
+				return TRUE;
+			}
+		}	break;
+		default: break;
+	}
+	return FALSE;
+}
+
+static int32_t qb_is_induction_variable(qb_compiler_context *cxt, qb_loop *loop, qb_address *address) {
+	uint32_t i, write_count = 0;
+	int64_t step;
+	if(CONSTANT(address) || address->mode != QB_ADDRESS_MODE_SCA || !SCALAR(address) || address->source_address) {
+		return FALSE;
+	}
+	// the variable can only be changed by a constant amount
+	for(i = loop->header_index; i <= loop->end_index; i++) {
+		if(loop->body[i]) {
+			qb_op *qop = cxt->ops[i];
+			if(qb_is_address_written_by_op(qop, address)) {
+				if(!qb_get_induction_step(cxt, qop, address, &step)) {
+					return FALSE;
+				}
+				write_count++;
+			}
+		}
+	}
+	return (write_count > 0);
+}
+
+static int32_t qb_reduce_strength(qb_compiler_context *cxt, qb_loop *loop, uint32_t index) {
+	qb_op *qop = cxt->ops[index];
+	qb_address *result_address, *induction_address, *factor_address;
+	qb_opcode add_opcode;
+	int32_t used_elsewhere = FALSE;
+	uint32_t i;
+
+	if(qop->opcode == QB_MUL_S32_S32_S32 || qop->opcode == QB_MUL_U32_U32_U32) {
+		add_opcode = QB_ADD_I32_I32_I32;
+	} else if(qop->opcode == QB_MUL_S64_S64_S64 || qop->opcode == QB_MUL_U64_U64_U64) {
+		add_opcode = QB_ADD_I64_I64_I64;
+	} else {
+		return FALSE;
+	}
+	result_address = qop->operands[2].address;
+	if(!qb_is_loop_temporary(result_address)) {
+		return FALSE;
+	}
+	if(qb_is_induction_variable(cxt, loop, qop->operands[0].address) && qb_is_loop_invariant(cxt, loop, qop->operands[1].address)) {
+		induction_address = qop->operands[0].address;
+		factor_address = qop->operands[1].address;
+	} else if(qb_is_induction_variable(cxt, loop, qop->operands[1].address) && qb_is_loop_invariant(cxt, loop, qop->operands[0].address)) {
+		induction_address = qop->operands[1].address;
+		factor_address = qop->operands[0].address;
+	} else {
+		return FALSE;
+	}
+	if(result_address == induction_address || result_address == factor_address) {
+		return FALSE;
+	}
+
+	// the product has to be used in the straight-line code that follows, 
+	// before the induction variable changes
+	for(i = index + 1; i <= loop->end_index && loop->body[i]; i++) {
+		qb_op *next_qop = cxt->ops[i];
+		if(next_qop->flags & QB_OP_JUMP_TARGET) {
+			break;
+		}
+		loop->window[i] = TRUE;
+		if(next_qop->jump_target_count > 0 || next_qop->opcode == QB_RET || (next_qop->flags & QB_OP_EXIT) || qb_is_address_written_by_op(next_qop, induction_address)) {
+			break;
+		}
+	}
+	for(i = loop->header_index; i <= loop->end_index; i++) {
+		if(loop->body[i] && i != index) {
+			qb_op *other_qop = cxt->ops[i];
+			if(qb_is_address_written_by_op(other_qop, result_address) || (!loop->window[i] && qb_is_address_referenced_by_op(other_qop, result_address))) {
+				used_elsewhere = TRUE;
+			}
+		}
+		loop->window[i] = FALSE;
+	}
+	if(used_elsewhere) {
+		return FALSE;
+	}
+
+	// calculate the initial value before the loop and add to it whenever the induction variable changes
+	for(i = loop->header_index; i <= loop->end_index; i++) {
+		if(loop->body[i]) {
+			qb_op *induction_qop = cxt->ops[i];
+			int64_t step;
+			if(qb_is_address_written_by_op(induction_qop, induction_address) && qb_get_induction_step(cxt, induction_qop, induction_address, &step)) {
+				qb_address *increment_address;
+				if(CONSTANT(factor_address)) {
+					increment_address = qb_obtain_constant(cxt, step * qb_get_constant_value(cxt, factor_address), result_address->type);
+				} else if(step == 1) {
+					increment_address = factor_address;
+				} else {
+					qb_address *step_address = qb_obtain_constant(cxt, step, result_address->type);
+					increment_address = qb_create_temporary_variable(cxt, result_address->type, NULL);
+					qb_mark_as_writable(cxt, increment_address);
+					qb_add_preheader_op(cxt, loop, qb_create_loop_op(cxt, qop->opcode, factor_address, step_address, increment_address, qop->line_id));
+				}
+				if(loop->update_op_count == loop->update_op_capacity) {
+					loop->update_op_capacity += 16;
+					loop->update_ops = erealloc(loop->update_ops, sizeof(qb_op *) * loop->update_op_capacity);
+					loop->updated_ops = erealloc(loop->updated_ops, sizeof(qb_op *) * loop->update_op_capacity);
+				}
+				loop->update_ops[loop->update_op_count] = qb_create_loop_op(cxt, add_opcode, result_address, increment_address, result_address, induction_qop->line_id);
+				loop->updated_ops[loop->update_op_count] = induction_qop;
+				loop->update_op_count++;
+			}
+		}
+	}
+	qb_move_op_to_preheader(cxt, loop, qop);
+	return TRUE;
+}
+
+static void qb_insert_ops(qb_compiler_context *cxt, uint32_t index, qb_op **new_ops, uint32_t count, int8_t *loop_body) {
+	uint32_t i, j;
+
+	// jumps to the op at the index will land on the new ops, except for jumps from inside the loop 
+	for(i = 0; i < cxt->op_count; i++) {
+		qb_op *qop = cxt->ops[i];
+		for(j = 0; j < qop->jump_target_count; j++) {
+			uint32_t target_index = qop->jump_target_indices[j];
+			if(target_index > index) {
+				qop->jump_target_indices[j] = target_index + count;
+			} else if(target_index == index) {
+				if(loop_body && !loop_body[i]) {
+					new_ops[0]->flags |= QB_OP_JUMP_TARGET;
+				} else {
+					qop->jump_target_indices[j] = target_index + count;
+				}
+			}
+		}
+	}
+	qb_enlarge_array((void **) &cxt->ops, count);
+	memmove(&cxt->ops[index + count], &cxt->ops[index], sizeof(qb_op *) * (cxt->op_count - count - index));
+	memcpy(&cxt->ops[index], new_ops, sizeof(qb_op *) * count);
+}
+
+static void qb_optimize_loop(qb_compiler_context *cxt, uint32_t header_index) {
+	qb_loop _loop, *loop = &_loop;
+	uint32_t i, j;
+	int32_t changed;
+
+	memset(loop, 0, sizeof(qb_loop));
+	loop->header_index = header_index;
+	loop->body = ecalloc(cxt->op_count, sizeof(int8_t));
+	loop->window = ecalloc(cxt->op_count, sizeof(int8_t));
+
+	if(qb_find_loop(cxt, loop)) {
+		// move calculations that yield the same result on every iteration out of the loop
+		do {
+			changed = FALSE;
+			for(i = loop->header_index; i <= loop->end_index; i++) {
+				if(loop->body[i] && qb_hoist_invariant_op(cxt, loop, i)) {
+					changed = TRUE;
+				}
+			}
+		} while(changed);
+
+		// replace multiplications involving the loop counter with additions
+		for(i = loop->header_index; i <= loop->end_index; i++) {
+			if(loop->body[i]) {
+				qb_reduce_strength(cxt, loop, i);
+			}
+		}
+
+		if(loop->preheader_op_count > 0) {
+			qb_insert_ops(cxt, loop->header_index, loop->preheader_ops, loop->preheader_op_count, loop->body);
+		}
+		for(i = 0; i < loop->update_op_count; i++) {
+			// the addition goes right after the op changing the loop counter
+			for(j = 0; j < cxt->op_count; j++) {
+				if(cxt->ops[j] == loop->updated_ops[i]) {
+					qb_insert_ops(cxt, j + 1, &loop->update_ops[i], 1, NULL);
+					break;
+				}
+			}
+		}
+	}
+
+	efree(loop->body);
+	efree(loop->window);
+	if(loop->preheader_ops) {
+		efree(loop->preheader_ops);
+	}
+	if(loop->update_ops) {
+		efree(loop->update_ops);
+		efree(loop->updated_ops);
+	}
+}
+
+static void qb_optimize_loops(qb_compiler_context *cxt) {
+	qb_op **header_qops;
+	uint32_t *spans;
+	uint32_t header_count = 0;
+	uint32_t i, j, k;
+
+	// look for backward jumps
+	header_qops = emalloc(sizeof(qb_op *) * cxt->op_count);
+	spans = emalloc(sizeof(uint32_t) * cxt->op_count);
+	for(i = 0; i < cxt->op_count; i++) {
+		qb_op *qop = cxt->ops[i];
+		for(j = 0; j < qop->jump_target_count; j++) {
+			uint32_t target_index = qop->jump_target_indices[j];
+			if(target_index <= i) {
+				qb_op *header_qop = cxt->ops[target_index];
+				uint32_t span = i - target_index;
+				for(k = 0; k < header_count; k++) {
+					if(header_qops[k] == header_qop) {
+						break;
+					}
+				}
+				if(k == header_count) {
+					header_qops[k] = header_qop;
+					spans[k] = span;
+					header_count++;
+				} else if(spans[k] < span) {
+					spans[k] = span;
+				}
+			}
+		}
+	}
+
+	// handle inner loops first, so that what's moved out of them can be moved further out
+	for(i = 1; i < header_count; i++) {
+		qb_op *header_qop = header_qops[i];
+		uint32_t span = spans[i];
+		for(j = i; j > 0 && spans[j - 1] > span; j--) {
+			header_qops[j] = header_qops[j - 1];
+			spans[j] = spans[j - 1];
+		}
+		header_qops[j] = header_qop;
+		spans[j] = span;
+	}
+	for(i = 0; i < header_count; i++) {
+		// ops might have been inserted in front of the header
+		for(j = 0; j < cxt->op_count; j++) {
+			if(cxt->ops[j] == header_qops[i]) {
+				qb_optimize_loop(cxt, j);
+				break;
+			}
+		}
+	}
+
+	efree(header_qops);
+	efree(spans);
+}
+
+typedef struct qb_value_range {
+	int64_t lower;
+	int64_t upper;
+} qb_value_range;
+
+typedef struct qb_index_fact {
+	qb_address *index_address;
+	qb_address *limit_address;
+} qb_index_fact;
+
+typedef struct qb_range_analysis {
+	qb_address **variables;
+	uint32_t variable_count;
+	qb_index_fact *facts;
+	uint32_t fact_count;
+	uint32_t fact_word_count;
+	uint32_t block_count;
+	uint32_t *block_indices;
+	qb_value_range *block_ranges;
+	uint32_t *block_facts;
+	int8_t *block_visited;
+	int8_t *block_pending;
+	uint32_t *block_change_counts;
+	qb_value_range *ranges;
+	uint32_t *fact_set;
+	qb_value_range *edge_ranges;
+	uint32_t *edge_fact_set;
+} qb_range_analysis;
+
+#define QB_RANGE_WIDENING_THRESHOLD		3
+#define QB_RANGE_ANALYSIS_MAX_SIZE		(1 << 20)
+
+static int32_t qb_get_type_bounds(qb_primitive_type type, qb_value_range *range) {
+	switch(type) {
+		case QB_TYPE_S08: range->lower = INT8_MIN; range->upper = INT8_MAX; return TRUE;
+		case QB_TYPE_U08: range->lower = 0; range->upper = UINT8_MAX; return TRUE;
+		case QB_TYPE_S16: range->lower = INT16_MIN; range->upper = INT16_MAX; return TRUE;
+		case QB_TYPE_U16: range->lower = 0; range->upper = UINT16_MAX; return TRUE;
+		case QB_TYPE_S32: range->lower = INT32_MIN; range->upper = INT32_MAX; return TRUE;
+		case QB_TYPE_U32: range->lower = 0; range->upper = UINT32_MAX; return TRUE;
+		default: return FALSE;
+	}
+}
+
+static int32_t qb_is_range_within(qb_value_range *range, qb_value_range *bounds) {
+	return (range->lower >= bounds->lower && range->upper <= bounds->upper);
+}
+
+static int32_t qb_is_range_tracked_address(qb_address *address) {
+	qb_value_range bounds;
+	return (SCALAR(address) && address->mode == QB_ADDRESS_MODE_SCA && qb_get_type_bounds(address->type, &bounds));
+}
+
+static int32_t qb_compare_variable_addresses(const void *p1, const void *p2) {
+	uintptr_t a1 = (uintptr_t) *((qb_address **) p1);
+	uintptr_t a2 = (uintptr_t) *((qb_address **) p2);
+	return (a1 < a2) ? -1 : (a1 > a2) ? 1 : 0;
+}
+
+static int32_t qb_find_range_variable(qb_range_analysis *ra, qb_address *address) {
+	qb_address *root_address = qb_get_root_address(address);
+	qb_address **p_variable = bsearch(&root_address, ra->variables, ra->variable_count, sizeof(qb_address *), qb_compare_variable_addresses);
+	return (p_variable) ? (int32_t) (p_variable - ra->variables) : -1;
+}
+
+static int64_t qb_get_constant_range_value(qb_compiler_context *cxt, qb_address *address) {
+	switch(address->type) {
+		case QB_TYPE_S08: return VALUE(S08, address);
+		case QB_TYPE_U08: return VALUE(U08, address);
+		case QB_TYPE_S16: return VALUE(S16, address);
+		case QB_TYPE_U16: return VALUE(U16, address);
+		case QB_TYPE_S32: return VALUE(S32, address);
+		case QB_TYPE_U32: return VALUE(U32, address);
+		default: return 0;
+	}
+}
+
+static int32_t qb_get_value_range(qb_compiler_context *cxt, qb_range_analysis *ra, qb_value_range *ranges, qb_address *address, qb_value_range *range) {
+	qb_value_range bounds;
+	int32_t index;
+	if(!qb_get_type_bounds(address->type, &bounds)) {
+		return FALSE;
+	}
+	*range = bounds;
+	if(qb_is_range_tracked_address(address)) {
+		if(CONSTANT(address)) {
+			range->lower = range->upper = qb_get_constant_range_value(cxt, address);
+		} else if((index = qb_find_range_variable(ra, address)) != -1) {
+			// the value is the same when viewed as a different type only if it fits in both
+			if(qb_is_range_within(&ranges[index], &bounds)) {
+				*range = ranges[index];
+			}
+		}
+	}
+	return TRUE;
+}
+
+static void qb_set_value_range(qb_range_analysis *ra, qb_value_range *ranges, qb_address *address, qb_value_range *range) {
+	int32_t index;
+	if(qb_is_range_tracked_address(address) && !CONSTANT(address) && (index = qb_find_range_variable(ra, address)) != -1) {
+		qb_value_range bounds, root_bounds;
+		qb_get_type_bounds(address->type, &bounds);
+		qb_get_type_bounds(ra->variables[index]->type, &root_bounds);
+		if(qb_is_range_within(range, &bounds) && qb_is_range_within(range, &root_bounds)) {
+			ranges[index] = *range;
+		} else {
+			// the result might have wrapped around
+			ranges[index] = root_bounds;
+		}
+	}
+}
+
+static int32_t qb_narrow_value_range(qb_compiler_context *cxt, qb_range_analysis *ra, qb_value_range *ranges, qb_address *address, int64_t lower, int64_t upper) {
+	qb_value_range range, bounds;
+	int32_t index;
+	if(!qb_get_value_range(cxt, ra, ranges, address, &range)) {
+		return TRUE;
+	}
+	if(lower > range.lower) {
+		range.lower = lower;
+	}
+	if(upper < range.upper) {
+		range.upper = upper;
+	}
+	if(range.lower > range.upper) {
+		// the condition can't be met
+		return FALSE;
+	}
+	if(qb_is_range_tracked_address(address) && !CONSTANT(address) && (index = qb_find_range_variable(ra, address)) != -1) {
+		// narrow the range only when the variable holds the same value in the type used by the comparison
+		qb_get_type_bounds(address->type, &bounds);
+		if(qb_is_range_within(&ranges[index], &bounds)) {
+			ranges[index] = range;
+		}
+	}
+	return TRUE;
+}
+
+static qb_address * qb_get_index_fact_address(qb_address *address) {
+	// facts are kept on scalar variables (and cast aliases of them) only, since the root of an
+	// array element is the whole array and a fact about one element would apply to the others
+	qb_address *root_address = qb_get_root_address(address);
+	if(CONSTANT(address) || !qb_is_range_tracked_address(address) || !qb_is_range_tracked_address(root_address)) {
+		return NULL;
+	}
+	return root_address;
+}
+
+static int32_t qb_find_index_fact(qb_range_analysis *ra, qb_address *index_address, qb_address *limit_address) {
+	qb_address *index_root_address = qb_get_index_fact_address(index_address);
+	qb_address *limit_root_address = qb_get_index_fact_address(limit_address);
+	uint32_t i;
+	if(!index_root_address || !limit_root_address) {
+		return -1;
+	}
+	for(i = 0; i < ra->fact_count; i++) {
+		if(ra->facts[i].index_address == index_root_address && ra->facts[i].limit_address == limit_root_address) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static void qb_add_index_fact(qb_range_analysis *ra, qb_address *index_address, qb_address *limit_address) {
+	qb_address *index_root_address = qb_get_index_fact_address(index_address);
+	qb_address *limit_root_address = qb_get_index_fact_address(limit_address);
+	if(index_root_address && limit_root_address) {
+		if(qb_find_index_fact(ra, index_address, limit_address) == -1) {
+			ra->facts = erealloc(ra->facts, sizeof(qb_index_fact) * (ra->fact_count + 1));
+			ra->facts[ra->fact_count].index_address = index_root_address;
+			ra->facts[ra->fact_count].limit_address = limit_root_address;
+			ra->fact_count++;
+		}
+	}
+}
+
+static void qb_set_index_fact(qb_range_analysis *ra, uint32_t *fact_set, qb_address *index_address, qb_address *limit_address) {
+	int32_t index = qb_find_index_fact(ra, index_address, limit_address);
+	if(index != -1) {
+		fact_set[index >> 5] |= (1 << (index & 0x1F));
+	}
+}
+
+static int32_t qb_check_index_fact(qb_range_analysis *ra, uint32_t *fact_set, qb_address *index_address, qb_address *limit_address) {
+	int32_t index = qb_find_index_fact(ra, index_address, limit_address);
+	if(index != -1) {
+		return (fact_set[index >> 5] & (1 << (index & 0x1F))) ? TRUE : FALSE;
+	}
+	return FALSE;
+}
+
+static void qb_invalidate_value_range(qb_range_analysis *ra, qb_value_range *ranges, uint32_t *fact_set, qb_address *address) {
+	qb_address *root_address = qb_get_root_address(address);
+	int32_t index = qb_find_range_variable(ra, root_address);
+	uint32_t i;
+	if(index != -1) {
+		qb_get_type_bounds(root_address->type, &ranges[index]);
+	}
+	for(i = 0; i < ra->fact_count; i++) {
+		if(ra->facts[i].index_address == root_address || ra->facts[i].limit_address == root_address) {
+			fact_set[i >> 5] &= ~(1 << (i & 0x1F));
+		}
+	}
+}
+
+static void qb_invalidate_all_value_ranges(qb_range_analysis *ra, qb_value_range *ranges, uint32_t *fact_set) {
+	uint32_t i;
+	for(i = 0; i < ra->variable_count; i++) {
+		qb_get_type_bounds(ra->variables[i]->type, &ranges[i]);
+	}
+	memset(fact_set, 0, sizeof(uint32_t) * ra->fact_word_count);
+}
+
+static int32_t qb_add_value_ranges(qb_value_range *range1, qb_value_range *range2, qb_value_range *result) {
+	result->lower = range1->lower + range2->lower;
+	result->upper = range1->upper + range2->upper;
+	return TRUE;
+}
+
+static int32_t qb_subtract_value_ranges(qb_value_range *range1, qb_value_range *range2, qb_value_range *result) {
+	result->lower = range1->lower - range2->upper;
+	result->upper = range1->upper - range2->lower;
+	return TRUE;
+}
+
+static int32_t qb_multiply_value_ranges(qb_value_range *range1, qb_value_range *range2, qb_value_range *result) {
+	int64_t products[4];
+	uint32_t i;
+	// all values are 32-bit or less; the products can overflow only when both are large
+	if(range1->lower < -0x7FFFFFFFLL || range1->upper > 0x7FFFFFFFLL || range2->lower < -0x7FFFFFFFLL || range2->upper > 0x7FFFFFFFLL) {
+		return FALSE;
+	}
+	products[0] = range1->lower * range2->lower;
+	products[1] = range1->lower * range2->upper;
+	products[2] = range1->upper * range2->lower;
+	products[3] = range1->upper * range2->upper;
+	result->lower = result->upper = products[0];
+	for(i = 1; i < 4; i++) {
+		if(products[i] < result->lower) {
+			result->lower = products[i];
+		}
+		if(products[i] > result->upper) {
+			result->upper = products[i];
+		}
+	}
+	return TRUE;
+}
+
+static int32_t qb_calculate_modulo_range(qb_value_range *range1, qb_value_range *range2, qb_value_range *result) {
+	int64_t max_remainder;
+	if(range2->lower <= 0) {
+		return FALSE;
+	}
+	// the remainder has the sign of the dividend and is smaller than the divisor
+	max_remainder = range2->upper - 1;
+	result->lower = (range1->lower >= 0) ? 0 : max(range1->lower, -max_remainder);
+	result->upper = (range1->upper <= 0) ? 0 : min(range1->upper, max_remainder);
+	return TRUE;
+}
+
+static int32_t qb_get_guarded_index_range(qb_compiler_context *cxt, qb_range_analysis *ra, qb_value_range *ranges, qb_op *qop, qb_value_range *range) {
+	qb_value_range limit_range;
+	qb_get_value_range(cxt, ra, ranges, qop->operands[0].address, range);
+	qb_get_value_range(cxt, ra, ranges, qop->operands[1].address, &limit_range);
+	if(range->upper > limit_range.upper - 1) {
+		range->upper = limit_range.upper - 1;
+	}
+	return (range->lower <= range->upper);
+}
+
+static void qb_update_value_ranges(qb_compiler_context *cxt, qb_range_analysis *ra, qb_op *qop, qb_value_range *ranges, uint32_t *fact_set) {
+	qb_address *result_address = NULL;
+	qb_value_range range1, range2, range3, result;
+	uint32_t i;
+
+	if(qb_is_loop_barrier(qop)) {
+		// anything could have changed
+		qb_invalidate_all_value_ranges(ra, ranges, fact_set);
+		return;
+	}
+	for(i = 0; i < qop->operand_count; i++) {
+		if(qop->operands[i].type != QB_OPERAND_ADDRESS) {
+			// the op works on a segment directly and could be changing the dimensions of arrays
+			qb_invalidate_all_value_ranges(ra, ranges, fact_set);
+			return;
+		}
+	}
+
+	// figure out what the result would be before forgetting what was known about the variables written to
+	switch(qop->opcode) {
+		case QB_MOV_I08_I08:
+		case QB_MOV_I16_I16:
+		case QB_MOV_I32_I32: {
+			if(qb_get_value_range(cxt, ra, ranges, qop->operands[0].address, &result)) {
+				result_address = qop->operands[1].address;
+			}
+		}	break;
+		case QB_INC_I08:
+		case QB_INC_I16:
+		case QB_INC_I32:
+		case QB_DEC_I08:
+		case QB_DEC_I16:
+		case QB_DEC_I32: {
+			if(qb_get_value_range(cxt, ra, ranges, qop->operands[0].address, &range1)) {
+				range2.lower = range2.upper = (qop->opcode == QB_INC_I08 || qop->opcode == QB_INC_I16 || qop->opcode == QB_INC_I32) ? 1 : -1;
+				qb_add_value_ranges(&range1, &range2, &result);
+				result_address = qop->operands[0].address;
+			}
+		}	break;
+		case QB_ADD_I08_I08_I08:
+		case QB_ADD_I16_I16_I16:
+		case QB_ADD_I32_I32_I32:
+		case QB_SUB_I08_I08_I08:
+		case QB_SUB_I16_I16_I16:
+		case QB_SUB_I32_I32_I32:
+		case QB_MUL_S08_S08_S08:
+		case QB_MUL_U08_U08_U08:
+		case QB_MUL_S16_S16_S16:
+		case QB_MUL_U16_U16_U16:
+		case QB_MUL_S32_S32_S32:
+		case QB_MUL_U32_U32_U32:
+		case QB_MOD_S08_S08_S08:
+		case QB_MOD_U08_U08_U08:
+		case QB_MOD_S16_S16_S16:
+		case QB_MOD_U16_U16_U16:
+		case QB_MOD_S32_S32_S32:
+		case QB_MOD_U32_U32_U32:
+		case QB_BW_AND_I08_I08_I08:
+		case QB_BW_AND_I16_I16_I16:
+		case QB_BW_AND_I32_I32_I32: {
+			if(qb_get_value_range(cxt, ra, ranges, qop->operands[0].address, &range1) && qb_get_value_range(cxt, ra, ranges, qop->operands[1].address, &range2)) {
+				int32_t known;
+				switch(qop->opcode) {
+					case QB_ADD_I08_I08_I08:
+					case QB_ADD_I16_I16_I16:
+					case QB_ADD_I32_I32_I32: known = qb_add_value_ranges(&range1, &range2, &result); break;
+					case QB_SUB_I08_I08_I08:
+					case QB_SUB_I16_I16_I16:
+					case QB_SUB_I32_I32_I32: known = qb_subtract_value_ranges(&range1, &range2, &result); break;
+					case QB_MOD_S08_S08_S08:
+					case QB_MOD_U08_U08_U08:
+					case QB_MOD_S16_S16_S16:
+					case QB_MOD_U16_U16_U16:
+					case QB_MOD_S32_S32_S32:
+					case QB_MOD_U32_U32_U32: known = qb_calculate_modulo_range(&range1, &range2, &result); break;
+					case QB_BW_AND_I08_I08_I08:
+					case QB_BW_AND_I16_I16_I16:
+					case QB_BW_AND_I32_I32_I32: {
+						// the result can't be larger than a non-negative operand
+						known = (range1.lower >= 0 || range2.lower >= 0);
+						result.lower = 0;
+						result.upper = (range1.lower >= 0 && (range2.lower < 0 || range1.upper < range2.upper)) ? range1.upper : range2.upper;
+					}	break;
+					default: known = qb_multiply_value_ranges(&range1, &range2, &result); break;
+				}
+				if(known) {
+					result_address = qop->operands[2].address;
+				}
+			}
+		}	break;
+		case QB_IDX_GUARD_ADD_U32_U32_U32_U32:
+		case QB_IDX_GUARD_MUL_U32_U32_U32_U32: {
+			if(qb_get_guarded_index_range(cxt, ra, ranges, qop, &range1)) {
+				qb_get_value_range(cxt, ra, ranges, qop->operands[2].address, &range2);
+				if(qop->opcode == QB_IDX_GUARD_ADD_U32_U32_U32_U32) {
+					qb_add_value_ranges(&range1, &range2, &result);
+					result_address = qop->operands[3].address;
+				} else if(qb_multiply_value_ranges(&range1, &range2, &result)) {
+					result_address = qop->operands[3].address;
+				}
+			}
+		}	break;
+		case QB_IDX_GUARD_MAC_U32_U32_U32_U32_U32: {
+			if(qb_get_guarded_index_range(cxt, ra, ranges, qop, &range1)) {
+				qb_get_value_range(cxt, ra, ranges, qop->operands[2].address, &range2);
+				qb_get_value_range(cxt, ra, ranges, qop->operands[3].address, &range3);
+				if(qb_multiply_value_ranges(&range1, &range2, &result)) {
+					qb_add_value_ranges(&result, &range3, &result);
+					result_address = qop->operands[4].address;
+				}
+			}
+		}	break;
+		default: break;
+	}
+
+	for(i = 0; i < qop->operand_count; i++) {
+		if(qb_is_operand_write_target(qop->opcode, i)) {
+			qb_invalidate_value_range(ra, ranges, fact_set, qop->operands[i].address);
+		}
+	}
+	if(result_address) {
+		qb_set_value_range(ra, ranges, result_address, &result);
+	}
+
+	switch(qop->opcode) {
+		case QB_IDX_GUARD_U32_U32:
+		case QB_IDX_GUARD_ADD_U32_U32_U32_U32:
+		case QB_IDX_GUARD_MUL_U32_U32_U32_U32:
+		case QB_IDX_GUARD_MAC_U32_U32_U32_U32_U32: {
+			// execution continues only if the index is less than the limit
+			if(qb_get_value_range(cxt, ra, ranges, qop->operands[1].address, &range2)) {
+				qb_narrow_value_range(cxt, ra, ranges, qop->operands[0].address, 0, range2.upper - 1);
+			}
+			qb_set_index_fact(ra, fact_set, qop->operands[0].address, qop->operands[1].address);
+		}	break;
+		default: break;
+	}
+}
+
+static int32_t qb_get_comparison_strictness(qb_opcode opcode) {
+	switch(opcode) {
+		case QB_LT_S08_S08_I32:
+		case QB_LT_S16_S16_I32:
+		case QB_LT_S32_S32_I32:
+		case QB_LT_U08_U08_I32:
+		case QB_LT_U16_U16_I32:
+		case QB_LT_U32_U32_I32:
+			return 1;
+		case QB_LE_S08_S08_I32:
+		case QB_LE_S16_S16_I32:
+		case QB_LE_S32_S32_I32:
+		case QB_LE_U08_U08_I32:
+		case QB_LE_U16_U16_I32:
+		case QB_LE_U32_U32_I32:
+			return 0;
+		default:
+			return -1;
+	}
+}
+
+static int32_t qb_narrow_value_ranges_by_comparison(qb_compiler_context *cxt, qb_range_analysis *ra, qb_value_range *ranges, uint32_t *fact_set, qb_address *address1, qb_address *address2, int32_t strict) {
+	qb_value_range range1, range2;
+	if(!qb_get_value_range(cxt, ra, ranges, address1, &range1) || !qb_get_value_range(cxt, ra, ranges, address2, &range2)) {
+		return TRUE;
+	}
+	if(!qb_narrow_value_range(cxt, ra, ranges, address1, range1.lower, range2.upper - strict)
+	|| !qb_narrow_value_range(cxt, ra, ranges, address2, range1.lower + strict, range2.upper)) {
+		return FALSE;
+	}
+	if(strict) {
+		// a non-negative signed value that's less than another is also less when both are viewed as unsigned
+		qb_get_value_range(cxt, ra, ranges, address1, &range1);
+		if(range1.lower >= 0) {
+			qb_set_index_fact(ra, fact_set, address1, address2);
+		}
+	}
+	return TRUE;
+}
+
+static int32_t qb_narrow_value_ranges_by_branch(qb_compiler_context *cxt, qb_range_analysis *ra, qb_value_range *ranges, uint32_t *fact_set, uint32_t index, uint32_t target_number) {
+	qb_op *qop = cxt->ops[index];
+	if((qop->opcode == QB_IF_T_I32 || qop->opcode == QB_IF_F_I32) && qop->jump_target_count == 2) {
+		qb_op *prev_qop = qb_get_previous_op(cxt, index);
+		if(prev_qop && prev_qop->operand_count == 3) {
+			int32_t strict = qb_get_comparison_strictness(prev_qop->opcode);
+			if(strict != -1 && qb_get_root_address(prev_qop->operands[2].address) == qb_get_root_address(qop->operands[0].address)) {
+				qb_address *address1 = prev_qop->operands[0].address;
+				qb_address *address2 = prev_qop->operands[1].address;
+				int32_t condition = (qop->opcode == QB_IF_T_I32) ? (target_number == 0) : (target_number == 1);
+				if(condition) {
+					return qb_narrow_value_ranges_by_comparison(cxt, ra, ranges, fact_set, address1, address2, strict);
+				} else {
+					// !(a < b) means b <= a and !(a <= b) means b < a
+					return qb_narrow_value_ranges_by_comparison(cxt, ra, ranges, fact_set, address2, address1, !strict);
+				}
+			}
+		}
+	}
+	return TRUE;
+}
+
+static void qb_merge_value_ranges(qb_range_analysis *ra, uint32_t block_number, qb_value_range *ranges, uint32_t *fact_set, int32_t backward) {
+	qb_value_range *block_ranges = ra->block_ranges + block_number * ra->variable_count;
+	uint32_t *block_facts = ra->block_facts + block_number * ra->fact_word_count;
+	uint32_t i;
+	if(!ra->block_visited[block_number]) {
+		memcpy(block_ranges, ranges, sizeof(qb_value_range) * ra->variable_count);
+		memcpy(block_facts, fact_set, sizeof(uint32_t) * ra->fact_word_count);
+		ra->block_visited[block_number] = TRUE;
+		ra->block_pending[block_number] = TRUE;
+	} else {
+		int32_t changed = FALSE;
+		int32_t widen = (backward && ra->block_change_counts[block_number] >= QB_RANGE_WIDENING_THRESHOLD);
+		for(i = 0; i < ra->variable_count; i++) {
+			qb_value_range bounds;
+			qb_get_type_bounds(ra->variables[i]->type, &bounds);
+			if(ranges[i].lower < block_ranges[i].lower) {
+				// jump to the limit if the range keeps expanding in a loop
+				block_ranges[i].lower = (widen) ? bounds.lower : ranges[i].lower;
+				changed = TRUE;
+			}
+			if(ranges[i].upper > block_ranges[i].upper) {
+				block_ranges[i].upper = (widen) ? bounds.upper : ranges[i].upper;
+				changed = TRUE;
+			}
+		}
+		for(i = 0; i < ra->fact_word_count; i++) {
+			if(block_facts[i] & ~fact_set[i]) {
+				block_facts[i] &= fact_set[i];
+				changed = TRUE;
+			}
+		}
+		if(changed) {
+			ra->block_change_counts[block_number]++;
+			ra->block_pending[block_number] = TRUE;
+		}
+	}
+}
+
+static void qb_propagate_value_ranges(qb_compiler_context *cxt, qb_range_analysis *ra, uint32_t index, uint32_t target_index, uint32_t target_number) {
+	// use separate copies, since the narrowing applies to one path only
+	memcpy(ra->edge_ranges, ra->ranges, sizeof(qb_value_range) * ra->variable_count);
+	memcpy(ra->edge_fact_set, ra->fact_set, sizeof(uint32_t) * ra->fact_word_count);
+	if(qb_narrow_value_ranges_by_branch(cxt, ra, ra->edge_ranges, ra->edge_fact_set, index, target_number)) {
+		qb_merge_value_ranges(ra, ra->block_indices[target_index], ra->edge_ranges, ra->edge_fact_set, (target_index <= index));
+	}
+}
+
+static int32_t qb_is_bound_check_redundant(qb_compiler_context *cxt, qb_range_analysis *ra, qb_op *qop) {
+	qb_value_range index_range, limit_range;
+	qb_get_value_range(cxt, ra, ra->ranges, qop->operands[0].address, &index_range);
+	qb_get_value_range(cxt, ra, ra->ranges, qop->operands[1].address, &limit_range);
+	if(index_range.upper < limit_range.lower) {
+		return TRUE;
+	}
+	return qb_check_index_fact(ra, ra->fact_set, qop->operands[0].address, qop->operands[1].address);
+}
+
+static void qb_remove_bound_check(qb_compiler_context *cxt, qb_op *qop) {
+	qb_opcode new_opcode;
+	uint32_t i;
+	switch(qop->opcode) {
+		case QB_IDX_GUARD_ADD_U32_U32_U32_U32: new_opcode = QB_ADD_I32_I32_I32; break;
+		case QB_IDX_GUARD_MUL_U32_U32_U32_U32: new_opcode = QB_MUL_U32_U32_U32; break;
+		case QB_IDX_GUARD_MAC_U32_U32_U32_U32_U32: new_opcode = QB_MAC_U32_U32_U32_U32; break;
+		default: {
+			// the index itself is the result
+			qop->opcode = QB_NOP;
+			qop->operand_count = 0;
+			qop->operands = NULL;
+		}	return;
+	}
+	// drop the limit and perform just the arithmetic
+	for(i = 1; i < qop->operand_count - 1; i++) {
+		qop->operands[i] = qop->operands[i + 1];
+	}
+	qop->operand_count--;
+	qop->opcode = new_opcode;
+	qop->flags = qb_get_op_flags(new_opcode) | (qop->flags & QB_OP_JUMP_TARGET);
+}
+
+static int32_t qb_is_bound_check(qb_op *qop) {
+	switch(qop->opcode) {
+		case QB_IDX_GUARD_U32_U32:
+		case QB_IDX_GUARD_ADD_U32_U32_U32_U32:
+		case QB_IDX_GUARD_MUL_U32_U32_U32_U32:
+		case QB_IDX_GUARD_MAC_U32_U32_U32_U32_U32:
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+static int32_t qb_analyze_value_ranges(qb_compiler_context *cxt, qb_range_analysis *ra) {
+	uint32_t i, j, k;
+
+	// gather the integer variables
+	for(i = 0, k = 0; i < cxt->op_count; i++) {
+		k += cxt->ops[i]->operand_count;
+	}
+	ra->variables = emalloc(sizeof(qb_address *) * (k + 1));
+	for(i = 0; i < cxt->op_count; i++) {
+		qb_op *qop = cxt->ops[i];
+		for(j = 0; j < qop->operand_count; j++) {
+			if(qop->operands[j].type == QB_OPERAND_ADDRESS) {
+				qb_address *address = qop->operands[j].address;
+				if(qb_is_range_tracked_address(address) && !CONSTANT(address)) {
+					qb_address *root_address = qb_get_root_address(address);
+					if(qb_is_range_tracked_address(root_address)) {
+						ra->variables[ra->variable_count++] = root_address;
+					}
+				}
+			}
+		}
+
+		// look for conditions that establish an index is less than a limit
+		if(qb_is_bound_check(qop)) {
+			qb_add_index_fact(ra, qop->operands[0].address, qop->operands[1].address);
+		} else if(qb_get_comparison_strictness(qop->opcode) != -1 && qop->operand_count == 3) {
+			qb_add_index_fact(ra, qop->operands[0].address, qop->operands[1].address);
+			qb_add_index_fact(ra, qop->operands[1].address, qop->operands[0].address);
+		}
+	}
+	qsort(ra->variables, ra->variable_count, sizeof(qb_address *), qb_compare_variable_addresses);
+	for(i = 0, j = 0; i < ra->variable_count; i++) {
+		if(j == 0 || ra->variables[j - 1] != ra->variables[i]) {
+			ra->variables[j++] = ra->variables[i];
+		}
+	}
+	ra->variable_count = j;
+	ra->fact_word_count = (ra->fact_count + 31) / 32;
+
+	// divide the ops into blocks that can only be entered at the top
+	ra->block_indices = emalloc(sizeof(uint32_t) * cxt->op_count);
+	for(i = 0, k = 0; i < cxt->op_count; i++) {
+		qb_op *qop = cxt->ops[i];
+		if(i > 0) {
+			qb_op *prev_qop = cxt->ops[i - 1];
+			if((qop->flags & QB_OP_JUMP_TARGET) || prev_qop->jump_target_count > 0 || prev_qop->opcode == QB_RET || (prev_qop->flags & QB_OP_EXIT)) {
+				k++;
+			}
+		}
+		ra->block_indices[i] = k;
+	}
+	ra->block_count = k + 1;
+	if((uint64_t) ra->block_count * (ra->variable_count + ra->fact_word_count) > QB_RANGE_ANALYSIS_MAX_SIZE) {
+		// too big--don't bother
+		return FALSE;
+	}
+	ra->block_ranges = emalloc(sizeof(qb_value_range) * (ra->block_count * ra->variable_count + 1));
+	ra->block_facts = emalloc(sizeof(uint32_t) * (ra->block_count * ra->fact_word_count + 1));
+	ra->block_visited = ecalloc(ra->block_count, sizeof(int8_t));
+	ra->block_pending = ecalloc(ra->block_count, sizeof(int8_t));
+	ra->block_change_counts = ecalloc(ra->block_count, sizeof(uint32_t));
+	ra->ranges = emalloc(sizeof(qb_value_range) * (ra->variable_count + 1));
+	ra->fact_set = emalloc(sizeof(uint32_t) * (ra->fact_word_count + 1));
+	ra->edge_ranges = emalloc(sizeof(qb_value_range) * (ra->variable_count + 1));
+	ra->edge_fact_set = emalloc(sizeof(uint32_t) * (ra->fact_word_count + 1));
+
+	// nothing is known at the beginning
+	qb_invalidate_all_value_ranges(ra, ra->ranges, ra->fact_set);
+	qb_merge_value_ranges(ra, 0, ra->ranges, ra->fact_set, FALSE);
+
+	for(;;) {
+		int32_t processed = FALSE;
+		for(i = 0; i < cxt->op_count; i++) {
+			uint32_t block_number = ra->block_indices[i];
+			if(ra->block_pending[block_number] && (i == 0 || ra->block_indices[i - 1] != block_number)) {
+				ra->block_pending[block_number] = FALSE;
+				processed = TRUE;
+				memcpy(ra->ranges, ra->block_ranges + block_number * ra->variable_count, sizeof(qb_value_range) * ra->variable_count);
+				memcpy(ra->fact_set, ra->block_facts + block_number * ra->fact_word_count, sizeof(uint32_t) * ra->fact_word_count);
+				for(j = i; j < cxt->op_count && ra->block_indices[j] == block_number; j++) {
+					qb_op *qop = cxt->ops[j];
+					qb_update_value_ranges(cxt, ra, qop, ra->ranges, ra->fact_set);
+					if(qop->jump_target_count > 0) {
+						for(k = 0; k < qop->jump_target_count; k++) {
+							qb_propagate_value_ranges(cxt, ra, j, qop->jump_target_indices[k], k);
+						}
+					} else if(qop->opcode != QB_RET && j + 1 < cxt->op_count && ra->block_indices[j + 1] != block_number) {
+						qb_propagate_value_ranges(cxt, ra, j, j + 1, 0);
+					}
+				}
+			}
+		}
+		if(!processed) {
+			break;
+		}
+	}
+	return TRUE;
+}
+
+static void qb_eliminate_bound_checks(qb_compiler_context *cxt) {
+	qb_range_analysis _ra, *ra = &_ra;
+	qb_op **redundant_qops;
+	uint32_t redundant_qop_count = 0;
+	uint32_t i, j;
+
+	for(i = 0; i < cxt->op_count; i++) {
+		if(qb_is_bound_check(cxt->ops[i])) {
+			break;
+		}
+	}
+	if(i == cxt->op_count) {
+		return;
+	}
+
+	memset(ra, 0, sizeof(qb_range_analysis));
+	redundant_qops = emalloc(sizeof(qb_op *) * cxt->op_count);
+	if(qb_analyze_value_ranges(cxt, ra)) {
+		// go through the blocks again and see which checks can't fail
+		for(i = 0; i < cxt->op_count; i++) {
+			uint32_t block_number = ra->block_indices[i];
+			if(ra->block_visited[block_number] && (i == 0 || ra->block_indices[i - 1] != block_number)) {
+				memcpy(ra->ranges, ra->block_ranges + block_number * ra->variable_count, sizeof(qb_value_range) * ra->variable_count);
+				memcpy(ra->fact_set, ra->block_facts + block_number * ra->fact_word_count, sizeof(uint32_t) * ra->fact_word_count);
+				for(j = i; j < cxt->op_count && ra->block_indices[j] == block_number; j++) {
+					qb_op *qop = cxt->ops[j];
+					if(qb_is_bound_check(qop) && qb_is_bound_check_redundant(cxt, ra, qop)) {
+						redundant_qops[redundant_qop_count++] = qop;
+					}
+					qb_update_value_ranges(cxt, ra, qop, ra->ranges, ra->fact_set);
+				}
+			}
+		}
+		for(i = 0; i < redundant_qop_count; i++) {
+			qb_remove_bound_check(cxt, redundant_qops[i]);
+		}
+	}
+
+	efree(redundant_qops);
+	if(ra->variables) {
+		efree(ra->variables);
+	}
+	if(ra->facts) {
+		efree(ra->facts);
+	}
+	if(ra->block_indices) {
+		efree(ra->block_indices);
+	}
+	if(ra->block_ranges) {
+		efree(ra->block_ranges);
+		efree(ra->block_facts);
+		efree(ra->block_visited);
+		efree(ra->block_pending);
+		efree(ra->block_change_counts);
+		efree(ra->ranges);
+		efree(ra->fact_set);
+		efree(ra->edge_ranges);
+		efree(ra->edge_fact_set);
+	}
+}
+
+typedef struct qb_element_loop {
+	uint32_t header_index;
+	uint32_t branch_index;
+	uint32_t increment_index;
+	qb_address *counter_address;
+	qb_address *limit_address;
+	uint32_t *path;
+	uint32_t path_length;
+	int8_t *on_path;
+	uint32_t *payload;
+	uint32_t payload_length;
+	qb_address *destination_address;
+	qb_address *accumulator_address;
+} qb_element_loop;
+
+static int32_t qb_is_element_loop_operand(qb_compiler_context *cxt, qb_element_loop *el, qb_address *address) {
+	// an element of a one-dimensional array, at the position given by the loop counter
+	qb_address *container_address, *index_address;
+	if(address->mode != QB_ADDRESS_MODE_ELE) {
+		return FALSE;
+	}
+	container_address = address->source_address;
+	index_address = address->array_index_address;
+	if(!container_address || container_address->mode != QB_ADDRESS_MODE_ARR || container_address->dimension_count != 1) {
+		return FALSE;
+	}
+	if(container_address->array_index_address && !(CONSTANT(container_address->array_index_address) && VALUE(U32, container_address->array_index_address) == 0)) {
+		return FALSE;
+	}
+	if(index_address->mode != QB_ADDRESS_MODE_SCA || CONSTANT(index_address) || !STORAGE_TYPE_MATCH(index_address->type, QB_TYPE_U32)) {
+		return FALSE;
+	}
+	return (qb_get_root_address(index_address) == el->counter_address);
+}
+
+static int32_t qb_is_element_loop_invariant(qb_compiler_context *cxt, qb_element_loop *el, qb_address *address) {
+	qb_address *root_address;
+	uint32_t i;
+	if(CONSTANT(address)) {
+		return TRUE;
+	}
+	if(address->mode != QB_ADDRESS_MODE_SCA || !SCALAR(address) || TEMPORARY(address)) {
+		return FALSE;
+	}
+	root_address = qb_get_root_address(address);
+	if(root_address == el->counter_address) {
+		return FALSE;
+	}
+	for(i = 0; i < el->path_length; i++) {
+		if(qb_is_address_written_by_op(cxt->ops[el->path[i]], root_address)) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static int32_t qb_find_element_loop(qb_compiler_context *cxt, qb_element_loop *el) {
+	uint32_t h = el->header_index;
+	qb_op *header_qop = cxt->ops[h], *branch_qop;
+	qb_address *condition_address;
+	uint32_t i, j, index;
+	int64_t step;
+
+	// the header compares the loop counter against a limit: for($i = ...; $i < $n; $i++)
+	if(header_qop->opcode != QB_LT_S32_S32_I32 && header_qop->opcode != QB_LT_U32_U32_I32) {
+		return FALSE;
+	}
+	if(h + 1 >= cxt->op_count) {
+		return FALSE;
+	}
+	el->branch_index = h + 1;
+	branch_qop = cxt->ops[el->branch_index];
+	if((branch_qop->opcode != QB_IF_T_I32 && branch_qop->opcode != QB_IF_F_I32) || (branch_qop->flags & QB_OP_JUMP_TARGET)) {
+		return FALSE;
+	}
+	condition_address = header_qop->operands[2].address;
+	if(branch_qop->operands[0].address != condition_address || !qb_is_loop_temporary(condition_address)) {
+		return FALSE;
+	}
+	el->counter_address = qb_get_root_address(header_qop->operands[0].address);
+	el->limit_address = header_qop->operands[1].address;
+	if(CONSTANT(el->counter_address) || TEMPORARY(el->counter_address) || el->counter_address->mode != QB_ADDRESS_MODE_SCA || !SCALAR(el->counter_address) || !STORAGE_TYPE_MATCH(el->counter_address->type, QB_TYPE_U32)) {
+		return FALSE;
+	}
+
+	// follow the body from the branch back to the header, accepting no other way out
+	index = branch_qop->jump_target_indices[(branch_qop->opcode == QB_IF_T_I32) ? 0 : 1];
+	while(index != h) {
+		qb_op *qop;
+		if(index >= cxt->op_count || el->on_path[index] || index == el->branch_index) {
+			return FALSE;
+		}
+		qop = cxt->ops[index];
+		el->on_path[index] = TRUE;
+		el->path[el->path_length++] = index;
+		if(qop->opcode == QB_JMP) {
+			index = qop->jump_target_indices[0];
+		} else if(qop->jump_target_count == 0 && qop->opcode != QB_RET && !qb_is_loop_barrier(qop)) {
+			index = index + 1;
+		} else {
+			return FALSE;
+		}
+	}
+
+	// and no way in besides the branch
+	for(i = 0; i < cxt->op_count; i++) {
+		qb_op *qop = cxt->ops[i];
+		if(!el->on_path[i] && i != el->branch_index) {
+			for(j = 0; j < qop->jump_target_count; j++) {
+				uint32_t target_index = qop->jump_target_indices[j];
+				if(target_index < cxt->op_count && el->on_path[target_index]) {
+					return FALSE;
+				}
+			}
+			if(i + 1 < cxt->op_count && el->on_path[i + 1] && qop->jump_target_count == 0 && qop->opcode != QB_RET) {
+				return FALSE;
+			}
+		}
+	}
+
+	// the counter is incremented once, after everything else
+	el->increment_index = cxt->op_count;
+	for(i = 0; i < el->path_length; i++) {
+		index = el->path[i];
+		if(qb_is_address_written_by_op(cxt->ops[index], el->counter_address)) {
+			if(el->increment_index != cxt->op_count || !qb_get_induction_step(cxt, cxt->ops[index], el->counter_address, &step) || step != 1) {
+				return FALSE;
+			}
+			el->increment_index = index;
+		} else if(cxt->ops[index]->opcode != QB_NOP && cxt->ops[index]->opcode != QB_JMP) {
+			if(el->increment_index != cxt->op_count) {
+				return FALSE;
+			}
+			el->payload[el->payload_length++] = index;
+		}
+	}
+	if(el->increment_index == cxt->op_count || el->payload_length == 0) {
+		return FALSE;
+	}
+	return qb_is_element_loop_invariant(cxt, el, el->limit_address);
+}
+
+static int32_t qb_is_element_loop_payload(qb_op *qop) {
+	uint32_t i;
+	if(!(qop->flags & QB_OP_VERSION_AVAILABLE_MIO) || (qop->flags & (QB_OP_NEED_LINE_IDENTIFIER | QB_OP_SIDE_EFFECT | QB_OP_BRANCH | QB_OP_JUMP | QB_OP_EXIT))) {
+		return FALSE;
+	}
+	for(i = 0; i < qop->operand_count; i++) {
+		if(qop->operands[i].type != QB_OPERAND_ADDRESS || qb_get_operand_address_mode(qop->opcode, i) != QB_ADDRESS_MODE_SCA) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static int32_t qb_find_element_loop_temporary(qb_address **temporaries, uint32_t count, qb_address *address) {
+	uint32_t i;
+	for(i = 0; i < count; i++) {
+		if(temporaries[i] == address) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static int32_t qb_check_element_map(qb_compiler_context *cxt, qb_element_loop *el) {
+	qb_address **temporaries;
+	int32_t *temporary_versions;
+	uint32_t temporary_count = 0, operand_count = 0;
+	int32_t destination_version = 0, merged_version = 0, valid = TRUE;
+	uint32_t i, j, k;
+
+	// all elements written have to come from the same array
+	for(i = 0; i < el->payload_length; i++) {
+		qb_op *qop = cxt->ops[el->payload[i]];
+		for(j = 0; j < qop->operand_count; j++) {
+			qb_address *address = qop->operands[j].address;
+			if(qb_is_operand_write_target(qop->opcode, j) && address->mode == QB_ADDRESS_MODE_ELE) {
+				if(!qb_is_element_loop_operand(cxt, el, address)) {
+					return FALSE;
+				}
+				if(!el->destination_address) {
+					el->destination_address = address;
+				} else if(qb_get_root_address(address) != qb_get_root_address(el->destination_address) || address->type != el->destination_address->type) {
+					return FALSE;
+				}
+			}
+		}
+	}
+	if(!el->destination_address) {
+		return FALSE;
+	}
+
+	// intermediate results are written into the destination array instead of temporary variables;
+	// that's only possible when every op still sees the value it would have seen originally
+	for(i = 0; i < el->payload_length; i++) {
+		operand_count += cxt->ops[el->payload[i]]->operand_count;
+	}
+	temporaries = emalloc(sizeof(qb_address *) * operand_count);
+	temporary_versions = emalloc(sizeof(int32_t) * operand_count);
+	for(i = 0; i < el->payload_length && valid; i++) {
+		qb_op *qop = cxt->ops[el->payload[i]];
+		int32_t version = i + 1;
+		if(!qb_is_element_loop_payload(qop)) {
+			valid = FALSE;
+			break;
+		}
+		for(j = 0; j < qop->operand_count; j++) {
+			qb_address *address = qop->operands[j].address;
+			if(!qb_is_operand_write_target(qop->opcode, j)) {
+				if(qb_is_element_loop_operand(cxt, el, address)) {
+					if(qb_get_root_address(address) == qb_get_root_address(el->destination_address) && destination_version != merged_version) {
+						valid = FALSE;
+					}
+				} else if(qb_is_loop_temporary(address)) {
+					int32_t t = qb_find_element_loop_temporary(temporaries, temporary_count, address);
+					if(t == -1 || temporary_versions[t] != merged_version) {
+						valid = FALSE;
+					}
+				} else if(!qb_is_element_loop_invariant(cxt, el, address)) {
+					valid = FALSE;
+				}
+			}
+		}
+		for(j = 0; j < qop->operand_count && valid; j++) {
+			qb_address *address = qop->operands[j].address;
+			if(qb_is_operand_write_target(qop->opcode, j)) {
+				if(address->mode == QB_ADDRESS_MODE_ELE) {
+					destination_version = version;
+				} else if(qb_is_loop_temporary(address) && address->type == el->destination_address->type) {
+					int32_t t = qb_find_element_loop_temporary(temporaries, temporary_count, address);
+					if(t == -1) {
+						t = temporary_count++;
+						temporaries[t] = address;
+					}
+					temporary_versions[t] = version;
+				} else {
+					valid = FALSE;
+				}
+				merged_version = version;
+			}
+		}
+	}
+	if(valid && destination_version != merged_version) {
+		// a temporary variable was written last
+		valid = FALSE;
+	}
+	if(valid) {
+		// the temporary variables shouldn't be used anywhere else
+		for(i = 0; i < cxt->op_count && valid; i++) {
+			if(!el->on_path[i]) {
+				for(k = 0; k < temporary_count; k++) {
+					if(qb_is_address_referenced_by_op(cxt->ops[i], temporaries[k])) {
+						valid = FALSE;
+						break;
+					}
+				}
+			}
+		}
+	}
+	efree(temporaries);
+	efree(temporary_versions);
+	return valid;
+}
+
+static qb_opcode qb_get_array_sum_opcode(qb_primitive_type type) {
+	switch(type) {
+		case QB_TYPE_S08: return QB_ASUM_S08_S08;
+		case QB_TYPE_U08: return QB_ASUM_U08_U08;
+		case QB_TYPE_S16: return QB_ASUM_S16_S16;
+		case QB_TYPE_U16: return QB_ASUM_U16_U16;
+		case QB_TYPE_S32: return QB_ASUM_S32_S32;
+		case QB_TYPE_U32: return QB_ASUM_U32_U32;
+		case QB_TYPE_S64: return QB_ASUM_S64_S64;
+		case QB_TYPE_U64: return QB_ASUM_U64_U64;
+		default: return QB_NOP;
+	}
+}
+
+static int32_t qb_check_element_reduction(qb_compiler_context *cxt, qb_element_loop *el) {
+	qb_op *qop;
+	qb_address *accumulator_address, *element_address;
+
+	// $sum += $a[$i], with integers only, since adding floating point numbers in a different order 
+	// can yield a different result
+	if(el->payload_length != 1) {
+		return FALSE;
+	}
+	qop = cxt->ops[el->payload[0]];
+	switch(qop->opcode) {
+		case QB_ADD_I08_I08_I08:
+		case QB_ADD_I16_I16_I16:
+		case QB_ADD_I32_I32_I32:
+		case QB_ADD_I64_I64_I64:
+			break;
+		default:
+			return FALSE;
+	}
+	accumulator_address = qop->operands[2].address;
+	if(qop->operands[0].address == accumulator_address) {
+		element_address = qop->operands[1].address;
+	} else if(qop->operands[1].address == accumulator_address) {
+		element_address = qop->operands[0].address;
+	} else {
+		return FALSE;
+	}
+	if(CONSTANT(accumulator_address) || TEMPORARY(accumulator_address) || accumulator_address->mode != QB_ADDRESS_MODE_SCA || !SCALAR(accumulator_address) || accumulator_address->source_address) {
+		return FALSE;
+	}
+	if(!qb_is_element_loop_operand(cxt, el, element_address) || element_address->type != accumulator_address->type) {
+		return FALSE;
+	}
+	if(qb_get_array_sum_opcode(element_address->type) == QB_NOP) {
+		return FALSE;
+	}
+	el->accumulator_address = accumulator_address;
+	return TRUE;
+}
+
+static qb_address * qb_obtain_element_loop_slice(qb_compiler_context *cxt, qb_address *element_address, qb_address *length_address) {
+	qb_address *container_address = element_address->source_address;
+	qb_address *index_address = element_address->array_index_address;
+	qb_address *result_address;
+	uint32_t i;
+
+	// see if we have created the address earlier
+	for(i = 0; i < cxt->address_alias_count; i++) {
+		qb_address *alias = cxt->address_aliases[i];
+		if(alias->source_address == container_address) {
+			if(alias->array_index_address == index_address && alias->array_size_address == length_address && alias->dimension_count == 1) {
+				return alias;
+			}
+		}
+	}
+
+	// the index is absolute already, as only arrays without an offset are accepted
+	result_address = qb_create_address_alias(cxt, container_address);
+	result_address->flags &= ~QB_ADDRESS_RESIZABLE;
+	result_address->array_index_address = index_address;
+	result_address->array_size_address = length_address;
+	result_address->array_size_addresses =
+	result_address->dimension_addresses = &result_address->array_size_address;
+	return result_address;
+}
+
+static void qb_convert_element_loop(qb_compiler_context *cxt, qb_element_loop *el) {
+	qb_op *increment_qop = cxt->ops[el->increment_index];
+	qb_op *new_qops[2];
+	qb_address *count_address;
+	uint32_t new_qop_count = 0;
+	uint32_t i, j;
+
+	// the number of iterations remaining
+	count_address = qb_create_temporary_variable(cxt, QB_TYPE_U32, NULL);
+	qb_mark_as_writable(cxt, count_address);
+	new_qops[new_qop_count++] = qb_create_loop_op(cxt, QB_SUB_I32_I32_I32, el->limit_address, cxt->ops[el->header_index]->operands[0].address, count_address, cxt->ops[el->payload[0]]->line_id);
+
+	if(el->accumulator_address) {
+		// sum up the elements first, then add the total to the accumulator
+		qb_op *qop = cxt->ops[el->payload[0]];
+		qb_address *element_address = (qop->operands[0].address == el->accumulator_address) ? qop->operands[1].address : qop->operands[0].address;
+		qb_address *slice_address = qb_obtain_element_loop_slice(cxt, element_address, count_address);
+		qb_address *sum_address = qb_create_temporary_variable(cxt, element_address->type, NULL);
+		qb_op *sum_qop = qb_create_loop_op(cxt, qb_get_array_sum_opcode(element_address->type), slice_address, sum_address, NULL, qop->line_id);
+		sum_qop->operand_count = 2;
+		qb_mark_as_writable(cxt, sum_address);
+		new_qops[new_qop_count++] = sum_qop;
+		if(qop->operands[0].address == el->accumulator_address) {
+			qop->operands[1].address = sum_address;
+		} else {
+			qop->operands[0].address = sum_address;
+		}
+	} else {
+		// apply each op to the whole range, storing intermediate results in the destination
+		qb_address *destination_slice_address = qb_obtain_element_loop_slice(cxt, el->destination_address, count_address);
+		for(i = 0; i < el->payload_length; i++) {
+			qb_op *qop = cxt->ops[el->payload[i]];
+			for(j = 0; j < qop->operand_count; j++) {
+				qb_address *address = qop->operands[j].address;
+				if(address->mode == QB_ADDRESS_MODE_ELE) {
+					qop->operands[j].address = qb_obtain_element_loop_slice(cxt, address, count_address);
+				} else if(qb_is_loop_temporary(address)) {
+					qop->operands[j].address = destination_slice_address;
+				}
+			}
+		}
+	}
+
+	// set the counter to its final value, so the loop exits when the condition is checked again
+	increment_qop->opcode = QB_MOV_I32_I32;
+	increment_qop->flags = qb_get_op_flags(QB_MOV_I32_I32) | (increment_qop->flags & QB_OP_COMPILE_TIME_FLAGS);
+	increment_qop->operands = qb_allocate_operands(cxt->pool, 2);
+	increment_qop->operand_count = 2;
+	increment_qop->operands[0].type = QB_OPERAND_ADDRESS;
+	increment_qop->operands[0].address = el->limit_address;
+	increment_qop->operands[1].type = QB_OPERAND_ADDRESS;
+	increment_qop->operands[1].address = el->counter_address;
+
+	// jumps into the body should land on the new ops
+	memset(el->on_path, 0, sizeof(int8_t) * cxt->op_count);
+	qb_insert_ops(cxt, el->payload[0], new_qops, new_qop_count, el->on_path);
+}
+
+static void qb_convert_element_loops(qb_compiler_context *cxt) {
+	qb_element_loop _el, *el = &_el;
+	uint32_t i;
+
+	for(i = 0; i + 1 < cxt->op_count; i++) {
+		qb_op *qop = cxt->ops[i];
+		if(qop->opcode == QB_LT_S32_S32_I32 || qop->opcode == QB_LT_U32_U32_I32) {
+			memset(el, 0, sizeof(qb_element_loop));
+			el->header_index = i;
+			el->path = emalloc(sizeof(uint32_t) * cxt->op_count);
+			el->payload = emalloc(sizeof(uint32_t) * cxt->op_count);
+			el->on_path = ecalloc(cxt->op_count, sizeof(int8_t));
+			if(qb_find_element_loop(cxt, el)) {
+				if(qb_check_element_reduction(cxt, el) || qb_check_element_map(cxt, el)) {
+					qb_convert_element_loop(cxt, el);
+				}
+			}
+			efree(el->path);
+			efree(el->payload);
+			efree(el->on_path);
+		}
+	}
+}
+
+void qb_fuse_instructions(qb_compiler_context *cxt, int32_t pass) {
+	USE_TSRM
+	uint32_t i;
+	if(pass == 1) {
+		// opcodes are not address mode specific at this point
+		if(!QB_G(force_bound_checks)) {
+			qb_eliminate_bound_checks(cxt);
+		}
+		qb_convert_element_loops(cxt);
+		qb_optimize_loops(cxt);
+
 		// the last op is always RET: there's no need to scan it
 		for(i = 0; i < cxt->op_count - 1; i++) {
 			qb_simplify_jump(cxt, i);
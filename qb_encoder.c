@@ -20,9 +20,22 @@
 
 #include "qb.h"
 
+static uint32_t qb_get_pointer_relocation_count(qb_encoder_context *cxt, qb_address *address) {
+	// only pointers to preallocated segments move when the function is relocated
+	// the rest are fixed up through the segment's references when memory is allocated
+	if(address->segment_selector < cxt->compiler_context->storage->segment_count) {
+		qb_memory_segment *segment = &cxt->compiler_context->storage->segments[address->segment_selector];
+		if(segment->flags & QB_SEGMENT_PREALLOCATED) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
 void qb_set_instruction_offsets(qb_encoder_context *cxt) {
-	uint32_t instruction_offset, i;
+	uint32_t instruction_offset, i, j;
 	uint32_t count = 0;
+	uint32_t handler_count = 0, pointer_count = 0;
 
 	// determine the offsets of each instruction in the stream
 	instruction_offset = sizeof(void *);
@@ -33,20 +46,95 @@ void qb_set_instruction_offsets(qb_encoder_context *cxt) {
 			uint32_t instruction_length = qb_get_instruction_length(qop->opcode);
 			instruction_offset += instruction_length;
 			count++;
+
+			// count the pointers that qb_relocate_function() will have to fix up
+			if(qop->flags & (QB_OP_JUMP | QB_OP_BRANCH | QB_OP_EXIT | QB_OP_BRANCH_TABLE)) {
+				handler_count += qop->jump_target_count;
+				pointer_count += qop->jump_target_count;
+			} else {
+				handler_count++;
+			}
+			for(j = 0; j < qop->operand_count; j++) {
+				qb_operand *operand = &qop->operands[j];
+				if(operand->type == QB_OPERAND_ADDRESS) {
+					qb_address *address = operand->address;
+					pointer_count += qb_get_pointer_relocation_count(cxt, address);
+					if(address->mode == QB_ADDRESS_MODE_ELE || address->mode == QB_ADDRESS_MODE_ARR) {
+						pointer_count += qb_get_pointer_relocation_count(cxt, address->array_index_address);
+					}
+					if(address->mode == QB_ADDRESS_MODE_ARR) {
+						pointer_count += qb_get_pointer_relocation_count(cxt, address->array_size_address);
+					}
+				}
+			}
 		}
 	}
+	if(count > 0) {
+		// handler of the "zeroth" instruction
+		handler_count++;
+	}
 
 	// the final offset also happens to be the total length
 	cxt->instruction_stream_length = instruction_offset;
 	cxt->instruction_op_count = count;
+	cxt->handler_relocation_count = handler_count;
+	cxt->pointer_relocation_count = pointer_count;
+}
+
+static int32_t qb_add_relocation(qb_encoder_context *cxt, void *pointer, uint32_t selector) {
+	if(cxt->relocations) {
+		// handlers are placed ahead of the other pointers, since they only need to be fixed up once
+		qb_instruction_relocation *relocation;
+		if(selector == QB_RELOCATION_HANDLER) {
+			if(cxt->handler_relocation_index >= cxt->handler_relocation_count) {
+				qb_report_internal_error(0, "Relocation table overflow");
+				return FALSE;
+			}
+			relocation = &cxt->relocations[cxt->handler_relocation_index++];
+		} else {
+			if(cxt->pointer_relocation_index >= cxt->pointer_relocation_count) {
+				qb_report_internal_error(0, "Relocation table overflow");
+				return FALSE;
+			}
+			relocation = &cxt->relocations[cxt->handler_relocation_count + cxt->pointer_relocation_index++];
+		}
+		relocation->offset = (uint32_t) ((int8_t *) pointer - cxt->instructions);
+		relocation->selector = selector;
+	}
+	return TRUE;
+}
+
+static int32_t qb_compare_relocations(const void *p1, const void *p2) {
+	qb_instruction_relocation *r1 = (qb_instruction_relocation *) p1;
+	qb_instruction_relocation *r2 = (qb_instruction_relocation *) p2;
+	if(r1->selector != r2->selector) {
+		return (r1->selector < r2->selector) ? -1 : 1;
+	}
+	return (r1->offset < r2->offset) ? -1 : (r1->offset > r2->offset) ? 1 : 0;
+}
+
+static uint32_t qb_find_first_relocation(qb_instruction_relocation *relocations, uint32_t low, uint32_t high, uint32_t selector) {
+	// find the first entry with the given selector or a higher one
+	while(low < high) {
+		uint32_t middle = low + (high - low) / 2;
+		if(relocations[middle].selector < selector) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return low;
 }
 
-static void qb_add_segment_reference(qb_encoder_context *cxt, qb_address *address, void **p_pointer) {
+static int32_t qb_add_segment_reference(qb_encoder_context *cxt, qb_address *address, void **p_pointer) {
 	qb_memory_segment *segment = &cxt->storage->segments[address->segment_selector];
 	// don't add relocation pointers for those pointing to preallocated segments 
 	if(!(segment->flags & QB_SEGMENT_PREALLOCATED)) {
 		uintptr_t **p_reference = &segment->references[segment->reference_count++];
 		*p_reference = (uintptr_t *) ((void *) (cxt->instruction_base_address + ((uintptr_t) p_pointer - (uintptr_t) cxt->instructions)));
+		return TRUE;
+	} else {
+		return qb_add_relocation(cxt, p_pointer, address->segment_selector);
 	}
 }
 
@@ -79,7 +167,9 @@ static int32_t qb_encode_address(qb_encoder_context *cxt, qb_address *address, i
 			}
 			*p_ip += sizeof(qb_pointer_SCA);
 
-			qb_add_segment_reference(cxt, address, &p->data_pointer);
+			if(!qb_add_segment_reference(cxt, address, &p->data_pointer)) {
+				return FALSE;
+			}
 		}	break;
 		case QB_ADDRESS_MODE_ELE: {
 			qb_pointer_ELE *p = ((qb_pointer_ELE *) *p_ip);
@@ -89,8 +179,10 @@ static int32_t qb_encode_address(qb_encoder_context *cxt, qb_address *address, i
 			}
 			*p_ip += sizeof(qb_pointer_ELE);
 
-			qb_add_segment_reference(cxt, address, &p->data_pointer);
-			qb_add_segment_reference(cxt, address->array_index_address, (void **) &p->index_pointer);
+			if(!qb_add_segment_reference(cxt, address, &p->data_pointer)
+			|| !qb_add_segment_reference(cxt, address->array_index_address, (void **) &p->index_pointer)) {
+				return FALSE;
+			}
 		}	break;
 		case QB_ADDRESS_MODE_ARR: {
 			qb_pointer_ARR *p = ((qb_pointer_ARR *) *p_ip);
@@ -101,9 +193,11 @@ static int32_t qb_encode_address(qb_encoder_context *cxt, qb_address *address, i
 			}
 			*p_ip += sizeof(qb_pointer_ARR);
 
-			qb_add_segment_reference(cxt, address, &p->data_pointer);
-			qb_add_segment_reference(cxt, address->array_index_address, (void **) &p->index_pointer);
-			qb_add_segment_reference(cxt, address->array_size_address, (void **) &p->count_pointer);
+			if(!qb_add_segment_reference(cxt, address, &p->data_pointer)
+			|| !qb_add_segment_reference(cxt, address->array_index_address, (void **) &p->index_pointer)
+			|| !qb_add_segment_reference(cxt, address->array_size_address, (void **) &p->count_pointer)) {
+				return FALSE;
+			}
 		}	break;
 		default: {
 			qb_report_internal_error(0, "Invalid address type");
@@ -138,6 +232,9 @@ static int32_t qb_encode_handler(qb_encoder_context *cxt, uint32_t target_index,
 			target_qop = cxt->ops[++target_index];
 		}
 
+		if(!qb_add_relocation(cxt, *p_ip, QB_RELOCATION_HANDLER)) {
+			return FALSE;
+		}
 		*((void **) *p_ip) = qb_get_handler(cxt, target_qop); 
 		*p_ip += sizeof(void *);
 		return TRUE;
@@ -165,9 +262,15 @@ static int32_t qb_encode_jump_target(qb_encoder_context *cxt, uint32_t target_in
 			target_qop = cxt->ops[++target_index];
 		}
 
+		if(!qb_add_relocation(cxt, *p_ip, QB_RELOCATION_HANDLER)) {
+			return FALSE;
+		}
 		*((void **) *p_ip) = qb_get_handler(cxt, target_qop);
 		*p_ip += sizeof(void *);
 
+		if(!qb_add_relocation(cxt, *p_ip, QB_RELOCATION_INSTRUCTION_POINTER)) {
+			return FALSE;
+		}
 		*((int8_t **) *p_ip) = qb_get_instruction_pointer(cxt, target_qop); 
 		*p_ip += sizeof(int8_t *);
 
@@ -292,6 +395,16 @@ int8_t * qb_encode_instruction_stream(qb_encoder_context *cxt, int8_t *memory) {
 		qb_debug_abort("length mismatch");
 	}
 #endif
+	// an entry left unfilled would be applied to offset zero when the function is relocated
+	if(cxt->relocations && (cxt->handler_relocation_index != cxt->handler_relocation_count || cxt->pointer_relocation_index != cxt->pointer_relocation_count)) {
+		qb_report_internal_error(0, "Relocation count mismatch");
+		return NULL;
+	}
+	if(cxt->relocations) {
+		// sort the pointers by selector so qb_relocate_function() can skip the ones it doesn't shift
+		// jump targets end up at the end, since their selector is higher than any segment's
+		qsort(cxt->relocations + cxt->handler_relocation_count, cxt->pointer_relocation_count, sizeof(qb_instruction_relocation), qb_compare_relocations);
+	}
 	return ip;
 }
 
@@ -308,6 +421,19 @@ int8_t * qb_copy_instruction_opcodes(qb_encoder_context *cxt, int8_t *memory) {
 	return (int8_t *) cp;
 }
 
+static int8_t * qb_copy_instruction_line_ids(qb_encoder_context *cxt, int8_t *memory) {
+	uint32_t *lp = (uint32_t *) memory;
+	uint32_t i;
+	for(i = 0; i < cxt->op_count; i++) {
+		qb_op *qop = cxt->ops[i];
+		if(qop->opcode != QB_NOP) {
+			*lp = qop->line_id;
+			lp++;
+		}
+	}
+	return (int8_t *) lp;
+}
+
 static uint32_t qb_get_address_length(qb_address *address) {
 	uint32_t i, j;
 	uint32_t length = sizeof(qb_address);	// the address itself
@@ -534,6 +660,7 @@ static int8_t * qb_copy_function_structure(qb_encoder_context *cxt, int8_t *memo
 	qfunc->next_reentrance_copy = NULL;
 	qfunc->next_forked_copy = NULL;
 	qfunc->in_use = 0;
+	qfunc->profile = NULL;
 
 #if ZEND_DEBUG
 	if(memory + length != p) {
@@ -679,7 +806,7 @@ int64_t qb_calculate_function_crc64(qb_encoder_context *cxt) {
 qb_function * qb_encode_function(qb_encoder_context *cxt) {
 	qb_function *qfunc;
 	int8_t *p;
-	uint32_t function_struct_size, storage_struct_size, preallocated_segment_size, instruction_length, opcode_length;
+	uint32_t function_struct_size, storage_struct_size, preallocated_segment_size, instruction_length, opcode_length, line_id_length, relocation_length;
 
 	// set the offset of the op
 	qb_set_instruction_offsets(cxt);
@@ -689,7 +816,12 @@ qb_function * qb_encode_function(qb_encoder_context *cxt) {
 	storage_struct_size = qb_get_storage_structure_size(cxt);
 	preallocated_segment_size = qb_get_preallocated_segment_size(cxt);
 	instruction_length = cxt->instruction_stream_length;
-	opcode_length = sizeof(uint16_t) * cxt->instruction_op_count;
+	opcode_length = ALIGN_TO(sizeof(uint16_t) * cxt->instruction_op_count, sizeof(uint32_t));
+	line_id_length = sizeof(uint32_t) * cxt->instruction_op_count;
+	relocation_length = sizeof(qb_instruction_relocation) * (cxt->handler_relocation_count + cxt->pointer_relocation_count);
+
+	// remember the size, in case the function is saved to the bytecode cache
+	cxt->function_structure_size = function_struct_size + 16;
 
 	// allocate memory for the function structure
 	p = emalloc(function_struct_size + 16);
@@ -711,8 +843,14 @@ qb_function * qb_encode_function(qb_encoder_context *cxt) {
 	// assign memory to preallocated segments
 	p = qb_preallocate_segments(cxt, p, qfunc->local_storage);
 
-	// allocate memory for the instruction stream and opcode array
-	p = emalloc(instruction_length + opcode_length);
+	// allocate memory for the instruction stream, opcode array, line id array, and relocation table
+	p = emalloc(instruction_length + opcode_length + line_id_length + relocation_length);
+
+	// the relocation table is filled in as the instructions are encoded
+	cxt->relocations = (qb_instruction_relocation *) (p + instruction_length + opcode_length + line_id_length);
+	qfunc->instruction_relocations = cxt->relocations;
+	qfunc->instruction_relocation_count = cxt->handler_relocation_count + cxt->pointer_relocation_count;
+	qfunc->instruction_handler_count = cxt->handler_relocation_count;
 
 	// encode the instructions
 	qfunc->instructions = cxt->instructions = p;
@@ -727,6 +865,10 @@ qb_function * qb_encode_function(qb_encoder_context *cxt) {
 	qfunc->instruction_opcode_count = cxt->instruction_op_count;
 	p = qb_copy_instruction_opcodes(cxt, p);
 
+	// store the line ids as well, so the profiler can attribute instructions to lines
+	qfunc->instruction_line_ids = (uint32_t *) (((int8_t *) qfunc->instruction_opcodes) + opcode_length);
+	p = qb_copy_instruction_line_ids(cxt, (int8_t *) qfunc->instruction_line_ids);
+
 	// calculate the CRC64 signature
 	qfunc->instruction_crc64 = qb_calculate_function_crc64(cxt);
 	qfunc->instruction_length = cxt->instruction_stream_length;
@@ -746,151 +888,56 @@ qb_function * qb_encode_function(qb_encoder_context *cxt) {
 	return qfunc;
 }
 
-static void qb_adjust_pointer(void **p, uintptr_t start, uintptr_t end, intptr_t shift) {
-	uintptr_t address = *((uintptr_t *) p);
-	if(start <= address && address < end) {
-		SHIFT_POINTER(*p, shift);
-	}
-}
-
 intptr_t qb_relocate_function(qb_function *qfunc, int32_t reentrance) {
 	intptr_t instruction_shift = ((uintptr_t) qfunc->instructions) - qfunc->instruction_base_address;
 	intptr_t storage_shift = ((uintptr_t) qfunc->local_storage) - qfunc->local_storage_base_address;
 	if(instruction_shift || storage_shift) {
-		int8_t *ip = qfunc->instructions;
+		int8_t *instructions = qfunc->instructions;
+		qb_instruction_relocation *relocations = qfunc->instruction_relocations;
 		uint32_t i, j;
 		int32_t initializing = !(qfunc->flags & QB_FUNCTION_INITIALIZED);
-		uintptr_t range_start, range_end;
-		qb_memory_segment *segment_start, *segment_end;
+		uint32_t selector_start, selector_end;
 
 		if(initializing) {
 			// all pointers to preallocated segments need to be relocated
-			segment_start = &qfunc->local_storage->segments[QB_SELECTOR_FIRST_PREALLOCATED];
-			segment_end = &qfunc->local_storage->segments[QB_SELECTOR_LAST_PREALLOCATED];
+			selector_start = QB_SELECTOR_FIRST_PREALLOCATED;
+			selector_end = QB_SELECTOR_LAST_PREALLOCATED;
 		} else {
 			if(reentrance) {
 				// the pointers to shared segments need to be relocated as well
 				// since they're only shared between forked copies of the function
-				segment_start = &qfunc->local_storage->segments[QB_SELECTOR_SHARED_SCALAR];
-				segment_end = &qfunc->local_storage->segments[QB_SELECTOR_SHARED_ARRAY];
+				selector_start = QB_SELECTOR_SHARED_SCALAR;
+				selector_end = QB_SELECTOR_SHARED_ARRAY;
 			} else {
 				// only pointers to local segments need to be relocated
-				segment_start = &qfunc->local_storage->segments[QB_SELECTOR_LOCAL_SCALAR];
-				segment_end = &qfunc->local_storage->segments[QB_SELECTOR_LOCAL_ARRAY];
+				selector_start = QB_SELECTOR_LOCAL_SCALAR;
+				selector_end = QB_SELECTOR_LOCAL_ARRAY;
 			}
 		}
-		range_start = qfunc->local_storage_base_address + ((uintptr_t) segment_start->memory - (uintptr_t) qfunc->local_storage);
-		range_end = qfunc->local_storage_base_address + ((uintptr_t) segment_end->memory - (uintptr_t) qfunc->local_storage) + segment_end->byte_count;
 
 #ifndef _MSC_VER
 		if(initializing) {
-			// update the first next handler
-			void **p_handler = (void **) ip;
-			qb_opcode next_opcode = (qb_opcode) *p_handler;
-			*p_handler = op_handlers[next_opcode];
-		}
-#endif
-		ip += sizeof(void *);
-
-		// go through the instructions and fix up pointers to preallocated segments
-		for(i = 0; i < qfunc->instruction_opcode_count; i++) {
-			qb_opcode opcode = qfunc->instruction_opcodes[i];
-			uint32_t op_flags = qb_get_op_flags(opcode);
-			const char *format = qb_get_op_format(opcode), *s;
-
-			if(op_flags & QB_OP_EXIT) {
-				// nothing
-			} else if(!(op_flags & QB_OP_BRANCH_TABLE)) {
-#ifndef _MSC_VER
-				if(initializing) {
-					// update next handler
-					void **p_handler = (void **) ip;
-					qb_opcode next_opcode = (qb_opcode) *p_handler;
-					*p_handler = op_handlers[next_opcode];
-				}
-#endif
-				ip += sizeof(void *);
-
-				if(op_flags & QB_OP_BRANCH) {
-					// update instruction pointer
-					int8_t **p_ip = (int8_t **) ip;
-					SHIFT_POINTER(*p_ip, instruction_shift);
-					ip += sizeof(int8_t *);
-
-#ifndef _MSC_VER
-					if(initializing) {
-						// update second next handler
-						void **p_handler = (void **) ip;
-						qb_opcode next_opcode = (qb_opcode) *p_handler;
-						*p_handler = op_handlers[next_opcode];
-					}
-#endif
-					ip += sizeof(void *);
-
-					// update second instruction pointer
-					p_ip = (int8_t **) ip;
-					SHIFT_POINTER(*p_ip, instruction_shift);
-					ip += sizeof(int8_t *);
-				} else if(op_flags & QB_OP_JUMP) {
-					int8_t **p_ip = (int8_t **) ip;
-					SHIFT_POINTER(*p_ip, instruction_shift);
-
-					ip += sizeof(int8_t *);
-				}
-			}
-			
-			for(s = format; *s != '\0'; s++) {
-				switch(*s) {
-					case 'S':
-					case 's': {
-						qb_pointer_SCA *p = (qb_pointer_SCA *) ip;
-						qb_adjust_pointer((void **) &p->data_pointer, range_start, range_end, storage_shift);
-						ip += sizeof(qb_pointer_SCA);
-					}	break;
-					case 'E':
-					case 'e': {
-						qb_pointer_ELE *p = (qb_pointer_ELE *) ip;
-						qb_adjust_pointer((void **) &p->data_pointer, range_start, range_end, storage_shift);
-						qb_adjust_pointer((void **) &p->index_pointer, range_start, range_end, storage_shift);
-						ip += sizeof(qb_pointer_ELE);
-					}	break;	
-					case 'A':
-					case 'a': {
-						qb_pointer_ARR *p = (qb_pointer_ARR *) ip;
-						qb_adjust_pointer((void **) &p->data_pointer, range_start, range_end, storage_shift);
-						qb_adjust_pointer((void **) &p->index_pointer, range_start, range_end, storage_shift);
-						qb_adjust_pointer((void **) &p->count_pointer, range_start, range_end, storage_shift);
-						ip += sizeof(qb_pointer_ARR);
-					}	break;
-					case 'c': {
-						ip += sizeof(uint32_t);
-					}	break;
-				}
+			// replace the opcode numbers with the addresses of the handlers
+			for(i = 0; i < qfunc->instruction_handler_count; i++) {
+				void **p_handler = (void **) (instructions + relocations[i].offset);
+				qb_opcode next_opcode = (qb_opcode) *p_handler;
+				*p_handler = op_handlers[next_opcode];
 			}
-
-			if(op_flags & QB_OP_BRANCH_TABLE) {
-				uint32_t branch_count = qb_get_switch_table_size_from_opcode(opcode);
-				uint32_t j;
-				for(j = 0; j < branch_count; j++) {
-					int8_t **p_ip;
-#ifndef _MSC_VER
-					if(initializing) {
-						// update next handler
-						void **p_handler = (void **) ip;
-						qb_opcode next_opcode = (qb_opcode) *p_handler;
-						*p_handler = op_handlers[next_opcode];
-					}
+		}
 #endif
-					ip += sizeof(void *);
 
-					p_ip = (int8_t **) ip;
-					SHIFT_POINTER(*p_ip, instruction_shift);
-					ip += sizeof(int8_t *);
-				}
+		// go through the relocation table and fix up pointers to preallocated segments and jump targets
+		// the pointers are sorted by selector, so only the range being shifted is visited
+		if(storage_shift) {
+			for(i = qb_find_first_relocation(relocations, qfunc->instruction_handler_count, qfunc->instruction_relocation_count, selector_start); i < qfunc->instruction_relocation_count && relocations[i].selector <= selector_end; i++) {
+				uintptr_t *p_pointer = (uintptr_t *) (instructions + relocations[i].offset);
+				*p_pointer += storage_shift;
 			}
-
-			if(op_flags & QB_OP_NEED_LINE_IDENTIFIER) {
-				ip += sizeof(uint32_t);
+		}
+		if(instruction_shift) {
+			for(i = qb_find_first_relocation(relocations, qfunc->instruction_handler_count, qfunc->instruction_relocation_count, QB_RELOCATION_INSTRUCTION_POINTER); i < qfunc->instruction_relocation_count && relocations[i].selector == QB_RELOCATION_INSTRUCTION_POINTER; i++) {
+				uintptr_t *p_pointer = (uintptr_t *) (instructions + relocations[i].offset);
+				*p_pointer += instruction_shift;
 			}
 		}
 
@@ -934,7 +981,7 @@ qb_function * qb_create_function_copy(qb_function *base, int32_t reentrance) {
 
 void qb_main(qb_interpreter_context *__restrict cxt);
 
-void qb_initialize_encoder_context(qb_encoder_context *cxt, qb_compiler_context *compiler_cxt, int32_t position_independent TSRMLS_DC) {
+void qb_initialize_op_handlers(void) {
 #ifndef _MSC_VER
 	static int handlers_initialized = FALSE;
 	if(!handlers_initialized) {
@@ -942,6 +989,10 @@ void qb_initialize_encoder_context(qb_encoder_context *cxt, qb_compiler_context
 		handlers_initialized = TRUE;
 	}
 #endif
+}
+
+void qb_initialize_encoder_context(qb_encoder_context *cxt, qb_compiler_context *compiler_cxt, int32_t position_independent TSRMLS_DC) {
+	qb_initialize_op_handlers();
 
 	memset(cxt, 0, sizeof(qb_encoder_context));
 
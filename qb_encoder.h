@@ -34,9 +34,16 @@ struct qb_encoder_context {
 
 	uint32_t instruction_stream_length;
 	uint32_t instruction_op_count;
+	uint32_t function_structure_size;
 	uint64_t instruction_crc64;
 	int8_t *instructions;
 
+	qb_instruction_relocation *relocations;
+	uint32_t handler_relocation_count;
+	uint32_t pointer_relocation_count;
+	uint32_t handler_relocation_index;
+	uint32_t pointer_relocation_index;
+
 	uintptr_t instruction_base_address;
 	uintptr_t storage_base_address;
 
@@ -50,6 +57,7 @@ void qb_set_instruction_offsets(qb_encoder_context *cxt);
 uint32_t qb_get_variable_length(qb_variable *qvar);
 int8_t * qb_copy_variable(qb_variable *qvar, int8_t *memory);
 
+void qb_initialize_op_handlers(void);
 void qb_initialize_encoder_context(qb_encoder_context *cxt, qb_compiler_context *compiler_cxt, int32_t position_independent TSRMLS_DC);
 void qb_free_encoder_context(qb_encoder_context *cxt);
 
@@ -258,8 +258,8 @@ void qb_report_incompatible_array_structure_exception(uint32_t line_id, qb_primi
 	qb_report_exception(line_id, E_ERROR, "Unable to convert %s to %s", type_specifier1, type_specifier2);
 }
 
-void qb_report_file_write_error(uint32_t line_id, uint32_t byte_count, php_stream *stream) {
-	qb_report_exception(line_id, E_ERROR, "Error encounter while writing %u bytes to %s", byte_count, stream->orig_path);
+void qb_report_file_write_error(uint32_t line_id, uint64_t byte_count, php_stream *stream) {
+	qb_report_exception(line_id, E_ERROR, "Error encounter while writing %" PRIu64 " bytes to %s", byte_count, stream->orig_path);
 }
 					
 void qb_report_too_man_dimension_exception(uint32_t line_id) {
@@ -581,16 +581,20 @@ void qb_report_illegal_array_structure_exception(uint32_t line_id) {
 	qb_report_exception(line_id, E_ERROR, "Array has irregular structure");
 }
 
-void qb_report_binary_string_size_mismatch_exception(uint32_t line_id, uint32_t byte_count, qb_primitive_type type) {
+void qb_report_binary_string_size_mismatch_exception(uint32_t line_id, uint64_t byte_count, qb_primitive_type type) {
 	uint32_t element_byte_count = BYTE_COUNT(1, type);
 	const char *type_name = type_names[type];
 	if(byte_count < element_byte_count) {
-		qb_report_exception(line_id, E_WARNING, "Number of bytes in string (%u) is less than the size of (%s)", byte_count, type_name);
+		qb_report_exception(line_id, E_WARNING, "Number of bytes in string (%" PRIu64 ") is less than the size of (%s)", byte_count, type_name);
 	} else {
-		qb_report_exception(line_id, E_WARNING, "Number of bytes in string (%u) is not divisible by the size of %s", byte_count, type_name);
+		qb_report_exception(line_id, E_WARNING, "Number of bytes in string (%" PRIu64 ") is not divisible by the size of %s", byte_count, type_name);
 	}
 }
 
+void qb_report_too_many_elements_exception(uint32_t line_id, uint64_t byte_count, qb_primitive_type type) {
+	qb_report_exception(line_id, E_ERROR, "Number of bytes (%" PRIu64 ") exceeds the maximum number of elements of type %s", byte_count, type_names[type]);
+}
+
 void qb_report_memory_map_exception(uint32_t line_id, const char *file_path) {
 	qb_report_exception(line_id, E_ERROR, "Cannot map file into memory: %s", file_path);
 }
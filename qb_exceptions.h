@@ -69,7 +69,7 @@ void qb_report_too_man_dimension_exception(uint32_t line_id);
 void qb_report_illegal_dimension_count_exception(uint32_t line_id, uint32_t dimension_count);
 void qb_report_illegal_dimension_exception(uint32_t line_id, long const_value);
 void qb_report_incompatible_array_structure_exception(uint32_t line_id, qb_primitive_type type1, uint32_t *dimensions1, uint32_t dimension_count1, qb_primitive_type type2, uint32_t *dimensions2, uint32_t dimension_count2);
-void qb_report_file_write_error(uint32_t line_id, uint32_t byte_count, php_stream *stream);
+void qb_report_file_write_error(uint32_t line_id, uint64_t byte_count, php_stream *stream);
 
 void qb_report_unexpected_tag_in_doc_comment_exception(uint32_t line_id, const char *tag, uint32_t tag_len);
 void qb_report_doc_comment_syntax_exception(uint32_t line_id);
@@ -117,7 +117,8 @@ void qb_report_void_return_value_exception(uint32_t line_id, const char *class_n
 void qb_report_too_much_recursion_exception(uint32_t line_id, uint32_t call_depth);
 
 void qb_report_illegal_array_structure_exception(uint32_t line_id);
-void qb_report_binary_string_size_mismatch_exception(uint32_t line_id, uint32_t byte_count, qb_primitive_type type);
+void qb_report_binary_string_size_mismatch_exception(uint32_t line_id, uint64_t byte_count, qb_primitive_type type);
+void qb_report_too_many_elements_exception(uint32_t line_id, uint64_t byte_count, qb_primitive_type type);
 void qb_report_memory_map_exception(uint32_t line_id, const char *file_path);
 void qb_report_argument_size_mismatch_exception(uint32_t line_id, uint32_t dimension, uint32_t dimension_expected);
 void qb_report_image_width_mismatch_exception(uint32_t line_id, uint32_t width, uint32_t width_expected);
@@ -23,6 +23,9 @@
 
 typedef struct qb_variable					qb_variable;
 typedef struct qb_native_code_bundle		qb_native_code_bundle;
+typedef struct qb_native_code_request		qb_native_code_request;
+typedef struct qb_function_profile			qb_function_profile;
+typedef struct qb_instruction_relocation	qb_instruction_relocation;
 
 typedef enum qb_external_symbol_type		qb_external_symbol_type;
 
@@ -106,6 +109,17 @@ enum {
 	QB_FUNCTION_HAS_BREAKPOINTS		= 0x00002000,
 	QB_FUNCTION_MULTITHREADED		= 0x00004000,
 	QB_FUNCTION_CLOSURE				= 0x00008000,
+	QB_FUNCTION_PROFILED			= 0x00010000,
+};
+
+enum {
+	QB_RELOCATION_INSTRUCTION_POINTER	= 0xFFFFFFFE,
+	QB_RELOCATION_HANDLER				= 0xFFFFFFFF,
+};
+
+struct qb_instruction_relocation {
+	uint32_t offset;
+	uint32_t selector;
 };
 
 struct qb_function {
@@ -114,7 +128,11 @@ struct qb_function {
 	uint64_t instruction_crc64;
 	uint32_t instruction_length;
 	uint16_t *instruction_opcodes;
+	uint32_t *instruction_line_ids;
 	uint32_t instruction_opcode_count;
+	qb_instruction_relocation *instruction_relocations;
+	uint32_t instruction_relocation_count;
+	uint32_t instruction_handler_count;
 	uint32_t flags;
 	qb_variable *return_variable;
 	qb_variable *return_key_variable;
@@ -132,6 +150,7 @@ struct qb_function {
 	qb_function *next_reentrance_copy;
 	qb_function *next_forked_copy;
 	volatile int32_t in_use;
+	qb_function_profile *profile;
 };
 
 struct qb_native_code_bundle {
@@ -139,6 +158,11 @@ struct qb_native_code_bundle {
 	uint32_t size;
 };
 
+struct qb_native_code_request {
+	qb_function *function;
+	void *native_proc;
+};
+
 #if ZEND_ENGINE_2_1 || ZEND_ENGINE_2_2 || ZEND_ENGINE_2_3
 	#define QB_GET_FUNCTION(op_array)		((void *) (op_array)->opcodes[0].op2.u.jmp_addr)
 	#define QB_SET_FUNCTION(op_array, p)	(op_array)->opcodes[0].op2.u.jmp_addr = (void *) p
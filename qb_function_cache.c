@@ -0,0 +1,567 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 5                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2012 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Chung Leong <cleong@cal.berkeley.edu>                        |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#include "qb.h"
+#include <ctype.h>
+
+#ifdef _MSC_VER
+#	include <process.h>
+#else
+#	include <unistd.h>
+#endif
+
+static uint64_t qb_add_constant_to_key(const char *name, uint32_t name_len, zend_class_entry *ce, uint64_t crc64 TSRMLS_DC) {
+	zval *value = NULL;
+	zval **p_value;
+	zend_constant *zconst;
+	char *key = estrndup(name, name_len);
+
+	if(ce && zend_hash_find(&ce->constants_table, key, name_len + 1, (void **) &p_value) == SUCCESS) {
+		value = *p_value;
+	} else if(zend_hash_find(EG(zend_constants), key, name_len + 1, (void **) &zconst) == SUCCESS) {
+		value = &zconst->value;
+	}
+	efree(key);
+
+	crc64 = qb_calculate_crc64((const uint8_t *) name, name_len, crc64 ^ 0x12F45678);
+	if(value) {
+		uint8_t type = Z_TYPE_P(value);
+		crc64 = qb_calculate_crc64(&type, sizeof(type), crc64);
+		switch(Z_TYPE_P(value)) {
+			case IS_BOOL:
+			case IS_LONG: crc64 = qb_calculate_crc64((const uint8_t *) &Z_LVAL_P(value), sizeof(long), crc64); break;
+			case IS_DOUBLE: crc64 = qb_calculate_crc64((const uint8_t *) &Z_DVAL_P(value), sizeof(double), crc64); break;
+			case IS_STRING:
+			case IS_CONSTANT: crc64 = qb_calculate_crc64((const uint8_t *) Z_STRVAL_P(value), Z_STRLEN_P(value), crc64); break;
+		}
+	}
+	return crc64;
+}
+
+static uint64_t qb_add_doc_comment_constants_to_key(const char *doc_comment, uint32_t doc_comment_len, zend_class_entry *ce, uint64_t crc64 TSRMLS_DC) {
+	// array dimensions can be given as constants (e.g. float32[WIDTH][HEIGHT])
+	uint32_t i = 0;
+	int32_t in_brackets = FALSE;
+	while(i < doc_comment_len) {
+		char c = doc_comment[i];
+		if(c == '[') {
+			in_brackets = TRUE;
+		} else if(c == ']') {
+			in_brackets = FALSE;
+		} else if(in_brackets && (isalpha((unsigned char) c) || c == '_')) {
+			uint32_t start = i;
+			while(i < doc_comment_len && (isalnum((unsigned char) doc_comment[i]) || doc_comment[i] == '_')) {
+				i++;
+			}
+			crc64 = qb_add_constant_to_key(doc_comment + start, i - start, ce, crc64 TSRMLS_CC);
+			continue;
+		}
+		i++;
+	}
+	return crc64;
+}
+
+static uint64_t qb_add_fetched_constants_to_key(zend_op_array *op_array, uint64_t crc64 TSRMLS_DC) {
+	// constants are folded into the code when it's translated, so their current values matter
+	uint32_t i;
+	for(i = 0; i < op_array->last; i++) {
+		zend_op *zop = &op_array->opcodes[i];
+		if(zop->opcode == ZEND_FETCH_CONSTANT && Z_OPERAND_TYPE(zop->op2) == Z_OPERAND_CONST) {
+			zval *name = Z_OPERAND_ZV(zop->op2);
+			if(Z_TYPE_P(name) == IS_STRING) {
+				zend_class_entry *ce = (Z_OPERAND_TYPE(zop->op1) != Z_OPERAND_UNUSED) ? op_array->scope : NULL;
+				const char *short_name = zend_memrchr(Z_STRVAL_P(name), '\\', Z_STRLEN_P(name));
+				crc64 = qb_add_constant_to_key(Z_STRVAL_P(name), Z_STRLEN_P(name), ce, crc64 TSRMLS_CC);
+				if(short_name) {
+					// an unqualified name in a namespace falls back to the global constant
+					short_name++;
+					crc64 = qb_add_constant_to_key(short_name, Z_STRLEN_P(name) - (uint32_t) (short_name - Z_STRVAL_P(name)), NULL, crc64 TSRMLS_CC);
+				}
+			}
+		}
+	}
+	return crc64;
+}
+
+static uint64_t qb_calculate_source_key(zend_op_array *op_array TSRMLS_DC) {
+	uint64_t crc64 = 0;
+	uint32_t settings[7];
+
+	// the location of the function
+	crc64 = qb_calculate_crc64((const uint8_t *) op_array->filename, strlen(op_array->filename), crc64);
+	crc64 = qb_calculate_crc64((const uint8_t *) &op_array->line_start, sizeof(op_array->line_start), crc64 ^ 0x1234567F);
+	crc64 = qb_calculate_crc64((const uint8_t *) &op_array->line_end, sizeof(op_array->line_end), crc64);
+	if(op_array->function_name) {
+		crc64 = qb_calculate_crc64((const uint8_t *) op_array->function_name, strlen(op_array->function_name), crc64 ^ 0x123456F8);
+	}
+	if(op_array->doc_comment) {
+		crc64 = qb_calculate_crc64((const uint8_t *) op_array->doc_comment, op_array->doc_comment_len, crc64 ^ 0x12345F78);
+		crc64 = qb_add_doc_comment_constants_to_key(op_array->doc_comment, op_array->doc_comment_len, op_array->scope, crc64 TSRMLS_CC);
+	}
+	if(op_array->scope) {
+		zend_class_entry *ce = op_array->scope;
+		crc64 = qb_calculate_crc64((const uint8_t *) ce->name, ce->name_length, crc64 ^ 0x1234F678);
+		if(ce->type == ZEND_USER_CLASS && Z_CLASS_INFO(ce, doc_comment)) {
+			crc64 = qb_calculate_crc64((const uint8_t *) Z_CLASS_INFO(ce, doc_comment), Z_CLASS_INFO(ce, doc_comment_len), crc64);
+			crc64 = qb_add_doc_comment_constants_to_key(Z_CLASS_INFO(ce, doc_comment), Z_CLASS_INFO(ce, doc_comment_len), ce, crc64 TSRMLS_CC);
+		}
+	}
+	crc64 = qb_add_fetched_constants_to_key(op_array, crc64 TSRMLS_CC);
+
+	// settings that affect how the code is translated
+	settings[0] = QB_G(column_major_matrix);
+	settings[1] = QB_G(allow_debugger_inspection);
+	settings[2] = QB_G(debug_with_exact_type);
+	settings[3] = QB_G(compile_to_native);
+	settings[4] = QB_G(allow_native_compilation);
+	settings[5] = (uint32_t) sizeof(void *);
+	settings[6] = QB_G(force_bound_checks);
+	crc64 = qb_calculate_crc64((const uint8_t *) settings, sizeof(settings), crc64 ^ 0x123F5678);
+	return crc64;
+}
+
+static int32_t qb_get_source_mtime(zend_op_array *op_array, int64_t *p_mtime TSRMLS_DC) {
+	struct stat sb;
+	if(VCWD_STAT(op_array->filename, &sb) == 0) {
+		*p_mtime = (int64_t) sb.st_mtime;
+		return TRUE;
+	}
+	return FALSE;
+}
+
+static char * qb_get_cache_file_path(uint64_t source_key TSRMLS_DC) {
+	char *path;
+	spprintf(&path, 0, "%s%cQB%016" PRIX64 ".qbc", QB_G(bytecode_cache_path), PHP_DIR_SEPARATOR, source_key);
+	return path;
+}
+
+static uint32_t * qb_get_next_line_id_pointer(int8_t **p_ip, qb_opcode opcode) {
+	// the line id, if there's one, is always placed at the end of an instruction
+	uint32_t op_flags = qb_get_op_flags(opcode);
+	uint32_t instruction_length = qb_get_instruction_length(opcode);
+	int8_t *ip = *p_ip;
+	*p_ip += instruction_length;
+	if(op_flags & QB_OP_NEED_LINE_IDENTIFIER) {
+		return (uint32_t *) (ip + instruction_length - sizeof(uint32_t));
+	}
+	return NULL;
+}
+
+static int32_t qb_is_cacheable(qb_function *qfunc, uint32_t source_file_id) {
+	int8_t *ip = qfunc->instructions + sizeof(void *);
+	uint32_t i;
+
+	if(qfunc->flags & QB_FUNCTION_CLOSURE) {
+		return FALSE;
+	}
+
+	for(i = 0; i < qfunc->variable_count; i++) {
+		qb_variable *qvar = qfunc->variables[i];
+		// class variables from other classes can't be resolved on reload
+		if(qvar->zend_class && qvar->zend_class != qfunc->zend_op_array->scope) {
+			return FALSE;
+		}
+		if(qvar->address && qvar->address->index_alias_schemes) {
+			uint32_t j;
+			for(j = 0; j < qvar->address->dimension_count; j++) {
+				qb_index_alias_scheme *scheme = qvar->address->index_alias_schemes[j];
+				if(scheme && scheme->zend_class && scheme->zend_class != qfunc->zend_op_array->scope) {
+					return FALSE;
+				}
+			}
+		}
+	}
+
+	for(i = 0; i < qfunc->instruction_opcode_count; i++) {
+		qb_opcode opcode = qfunc->instruction_opcodes[i];
+		uint32_t *p_line_id;
+
+		// function calls refer to the external symbol table, which is rebuilt on every request
+		if(opcode == QB_FCALL_U32_U32_U32) {
+			return FALSE;
+		}
+
+		// code inlined from a different file has line ids pointing to that file
+		p_line_id = qb_get_next_line_id_pointer(&ip, opcode);
+		if(p_line_id) {
+			uint32_t file_id = FILE_ID(*p_line_id);
+			if(file_id != 0 && file_id != source_file_id) {
+				return FALSE;
+			}
+		}
+	}
+	return TRUE;
+}
+
+static uint64_t qb_calculate_content_crc64(int8_t *function_block, uint32_t function_block_size, int8_t *storage_block, uint32_t storage_block_size, int8_t *instruction_block, uint32_t instruction_block_size) {
+	uint64_t crc64 = 0;
+	crc64 = qb_calculate_crc64((uint8_t *) function_block, function_block_size, crc64);
+	crc64 = qb_calculate_crc64((uint8_t *) storage_block, storage_block_size, crc64 ^ 0x1234567F);
+	crc64 = qb_calculate_crc64((uint8_t *) instruction_block, instruction_block_size, crc64 ^ 0x123456F8);
+	return crc64;
+}
+
+void qb_save_cached_function(qb_encoder_context *encoder_cxt, qb_function *qfunc TSRMLS_DC) {
+	zend_op_array *op_array = qfunc->zend_op_array;
+	qb_function_cache_header header;
+	char *file_path, *temp_file_path;
+	FILE *file;
+	int32_t success = FALSE;
+
+	if(!QB_G(bytecode_cache_path)[0] || !op_array || !op_array->filename) {
+		return;
+	}
+	if(qfunc->flags & QB_FUNCTION_INITIALIZED) {
+		// the function has to be saved before it's relocated
+		return;
+	}
+	if((qfunc->flags & QB_FUNCTION_NATIVE_IF_POSSIBLE) && QB_G(allow_native_compilation)) {
+		// native code is attached during the build, so the function has to go through it
+		return;
+	}
+
+	memset(&header, 0, sizeof(qb_function_cache_header));
+	header.source_file_id = qb_get_source_file_id(op_array->filename TSRMLS_CC);
+	if(!qb_is_cacheable(qfunc, header.source_file_id)) {
+		return;
+	}
+	if(!qb_get_source_mtime(op_array, &header.source_mtime TSRMLS_CC)) {
+		return;
+	}
+	header.signature = QB_FUNCTION_CACHE_SIGNATURE;
+	header.qb_version = QB_VERSION_SIGNATURE;
+	header.pointer_size = sizeof(void *);
+	header.source_key = qb_calculate_source_key(op_array TSRMLS_CC);
+	header.instruction_crc64 = qfunc->instruction_crc64;
+	header.function_structure_size = encoder_cxt->function_structure_size;
+	header.storage_structure_size = qfunc->local_storage->size;
+	header.instruction_stream_size = (uint32_t) ((int8_t *) (qfunc->instruction_relocations + qfunc->instruction_relocation_count) - qfunc->instructions);
+	header.function_address = (uintptr_t) qfunc;
+	header.storage_address = (uintptr_t) qfunc->local_storage;
+	header.instruction_address = (uintptr_t) qfunc->instructions;
+	header.scope_address = (uintptr_t) op_array->scope;
+	header.content_crc64 = qb_calculate_content_crc64((int8_t *) qfunc, header.function_structure_size, (int8_t *) qfunc->local_storage, header.storage_structure_size, qfunc->instructions, header.instruction_stream_size);
+
+	VCWD_MKDIR(QB_G(bytecode_cache_path), 0777);
+	file_path = qb_get_cache_file_path(header.source_key TSRMLS_CC);
+
+	// write to a temporary file first, so other processes never see a partial file
+	spprintf(&temp_file_path, 0, "%s.%d", file_path, (int) getpid());
+	file = VCWD_FOPEN(temp_file_path, "wb");
+	if(file) {
+		if(fwrite(&header, sizeof(qb_function_cache_header), 1, file) == 1
+		&& fwrite(qfunc, header.function_structure_size, 1, file) == 1
+		&& fwrite(qfunc->local_storage, header.storage_structure_size, 1, file) == 1
+		&& fwrite(qfunc->instructions, header.instruction_stream_size, 1, file) == 1) {
+			success = TRUE;
+		}
+		if(fclose(file) != 0) {
+			success = FALSE;
+		}
+		if(success) {
+			VCWD_UNLINK(file_path);
+			success = (VCWD_RENAME(temp_file_path, file_path) == 0);
+		}
+		if(!success) {
+			VCWD_UNLINK(temp_file_path);
+		}
+	}
+	efree(temp_file_path);
+	efree(file_path);
+}
+
+static zval * qb_find_default_value(zend_op_array *op_array, uint32_t argument_number) {
+	uint32_t i;
+	for(i = 0; i < op_array->last; i++) {
+		zend_op *zop = &op_array->opcodes[i];
+		if(zop->opcode == ZEND_RECV_INIT) {
+#if !ZEND_ENGINE_2_3 && !ZEND_ENGINE_2_2 && !ZEND_ENGINE_2_1
+			uint32_t number = Z_OPERAND_INFO(zop->op1, num);
+#else
+			uint32_t number = Z_LVAL_P(Z_OPERAND_ZV(zop->op1));
+#endif
+			if(number == argument_number) {
+				return Z_OPERAND_ZV(zop->op2);
+			}
+		}
+	}
+	return NULL;
+}
+
+static zend_class_entry * qb_relink_class(zend_class_entry *ce, qb_function_cache_header *header, zend_op_array *op_array) {
+	if(ce) {
+		if((uintptr_t) ce == header->scope_address) {
+			return op_array->scope;
+		}
+	}
+	return NULL;
+}
+
+static void qb_relink_address(qb_address *address, intptr_t shift, qb_function_cache_header *header, zend_op_array *op_array) {
+	uint32_t i, j;
+
+	// these only exist during compilation
+	address->source_address = NULL;
+	address->expression = NULL;
+
+	if(SCALAR(address)) {
+		// dimension addresses are shallow copies, so their pointers could be stale
+		address->array_index_address = NULL;
+		address->array_size_address = NULL;
+		address->dimension_addresses = NULL;
+		address->array_size_addresses = NULL;
+		address->index_alias_schemes = NULL;
+		return;
+	}
+
+	if(address->dimension_count > 1) {
+		SHIFT_POINTER(address->dimension_addresses, shift);
+		SHIFT_POINTER(address->array_size_addresses, shift);
+		for(i = 0; i < address->dimension_count; i++) {
+			SHIFT_POINTER(address->dimension_addresses[i], shift);
+			qb_relink_address(address->dimension_addresses[i], shift, header, op_array);
+			if(i == address->dimension_count - 1) {
+				address->array_size_addresses[i] = address->dimension_addresses[i];
+			} else {
+				SHIFT_POINTER(address->array_size_addresses[i], shift);
+				qb_relink_address(address->array_size_addresses[i], shift, header, op_array);
+			}
+		}
+		address->array_size_address = address->array_size_addresses[0];
+	} else {
+		address->dimension_addresses = &address->array_size_address;
+		address->array_size_addresses = &address->array_size_address;
+		SHIFT_POINTER(address->array_size_address, shift);
+		qb_relink_address(address->array_size_address, shift, header, op_array);
+	}
+	if(address->array_index_address) {
+		SHIFT_POINTER(address->array_index_address, shift);
+		qb_relink_address(address->array_index_address, shift, header, op_array);
+	}
+	if(address->index_alias_schemes) {
+		SHIFT_POINTER(address->index_alias_schemes, shift);
+		for(i = 0; i < address->dimension_count; i++) {
+			if(address->index_alias_schemes[i]) {
+				qb_index_alias_scheme *scheme;
+				SHIFT_POINTER(address->index_alias_schemes[i], shift);
+				scheme = address->index_alias_schemes[i];
+				SHIFT_POINTER(scheme->aliases, shift);
+				SHIFT_POINTER(scheme->alias_lengths, shift);
+				for(j = 0; j < scheme->dimension; j++) {
+					SHIFT_POINTER(scheme->aliases[j], shift);
+				}
+				if(scheme->class_name) {
+					SHIFT_POINTER(scheme->class_name, shift);
+				}
+				scheme->zend_class = qb_relink_class(scheme->zend_class, header, op_array);
+			}
+		}
+	}
+}
+
+static void qb_relink_function(qb_function *qfunc, qb_function_cache_header *header, zend_op_array *op_array) {
+	intptr_t shift = (uintptr_t) qfunc - header->function_address;
+	uint32_t i;
+
+	SHIFT_POINTER(qfunc->variables, shift);
+	for(i = 0; i < qfunc->variable_count; i++) {
+		qb_variable *qvar;
+		SHIFT_POINTER(qfunc->variables[i], shift);
+		qvar = qfunc->variables[i];
+		if(qvar->name) {
+			SHIFT_POINTER(qvar->name, shift);
+		}
+		if(qvar->address) {
+			SHIFT_POINTER(qvar->address, shift);
+			qb_relink_address(qvar->address, shift, header, op_array);
+		}
+		qvar->zend_class = qb_relink_class(qvar->zend_class, header, op_array);
+		if(qvar->default_value) {
+			qvar->default_value = qb_find_default_value(op_array, i + 1);
+		}
+		qvar->value = NULL;
+		qvar->value_pointer = NULL;
+	}
+	if(qfunc->return_variable) {
+		SHIFT_POINTER(qfunc->return_variable, shift);
+	}
+	if(qfunc->return_key_variable) {
+		SHIFT_POINTER(qfunc->return_key_variable, shift);
+	}
+	if(qfunc->sent_variable) {
+		SHIFT_POINTER(qfunc->sent_variable, shift);
+	}
+	qfunc->name = op_array->function_name;
+	qfunc->zend_op_array = op_array;
+	qfunc->native_proc = NULL;
+	qfunc->next_reentrance_copy = NULL;
+	qfunc->next_forked_copy = NULL;
+	qfunc->in_use = 0;
+	qfunc->profile = NULL;
+}
+
+static void qb_realign_preallocated_segments(qb_storage *storage) {
+	int8_t *structure_end = (int8_t *) &storage->segments[storage->segment_count];
+	int8_t *region_start = NULL, *region_end = NULL, *aligned_start;
+	intptr_t shift;
+	uint32_t i;
+
+	// find where the structure ends and where the preallocated segments are
+	for(i = 0; i < storage->segment_count; i++) {
+		qb_memory_segment *segment = &storage->segments[i];
+		if(segment->references && (int8_t *) (segment->references + segment->reference_count) > structure_end) {
+			structure_end = (int8_t *) (segment->references + segment->reference_count);
+		}
+		if(segment->flags & QB_SEGMENT_PREALLOCATED) {
+			if(!region_start || segment->memory < region_start) {
+				region_start = segment->memory;
+			}
+			if(!region_end || segment->memory + segment->current_allocation > region_end) {
+				region_end = segment->memory + segment->current_allocation;
+			}
+		}
+	}
+
+	// the SIMD handlers expect the segments to be 16-byte aligned, as qb_preallocate_segments() had placed them;
+	// the storage structure was allocated with 16 bytes of padding, so moving them up to the boundary after the
+	// structure will not go past the end of the block
+	aligned_start = (int8_t *) ALIGN_TO((uintptr_t) structure_end, 16);
+	if(region_start && region_start != aligned_start) {
+		shift = aligned_start - region_start;
+		memmove(aligned_start, region_start, region_end - region_start);
+		for(i = 0; i < storage->segment_count; i++) {
+			qb_memory_segment *segment = &storage->segments[i];
+			if(segment->flags & QB_SEGMENT_PREALLOCATED) {
+				SHIFT_POINTER(segment->memory, shift);
+			}
+		}
+	}
+}
+
+static void qb_relink_storage(qb_storage *storage, qb_function_cache_header *header) {
+	intptr_t shift = (uintptr_t) storage - header->storage_address;
+	uint32_t i;
+
+	SHIFT_POINTER(storage->segments, shift);
+	for(i = 0; i < storage->segment_count; i++) {
+		qb_memory_segment *segment = &storage->segments[i];
+		if(segment->memory) {
+			SHIFT_POINTER(segment->memory, shift);
+		}
+		if(segment->references) {
+			// the references themselves are relative to the placeholder
+			// base address and will be fixed by qb_relocate_function()
+			SHIFT_POINTER(segment->references, shift);
+		}
+		segment->stream = NULL;
+		segment->imported_segment = NULL;
+		segment->next_dependent = NULL;
+	}
+	qb_realign_preallocated_segments(storage);
+}
+
+static void qb_relink_line_ids(qb_function *qfunc, uint32_t old_file_id, uint32_t new_file_id) {
+	int8_t *ip = qfunc->instructions + sizeof(void *);
+	uint32_t i;
+
+	if(old_file_id != new_file_id) {
+		for(i = 0; i < qfunc->instruction_opcode_count; i++) {
+			uint32_t *p_line_id = qb_get_next_line_id_pointer(&ip, qfunc->instruction_opcodes[i]);
+			if(p_line_id && FILE_ID(*p_line_id) == old_file_id) {
+				*p_line_id = LINE_ID(new_file_id, LINE_NUMBER(*p_line_id));
+			}
+			if(FILE_ID(qfunc->instruction_line_ids[i]) == old_file_id) {
+				qfunc->instruction_line_ids[i] = LINE_ID(new_file_id, LINE_NUMBER(qfunc->instruction_line_ids[i]));
+			}
+		}
+		if(FILE_ID(qfunc->line_id) == old_file_id) {
+			qfunc->line_id = LINE_ID(new_file_id, LINE_NUMBER(qfunc->line_id));
+		}
+	}
+}
+
+qb_function * qb_load_cached_function(zend_op_array *op_array TSRMLS_DC) {
+	qb_function_cache_header header;
+	qb_function *qfunc = NULL;
+	int8_t *function_block = NULL, *storage_block = NULL, *instruction_block = NULL;
+	uint64_t source_key;
+	int64_t source_mtime;
+	char *file_path;
+	FILE *file;
+
+	if(!QB_G(bytecode_cache_path)[0] || !op_array->filename) {
+		return NULL;
+	}
+#ifdef ZEND_ACC_CLOSURE
+	if(op_array->fn_flags & ZEND_ACC_CLOSURE) {
+		return NULL;
+	}
+#endif
+	if(!qb_get_source_mtime(op_array, &source_mtime TSRMLS_CC)) {
+		return NULL;
+	}
+
+	source_key = qb_calculate_source_key(op_array TSRMLS_CC);
+	file_path = qb_get_cache_file_path(source_key TSRMLS_CC);
+	file = VCWD_FOPEN(file_path, "rb");
+	efree(file_path);
+	if(!file) {
+		return NULL;
+	}
+
+	if(fread(&header, sizeof(qb_function_cache_header), 1, file) == 1
+	&& header.signature == QB_FUNCTION_CACHE_SIGNATURE
+	&& header.qb_version == QB_VERSION_SIGNATURE
+	&& header.pointer_size == sizeof(void *)
+	&& header.source_key == source_key
+	&& header.source_mtime == source_mtime) {
+		function_block = emalloc(header.function_structure_size);
+		storage_block = emalloc(header.storage_structure_size);
+		instruction_block = emalloc(header.instruction_stream_size);
+		if(fread(function_block, header.function_structure_size, 1, file) == 1
+		&& fread(storage_block, header.storage_structure_size, 1, file) == 1
+		&& fread(instruction_block, header.instruction_stream_size, 1, file) == 1
+		&& qb_calculate_content_crc64(function_block, header.function_structure_size, storage_block, header.storage_structure_size, instruction_block, header.instruction_stream_size) == header.content_crc64) {
+			qfunc = (qb_function *) function_block;
+			qfunc->instructions = instruction_block;
+			qfunc->instruction_opcodes = (uint16_t *) (instruction_block + qfunc->instruction_length);
+			qfunc->instruction_line_ids = (uint32_t *) (instruction_block + qfunc->instruction_length + ALIGN_TO(sizeof(uint16_t) * qfunc->instruction_opcode_count, sizeof(uint32_t)));
+			qfunc->instruction_relocations = (qb_instruction_relocation *) (qfunc->instruction_line_ids + qfunc->instruction_opcode_count);
+			qfunc->local_storage = (qb_storage *) storage_block;
+			qb_relink_function(qfunc, &header, op_array);
+			qb_relink_storage(qfunc->local_storage, &header);
+			qb_relink_line_ids(qfunc, header.source_file_id, qb_get_source_file_id(op_array->filename TSRMLS_CC));
+		} else {
+			efree(function_block);
+			efree(storage_block);
+			efree(instruction_block);
+		}
+	}
+	fclose(file);
+
+	if(qfunc) {
+		// the handlers are stored as opcode numbers; the addresses have to be available before relocation
+		qb_initialize_op_handlers();
+
+		// the cached function is position-independent, so it can be relocated like a freshly encoded one
+		qb_relocate_function(qfunc, TRUE);
+	}
+	return qfunc;
+}
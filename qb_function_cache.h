@@ -0,0 +1,54 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 5                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2012 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Chung Leong <cleong@cal.berkeley.edu>                        |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifndef QB_FUNCTION_CACHE_H_
+#define QB_FUNCTION_CACHE_H_
+
+typedef struct qb_function_cache_header		qb_function_cache_header;
+
+#define QB_FUNCTION_CACHE_SIGNATURE			0x47425151		// "QQBG"
+
+struct qb_function_cache_header {
+	uint32_t signature;
+	uint32_t qb_version;
+	uint32_t pointer_size;
+	uint32_t source_file_id;
+	uint64_t source_key;
+	int64_t source_mtime;
+	uint64_t instruction_crc64;
+	uint64_t content_crc64;
+
+	// sizes of the three blocks allocated by qb_encode_function()
+	uint32_t function_structure_size;
+	uint32_t storage_structure_size;
+	uint32_t instruction_stream_size;
+	uint32_t reserved;
+
+	// addresses of the blocks and of the class scope at the time they were saved
+	uintptr_t function_address;
+	uintptr_t storage_address;
+	uintptr_t instruction_address;
+	uintptr_t scope_address;
+};
+
+qb_function * qb_load_cached_function(zend_op_array *op_array TSRMLS_DC);
+void qb_save_cached_function(qb_encoder_context *encoder_cxt, qb_function *qfunc TSRMLS_DC);
+
+#endif
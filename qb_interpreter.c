@@ -543,6 +543,11 @@ static qb_function * qb_acquire_function(qb_function *base, int32_t reentrance)
 			}
 		}
 	}
+#ifdef NATIVE_COMPILE_ENABLED
+	// native code might have become available after the copy was made
+	// (forks need to run the same code as the function they're forked from)
+	f->native_proc = base->native_proc;
+#endif
 	return f;
 }
 
@@ -571,6 +576,12 @@ void qb_initialize_interpreter_context(qb_interpreter_context *cxt, qb_function
 	cxt->result_index = 0;
 	cxt->line_id = 0;
 	cxt->shadow_variables = NULL;
+	cxt->profile = NULL;
+	cxt->profile_instruction_index = INVALID_INDEX;
+	cxt->fork_loop_counters = NULL;
+	cxt->fork_loop_index = 0;
+	cxt->next_fork_iteration = 0;
+	cxt->fork_chunk_end = 0;
 #ifdef ZEND_WIN32
 	cxt->windows_timed_out_pointer = &EG(timed_out);
 #endif
@@ -611,6 +622,13 @@ static void qb_fork_execution(qb_interpreter_context *cxt) {
 	qb_function *function = cxt->function;
 	uint32_t original_fork_id = cxt->fork_id;
 	uint32_t original_thread_count = cxt->thread_count;
+	qb_function_profile *original_profile = cxt->profile;
+	uint32_t original_profile_instruction_index = cxt->profile_instruction_index;
+	volatile long *original_fork_loop_counters = cxt->fork_loop_counters;
+	uint32_t original_fork_loop_index = cxt->fork_loop_index;
+	uint32_t original_next_fork_iteration = cxt->next_fork_iteration;
+	uint32_t original_fork_chunk_end = cxt->fork_chunk_end;
+	volatile long fork_loop_counters[QB_FORK_LOOP_COUNTER_COUNT];
 	uint32_t i, fork_id, fork_count, function_count, new_context_count, remaining_thread_count;
 	intptr_t instr_offset = cxt->instruction_pointer - cxt->function->instructions;
 	int32_t reusing_original_cxt = 1;
@@ -637,6 +655,9 @@ static void qb_fork_execution(qb_interpreter_context *cxt) {
 		remaining_thread_count = 0;
 	}
 
+	// each fork_next() loop in the forked section gets its own counter
+	memset((void *) fork_loop_counters, 0, sizeof(fork_loop_counters));
+
 	// initialize the group, allocating extra memory for new interpreter contexts
 	group = qb_allocate_task_group(fork_count, sizeof(qb_interpreter_context) * new_context_count);
 	fork_contexts = group->extra_memory;
@@ -672,6 +693,12 @@ static void qb_fork_execution(qb_interpreter_context *cxt) {
 			fork_cxt->floating_point_precision = cxt->floating_point_precision;
 			fork_cxt->send_target = NULL;
 			fork_cxt->shadow_variables = cxt->shadow_variables;
+			fork_cxt->profile = NULL;
+			fork_cxt->profile_instruction_index = INVALID_INDEX;
+			fork_cxt->fork_loop_counters = fork_loop_counters;
+			fork_cxt->fork_loop_index = 0;
+			fork_cxt->next_fork_iteration = 0;
+			fork_cxt->fork_chunk_end = 0;
 #ifdef ZTS
 			fork_cxt->tsrm_ls = tsrm_ls;
 #endif
@@ -680,10 +707,17 @@ static void qb_fork_execution(qb_interpreter_context *cxt) {
 		}
 	}
 
+	// the time spent in the forks is charged to the fork instruction
+	cxt->profile = NULL;
+
 	if(reusing_original_cxt) {
 		// schedule the first worker
 		cxt->fork_id = 0;
 		cxt->thread_count = remaining_thread_count;
+		cxt->fork_loop_counters = fork_loop_counters;
+		cxt->fork_loop_index = 0;
+		cxt->next_fork_iteration = 0;
+		cxt->fork_chunk_end = 0;
 		qb_add_task(group, qb_execute_in_worker_thread, cxt, NULL, 0);
 	}
 
@@ -694,6 +728,10 @@ static void qb_fork_execution(qb_interpreter_context *cxt) {
 		// restore variables in the original context
 		cxt->fork_id = original_fork_id;
 		cxt->thread_count = original_thread_count;
+		cxt->fork_loop_counters = original_fork_loop_counters;
+		cxt->fork_loop_index = original_fork_loop_index;
+		cxt->next_fork_iteration = original_next_fork_iteration;
+		cxt->fork_chunk_end = original_fork_chunk_end;
 
 		// fix up the ip as well
 		cxt->instruction_pointer += (intptr_t) cxt->function->instructions;
@@ -711,6 +749,8 @@ static void qb_fork_execution(qb_interpreter_context *cxt) {
 		}
 	}
 	cxt->fork_count = 0;
+	cxt->profile = original_profile;
+	cxt->profile_instruction_index = original_profile_instruction_index;
 
 	if(new_context_count > 0) {
 		// free the new interpreter contexts
@@ -861,7 +901,7 @@ static void qb_finalize_variables(qb_interpreter_context *cxt) {
 	for(i = QB_SELECTOR_ARRAY_START; i < cxt->function->local_storage->segment_count; i++) {
 		qb_memory_segment *segment = &cxt->function->local_storage->segments[i];
 		if(segment->flags & QB_SEGMENT_FREE_ON_RETURN) {
-			qb_release_segment(segment);
+			qb_recycle_segment(segment);
 			if(segment->flags & QB_SEGMENT_EMPTY_ON_RETURN) {
 				segment->byte_count = 0;
 			}
@@ -881,8 +921,13 @@ int32_t qb_execute(qb_interpreter_context *cxt) {
 	if(qb_initialize_local_variables(cxt)) {
 		// copy values from arguments, class variables, object variables, and global variables
 		if(qb_transfer_variables_from_external_sources(cxt)) {
+			int32_t completed;
+
 			// enter the vm
-			if(qb_execute_in_current_thread(cxt)) {
+			qb_begin_function_profiling(cxt);
+			completed = qb_execute_in_current_thread(cxt);
+			qb_end_function_profiling(cxt);
+			if(completed) {
 				// move values back into caller space
 				if(qb_transfer_variables_to_external_sources(cxt)) {
 					success = TRUE;
@@ -897,13 +942,272 @@ int32_t qb_execute(qb_interpreter_context *cxt) {
 	return success;
 }
 
+static int32_t qb_transfer_arguments_from_zvals(qb_interpreter_context *cxt, zval **arguments, uint32_t argument_count) {
+	USE_TSRM
+	int32_t result = TRUE;
+	uint32_t i;
+
+	for(i = 0; i < cxt->function->argument_count; i++) {
+		qb_variable *qvar = cxt->function->variables[i];
+		uint32_t transfer_flags = 0;
+		if(READ_ONLY(qvar->address) && !(qvar->flags & QB_VARIABLE_BY_REF)) {
+			// the zvals are referenced until the call ends, so PHP will separate them before making changes
+			transfer_flags = QB_TRANSFER_CAN_BORROW_MEMORY;
+		}
+
+		if(i < argument_count) {
+			if(!qb_transfer_value_from_zval(cxt->function->local_storage, qvar->address, arguments[i], transfer_flags)) {
+				uint32_t line_id = qb_get_zend_line_id(TSRMLS_C);
+				qb_set_exception_line_id(line_id TSRMLS_CC);
+				result = FALSE;
+			}
+		} else {
+			if(qvar->default_value) {
+				if(!qb_transfer_value_from_zval(cxt->function->local_storage, qvar->address, qvar->default_value, transfer_flags)) {
+					uint32_t line_id = qb_get_zend_line_id(TSRMLS_C);
+					qb_set_exception_line_id(line_id TSRMLS_CC);
+					result = FALSE;
+				}
+			} else {
+				const char *class_name = (cxt->function->zend_op_array->scope) ? cxt->function->zend_op_array->scope->name : NULL;
+				uint32_t caller_line_id = qb_get_zend_line_id(TSRMLS_C);
+				qb_report_missing_argument_exception(cxt->function->line_id, class_name, cxt->function->name, i, caller_line_id);
+				result = FALSE;
+			}
+		}
+	}
+	return result;
+}
+
+static void qb_release_async_call_arguments(qb_async_call *call) {
+	uint32_t i;
+	for(i = 0; i < call->argument_count; i++) {
+		zval_ptr_dtor(&call->arguments[i]);
+	}
+	if(call->arguments) {
+		efree(call->arguments);
+		call->arguments = NULL;
+	}
+	call->argument_count = 0;
+}
+
+static void qb_execute_async_call_in_worker_thread(void *param1, void *param2, int param3) {
+	qb_async_call *call = param1;
+	call->success = qb_execute_in_current_thread(&call->context);
+}
+
+int32_t qb_start_async_call(qb_async_call *call, qb_function *qfunc, zval **arguments, uint32_t argument_count TSRMLS_DC) {
+	qb_interpreter_context *cxt = &call->context;
+
+	// the call takes over the references to the arguments
+	call->arguments = arguments;
+	call->argument_count = argument_count;
+	call->group = NULL;
+	call->return_value = NULL;
+	call->success = FALSE;
+	call->finished = FALSE;
+	call->released = FALSE;
+
+	// everything that requires the Zend engine happens here in the main thread
+	qb_initialize_interpreter_context(cxt, qfunc, NULL TSRMLS_CC);
+	if(qb_initialize_local_variables(cxt)) {
+		if(qb_transfer_arguments_from_zvals(cxt, arguments, argument_count)) {
+			call->group = qb_allocate_task_group(1, 0);
+			qb_add_task(call->group, qb_execute_async_call_in_worker_thread, call, NULL, 0);
+			qb_start_task_group(call->group);
+			return TRUE;
+		}
+		qb_finalize_variables(cxt);
+	}
+	qb_free_interpreter_context(cxt);
+	qb_release_async_call_arguments(call);
+	call->finished = TRUE;
+	qb_dispatch_exceptions(TSRMLS_C);
+	return FALSE;
+}
+
+int32_t qb_is_async_call_completed(qb_async_call *call) {
+	return call->finished || qb_is_task_group_completed(call->group);
+}
+
+int32_t qb_finish_async_call(qb_async_call *call TSRMLS_DC) {
+	if(!call->finished) {
+		qb_interpreter_context *cxt = &call->context;
+
+		// the worker might need the main thread for a while (to report errors, for instance)
+		qb_wait_for_task_group(call->group);
+		qb_free_task_group(call->group);
+		call->group = NULL;
+
+		if(call->success) {
+			// copy the result back into PHP space
+			ALLOC_INIT_ZVAL(call->return_value);
+			if(cxt->function->return_variable->address) {
+				if(!qb_transfer_value_to_zval(cxt->function->local_storage, cxt->function->return_variable->address, call->return_value)) {
+					uint32_t line_id = qb_get_zend_line_id(TSRMLS_C);
+					qb_set_exception_line_id(line_id TSRMLS_CC);
+					call->success = FALSE;
+				}
+			}
+		}
+		qb_finalize_variables(cxt);
+		qb_free_interpreter_context(cxt);
+		qb_release_async_call_arguments(call);
+		call->finished = TRUE;
+		qb_dispatch_exceptions(TSRMLS_C);
+	}
+	return call->success;
+}
+
+void qb_abandon_async_call(qb_async_call *call TSRMLS_DC) {
+	if(!call->finished) {
+		// the workers have been terminated--the function is in an unknown state so it's left locked
+		qb_free_task_group(call->group);
+		call->group = NULL;
+		qb_release_async_call_arguments(call);
+		call->finished = TRUE;
+	}
+}
+
+static void qb_execute_map_item_in_worker_thread(void *param1, void *param2, int param3) {
+	qb_interpreter_context *cxt = param1;
+	qb_map_item *item = param2;
+	item->completed = qb_execute_in_current_thread(cxt);
+}
+
+static uint32_t qb_get_map_arguments(zval *argument_set, zval **arguments, uint32_t max_argument_count) {
+	uint32_t argument_count = 0;
+	if(Z_TYPE_P(argument_set) == IS_ARRAY) {
+		// the keys are ignored--arguments are passed in the order they appear
+		HashTable *ht = Z_ARRVAL_P(argument_set);
+		HashPosition pos;
+		zval **p_zarg;
+		for(zend_hash_internal_pointer_reset_ex(ht, &pos); argument_count < max_argument_count && zend_hash_get_current_data_ex(ht, (void **) &p_zarg, &pos) == SUCCESS; zend_hash_move_forward_ex(ht, &pos)) {
+			arguments[argument_count++] = *p_zarg;
+		}
+	} else if(max_argument_count > 0) {
+		// a lone value is the only argument
+		arguments[argument_count++] = argument_set;
+	}
+	return argument_count;
+}
+
+int32_t qb_execute_map(qb_function *qfunc, HashTable *argument_sets, zval *results TSRMLS_DC) {
+	uint32_t item_count = zend_hash_num_elements(argument_sets);
+	uint32_t context_count = QB_G(thread_count), max_argument_count = qfunc->argument_count;
+	qb_interpreter_context *contexts;
+	qb_task_group *group;
+	zval **arguments;
+	qb_map_item *items;
+	int32_t success = TRUE;
+	HashPosition pos;
+	uint32_t i;
+
+	if(item_count == 0) {
+		return TRUE;
+	}
+	if(context_count < 1 || (qfunc->flags & QB_FUNCTION_HAS_BREAKPOINTS)) {
+		context_count = 1;
+	}
+	if(context_count > item_count) {
+		context_count = item_count;
+	}
+
+	// one copy of the function per thread is set up once and reused for every item it runs
+	group = qb_allocate_task_group(context_count, (sizeof(qb_interpreter_context) + sizeof(qb_map_item)) * context_count);
+	contexts = group->extra_memory;
+	items = (qb_map_item *) (contexts + context_count);
+	arguments = (max_argument_count > 0) ? emalloc(sizeof(zval *) * max_argument_count * context_count) : NULL;
+	for(i = 0; i < context_count; i++) {
+		qb_interpreter_context *cxt = &contexts[i];
+		qb_initialize_interpreter_context(cxt, qfunc, NULL TSRMLS_CC);
+		if(context_count > 1) {
+			// the items are already spread across the threads
+			cxt->thread_count = 0;
+		}
+	}
+
+	zend_hash_internal_pointer_reset_ex(argument_sets, &pos);
+	while(item_count > 0) {
+		uint32_t batch_size = (item_count < context_count) ? item_count : context_count;
+
+		// values can only be copied from and to PHP in the main thread
+		group->task_count = 0;
+		group->task_index = 0;
+		group->completion_count = 0;
+		for(i = 0; i < batch_size; i++) {
+			qb_interpreter_context *cxt = &contexts[i];
+			zval **p_argument_set, **item_arguments = arguments + max_argument_count * i;
+			uint32_t argument_count;
+
+			zend_hash_get_current_data_ex(argument_sets, (void **) &p_argument_set, &pos);
+			items[i].key_type = zend_hash_get_current_key_ex(argument_sets, &items[i].key, &items[i].key_length, &items[i].index, 0, &pos);
+			zend_hash_move_forward_ex(argument_sets, &pos);
+
+			cxt->instruction_pointer = cxt->function->instruction_start;
+			cxt->exit_type = QB_VM_RETURN;
+			cxt->exception_encountered = FALSE;
+			items[i].completed = FALSE;
+			qb_initialize_local_variables(cxt);
+			argument_count = qb_get_map_arguments(*p_argument_set, item_arguments, max_argument_count);
+			if(qb_transfer_arguments_from_zvals(cxt, item_arguments, argument_count)) {
+				qb_add_task(group, qb_execute_map_item_in_worker_thread, cxt, &items[i], 0);
+			}
+		}
+		if(group->task_count > 0) {
+			qb_run_task_group(group, FALSE);
+		}
+
+		for(i = 0; i < batch_size; i++) {
+			qb_interpreter_context *cxt = &contexts[i];
+			zval *retval;
+			ALLOC_INIT_ZVAL(retval);
+			if(items[i].completed) {
+				if(cxt->function->return_variable->address) {
+					if(!qb_transfer_value_to_zval(cxt->function->local_storage, cxt->function->return_variable->address, retval)) {
+						uint32_t line_id = qb_get_zend_line_id(TSRMLS_C);
+						qb_set_exception_line_id(line_id TSRMLS_CC);
+						success = FALSE;
+					}
+				}
+			} else {
+				success = FALSE;
+			}
+			qb_finalize_variables(cxt);
+
+			// results are keyed the same way as the argument sets
+			if(items[i].key_type == HASH_KEY_IS_STRING) {
+				add_assoc_zval_ex(results, items[i].key, items[i].key_length, retval);
+			} else {
+				add_index_zval(results, items[i].index, retval);
+			}
+		}
+		qb_dispatch_exceptions(TSRMLS_C);
+		item_count -= batch_size;
+	}
+
+	for(i = 0; i < context_count; i++) {
+		qb_free_interpreter_context(&contexts[i]);
+	}
+	if(arguments) {
+		efree(arguments);
+	}
+	qb_free_task_group(group);
+	return success;
+}
+
 #ifdef ZEND_ACC_GENERATOR
 int32_t qb_execute_resume(qb_interpreter_context *cxt) {
+	int32_t completed;
+
 	// copy variable passed by send()
 	qb_transfer_arguments_from_generator(cxt);
 
 	// enter the vm
-	if(!qb_execute_in_current_thread(cxt)) {
+	qb_begin_function_profiling(cxt);
+	completed = qb_execute_in_current_thread(cxt);
+	qb_end_function_profiling(cxt);
+	if(!completed) {
 		// there're more values still
 		qb_transfer_variables_to_generator(cxt);
 		return FALSE;
@@ -928,9 +1232,11 @@ int32_t qb_execute_rewind(qb_interpreter_context *cxt) {
 int32_t qb_execute_internal(qb_interpreter_context *cxt) {
 	int32_t success = TRUE;
 	qb_initialize_local_variables(cxt);
+	qb_begin_function_profiling(cxt);
 	if(!qb_execute_in_current_thread(cxt)) {
 		success = FALSE;
 	}
+	qb_end_function_profiling(cxt);
 	qb_finalize_variables(cxt);
 	return success;
 }
@@ -943,6 +1249,8 @@ void qb_dispatch_instruction_to_threads(qb_interpreter_context *cxt, void *contr
 
 	group->tasks = tasks;
 	group->completion_count = 0;
+	group->detached = FALSE;
+	group->token_count = 0;
 	group->task_count = 0;
 	group->task_index = 0;
 	group->owner = qb_get_current_thread();
@@ -966,6 +1274,148 @@ void qb_dispatch_instruction_to_main_thread(qb_interpreter_context *cxt, void *c
 	qb_run_in_main_thread(control_func, cxt, instruction_pointer, 0);
 }
 
+uint32_t qb_get_next_fork_iteration(qb_interpreter_context *cxt, uint32_t count) {
+	if(cxt->next_fork_iteration >= cxt->fork_chunk_end) {
+		if(cxt->fork_loop_counters && cxt->fork_loop_index < QB_FORK_LOOP_COUNTER_COUNT) {
+			// claim a chunk from the counter that the forked copies share for this loop; chunks get smaller as the work runs out,
+			// so that the copies finish at around the same time even when some iterations take longer than others
+			volatile long *counter = &cxt->fork_loop_counters[cxt->fork_loop_index];
+			long claimed = *counter;
+			uint32_t remaining = (claimed < (long) count) ? count - (uint32_t) claimed : 0;
+			uint32_t chunk_size = remaining / (cxt->fork_count * 2);
+			uint32_t end;
+			if(chunk_size == 0) {
+				chunk_size = 1;
+			}
+			end = (uint32_t) qb_atomic_add(counter, chunk_size);
+			cxt->next_fork_iteration = end - chunk_size;
+			cxt->fork_chunk_end = (end < count) ? end : count;
+			if(cxt->next_fork_iteration >= count) {
+				// the loop is finished--the next one uses the next counter
+				cxt->fork_loop_index++;
+				cxt->next_fork_iteration = cxt->fork_chunk_end = 0;
+				return count;
+			}
+		} else if(cxt->fork_loop_counters) {
+			// out of counters--take every fork_count-th iteration, starting from the fork id
+			uint32_t next = (cxt->fork_chunk_end == 0) ? cxt->fork_id : cxt->fork_chunk_end - 1 + cxt->fork_count;
+			if(next >= count) {
+				cxt->fork_loop_index++;
+				cxt->next_fork_iteration = cxt->fork_chunk_end = 0;
+				return count;
+			}
+			cxt->next_fork_iteration = next;
+			cxt->fork_chunk_end = next + 1;
+		} else {
+			// not forked--go through the iterations one by one, starting over once they're used up
+			if(cxt->fork_chunk_end == count) {
+				cxt->next_fork_iteration = cxt->fork_chunk_end = 0;
+				return count;
+			}
+			cxt->next_fork_iteration = 0;
+			cxt->fork_chunk_end = count;
+		}
+	}
+	return cxt->next_fork_iteration++;
+}
+
+typedef void (*qb_sort_proc)(void *elements, uint32_t count, uint32_t width);
+typedef void (*qb_merge_proc)(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+
+typedef struct qb_sort_range {
+	int8_t *elements;
+	int8_t *destination;
+	uint32_t count;
+	uint32_t width;
+} qb_sort_range;
+
+static void qb_sort_range_in_worker_thread(void *param1, void *param2, int param3) {
+	qb_sort_range *range = param1;
+	qb_sort_proc sort_func = (qb_sort_proc) param2;
+	sort_func(range->elements, range->count, range->width);
+}
+
+static void qb_merge_ranges_in_worker_thread(void *param1, void *param2, int param3) {
+	qb_sort_range *range1 = param1, *range2 = range1 + 1;
+	qb_merge_proc merge_func = (qb_merge_proc) param2;
+	merge_func(range1->elements, range1->count, range2->elements, range2->count, range1->destination, range1->width);
+}
+
+static void qb_initialize_sort_task_group(qb_task_group *group, qb_task *tasks) {
+	group->tasks = tasks;
+	group->completion_count = 0;
+	group->detached = FALSE;
+	group->token_count = 0;
+	group->task_count = 0;
+	group->task_index = 0;
+	group->owner = qb_get_current_thread();
+	group->extra_memory = NULL;
+	group->previous_group = NULL;
+	group->next_group = NULL;
+}
+
+int32_t qb_dispatch_sort_to_threads(qb_interpreter_context *cxt, void *sort_func, void *merge_func, void *elements, uint32_t count, uint32_t width, uint32_t element_size) {
+	qb_task_group _group, *group = &_group;
+	qb_task tasks[MAX_THREAD_COUNT];
+	qb_sort_range ranges[MAX_THREAD_COUNT];
+	uint32_t range_count = cxt->thread_count;
+	uint32_t chunk_size = (range_count) ? count / range_count : 0;
+	int8_t *buffer, *src, *dst, *temp;
+	uint32_t i;
+
+	if(range_count < 2 || chunk_size == 0) {
+		return FALSE;
+	}
+	buffer = malloc((size_t) count * element_size);
+	if(!buffer) {
+		return FALSE;
+	}
+
+	// sort a chunk of the array in each thread
+	qb_initialize_sort_task_group(group, tasks);
+	for(i = 0; i < range_count; i++) {
+		qb_sort_range *range = &ranges[i];
+		range->elements = (int8_t *) elements + (size_t) i * chunk_size * element_size;
+		range->count = (i == range_count - 1) ? count - i * chunk_size : chunk_size;
+		range->width = width;
+		qb_add_task(group, qb_sort_range_in_worker_thread, range, sort_func, 0);
+	}
+	qb_run_task_group(group, FALSE);
+
+	// merge neighboring chunks in pairs until only one is left, going back and forth between the array and the buffer
+	src = elements;
+	dst = buffer;
+	while(range_count > 1) {
+		uint32_t merged_range_count = 0;
+		qb_initialize_sort_task_group(group, tasks);
+		for(i = 0; i < range_count; i += 2) {
+			qb_sort_range *range = &ranges[i];
+			range->destination = dst + (range->elements - src);
+			if(i + 1 < range_count) {
+				qb_add_task(group, qb_merge_ranges_in_worker_thread, range, merge_func, 0);
+			} else {
+				// the odd one out gets copied
+				memcpy(range->destination, range->elements, (size_t) range->count * element_size);
+			}
+		}
+		qb_run_task_group(group, FALSE);
+		for(i = 0; i < range_count; i += 2) {
+			ranges[merged_range_count].elements = ranges[i].destination;
+			ranges[merged_range_count].count = ranges[i].count + ((i + 1 < range_count) ? ranges[i + 1].count : 0);
+			merged_range_count++;
+		}
+		range_count = merged_range_count;
+		temp = src;
+		src = dst;
+		dst = temp;
+	}
+	if(src != elements) {
+		memcpy(elements, src, (size_t) count * element_size);
+	}
+	free(buffer);
+	return TRUE;
+}
+
 static int32_t qb_invoke_zend_function(qb_interpreter_context *cxt, zend_function *zfunc, zval ***argument_pointers, uint32_t argument_count, uint32_t line_id, zval **p_retval) {
 	USE_TSRM
 	zval *retval = NULL;
@@ -21,8 +21,10 @@
 #ifndef QB_INTERPRETER_H_
 #define QB_INTERPRETER_H_
 
+typedef struct qb_async_call			qb_async_call;
 typedef struct qb_import_scope			qb_import_scope;
 typedef struct qb_interpreter_context	qb_interpreter_context;
+typedef struct qb_map_item				qb_map_item;
 typedef struct qb_native_symbol			qb_native_symbol;
 typedef struct qb_native_proc_record	qb_native_proc_record;
 typedef struct qb_zend_argument_stack	qb_zend_argument_stack;
@@ -30,6 +32,10 @@ typedef struct qb_zend_argument_stack	qb_zend_argument_stack;
 typedef enum qb_import_scope_type		qb_import_scope_type;
 typedef enum qb_vm_exit_type			qb_vm_exit_type;
 
+// number of fork_next() loops in a forked section that get their own shared counter
+// loops beyond that are split among the forked copies by fork id
+#define QB_FORK_LOOP_COUNTER_COUNT		16
+
 enum qb_import_scope_type {
 	QB_IMPORT_SCOPE_GLOBAL = 1,
 	QB_IMPORT_SCOPE_CLASS,
@@ -102,9 +108,38 @@ struct qb_interpreter_context {
 	void ***tsrm_ls;
 
 	zval **shadow_variables;
+
+	qb_function_profile *profile;
+	uint32_t profile_instruction_index;
+	uint64_t profile_timestamp;
+	uint64_t profile_start_timestamp;
+
+	volatile long *fork_loop_counters;
+	uint32_t fork_loop_index;
+	uint32_t next_fork_iteration;
+	uint32_t fork_chunk_end;
 };
 
 
+struct qb_async_call {
+	qb_interpreter_context context;
+	qb_task_group *group;
+	zval **arguments;
+	uint32_t argument_count;
+	zval *return_value;
+	int32_t success;
+	int32_t finished;
+	int32_t released;
+};
+
+struct qb_map_item {
+	char *key;
+	uint key_length;
+	ulong index;
+	int key_type;
+	int32_t completed;
+};
+
 #if ZEND_DEBUG
 extern qb_native_proc_record *native_proc_table;
 extern uint32_t native_proc_table_size;
@@ -112,10 +147,13 @@ extern uint32_t native_proc_table_size;
 
 #ifdef __GNUC__
 extern void *op_handlers[];
+extern void *profile_handler;
 #endif
 
 void qb_dispatch_instruction_to_threads(qb_interpreter_context *cxt, void *control_func, int8_t **instruction_pointers, uint32_t thread_count);
 void qb_dispatch_instruction_to_main_thread(qb_interpreter_context *cxt, void *control_func, int8_t *instruction_pointer);
+uint32_t qb_get_next_fork_iteration(qb_interpreter_context *cxt, uint32_t count);
+int32_t qb_dispatch_sort_to_threads(qb_interpreter_context *cxt, void *sort_func, void *merge_func, void *elements, uint32_t count, uint32_t width, uint32_t element_size);
 
 int32_t qb_execute(qb_interpreter_context *cxt);
 int32_t qb_execute_internal(qb_interpreter_context *cxt);
@@ -131,6 +169,11 @@ void qb_sync_imported_variable(qb_interpreter_context *cxt, qb_variable *qvar);
 int32_t qb_dispatch_function_call(qb_interpreter_context *cxt, uint32_t symbol_index, uint32_t *variable_indices, uint32_t argument_count, uint32_t result_index, uint32_t line_number);
 
 void qb_initialize_interpreter_context(qb_interpreter_context *cxt, qb_function *qfunc, qb_interpreter_context *caller_cxt TSRMLS_DC);
+int32_t qb_start_async_call(qb_async_call *call, qb_function *qfunc, zval **arguments, uint32_t argument_count TSRMLS_DC);
+int32_t qb_is_async_call_completed(qb_async_call *call);
+int32_t qb_finish_async_call(qb_async_call *call TSRMLS_DC);
+void qb_abandon_async_call(qb_async_call *call TSRMLS_DC);
+int32_t qb_execute_map(qb_function *qfunc, HashTable *argument_sets, zval *results TSRMLS_DC);
 void qb_free_interpreter_context(qb_interpreter_context *cxt);
 
 void qb_main(qb_interpreter_context *__restrict cxt);
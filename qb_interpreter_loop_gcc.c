@@ -175,6 +175,34 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 			goto *handler;
 		}
 #undef INSTR
+#undef res
+		
+		label_FORK_NEXT_U32_SCA:
+#define INSTR		((qb_instruction_SCA_SCA * __restrict) ip)
+#define op1	((uint32_t *) INSTR->operand1.data_pointer)[0]
+#define res	((uint32_t *) INSTR->operand2.data_pointer)[0]
+		{
+			handler = INSTR->next_handler;
+			qb_do_fork_next_U32(cxt, op1, &res);
+			ip += sizeof(qb_instruction_SCA_SCA);
+			goto *handler;
+		}
+#undef INSTR
+#undef op1
+#undef res
+		
+		label_FORK_NEXT_U32_ELE:
+#define INSTR		((qb_instruction_ELE_ELE * __restrict) ip)
+#define op1	((uint32_t *) INSTR->operand1.data_pointer)[INSTR->operand1.index_pointer[0]]
+#define res	((uint32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
+		{
+			handler = INSTR->next_handler;
+			qb_do_fork_next_U32(cxt, op1, &res);
+			ip += sizeof(qb_instruction_ELE_ELE);
+			goto *handler;
+		}
+#undef INSTR
+#undef op1
 #undef res
 		
 		label_RESUME:
@@ -1863,7 +1891,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_sort_U32(op1, res_ptr, res_count);
+			qb_do_sort_U32(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -1879,7 +1907,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_reverse_sort_U32(op1, res_ptr, res_count);
+			qb_do_reverse_sort_U32(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -1895,7 +1923,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_min_U32(op1_ptr, op1_count, &res);
+			qb_redirect_array_min_U32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -1911,7 +1939,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_min_U32(op1_ptr, op1_count, &res);
+			qb_redirect_array_min_array_element_U32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -1927,7 +1955,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_max_U32(op1_ptr, op1_count, &res);
+			qb_redirect_array_max_U32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -1943,7 +1971,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_max_U32(op1_ptr, op1_count, &res);
+			qb_redirect_array_max_array_element_U32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -1959,7 +1987,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_product_U32(op1_ptr, op1_count, &res);
+			qb_redirect_array_product_U32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -1975,7 +2003,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_product_U32(op1_ptr, op1_count, &res);
+			qb_redirect_array_product_array_element_U32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -1991,7 +2019,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_sum_U32(op1_ptr, op1_count, &res);
+			qb_redirect_array_sum_U32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -2007,7 +2035,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_sum_U32(op1_ptr, op1_count, &res);
+			qb_redirect_array_sum_array_element_U32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -4257,7 +4285,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_sort_S32(op1, res_ptr, res_count);
+			qb_do_sort_S32(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -4273,7 +4301,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_reverse_sort_S32(op1, res_ptr, res_count);
+			qb_do_reverse_sort_S32(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -4289,7 +4317,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_min_S32(op1_ptr, op1_count, &res);
+			qb_redirect_array_min_S32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -4305,7 +4333,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_min_S32(op1_ptr, op1_count, &res);
+			qb_redirect_array_min_array_element_S32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -4321,7 +4349,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_max_S32(op1_ptr, op1_count, &res);
+			qb_redirect_array_max_S32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -4337,7 +4365,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_max_S32(op1_ptr, op1_count, &res);
+			qb_redirect_array_max_array_element_S32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -4353,7 +4381,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_product_S32(op1_ptr, op1_count, &res);
+			qb_redirect_array_product_S32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -4369,7 +4397,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_product_S32(op1_ptr, op1_count, &res);
+			qb_redirect_array_product_array_element_S32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -4385,7 +4413,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_sum_S32(op1_ptr, op1_count, &res);
+			qb_redirect_array_sum_S32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -4401,7 +4429,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_sum_S32(op1_ptr, op1_count, &res);
+			qb_redirect_array_sum_array_element_S32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -4494,7 +4522,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_search_I32(op1_ptr, op1_count, op2, &res);
+			qb_redirect_array_search_I32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA_SCA);
 			goto *handler;
 		}
@@ -4512,7 +4540,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_search_I32(op1_ptr, op1_count, op2, &res);
+			qb_redirect_array_search_array_element_I32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE_SCA);
 			goto *handler;
 		}
@@ -8873,7 +8901,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_sort_F32(op1, res_ptr, res_count);
+			qb_do_sort_F32(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -8889,7 +8917,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_reverse_sort_F32(op1, res_ptr, res_count);
+			qb_do_reverse_sort_F32(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -8905,7 +8933,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_min_F32(op1_ptr, op1_count, &res);
+			qb_redirect_array_min_F32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -8921,7 +8949,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_min_F32(op1_ptr, op1_count, &res);
+			qb_redirect_array_min_array_element_F32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -8937,7 +8965,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_max_F32(op1_ptr, op1_count, &res);
+			qb_redirect_array_max_F32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -8953,7 +8981,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_max_F32(op1_ptr, op1_count, &res);
+			qb_redirect_array_max_array_element_F32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -8969,7 +8997,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_product_F32(op1_ptr, op1_count, &res);
+			qb_redirect_array_product_F32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -8985,7 +9013,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_product_F32(op1_ptr, op1_count, &res);
+			qb_redirect_array_product_array_element_F32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -9001,7 +9029,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_sum_F32(op1_ptr, op1_count, &res);
+			qb_redirect_array_sum_F32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -9017,7 +9045,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_sum_F32(op1_ptr, op1_count, &res);
+			qb_redirect_array_sum_array_element_F32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -9110,7 +9138,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_search_F32(op1_ptr, op1_count, op2, &res);
+			qb_redirect_array_search_F32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA_SCA);
 			goto *handler;
 		}
@@ -9128,7 +9156,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_search_F32(op1_ptr, op1_count, op2, &res);
+			qb_redirect_array_search_array_element_F32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE_SCA);
 			goto *handler;
 		}
@@ -14563,7 +14591,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand6.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_multiply_matrix_by_matrix_column_major_F32(op1_ptr, op1_count, op2_ptr, op2_count, op3, op4, op5, res_ptr, res_count);
+			qb_redirect_multiply_matrix_by_matrix_column_major_F32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ARR_SCA_SCA_SCA_ARR);
 			goto *handler;
 		}
@@ -14864,7 +14892,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand4.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_dot_product_F32(op1_ptr, op1_count, op2_ptr, op2_count, op3, &res);
+			qb_redirect_dot_product_F32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ARR_SCA_SCA);
 			goto *handler;
 		}
@@ -14886,7 +14914,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand4.data_pointer)[INSTR->operand4.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_dot_product_F32(op1_ptr, op1_count, op2_ptr, op2_count, op3, &res);
+			qb_redirect_dot_product_array_element_F32(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ARR_SCA_ELE);
 			goto *handler;
 		}
@@ -19239,7 +19267,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_sort_F64(op1, res_ptr, res_count);
+			qb_do_sort_F64(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -19255,7 +19283,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_reverse_sort_F64(op1, res_ptr, res_count);
+			qb_do_reverse_sort_F64(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -19271,7 +19299,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_min_F64(op1_ptr, op1_count, &res);
+			qb_redirect_array_min_F64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -19287,7 +19315,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_min_F64(op1_ptr, op1_count, &res);
+			qb_redirect_array_min_array_element_F64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -19303,7 +19331,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_max_F64(op1_ptr, op1_count, &res);
+			qb_redirect_array_max_F64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -19319,7 +19347,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_max_F64(op1_ptr, op1_count, &res);
+			qb_redirect_array_max_array_element_F64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -19335,7 +19363,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_product_F64(op1_ptr, op1_count, &res);
+			qb_redirect_array_product_F64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -19351,7 +19379,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_product_F64(op1_ptr, op1_count, &res);
+			qb_redirect_array_product_array_element_F64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -19367,7 +19395,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_sum_F64(op1_ptr, op1_count, &res);
+			qb_redirect_array_sum_F64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -19383,7 +19411,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_sum_F64(op1_ptr, op1_count, &res);
+			qb_redirect_array_sum_array_element_F64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -19476,7 +19504,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_search_F64(op1_ptr, op1_count, op2, &res);
+			qb_redirect_array_search_F64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA_SCA);
 			goto *handler;
 		}
@@ -19494,7 +19522,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_search_F64(op1_ptr, op1_count, op2, &res);
+			qb_redirect_array_search_array_element_F64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE_SCA);
 			goto *handler;
 		}
@@ -24863,7 +24891,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand6.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_multiply_matrix_by_matrix_column_major_F64(op1_ptr, op1_count, op2_ptr, op2_count, op3, op4, op5, res_ptr, res_count);
+			qb_redirect_multiply_matrix_by_matrix_column_major_F64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ARR_SCA_SCA_SCA_ARR);
 			goto *handler;
 		}
@@ -25164,7 +25192,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand4.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_dot_product_F64(op1_ptr, op1_count, op2_ptr, op2_count, op3, &res);
+			qb_redirect_dot_product_F64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ARR_SCA_SCA);
 			goto *handler;
 		}
@@ -25186,7 +25214,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand4.data_pointer)[INSTR->operand4.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_dot_product_F64(op1_ptr, op1_count, op2_ptr, op2_count, op3, &res);
+			qb_redirect_dot_product_array_element_F64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ARR_SCA_ELE);
 			goto *handler;
 		}
@@ -27897,7 +27925,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_sort_S08(op1, res_ptr, res_count);
+			qb_do_sort_S08(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -27913,7 +27941,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_reverse_sort_S08(op1, res_ptr, res_count);
+			qb_do_reverse_sort_S08(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -29745,7 +29773,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_sort_U08(op1, res_ptr, res_count);
+			qb_do_sort_U08(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -29761,7 +29789,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_reverse_sort_U08(op1, res_ptr, res_count);
+			qb_do_reverse_sort_U08(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -31809,7 +31837,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_sort_S16(op1, res_ptr, res_count);
+			qb_do_sort_S16(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -31825,7 +31853,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_reverse_sort_S16(op1, res_ptr, res_count);
+			qb_do_reverse_sort_S16(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -33657,7 +33685,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_sort_U16(op1, res_ptr, res_count);
+			qb_do_sort_U16(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -33673,7 +33701,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_reverse_sort_U16(op1, res_ptr, res_count);
+			qb_do_reverse_sort_U16(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -35783,7 +35811,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_sort_S64(op1, res_ptr, res_count);
+			qb_do_sort_S64(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -35799,7 +35827,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_reverse_sort_S64(op1, res_ptr, res_count);
+			qb_do_reverse_sort_S64(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -35815,7 +35843,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_min_S64(op1_ptr, op1_count, &res);
+			qb_redirect_array_min_S64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -35831,7 +35859,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_min_S64(op1_ptr, op1_count, &res);
+			qb_redirect_array_min_array_element_S64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -35847,7 +35875,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_max_S64(op1_ptr, op1_count, &res);
+			qb_redirect_array_max_S64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -35863,7 +35891,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_max_S64(op1_ptr, op1_count, &res);
+			qb_redirect_array_max_array_element_S64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -35879,7 +35907,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_product_S64(op1_ptr, op1_count, &res);
+			qb_redirect_array_product_S64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -35895,7 +35923,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_product_S64(op1_ptr, op1_count, &res);
+			qb_redirect_array_product_array_element_S64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -35911,7 +35939,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_sum_S64(op1_ptr, op1_count, &res);
+			qb_redirect_array_sum_S64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -35927,7 +35955,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_sum_S64(op1_ptr, op1_count, &res);
+			qb_redirect_array_sum_array_element_S64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -36020,7 +36048,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_search_I64(op1_ptr, op1_count, op2, &res);
+			qb_redirect_array_search_I64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA_SCA);
 			goto *handler;
 		}
@@ -36038,7 +36066,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_search_I64(op1_ptr, op1_count, op2, &res);
+			qb_redirect_array_search_array_element_I64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE_SCA);
 			goto *handler;
 		}
@@ -37693,7 +37721,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_sort_U64(op1, res_ptr, res_count);
+			qb_do_sort_U64(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -37709,7 +37737,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_reverse_sort_U64(op1, res_ptr, res_count);
+			qb_do_reverse_sort_U64(cxt, op1, res_ptr, res_count);
 			ip += sizeof(qb_instruction_SCA_ARR);
 			goto *handler;
 		}
@@ -37725,7 +37753,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_min_U64(op1_ptr, op1_count, &res);
+			qb_redirect_array_min_U64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -37741,7 +37769,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_min_U64(op1_ptr, op1_count, &res);
+			qb_redirect_array_min_array_element_U64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -37757,7 +37785,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_max_U64(op1_ptr, op1_count, &res);
+			qb_redirect_array_max_U64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -37773,7 +37801,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_max_U64(op1_ptr, op1_count, &res);
+			qb_redirect_array_max_array_element_U64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -37789,7 +37817,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_product_U64(op1_ptr, op1_count, &res);
+			qb_redirect_array_product_U64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -37805,7 +37833,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_product_U64(op1_ptr, op1_count, &res);
+			qb_redirect_array_product_array_element_U64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -37821,7 +37849,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[0]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_sum_U64(op1_ptr, op1_count, &res);
+			qb_redirect_array_sum_U64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_SCA);
 			goto *handler;
 		}
@@ -37837,7 +37865,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 		{
 			handler = INSTR->next_handler;
-			qb_do_array_sum_U64(op1_ptr, op1_count, &res);
+			qb_redirect_array_sum_array_element_U64(cxt, ip, 0);
 			ip += sizeof(qb_instruction_ARR_ELE);
 			goto *handler;
 		}
@@ -45736,6 +45764,12 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #undef INSTR
 #undef op1
 		
+		label_PROFILE:
+		{
+			handler = qb_profile_instruction(cxt, ip);
+			goto *handler;
+		}
+		
 	} else {
 		op_handlers[QB_NOP] = &&label_NOP;
 		op_handlers[QB_JMP] = &&label_JMP;
@@ -45749,6 +45783,8 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 		op_handlers[QB_FORK_ID_U32_ELE] = &&label_FORK_ID_U32_ELE;
 		op_handlers[QB_FORK_CNT_U32_SCA] = &&label_FORK_CNT_U32_SCA;
 		op_handlers[QB_FORK_CNT_U32_ELE] = &&label_FORK_CNT_U32_ELE;
+		op_handlers[QB_FORK_NEXT_U32_SCA] = &&label_FORK_NEXT_U32_SCA;
+		op_handlers[QB_FORK_NEXT_U32_ELE] = &&label_FORK_NEXT_U32_ELE;
 		op_handlers[QB_RESUME] = &&label_RESUME;
 		op_handlers[QB_SPOON] = &&label_SPOON;
 		op_handlers[QB_INC_IF_GT_U32_U32_SCA] = &&label_INC_IF_GT_U32_U32_SCA;
@@ -48129,10 +48165,12 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 		op_handlers[QB_TIME_F64_ELE] = &&label_TIME_F64_ELE;
 		op_handlers[QB_EXT_U32] = &&label_EXT_U32;
 		op_handlers[QB_DBG_SYNC_U32] = &&label_DBG_SYNC_U32;
+		profile_handler = &&label_PROFILE;
 	}
 }
 
 void *op_handlers[QB_OPCODE_COUNT];
+void *profile_handler;
 #if NATIVE_COMPILE_ENABLED && ZEND_DEBUG
 #include "qb_native_proc_debug.c"
 #ifdef HAVE_NATIVE_PROC_RECORDS
@@ -184,6 +184,34 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 				break;
 			}
 #undef INSTR
+#undef res
+			
+			case QB_FORK_NEXT_U32_SCA:
+#define INSTR		((qb_instruction_SCA_SCA * __restrict) ip)
+#define op1	((uint32_t *) INSTR->operand1.data_pointer)[0]
+#define res	((uint32_t *) INSTR->operand2.data_pointer)[0]
+			{
+				handler = INSTR->next_handler;
+				qb_do_fork_next_U32(cxt, op1, &res);
+				ip += sizeof(qb_instruction_SCA_SCA);
+				break;
+			}
+#undef INSTR
+#undef op1
+#undef res
+			
+			case QB_FORK_NEXT_U32_ELE:
+#define INSTR		((qb_instruction_ELE_ELE * __restrict) ip)
+#define op1	((uint32_t *) INSTR->operand1.data_pointer)[INSTR->operand1.index_pointer[0]]
+#define res	((uint32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
+			{
+				handler = INSTR->next_handler;
+				qb_do_fork_next_U32(cxt, op1, &res);
+				ip += sizeof(qb_instruction_ELE_ELE);
+				break;
+			}
+#undef INSTR
+#undef op1
 #undef res
 			
 			case QB_RESUME:
@@ -1907,7 +1935,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_sort_U32(op1, res_ptr, res_count);
+				qb_do_sort_U32(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -1923,7 +1951,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_reverse_sort_U32(op1, res_ptr, res_count);
+				qb_do_reverse_sort_U32(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -1939,7 +1967,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_min_U32(op1_ptr, op1_count, &res);
+				qb_redirect_array_min_U32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -1955,7 +1983,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_min_U32(op1_ptr, op1_count, &res);
+				qb_redirect_array_min_array_element_U32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -1971,7 +1999,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_max_U32(op1_ptr, op1_count, &res);
+				qb_redirect_array_max_U32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -1987,7 +2015,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_max_U32(op1_ptr, op1_count, &res);
+				qb_redirect_array_max_array_element_U32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -2003,7 +2031,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_product_U32(op1_ptr, op1_count, &res);
+				qb_redirect_array_product_U32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -2019,7 +2047,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_product_U32(op1_ptr, op1_count, &res);
+				qb_redirect_array_product_array_element_U32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -2035,7 +2063,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_sum_U32(op1_ptr, op1_count, &res);
+				qb_redirect_array_sum_U32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -2051,7 +2079,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_sum_U32(op1_ptr, op1_count, &res);
+				qb_redirect_array_sum_array_element_U32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -4385,7 +4413,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_sort_S32(op1, res_ptr, res_count);
+				qb_do_sort_S32(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -4401,7 +4429,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_reverse_sort_S32(op1, res_ptr, res_count);
+				qb_do_reverse_sort_S32(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -4417,7 +4445,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_min_S32(op1_ptr, op1_count, &res);
+				qb_redirect_array_min_S32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -4433,7 +4461,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_min_S32(op1_ptr, op1_count, &res);
+				qb_redirect_array_min_array_element_S32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -4449,7 +4477,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_max_S32(op1_ptr, op1_count, &res);
+				qb_redirect_array_max_S32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -4465,7 +4493,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_max_S32(op1_ptr, op1_count, &res);
+				qb_redirect_array_max_array_element_S32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -4481,7 +4509,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_product_S32(op1_ptr, op1_count, &res);
+				qb_redirect_array_product_S32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -4497,7 +4525,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_product_S32(op1_ptr, op1_count, &res);
+				qb_redirect_array_product_array_element_S32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -4513,7 +4541,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_sum_S32(op1_ptr, op1_count, &res);
+				qb_redirect_array_sum_S32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -4529,7 +4557,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_sum_S32(op1_ptr, op1_count, &res);
+				qb_redirect_array_sum_array_element_S32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -4622,7 +4650,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_search_I32(op1_ptr, op1_count, op2, &res);
+				qb_redirect_array_search_I32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA_SCA);
 				break;
 			}
@@ -4640,7 +4668,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_search_I32(op1_ptr, op1_count, op2, &res);
+				qb_redirect_array_search_array_element_I32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE_SCA);
 				break;
 			}
@@ -9057,7 +9085,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_sort_F32(op1, res_ptr, res_count);
+				qb_do_sort_F32(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -9073,7 +9101,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_reverse_sort_F32(op1, res_ptr, res_count);
+				qb_do_reverse_sort_F32(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -9089,7 +9117,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_min_F32(op1_ptr, op1_count, &res);
+				qb_redirect_array_min_F32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -9105,7 +9133,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_min_F32(op1_ptr, op1_count, &res);
+				qb_redirect_array_min_array_element_F32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -9121,7 +9149,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_max_F32(op1_ptr, op1_count, &res);
+				qb_redirect_array_max_F32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -9137,7 +9165,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_max_F32(op1_ptr, op1_count, &res);
+				qb_redirect_array_max_array_element_F32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -9153,7 +9181,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_product_F32(op1_ptr, op1_count, &res);
+				qb_redirect_array_product_F32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -9169,7 +9197,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_product_F32(op1_ptr, op1_count, &res);
+				qb_redirect_array_product_array_element_F32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -9185,7 +9213,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_sum_F32(op1_ptr, op1_count, &res);
+				qb_redirect_array_sum_F32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -9201,7 +9229,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_sum_F32(op1_ptr, op1_count, &res);
+				qb_redirect_array_sum_array_element_F32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -9294,7 +9322,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_search_F32(op1_ptr, op1_count, op2, &res);
+				qb_redirect_array_search_F32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA_SCA);
 				break;
 			}
@@ -9312,7 +9340,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_search_F32(op1_ptr, op1_count, op2, &res);
+				qb_redirect_array_search_array_element_F32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE_SCA);
 				break;
 			}
@@ -14747,7 +14775,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand6.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_multiply_matrix_by_matrix_column_major_F32(op1_ptr, op1_count, op2_ptr, op2_count, op3, op4, op5, res_ptr, res_count);
+				qb_redirect_multiply_matrix_by_matrix_column_major_F32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ARR_SCA_SCA_SCA_ARR);
 				break;
 			}
@@ -15048,7 +15076,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand4.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_dot_product_F32(op1_ptr, op1_count, op2_ptr, op2_count, op3, &res);
+				qb_redirect_dot_product_F32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ARR_SCA_SCA);
 				break;
 			}
@@ -15070,7 +15098,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float32_t *) INSTR->operand4.data_pointer)[INSTR->operand4.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_dot_product_F32(op1_ptr, op1_count, op2_ptr, op2_count, op3, &res);
+				qb_redirect_dot_product_array_element_F32(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ARR_SCA_ELE);
 				break;
 			}
@@ -19479,7 +19507,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_sort_F64(op1, res_ptr, res_count);
+				qb_do_sort_F64(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -19495,7 +19523,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_reverse_sort_F64(op1, res_ptr, res_count);
+				qb_do_reverse_sort_F64(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -19511,7 +19539,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_min_F64(op1_ptr, op1_count, &res);
+				qb_redirect_array_min_F64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -19527,7 +19555,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_min_F64(op1_ptr, op1_count, &res);
+				qb_redirect_array_min_array_element_F64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -19543,7 +19571,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_max_F64(op1_ptr, op1_count, &res);
+				qb_redirect_array_max_F64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -19559,7 +19587,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_max_F64(op1_ptr, op1_count, &res);
+				qb_redirect_array_max_array_element_F64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -19575,7 +19603,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_product_F64(op1_ptr, op1_count, &res);
+				qb_redirect_array_product_F64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -19591,7 +19619,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_product_F64(op1_ptr, op1_count, &res);
+				qb_redirect_array_product_array_element_F64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -19607,7 +19635,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_sum_F64(op1_ptr, op1_count, &res);
+				qb_redirect_array_sum_F64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -19623,7 +19651,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_sum_F64(op1_ptr, op1_count, &res);
+				qb_redirect_array_sum_array_element_F64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -19716,7 +19744,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_search_F64(op1_ptr, op1_count, op2, &res);
+				qb_redirect_array_search_F64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA_SCA);
 				break;
 			}
@@ -19734,7 +19762,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_search_F64(op1_ptr, op1_count, op2, &res);
+				qb_redirect_array_search_array_element_F64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE_SCA);
 				break;
 			}
@@ -25103,7 +25131,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand6.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_multiply_matrix_by_matrix_column_major_F64(op1_ptr, op1_count, op2_ptr, op2_count, op3, op4, op5, res_ptr, res_count);
+				qb_redirect_multiply_matrix_by_matrix_column_major_F64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ARR_SCA_SCA_SCA_ARR);
 				break;
 			}
@@ -25404,7 +25432,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand4.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_dot_product_F64(op1_ptr, op1_count, op2_ptr, op2_count, op3, &res);
+				qb_redirect_dot_product_F64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ARR_SCA_SCA);
 				break;
 			}
@@ -25426,7 +25454,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((float64_t *) INSTR->operand4.data_pointer)[INSTR->operand4.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_dot_product_F64(op1_ptr, op1_count, op2_ptr, op2_count, op3, &res);
+				qb_redirect_dot_product_array_element_F64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ARR_SCA_ELE);
 				break;
 			}
@@ -28193,7 +28221,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_sort_S08(op1, res_ptr, res_count);
+				qb_do_sort_S08(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -28209,7 +28237,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_reverse_sort_S08(op1, res_ptr, res_count);
+				qb_do_reverse_sort_S08(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -30069,7 +30097,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_sort_U08(op1, res_ptr, res_count);
+				qb_do_sort_U08(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -30085,7 +30113,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_reverse_sort_U08(op1, res_ptr, res_count);
+				qb_do_reverse_sort_U08(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -32189,7 +32217,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_sort_S16(op1, res_ptr, res_count);
+				qb_do_sort_S16(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -32205,7 +32233,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_reverse_sort_S16(op1, res_ptr, res_count);
+				qb_do_reverse_sort_S16(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -34065,7 +34093,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_sort_U16(op1, res_ptr, res_count);
+				qb_do_sort_U16(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -34081,7 +34109,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_reverse_sort_U16(op1, res_ptr, res_count);
+				qb_do_reverse_sort_U16(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -36247,7 +36275,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_sort_S64(op1, res_ptr, res_count);
+				qb_do_sort_S64(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -36263,7 +36291,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_reverse_sort_S64(op1, res_ptr, res_count);
+				qb_do_reverse_sort_S64(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -36279,7 +36307,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_min_S64(op1_ptr, op1_count, &res);
+				qb_redirect_array_min_S64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -36295,7 +36323,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_min_S64(op1_ptr, op1_count, &res);
+				qb_redirect_array_min_array_element_S64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -36311,7 +36339,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_max_S64(op1_ptr, op1_count, &res);
+				qb_redirect_array_max_S64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -36327,7 +36355,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_max_S64(op1_ptr, op1_count, &res);
+				qb_redirect_array_max_array_element_S64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -36343,7 +36371,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_product_S64(op1_ptr, op1_count, &res);
+				qb_redirect_array_product_S64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -36359,7 +36387,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_product_S64(op1_ptr, op1_count, &res);
+				qb_redirect_array_product_array_element_S64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -36375,7 +36403,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_sum_S64(op1_ptr, op1_count, &res);
+				qb_redirect_array_sum_S64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -36391,7 +36419,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_sum_S64(op1_ptr, op1_count, &res);
+				qb_redirect_array_sum_array_element_S64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -36484,7 +36512,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_search_I64(op1_ptr, op1_count, op2, &res);
+				qb_redirect_array_search_I64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA_SCA);
 				break;
 			}
@@ -36502,7 +36530,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((int32_t *) INSTR->operand3.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_search_I64(op1_ptr, op1_count, op2, &res);
+				qb_redirect_array_search_array_element_I64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE_SCA);
 				break;
 			}
@@ -38185,7 +38213,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_sort_U64(op1, res_ptr, res_count);
+				qb_do_sort_U64(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -38201,7 +38229,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res_count	INSTR->operand2.count_pointer[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_reverse_sort_U64(op1, res_ptr, res_count);
+				qb_do_reverse_sort_U64(cxt, op1, res_ptr, res_count);
 				ip += sizeof(qb_instruction_SCA_ARR);
 				break;
 			}
@@ -38217,7 +38245,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_min_U64(op1_ptr, op1_count, &res);
+				qb_redirect_array_min_U64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -38233,7 +38261,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_min_U64(op1_ptr, op1_count, &res);
+				qb_redirect_array_min_array_element_U64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -38249,7 +38277,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_max_U64(op1_ptr, op1_count, &res);
+				qb_redirect_array_max_U64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -38265,7 +38293,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_max_U64(op1_ptr, op1_count, &res);
+				qb_redirect_array_max_array_element_U64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -38281,7 +38309,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_product_U64(op1_ptr, op1_count, &res);
+				qb_redirect_array_product_U64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -38297,7 +38325,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_product_U64(op1_ptr, op1_count, &res);
+				qb_redirect_array_product_array_element_U64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -38313,7 +38341,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[0]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_sum_U64(op1_ptr, op1_count, &res);
+				qb_redirect_array_sum_U64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_SCA);
 				break;
 			}
@@ -38329,7 +38357,7 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #define res	((uint64_t *) INSTR->operand2.data_pointer)[INSTR->operand2.index_pointer[0]]
 			{
 				handler = INSTR->next_handler;
-				qb_do_array_sum_U64(op1_ptr, op1_count, &res);
+				qb_redirect_array_sum_array_element_U64(cxt, ip, 0);
 				ip += sizeof(qb_instruction_ARR_ELE);
 				break;
 			}
@@ -46228,6 +46256,12 @@ void qb_main(qb_interpreter_context *__restrict cxt) {
 #undef INSTR
 #undef op1
 			
+			case QB_PROFILE_HANDLER:
+			{
+				handler = qb_profile_instruction(cxt, ip);
+				break;
+			}
+			
 			default:
 			__assume(0);
 		}
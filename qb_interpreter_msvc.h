@@ -1034,46 +1034,6 @@ typedef struct qb_instruction_jump {
 
 extern void *op_handlers[];
 
-int qb_compare_ascending_F32(const void *p1, const void *p2);
-int qb_compare_ascending_F32_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_ascending_F64(const void *p1, const void *p2);
-int qb_compare_ascending_F64_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_ascending_S08(const void *p1, const void *p2);
-int qb_compare_ascending_S08_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_ascending_S16(const void *p1, const void *p2);
-int qb_compare_ascending_S16_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_ascending_S32(const void *p1, const void *p2);
-int qb_compare_ascending_S32_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_ascending_S64(const void *p1, const void *p2);
-int qb_compare_ascending_S64_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_ascending_U08(const void *p1, const void *p2);
-int qb_compare_ascending_U08_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_ascending_U16(const void *p1, const void *p2);
-int qb_compare_ascending_U16_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_ascending_U32(const void *p1, const void *p2);
-int qb_compare_ascending_U32_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_ascending_U64(const void *p1, const void *p2);
-int qb_compare_ascending_U64_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_descending_F32(const void *p1, const void *p2);
-int qb_compare_descending_F32_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_descending_F64(const void *p1, const void *p2);
-int qb_compare_descending_F64_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_descending_S08(const void *p1, const void *p2);
-int qb_compare_descending_S08_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_descending_S16(const void *p1, const void *p2);
-int qb_compare_descending_S16_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_descending_S32(const void *p1, const void *p2);
-int qb_compare_descending_S32_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_descending_S64(const void *p1, const void *p2);
-int qb_compare_descending_S64_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_descending_U08(const void *p1, const void *p2);
-int qb_compare_descending_U08_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_descending_U16(const void *p1, const void *p2);
-int qb_compare_descending_U16_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_descending_U32(const void *p1, const void *p2);
-int qb_compare_descending_U32_array(const void *p1, const void *p2, const void *p3);
-int qb_compare_descending_U64(const void *p1, const void *p2);
-int qb_compare_descending_U64_array(const void *p1, const void *p2, const void *p3);
 int32_t qb_compare_array_F32(float32_t *op1_ptr, uint32_t op1_count, float32_t *op2_ptr, uint32_t op2_count);
 int32_t qb_compare_array_F64(float64_t *op1_ptr, uint32_t op1_count, float64_t *op2_ptr, uint32_t op2_count);
 int32_t qb_compare_array_S08(int8_t *op1_ptr, uint32_t op1_count, int8_t *op2_ptr, uint32_t op2_count);
@@ -1084,6 +1044,40 @@ int32_t qb_compare_array_U08(uint8_t *op1_ptr, uint32_t op1_count, uint8_t *op2_
 int32_t qb_compare_array_U16(uint16_t *op1_ptr, uint32_t op1_count, uint16_t *op2_ptr, uint32_t op2_count);
 int32_t qb_compare_array_U32(uint32_t *op1_ptr, uint32_t op1_count, uint32_t *op2_ptr, uint32_t op2_count);
 int32_t qb_compare_array_U64(uint64_t *op1_ptr, uint32_t op1_count, uint64_t *op2_ptr, uint32_t op2_count);
+int32_t qb_insertion_sort_F32(float32_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_insertion_sort_F64(float64_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_insertion_sort_S16(int16_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_insertion_sort_S32(int32_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_insertion_sort_S64(int64_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_insertion_sort_U16(uint16_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_insertion_sort_U32(uint32_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_insertion_sort_U64(uint64_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_radix_sort_S16(int16_t *elements, uint32_t count);
+int32_t qb_radix_sort_S32(int32_t *elements, uint32_t count);
+int32_t qb_radix_sort_S64(int64_t *elements, uint32_t count);
+int32_t qb_radix_sort_U16(uint16_t *elements, uint32_t count);
+int32_t qb_radix_sort_U32(uint32_t *elements, uint32_t count);
+int32_t qb_radix_sort_U64(uint64_t *elements, uint32_t count);
+int32_t qb_reverse_insertion_sort_F32(float32_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_reverse_insertion_sort_F64(float64_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_reverse_insertion_sort_S16(int16_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_reverse_insertion_sort_S32(int32_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_reverse_insertion_sort_S64(int64_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_reverse_insertion_sort_U16(uint16_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_reverse_insertion_sort_U32(uint32_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_reverse_insertion_sort_U64(uint64_t *elements, uint32_t count, uint32_t move_limit);
+int32_t qb_reverse_radix_sort_S16(int16_t *elements, uint32_t count);
+int32_t qb_reverse_radix_sort_S32(int32_t *elements, uint32_t count);
+int32_t qb_reverse_radix_sort_S64(int64_t *elements, uint32_t count);
+int32_t qb_reverse_radix_sort_U16(uint16_t *elements, uint32_t count);
+int32_t qb_reverse_radix_sort_U32(uint32_t *elements, uint32_t count);
+int32_t qb_reverse_radix_sort_U64(uint64_t *elements, uint32_t count);
+uint32_t qb_hash_array_F32(float32_t *op1_ptr, uint32_t op1_count);
+uint32_t qb_hash_array_F64(float64_t *op1_ptr, uint32_t op1_count);
+uint32_t qb_hash_array_I08(int8_t *op1_ptr, uint32_t op1_count);
+uint32_t qb_hash_array_I16(int16_t *op1_ptr, uint32_t op1_count);
+uint32_t qb_hash_array_I32(int32_t *op1_ptr, uint32_t op1_count);
+uint32_t qb_hash_array_I64(int64_t *op1_ptr, uint32_t op1_count);
 void qb_convert_hsl_to_rgb_F32(float32_t *op1_ptr, float32_t *res_ptr);
 void qb_convert_hsl_to_rgb_F64(float64_t *op1_ptr, float64_t *res_ptr);
 void qb_convert_hsv_to_rgb_F32(float32_t *op1_ptr, float32_t *res_ptr);
@@ -1092,12 +1086,130 @@ void qb_convert_rgb_to_hsl_F32(float32_t *op1_ptr, float32_t *res_ptr);
 void qb_convert_rgb_to_hsl_F64(float64_t *op1_ptr, float64_t *res_ptr);
 void qb_convert_rgb_to_hsv_F32(float32_t *op1_ptr, float32_t *res_ptr);
 void qb_convert_rgb_to_hsv_F64(float64_t *op1_ptr, float64_t *res_ptr);
+void qb_counting_sort_S08(int8_t *elements, uint32_t count);
+void qb_counting_sort_U08(uint8_t *elements, uint32_t count);
+void qb_heap_sort_F32(float32_t *elements, uint32_t count);
+void qb_heap_sort_F64(float64_t *elements, uint32_t count);
+void qb_heap_sort_S16(int16_t *elements, uint32_t count);
+void qb_heap_sort_S32(int32_t *elements, uint32_t count);
+void qb_heap_sort_S64(int64_t *elements, uint32_t count);
+void qb_heap_sort_U16(uint16_t *elements, uint32_t count);
+void qb_heap_sort_U32(uint32_t *elements, uint32_t count);
+void qb_heap_sort_U64(uint64_t *elements, uint32_t count);
+void qb_heap_sort_rows_F32(float32_t *elements, uint32_t count, uint32_t width);
+void qb_heap_sort_rows_F64(float64_t *elements, uint32_t count, uint32_t width);
+void qb_heap_sort_rows_S08(int8_t *elements, uint32_t count, uint32_t width);
+void qb_heap_sort_rows_S16(int16_t *elements, uint32_t count, uint32_t width);
+void qb_heap_sort_rows_S32(int32_t *elements, uint32_t count, uint32_t width);
+void qb_heap_sort_rows_S64(int64_t *elements, uint32_t count, uint32_t width);
+void qb_heap_sort_rows_U08(uint8_t *elements, uint32_t count, uint32_t width);
+void qb_heap_sort_rows_U16(uint16_t *elements, uint32_t count, uint32_t width);
+void qb_heap_sort_rows_U32(uint32_t *elements, uint32_t count, uint32_t width);
+void qb_heap_sort_rows_U64(uint64_t *elements, uint32_t count, uint32_t width);
+void qb_introsort_F32(float32_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_introsort_F64(float64_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_introsort_S16(int16_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_introsort_S32(int32_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_introsort_S64(int64_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_introsort_U16(uint16_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_introsort_U32(uint32_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_introsort_U64(uint64_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_merge_F32(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_merge_F64(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_merge_S08(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_merge_S16(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_merge_S32(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_merge_S64(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_merge_U08(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_merge_U16(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_merge_U32(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_merge_U64(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_multiply_matrix_blocks_column_major_F32(float32_t *__restrict m1, float32_t *__restrict m2, float32_t *__restrict res, uint32_t m1_rows, uint32_t m1_cols, uint32_t m2_cols);
+void qb_multiply_matrix_blocks_column_major_F64(float64_t *__restrict m1, float64_t *__restrict m2, float64_t *__restrict res, uint32_t m1_rows, uint32_t m1_cols, uint32_t m2_cols);
 void qb_relocate_elements_F32(float32_t *elements, uint32_t *old_dims, uint32_t *new_dims, uint32_t dimension_count);
 void qb_relocate_elements_F64(float64_t *elements, uint32_t *old_dims, uint32_t *new_dims, uint32_t dimension_count);
 void qb_relocate_elements_I08(int8_t *elements, uint32_t *old_dims, uint32_t *new_dims, uint32_t dimension_count);
 void qb_relocate_elements_I16(int16_t *elements, uint32_t *old_dims, uint32_t *new_dims, uint32_t dimension_count);
 void qb_relocate_elements_I32(int32_t *elements, uint32_t *old_dims, uint32_t *new_dims, uint32_t dimension_count);
 void qb_relocate_elements_I64(int64_t *elements, uint32_t *old_dims, uint32_t *new_dims, uint32_t dimension_count);
+void qb_reverse_counting_sort_S08(int8_t *elements, uint32_t count);
+void qb_reverse_counting_sort_U08(uint8_t *elements, uint32_t count);
+void qb_reverse_heap_sort_F32(float32_t *elements, uint32_t count);
+void qb_reverse_heap_sort_F64(float64_t *elements, uint32_t count);
+void qb_reverse_heap_sort_S16(int16_t *elements, uint32_t count);
+void qb_reverse_heap_sort_S32(int32_t *elements, uint32_t count);
+void qb_reverse_heap_sort_S64(int64_t *elements, uint32_t count);
+void qb_reverse_heap_sort_U16(uint16_t *elements, uint32_t count);
+void qb_reverse_heap_sort_U32(uint32_t *elements, uint32_t count);
+void qb_reverse_heap_sort_U64(uint64_t *elements, uint32_t count);
+void qb_reverse_heap_sort_rows_F32(float32_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_heap_sort_rows_F64(float64_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_heap_sort_rows_S08(int8_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_heap_sort_rows_S16(int16_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_heap_sort_rows_S32(int32_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_heap_sort_rows_S64(int64_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_heap_sort_rows_U08(uint8_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_heap_sort_rows_U16(uint16_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_heap_sort_rows_U32(uint32_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_heap_sort_rows_U64(uint64_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_introsort_F32(float32_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_reverse_introsort_F64(float64_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_reverse_introsort_S16(int16_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_reverse_introsort_S32(int32_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_reverse_introsort_S64(int64_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_reverse_introsort_U16(uint16_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_reverse_introsort_U32(uint32_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_reverse_introsort_U64(uint64_t *elements, uint32_t count, uint32_t bad_partition_limit);
+void qb_reverse_merge_F32(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_reverse_merge_F64(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_reverse_merge_S08(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_reverse_merge_S16(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_reverse_merge_S32(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_reverse_merge_S64(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_reverse_merge_U08(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_reverse_merge_U16(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_reverse_merge_U32(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_reverse_merge_U64(void *elements1, uint32_t count1, void *elements2, uint32_t count2, void *result, uint32_t width);
+void qb_reverse_sort_F32(void *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_F64(void *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_S08(void *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_S16(void *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_S32(void *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_S64(void *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_U08(void *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_U16(void *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_U32(void *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_U64(void *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_rows_F32(float32_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_rows_F64(float64_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_rows_S08(int8_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_rows_S16(int16_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_rows_S32(int32_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_rows_S64(int64_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_rows_U08(uint8_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_rows_U16(uint16_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_rows_U32(uint32_t *elements, uint32_t count, uint32_t width);
+void qb_reverse_sort_rows_U64(uint64_t *elements, uint32_t count, uint32_t width);
+void qb_sort_F32(void *elements, uint32_t count, uint32_t width);
+void qb_sort_F64(void *elements, uint32_t count, uint32_t width);
+void qb_sort_S08(void *elements, uint32_t count, uint32_t width);
+void qb_sort_S16(void *elements, uint32_t count, uint32_t width);
+void qb_sort_S32(void *elements, uint32_t count, uint32_t width);
+void qb_sort_S64(void *elements, uint32_t count, uint32_t width);
+void qb_sort_U08(void *elements, uint32_t count, uint32_t width);
+void qb_sort_U16(void *elements, uint32_t count, uint32_t width);
+void qb_sort_U32(void *elements, uint32_t count, uint32_t width);
+void qb_sort_U64(void *elements, uint32_t count, uint32_t width);
+void qb_sort_rows_F32(float32_t *elements, uint32_t count, uint32_t width);
+void qb_sort_rows_F64(float64_t *elements, uint32_t count, uint32_t width);
+void qb_sort_rows_S08(int8_t *elements, uint32_t count, uint32_t width);
+void qb_sort_rows_S16(int16_t *elements, uint32_t count, uint32_t width);
+void qb_sort_rows_S32(int32_t *elements, uint32_t count, uint32_t width);
+void qb_sort_rows_S64(int64_t *elements, uint32_t count, uint32_t width);
+void qb_sort_rows_U08(uint8_t *elements, uint32_t count, uint32_t width);
+void qb_sort_rows_U16(uint16_t *elements, uint32_t count, uint32_t width);
+void qb_sort_rows_U32(uint32_t *elements, uint32_t count, uint32_t width);
+void qb_sort_rows_U64(uint64_t *elements, uint32_t count, uint32_t width);
 int32_t qb_do_array_column_F32(qb_interpreter_context *__restrict cxt, float32_t *op1_ptr, uint32_t op1_count, uint32_t op2, uint32_t op3, uint32_t op4, float32_t *res_ptr, uint32_t res_count, uint32_t line_id);
 int32_t qb_do_array_column_F64(qb_interpreter_context *__restrict cxt, float64_t *op1_ptr, uint32_t op1_count, uint32_t op2, uint32_t op3, uint32_t op4, float64_t *res_ptr, uint32_t res_count, uint32_t line_id);
 int32_t qb_do_array_column_I08(qb_interpreter_context *__restrict cxt, int8_t *op1_ptr, uint32_t op1_count, uint32_t op2, uint32_t op3, uint32_t op4, int8_t *res_ptr, uint32_t res_count, uint32_t line_id);
@@ -2022,16 +2134,16 @@ void qb_do_remove_premultiplication_4x_F32(float32_t *op1_ptr, float32_t *res_pt
 void qb_do_remove_premultiplication_4x_F64(float64_t *op1_ptr, float64_t *res_ptr);
 void qb_do_remove_premultiplication_4x_multiple_times_F32(float32_t *op1_ptr, uint32_t op1_count, float32_t *res_ptr, uint32_t res_count);
 void qb_do_remove_premultiplication_4x_multiple_times_F64(float64_t *op1_ptr, uint32_t op1_count, float64_t *res_ptr, uint32_t res_count);
-void qb_do_reverse_sort_F32(uint32_t op1, float32_t *res_ptr, uint32_t res_count);
-void qb_do_reverse_sort_F64(uint32_t op1, float64_t *res_ptr, uint32_t res_count);
-void qb_do_reverse_sort_S08(uint32_t op1, int8_t *res_ptr, uint32_t res_count);
-void qb_do_reverse_sort_S16(uint32_t op1, int16_t *res_ptr, uint32_t res_count);
-void qb_do_reverse_sort_S32(uint32_t op1, int32_t *res_ptr, uint32_t res_count);
-void qb_do_reverse_sort_S64(uint32_t op1, int64_t *res_ptr, uint32_t res_count);
-void qb_do_reverse_sort_U08(uint32_t op1, uint8_t *res_ptr, uint32_t res_count);
-void qb_do_reverse_sort_U16(uint32_t op1, uint16_t *res_ptr, uint32_t res_count);
-void qb_do_reverse_sort_U32(uint32_t op1, uint32_t *res_ptr, uint32_t res_count);
-void qb_do_reverse_sort_U64(uint32_t op1, uint64_t *res_ptr, uint32_t res_count);
+void qb_do_reverse_sort_F32(qb_interpreter_context *__restrict cxt, uint32_t op1, float32_t *res_ptr, uint32_t res_count);
+void qb_do_reverse_sort_F64(qb_interpreter_context *__restrict cxt, uint32_t op1, float64_t *res_ptr, uint32_t res_count);
+void qb_do_reverse_sort_S08(qb_interpreter_context *__restrict cxt, uint32_t op1, int8_t *res_ptr, uint32_t res_count);
+void qb_do_reverse_sort_S16(qb_interpreter_context *__restrict cxt, uint32_t op1, int16_t *res_ptr, uint32_t res_count);
+void qb_do_reverse_sort_S32(qb_interpreter_context *__restrict cxt, uint32_t op1, int32_t *res_ptr, uint32_t res_count);
+void qb_do_reverse_sort_S64(qb_interpreter_context *__restrict cxt, uint32_t op1, int64_t *res_ptr, uint32_t res_count);
+void qb_do_reverse_sort_U08(qb_interpreter_context *__restrict cxt, uint32_t op1, uint8_t *res_ptr, uint32_t res_count);
+void qb_do_reverse_sort_U16(qb_interpreter_context *__restrict cxt, uint32_t op1, uint16_t *res_ptr, uint32_t res_count);
+void qb_do_reverse_sort_U32(qb_interpreter_context *__restrict cxt, uint32_t op1, uint32_t *res_ptr, uint32_t res_count);
+void qb_do_reverse_sort_U64(qb_interpreter_context *__restrict cxt, uint32_t op1, uint64_t *res_ptr, uint32_t res_count);
 void qb_do_rgb2hsl_3x_multiple_times_F32(float32_t *op1_ptr, uint32_t op1_count, float32_t *res_ptr, uint32_t res_count);
 void qb_do_rgb2hsl_3x_multiple_times_F64(float64_t *op1_ptr, uint32_t op1_count, float64_t *res_ptr, uint32_t res_count);
 void qb_do_rgb2hsl_4x_multiple_times_F32(float32_t *op1_ptr, uint32_t op1_count, float32_t *res_ptr, uint32_t res_count);
@@ -2173,16 +2285,16 @@ void qb_do_sinh_multiple_times_F32(float32_t *op1_ptr, uint32_t op1_count, float
 void qb_do_sinh_multiple_times_F64(float64_t *op1_ptr, uint32_t op1_count, float64_t *res_ptr, uint32_t res_count);
 void qb_do_smooth_step_multiple_times_F32(float32_t *op1_ptr, uint32_t op1_count, float32_t *op2_ptr, uint32_t op2_count, float32_t *op3_ptr, uint32_t op3_count, float32_t *res_ptr, uint32_t res_count);
 void qb_do_smooth_step_multiple_times_F64(float64_t *op1_ptr, uint32_t op1_count, float64_t *op2_ptr, uint32_t op2_count, float64_t *op3_ptr, uint32_t op3_count, float64_t *res_ptr, uint32_t res_count);
-void qb_do_sort_F32(uint32_t op1, float32_t *res_ptr, uint32_t res_count);
-void qb_do_sort_F64(uint32_t op1, float64_t *res_ptr, uint32_t res_count);
-void qb_do_sort_S08(uint32_t op1, int8_t *res_ptr, uint32_t res_count);
-void qb_do_sort_S16(uint32_t op1, int16_t *res_ptr, uint32_t res_count);
-void qb_do_sort_S32(uint32_t op1, int32_t *res_ptr, uint32_t res_count);
-void qb_do_sort_S64(uint32_t op1, int64_t *res_ptr, uint32_t res_count);
-void qb_do_sort_U08(uint32_t op1, uint8_t *res_ptr, uint32_t res_count);
-void qb_do_sort_U16(uint32_t op1, uint16_t *res_ptr, uint32_t res_count);
-void qb_do_sort_U32(uint32_t op1, uint32_t *res_ptr, uint32_t res_count);
-void qb_do_sort_U64(uint32_t op1, uint64_t *res_ptr, uint32_t res_count);
+void qb_do_sort_F32(qb_interpreter_context *__restrict cxt, uint32_t op1, float32_t *res_ptr, uint32_t res_count);
+void qb_do_sort_F64(qb_interpreter_context *__restrict cxt, uint32_t op1, float64_t *res_ptr, uint32_t res_count);
+void qb_do_sort_S08(qb_interpreter_context *__restrict cxt, uint32_t op1, int8_t *res_ptr, uint32_t res_count);
+void qb_do_sort_S16(qb_interpreter_context *__restrict cxt, uint32_t op1, int16_t *res_ptr, uint32_t res_count);
+void qb_do_sort_S32(qb_interpreter_context *__restrict cxt, uint32_t op1, int32_t *res_ptr, uint32_t res_count);
+void qb_do_sort_S64(qb_interpreter_context *__restrict cxt, uint32_t op1, int64_t *res_ptr, uint32_t res_count);
+void qb_do_sort_U08(qb_interpreter_context *__restrict cxt, uint32_t op1, uint8_t *res_ptr, uint32_t res_count);
+void qb_do_sort_U16(qb_interpreter_context *__restrict cxt, uint32_t op1, uint16_t *res_ptr, uint32_t res_count);
+void qb_do_sort_U32(qb_interpreter_context *__restrict cxt, uint32_t op1, uint32_t *res_ptr, uint32_t res_count);
+void qb_do_sort_U64(qb_interpreter_context *__restrict cxt, uint32_t op1, uint64_t *res_ptr, uint32_t res_count);
 void qb_do_sqrt_multiple_times_F32(float32_t *op1_ptr, uint32_t op1_count, float32_t *res_ptr, uint32_t res_count);
 void qb_do_sqrt_multiple_times_F64(float64_t *op1_ptr, uint32_t op1_count, float64_t *res_ptr, uint32_t res_count);
 void qb_do_step_multiple_times_F32(float32_t *op1_ptr, uint32_t op1_count, float32_t *op2_ptr, uint32_t op2_count, float32_t *res_ptr, uint32_t res_count);
@@ -2252,6 +2364,14 @@ void qb_do_utf8encode_count_U32(uint32_t *op1_ptr, uint32_t op1_count, uint32_t
 void qb_redirect_multiply_multiple_times_U32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_shift_left_multiple_times_U32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_shift_right_multiple_times_U32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_min_U32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_min_array_element_U32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_max_U32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_max_array_element_U32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_product_U32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_product_array_element_U32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_sum_U32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_sum_array_element_U32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_increment_multiple_times_I32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_decrement_multiple_times_I32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_add_multiple_times_I32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
@@ -2265,6 +2385,16 @@ void qb_redirect_bitwise_not_multiple_times_I32(qb_interpreter_context *__restri
 void qb_redirect_shift_left_multiple_times_S32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_shift_right_multiple_times_S32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_abs_multiple_times_S32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_min_S32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_min_array_element_S32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_max_S32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_max_array_element_S32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_product_S32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_product_array_element_S32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_sum_S32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_sum_array_element_S32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_search_I32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_search_array_element_I32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_increment_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_decrement_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_add_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
@@ -2315,6 +2445,16 @@ void qb_redirect_step_multiple_times_F32(qb_interpreter_context *__restrict cxt,
 void qb_redirect_smooth_step_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_radian_to_degree_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_degree_to_radian_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_min_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_min_array_element_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_max_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_max_array_element_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_product_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_product_array_element_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_sum_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_sum_array_element_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_search_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_search_array_element_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_sample_nearest_4x_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_sample_nearest_3x_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_sample_nearest_2x_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
@@ -2392,6 +2532,9 @@ void qb_redirect_modulo_2x_multiple_times_F32(qb_interpreter_context *__restrict
 void qb_redirect_negate_2x_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_increment_2x_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_multiply_accumulate_2x_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_multiply_matrix_by_matrix_column_major_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_dot_product_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_dot_product_array_element_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_complex_abs_2x_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_complex_argument_2x_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_complex_multiply_2x_multiple_times_F32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
@@ -2456,6 +2599,16 @@ void qb_redirect_step_multiple_times_F64(qb_interpreter_context *__restrict cxt,
 void qb_redirect_smooth_step_multiple_times_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_radian_to_degree_multiple_times_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_degree_to_radian_multiple_times_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_min_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_min_array_element_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_max_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_max_array_element_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_product_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_product_array_element_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_sum_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_sum_array_element_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_search_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_search_array_element_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_sample_nearest_4x_multiple_times_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_sample_nearest_3x_multiple_times_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_sample_nearest_2x_multiple_times_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
@@ -2540,6 +2693,9 @@ void qb_redirect_divide_2x_multiple_times_F64(qb_interpreter_context *__restrict
 void qb_redirect_modulo_2x_multiple_times_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_negate_2x_multiple_times_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_multiply_accumulate_2x_multiple_times_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_multiply_matrix_by_matrix_column_major_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_dot_product_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_dot_product_array_element_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_complex_abs_2x_multiple_times_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_complex_argument_2x_multiple_times_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_complex_multiply_2x_multiple_times_F64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
@@ -2599,9 +2755,27 @@ void qb_redirect_bitwise_not_multiple_times_I64(qb_interpreter_context *__restri
 void qb_redirect_shift_left_multiple_times_S64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_shift_right_multiple_times_S64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_abs_multiple_times_S64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_min_S64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_min_array_element_S64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_max_S64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_max_array_element_S64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_product_S64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_product_array_element_S64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_sum_S64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_sum_array_element_S64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_search_I64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_search_array_element_I64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_multiply_multiple_times_U64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_shift_left_multiple_times_U64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_shift_right_multiple_times_U64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_min_U64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_min_array_element_U64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_max_U64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_max_array_element_U64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_product_U64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_product_array_element_U64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_sum_U64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
+void qb_redirect_array_sum_array_element_U64(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_print_variable_U32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_print_variable_array_element_U32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
 void qb_redirect_print_variable_multiple_times_U32(qb_interpreter_context *__restrict cxt, int8_t *__restrict ip, int unused);
@@ -2652,6 +2826,13 @@ int32_t qb_dispatch_instruction_ARR_ARR_ARR(qb_interpreter_context *__restrict c
 int32_t qb_dispatch_instruction_ARR_ARR_ARR_ARR(qb_interpreter_context *__restrict cxt, void *control_func, qb_instruction_ARR_ARR_ARR_ARR *__restrict instr, uint32_t operand1_size, uint32_t operand2_size, uint32_t operand3_size, uint32_t operand4_size, uint32_t threshold);
 int32_t qb_dispatch_instruction_ARR_ARR_SCA_ARR(qb_interpreter_context *__restrict cxt, void *control_func, qb_instruction_ARR_ARR_SCA_ARR *__restrict instr, uint32_t operand1_size, uint32_t operand2_size, uint32_t operand4_size, uint32_t threshold);
 int32_t qb_dispatch_instruction_ARR_SCA_SCA_ARR_ARR_ARR(qb_interpreter_context *__restrict cxt, void *control_func, qb_instruction_ARR_SCA_SCA_ARR_ARR_ARR *__restrict instr, uint32_t operand1_size, uint32_t operand4_size, uint32_t operand5_size, uint32_t operand6_size, uint32_t threshold);
+int32_t qb_dispatch_matrix_columns_ARR_ARR_SCA_SCA_SCA_ARR(qb_interpreter_context *__restrict cxt, void *control_func, qb_instruction_ARR_ARR_SCA_SCA_SCA_ARR *__restrict instr, uint32_t threshold);
+uint32_t qb_dispatch_reduction_ARR_ARR_SCA_ELE(qb_interpreter_context *__restrict cxt, void *control_func, qb_instruction_ARR_ARR_SCA_ELE *__restrict instr, void *partial_results, uint32_t partial_result_size, uint32_t count, uint32_t threshold);
+uint32_t qb_dispatch_reduction_ARR_ARR_SCA_SCA(qb_interpreter_context *__restrict cxt, void *control_func, qb_instruction_ARR_ARR_SCA_SCA *__restrict instr, void *partial_results, uint32_t partial_result_size, uint32_t count, uint32_t threshold);
+uint32_t qb_dispatch_reduction_ARR_ELE(qb_interpreter_context *__restrict cxt, void *control_func, qb_instruction_ARR_ELE *__restrict instr, void *partial_results, uint32_t partial_result_size, uint32_t count, uint32_t threshold);
+uint32_t qb_dispatch_reduction_ARR_ELE_SCA(qb_interpreter_context *__restrict cxt, void *control_func, qb_instruction_ARR_ELE_SCA *__restrict instr, void *partial_results, uint32_t partial_result_size, uint32_t count, uint32_t threshold);
+uint32_t qb_dispatch_reduction_ARR_SCA(qb_interpreter_context *__restrict cxt, void *control_func, qb_instruction_ARR_SCA *__restrict instr, void *partial_results, uint32_t partial_result_size, uint32_t count, uint32_t threshold);
+uint32_t qb_dispatch_reduction_ARR_SCA_SCA(qb_interpreter_context *__restrict cxt, void *control_func, qb_instruction_ARR_SCA_SCA *__restrict instr, void *partial_results, uint32_t partial_result_size, uint32_t count, uint32_t threshold);
 
 static zend_always_inline int32_t qb_do_check_index_add_U32(qb_interpreter_context *__restrict cxt, uint32_t op1, uint32_t op2, uint32_t op3, int32_t *op4_ptr, uint32_t *res_ptr, uint32_t line_id) {
 	(*res_ptr) = op1 + op3;
@@ -3030,7 +3211,7 @@ static zend_always_inline void qb_do_accommodate_index_U32(qb_interpreter_contex
 	if(UNEXPECTED(!(op1 < (*op2_ptr)))) {
 		uint32_t new_size = op1 + 1;
 		(*op2_ptr) = new_size;
-		qb_resize_segment(&cxt->function->local_storage->segments[op3], new_size * op4);
+		qb_resize_segment(&cxt->function->local_storage->segments[op3], (uint64_t) new_size * op4);
 	}
 }
 
@@ -3041,7 +3222,7 @@ static zend_always_inline void qb_do_accommodate_index_multiply_U32(qb_interpret
 		uint32_t new_size = new_dim * op3;
 		(*op4_ptr) = new_size;
 		(*op2_ptr) = new_dim;
-		qb_resize_segment(&cxt->function->local_storage->segments[op5], new_size * op6);
+		qb_resize_segment(&cxt->function->local_storage->segments[op5], (uint64_t) new_size * op6);
 	}
 }
 
@@ -3049,14 +3230,14 @@ static zend_always_inline void qb_do_accommodate_push_U32(qb_interpreter_context
 	uint32_t new_dim = (*op1_ptr) + 1;
 	(*res_ptr) = (*op1_ptr);
 	(*op1_ptr) = new_dim;
-	qb_resize_segment(&cxt->function->local_storage->segments[op2], new_dim * op3);
+	qb_resize_segment(&cxt->function->local_storage->segments[op2], (uint64_t) new_dim * op3);
 }
 
 static zend_always_inline void qb_do_accommodate_size_U32(qb_interpreter_context *__restrict cxt, uint32_t op1, uint32_t *op2_ptr, uint32_t op3, uint32_t op4) {
 	if(UNEXPECTED(!(op1 == (*op2_ptr)))) {
 		uint32_t new_dim = op1;
 		(*op2_ptr) = new_dim;
-		qb_resize_segment(&cxt->function->local_storage->segments[op3], new_dim * op4);
+		qb_resize_segment(&cxt->function->local_storage->segments[op3], (uint64_t) new_dim * op4);
 	}
 }
 
@@ -3065,7 +3246,7 @@ static zend_always_inline void qb_do_accommodate_size_copy_dimension_2_U32(qb_in
 	(*op4_ptr) = op2;
 	(*op7_ptr) = op5;
 	(*op8_ptr) = op6;
-	qb_resize_segment(&cxt->function->local_storage->segments[op9], op1 * op10);
+	qb_resize_segment(&cxt->function->local_storage->segments[op9], (uint64_t) op1 * op10);
 }
 
 static zend_always_inline void qb_do_accommodate_size_copy_dimension_3_U32(qb_interpreter_context *__restrict cxt, uint32_t op1, uint32_t op2, uint32_t *op3_ptr, uint32_t *op4_ptr, uint32_t op5, uint32_t op6, uint32_t *op7_ptr, uint32_t *op8_ptr, uint32_t op9, uint32_t op10, uint32_t *op11_ptr, uint32_t *op12_ptr, uint32_t op13, uint32_t op14) {
@@ -3075,7 +3256,7 @@ static zend_always_inline void qb_do_accommodate_size_copy_dimension_3_U32(qb_in
 	(*op8_ptr) = op6;
 	(*op11_ptr) = op9;
 	(*op12_ptr) = op10;
-	qb_resize_segment(&cxt->function->local_storage->segments[op13], op1 * op14);
+	qb_resize_segment(&cxt->function->local_storage->segments[op13], (uint64_t) op1 * op14);
 }
 
 static zend_always_inline void qb_do_acos_F32(float32_t op1, float32_t *res_ptr) {
@@ -4084,6 +4265,10 @@ static zend_always_inline void qb_do_fork_identifier_U32(qb_interpreter_context
 	(*res_ptr) = cxt->fork_id;
 }
 
+static zend_always_inline void qb_do_fork_next_U32(qb_interpreter_context *__restrict cxt, uint32_t op1, uint32_t *res_ptr) {
+	(*res_ptr) = qb_get_next_fork_iteration(cxt, op1);
+}
+
 static zend_always_inline void qb_do_fract_F32(float32_t op1, float32_t *res_ptr) {
 	(*res_ptr) = op1 - floorf(op1);
 }
@@ -22,6 +22,12 @@
 
 #if NATIVE_COMPILE_ENABLED
 
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#elif defined(__GNUC__)
+#	include <cpuid.h>
+#endif
+
 ZEND_ATTRIBUTE_FORMAT(printf, 2, 3)
 static void qb_printf(qb_native_compiler_context *cxt, const char *format, ...) {
 	USE_TSRM
@@ -147,6 +153,7 @@ static void qb_print_typedefs(qb_native_compiler_context *cxt) {
 	qb_print(cxt, "typedef struct qb_memory_segment\tqb_memory_segment;\n");
 	qb_print(cxt, "typedef struct qb_storage\tqb_storage;\n");
 	qb_print(cxt, "typedef struct qb_function\tqb_function;\n");
+	qb_print(cxt, "typedef struct qb_function_profile\tqb_function_profile;\n");
 	qb_print(cxt, "typedef struct qb_interpreter_context\tqb_interpreter_context;\n");
 	qb_print(cxt, "typedef struct qb_external_symbol\tqb_external_symbol;\n");
 	
@@ -169,8 +176,8 @@ enum qb_vm_exit_type {\
 struct qb_memory_segment {\
 	int8_t *memory;\
 	uint32_t flags;\
-	uint32_t byte_count;\
-	uint32_t current_allocation;\
+	uint64_t byte_count;\
+	uint64_t current_allocation;\
 	php_stream *stream;\
 	qb_memory_segment *imported_segment;\
 	qb_memory_segment *next_dependent;\
@@ -203,7 +210,11 @@ struct qb_function {\
 	uint64_t instruction_crc64;\
 	uint32_t instruction_length;\
 	uint16_t *instruction_opcodes;\
+	uint32_t *instruction_line_ids;\
 	uint32_t instruction_opcode_count;\
+	void *instruction_relocations;\
+	uint32_t instruction_relocation_count;\
+	uint32_t instruction_handler_count;\
 	uint32_t flags;\
 	qb_variable *return_variable;\
 	qb_variable *return_key_variable;\
@@ -221,6 +232,7 @@ struct qb_function {\
 	qb_function *next_reentrance_copy;\
 	qb_function *next_forked_copy;\
 	volatile int32_t in_use;\
+	qb_function_profile *profile;\
 };\
 \n");
 
@@ -1074,7 +1086,7 @@ static void qb_print_function(qb_native_compiler_context *cxt) {
 }
 
 static void qb_print_version(qb_native_compiler_context *cxt) {
-	qb_printf(cxt, "\nuint32_t QB_VERSION = 0x%08x;\n\n", QB_VERSION_SIGNATURE);
+	qb_printf(cxt, "\nuint32_t QB_VERSION = 0x%08x;\n\n", QB_NATIVE_CODE_SIGNATURE);
 }
 
 static void qb_print_functions(qb_native_compiler_context *cxt) {
@@ -1157,7 +1169,7 @@ static int32_t qb_check_symbol(qb_native_compiler_context *cxt, const char *name
 	return FALSE;
 }
 
-static void * qb_find_symbol(qb_native_compiler_context *cxt, const char *name) {
+static int32_t qb_find_symbol_index(qb_native_compiler_context *cxt, const char *name) {
 	long hash_value;
 	uint32_t i, name_len = (uint32_t) strlen(name);
 	hash_value = zend_get_hash_value(name, name_len + 1);
@@ -1165,10 +1177,18 @@ static void * qb_find_symbol(qb_native_compiler_context *cxt, const char *name)
 		qb_native_symbol *symbol = &global_native_symbols[i];
 		if(symbol->hash_value == hash_value) {
 			if(strcmp(symbol->name, name) == 0) {
-				return qb_get_symbol_address(cxt, symbol);
+				return i;
 			}
 		}
 	}
+	return -1;
+}
+
+static void * qb_find_symbol(qb_native_compiler_context *cxt, const char *name) {
+	int32_t index = qb_find_symbol_index(cxt, name);
+	if(index != -1) {
+		return qb_get_symbol_address(cxt, &global_native_symbols[index]);
+	}
 	return NULL;
 }
 
@@ -1178,10 +1198,10 @@ static uint32_t qb_attach_symbol(qb_native_compiler_context *cxt, const char *sy
 		qb_native_proc proc = (qb_native_proc) address;
 		uint64_t crc64 = strtoull(symbol_name + 4, NULL, 16);
 		uint32_t i;
-		for(i = 0; i < cxt->compiler_context_count; i++) {
-			qb_compiler_context *compiler_cxt = cxt->compiler_contexts[i];
-			if(compiler_cxt->compiled_function->instruction_crc64 == crc64) {
-				compiler_cxt->compiled_function->native_proc = proc;
+		for(i = 0; i < cxt->request_count; i++) {
+			qb_native_code_request *request = &cxt->requests[i];
+			if(request->function && request->function->instruction_crc64 == crc64) {
+				request->native_proc = proc;
 				count++;
 			}
 		}
@@ -1191,9 +1211,11 @@ static uint32_t qb_attach_symbol(qb_native_compiler_context *cxt, const char *sy
 
 static void qb_detach_symbols(qb_native_compiler_context *cxt) {
 	uint32_t i;
-	for(i = 0; i < cxt->compiler_context_count; i++) {
-		qb_compiler_context *compiler_cxt = cxt->compiler_contexts[i];
-		compiler_cxt->compiled_function->native_proc = NULL;
+	for(i = 0; i < cxt->request_count; i++) {
+		qb_native_code_request *request = &cxt->requests[i];
+		if(request->function && request->function->instruction_crc64 == cxt->file_id) {
+			request->native_proc = NULL;
+		}
 	}
 	cxt->qb_version = 0;
 }
@@ -1239,6 +1261,122 @@ int32_t qb_decompress_code(qb_native_compiler_context *cxt) {
 	return (cxt->op_actions && cxt->op_function_usages && cxt->function_prototypes);
 }
 
+static const char *qb_cpu_level_names[QB_CPU_LEVEL_COUNT] = {
+	"generic",
+	"sse2",
+	"avx2",
+	"avx512",
+};
+
+// compiler options for each level, terminated by NULL
+#ifdef _MSC_VER
+static const char *qb_cpu_level_options[QB_CPU_LEVEL_COUNT][2] = {
+	{	NULL	},
+#ifdef _WIN64
+	// SSE2 is always available in x64
+	{	NULL	},
+#else
+	{	"/arch:SSE2",	NULL	},
+#endif
+	{	"/arch:AVX2",	NULL	},
+	{	"/arch:AVX512",	NULL	},
+};
+#else
+static const char *qb_cpu_level_options[QB_CPU_LEVEL_COUNT][7] = {
+	{	NULL	},
+	{	"-msse2",	NULL	},
+	{	"-mavx2",	"-mfma",	NULL	},
+	{	"-mavx512f",	"-mavx512dq",	"-mavx512bw",	"-mavx512vl",	"-mavx2",	"-mfma",	NULL	},
+};
+#endif
+
+static void qb_get_cpuid(uint32_t leaf, uint32_t subleaf, uint32_t *regs) {
+#if defined(_MSC_VER)
+	__cpuidex((int *) regs, (int) leaf, (int) subleaf);
+#elif defined(__GNUC__)
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#else
+	regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#endif
+}
+
+static uint64_t qb_get_xcr0(void) {
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#elif defined(__GNUC__)
+	uint32_t eax, edx;
+	__asm__ __volatile__("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+	return ((uint64_t) edx << 32) | eax;
+#else
+	return 0;
+#endif
+}
+
+static qb_cpu_level qb_detect_cpu_level(void) {
+	uint32_t regs1[4], regs7[4] = { 0, 0, 0, 0 };
+	uint64_t xcr0 = 0;
+	int32_t ymm_enabled, zmm_enabled;
+
+	qb_get_cpuid(0, 0, regs1);
+	if(regs1[0] >= 7) {
+		qb_get_cpuid(7, 0, regs7);
+	}
+	qb_get_cpuid(1, 0, regs1);
+
+	// the OS has to save the wider registers on context switches, in addition to the CPU supporting them
+	if(regs1[2] & (1 << 27)) {
+		xcr0 = qb_get_xcr0();
+	}
+	ymm_enabled = (xcr0 & 0x06) == 0x06;
+	zmm_enabled = (xcr0 & 0xE6) == 0xE6;
+
+	if(ymm_enabled && (regs1[2] & (1 << 28)) && (regs1[2] & (1 << 12)) && (regs7[1] & (1 << 5))) {
+		// AVX, FMA, AVX2
+		const uint32_t avx512_bits = (1 << 16) | (1 << 17) | (1 << 30) | (1U << 31);
+		if(zmm_enabled && (regs7[1] & avx512_bits) == avx512_bits) {
+			// AVX-512 F, DQ, BW, VL
+			return QB_CPU_LEVEL_AVX512;
+		}
+		return QB_CPU_LEVEL_AVX2;
+	}
+	if(regs1[3] & (1 << 26)) {
+		return QB_CPU_LEVEL_SSE2;
+	}
+	return QB_CPU_LEVEL_GENERIC;
+}
+
+qb_cpu_level qb_get_cpu_level(void) {
+	static int32_t detected = FALSE;
+	static qb_cpu_level level;
+	if(!detected) {
+		level = qb_detect_cpu_level();
+		detected = TRUE;
+	}
+	return level;
+}
+
+const char * qb_get_cpu_level_name(qb_cpu_level level) {
+	return qb_cpu_level_names[level];
+}
+
+static uint32_t qb_get_prebuild_cpu_levels(TSRMLS_D) {
+	// qb.native_code_prebuild_levels is a list of level names separated by commas or spaces
+	const char *s = QB_G(native_code_prebuild_levels);
+	uint32_t flags = 0;
+	while(s && *s) {
+		uint32_t len = (uint32_t) strcspn(s, ", ");
+		uint32_t i;
+		for(i = 0; i < QB_CPU_LEVEL_COUNT; i++) {
+			if(strlen(qb_cpu_level_names[i]) == len && strncmp(s, qb_cpu_level_names[i], len) == 0) {
+				flags |= 1 << i;
+			}
+		}
+		s += len;
+		s += strspn(s, ", ");
+	}
+	return flags;
+}
+
 #if defined(__MACH__)
 #include "qb_native_compiler_osx.c"
 #elif defined(__ELF__)
@@ -1247,11 +1385,240 @@ int32_t qb_decompress_code(qb_native_compiler_context *cxt) {
 #include "qb_native_compiler_win32.c"
 #endif
 
-void qb_compile_to_native_code(qb_native_compiler_context *cxt) {
+static void qb_set_object_file_paths(qb_native_compiler_context *cxt) {
+	const char *level_name = qb_get_cpu_level_name(cxt->cpu_level);
+	if(cxt->obj_file_path) {
+		efree(cxt->obj_file_path);
+	}
+	if(cxt->lock_file_path) {
+		efree(cxt->lock_file_path);
+	}
+	spprintf(&cxt->obj_file_path, 0, "%s%cQB%" PRIX64 "-%s.o", cxt->cache_folder_path, PHP_DIR_SEPARATOR, cxt->file_id, level_name);
+	spprintf(&cxt->lock_file_path, 0, "%s%cQB%" PRIX64 "-%s.lock", cxt->cache_folder_path, PHP_DIR_SEPARATOR, cxt->file_id, level_name);
+}
+
+static void * qb_find_native_proc(uint64_t crc64 TSRMLS_DC) {
+	uint32_t i;
+	for(i = 0; i < QB_G(native_proc_count); i++) {
+		qb_native_proc_record *record = &QB_G(native_procs)[i];
+		if(record->crc64 == crc64) {
+			return record->proc;
+		}
+	}
+	return NULL;
+}
+
+static void qb_add_native_code_bundle(qb_native_compiler_context *cxt) {
 	USE_TSRM
-	uint32_t i, attempt;
+	qb_native_code_bundle *bundle;
+	uint32_t i;
+
+	// the code outlives the request, so the arrays have to be allocated persistently
+	QB_G(native_code_bundles) = perealloc(QB_G(native_code_bundles), sizeof(qb_native_code_bundle) * (QB_G(native_code_bundle_count) + 1), TRUE);
+	bundle = &QB_G(native_code_bundles)[QB_G(native_code_bundle_count)++];
+	bundle->memory = cxt->binary;
+	bundle->size = cxt->binary_size;
+	cxt->binary = NULL;
+
+	// remember where each function is, so later requests can link to it without loading anything
+	for(i = 0; i < cxt->request_count; i++) {
+		qb_native_code_request *request = &cxt->requests[i];
+		if(request->native_proc && request->function) {
+			uint64_t crc64 = request->function->instruction_crc64;
+			if(!qb_find_native_proc(crc64 TSRMLS_CC)) {
+				qb_native_proc_record *record;
+				QB_G(native_procs) = perealloc(QB_G(native_procs), sizeof(qb_native_proc_record) * (QB_G(native_proc_count) + 1), TRUE);
+				record = &QB_G(native_procs)[QB_G(native_proc_count)++];
+				record->crc64 = crc64;
+				record->proc = request->native_proc;
+			}
+		}
+	}
+}
+
+static void qb_link_loaded_native_code(qb_native_compiler_context *cxt) {
+	USE_TSRM
+	uint32_t i;
+	if(!QB_G(native_proc_count)) {
+		return;
+	}
+	for(i = 0; i < cxt->compiler_context_count; i++) {
+		qb_compiler_context *compiler_cxt = cxt->compiler_contexts[i];
+		qb_function *qfunc = compiler_cxt->compiled_function;
+		if(!qfunc->native_proc && (compiler_cxt->function_flags & QB_FUNCTION_NATIVE_IF_POSSIBLE)) {
+			qfunc->native_proc = qb_find_native_proc(qfunc->instruction_crc64 TSRMLS_CC);
+		}
+	}
+}
+
+static int32_t qb_load_native_code(qb_native_compiler_context *cxt) {
 	int32_t success = FALSE;
 
+	// load the object file produced by the compiler into memory
+	if(qb_load_object_file(cxt)) {
+		if(cxt->qb_version == QB_NATIVE_CODE_SIGNATURE) {
+			qb_add_native_code_bundle(cxt);
+			success = TRUE;
+		} else {
+			qb_detach_symbols(cxt);
+		}
+	}
+	if(!success) {
+		qb_remove_object_file(cxt);
+	}
+	return success;
+}
+
+static int32_t qb_load_cached_native_code(qb_native_compiler_context *cxt) {
+	USE_TSRM
+	qb_cpu_level cpu_level = cxt->cpu_level;
+	int32_t level, success = FALSE;
+
+	// look for an object file built for this CPU, then for ones built for lesser CPUs
+	for(level = cpu_level; level >= QB_CPU_LEVEL_GENERIC && !success; level--) {
+		cxt->cpu_level = (qb_cpu_level) level;
+		qb_set_object_file_paths(cxt);
+		if(VCWD_ACCESS(cxt->obj_file_path, F_OK) == 0) {
+			// skip it if a compiler is still writing it
+			if(qb_lock_object_file(cxt)) {
+				success = qb_load_native_code(cxt);
+				qb_unlock_object_file(cxt);
+			}
+		}
+	}
+	if(success) {
+		cxt->loaded_cpu_level = cxt->cpu_level;
+	}
+	// anything new should be compiled for this CPU
+	cxt->cpu_level = cpu_level;
+	qb_set_object_file_paths(cxt);
+	return success;
+}
+
+static void qb_print_source(qb_native_compiler_context *cxt) {
+#if ZEND_DEBUG
+	// exclude macros, type declaration, and prototypes so they don't conflict with
+	// what's defined in the header files if we include generated code to debug it
+	qb_print(cxt, "#ifndef ZEND_DEBUG\n");
+#endif
+	// print macros and type definitions
+	qb_print_macros(cxt);
+	qb_print_typedefs(cxt);
+
+	// print prototypes of function referenced
+	qb_print_prototypes(cxt);
+#if ZEND_DEBUG
+	qb_print(cxt, "#endif\n");
+#endif
+	// print the current QB version
+	qb_print_version(cxt);
+
+	// print code of the qb functions themselves
+	qb_print_functions(cxt);
+
+#if ZEND_DEBUG
+	// print a table of the functions
+	qb_print_function_records(cxt);
+#endif
+}
+
+static int32_t qb_start_compiler(qb_native_compiler_context *cxt) {
+	USE_TSRM
+	if(!qb_decompress_code(cxt)) {
+		php_error_docref0(NULL TSRMLS_CC, E_WARNING, "Unable to decompress C source code");
+		return FALSE;
+	}
+
+	// launch compiler
+	if(!qb_launch_compiler(cxt)) {
+		php_error_docref0(NULL TSRMLS_CC, E_WARNING, "Unable to launch compiler");
+		return FALSE;
+	}
+
+	qb_print_source(cxt);
+	cxt->compiling = TRUE;
+	return TRUE;
+}
+
+static void qb_finish_compilation(qb_native_compiler_context *cxt) {
+	// wait for compiler to finish and see if it emits any error messages
+	if(qb_wait_for_compiler_response(cxt)) {
+		qb_load_native_code(cxt);
+	} else {
+		qb_remove_object_file(cxt);
+	}
+	qb_unlock_object_file(cxt);
+	cxt->compiling = FALSE;
+}
+
+static void qb_add_native_code_request(qb_native_code_request **p_requests, uint32_t *p_count, qb_function *qfunc) {
+	qb_native_code_request *request;
+	if(!*p_requests) {
+		qb_create_array((void **) p_requests, p_count, sizeof(qb_native_code_request), 8);
+	}
+	request = qb_enlarge_array((void **) p_requests, 1);
+	request->function = qfunc;
+	request->native_proc = NULL;
+}
+
+#ifdef HAVE_LIBTCC
+#include "qb_native_compiler_tcc.c"
+#endif
+
+void qb_initialize_native_compiler(void) {
+#if defined(HAVE_LIBTCC) && defined(ZTS)
+	tcc_mutex = tsrm_mutex_alloc();
+#endif
+}
+
+void qb_free_native_compiler(void) {
+#if defined(HAVE_LIBTCC) && defined(ZTS)
+	tsrm_mutex_free(tcc_mutex);
+	tcc_mutex = NULL;
+#endif
+}
+
+static void qb_build_object_file_in_background(qb_native_compiler_context *cxt) {
+	USE_TSRM
+	int32_t background = cxt->background;
+	cxt->background = TRUE;
+	if(VCWD_ACCESS(cxt->obj_file_path, F_OK) != 0 && qb_lock_object_file(cxt)) {
+		if(qb_start_compiler(cxt)) {
+			qb_detach_compiler(cxt);
+			cxt->compiling = FALSE;
+		}
+		qb_unlock_object_file(cxt);
+	}
+	cxt->background = background;
+}
+
+static void qb_initialize_function_compiler_context(qb_native_compiler_context *cxt, qb_native_compiler_context *build_cxt, uint32_t index) {
+	// each function is printed into its own object file, so they can be compiled in parallel 
+	// and other processes can pick up the ones they need
+	memcpy(cxt, build_cxt, sizeof(qb_native_compiler_context));
+	cxt->compiler_contexts = &build_cxt->compiler_contexts[index];
+	cxt->compiler_context_count = 1;
+	cxt->requests = NULL;
+	cxt->request_count = 0;
+	cxt->file_id = cxt->compiler_contexts[0]->compiled_function->instruction_crc64;
+	qb_set_object_file_paths(cxt);
+}
+
+static void qb_free_function_compiler_context(qb_native_compiler_context *cxt) {
+	// the folder path belongs to the build's context
+	cxt->cache_folder_path = NULL;
+	if(cxt->requests) {
+		qb_destroy_array((void **) &cxt->requests);
+	}
+	qb_free_native_compiler_context(cxt);
+}
+
+void qb_compile_to_native_code(qb_native_compiler_context *cxt) {
+	USE_TSRM
+	qb_native_compiler_context *function_cxts;
+	uint32_t function_cxt_count = 0, running_count = 0, max_running_count, next_index = 0;
+	uint32_t i, j, level, prebuild_levels;
+
 #if ZEND_DEBUG
 	if(native_proc_table) {
 		// link the functions to code in qb_native_proc_debug.c instead of compiling them live
@@ -1260,89 +1627,203 @@ void qb_compile_to_native_code(qb_native_compiler_context *cxt) {
 	}
 #endif
 
+	// use code loaded during an earlier request
+	qb_link_loaded_native_code(cxt);
+
+#ifdef HAVE_LIBTCC
+	if(QB_G(native_compile_in_process)) {
+		// compile everything in one go without involving an external compiler
+		// fall back to the external compiler for whatever libtcc fails to produce
+		if(qb_compile_in_process(cxt)) {
+			return;
+		}
+	}
+#endif
+
 	// make sure the cache folder exists
 	qb_create_cache_folder(cxt);
 
-	// XOR the crc64 of the functions together and use it as the file id
-	cxt->file_id = 0;
+	// group the functions by crc64, since functions with the same code can use the same object file
+	function_cxts = emalloc(sizeof(qb_native_compiler_context) * cxt->compiler_context_count);
 	for(i = 0; i < cxt->compiler_context_count; i++) {
 		qb_compiler_context *compiler_cxt = cxt->compiler_contexts[i];
 		qb_function *qfunc = compiler_cxt->compiled_function;
 		if(!qfunc->native_proc && (compiler_cxt->function_flags & QB_FUNCTION_NATIVE_IF_POSSIBLE)) {
-			cxt->file_id ^= qfunc->instruction_crc64;
+			qb_native_compiler_context *function_cxt = NULL;
+			for(j = 0; j < function_cxt_count; j++) {
+				if(function_cxts[j].file_id == qfunc->instruction_crc64) {
+					function_cxt = &function_cxts[j];
+					break;
+				}
+			}
+			if(!function_cxt) {
+				function_cxt = &function_cxts[function_cxt_count++];
+				qb_initialize_function_compiler_context(function_cxt, cxt, i);
+			}
+			qb_add_native_code_request(&function_cxt->requests, &function_cxt->request_count, qfunc);
 		}
 	}
-	spprintf(&cxt->obj_file_path, 0, "%s%cQB%" PRIX64 ".o", cxt->cache_folder_path, PHP_DIR_SEPARATOR, cxt->file_id);
 
-#if ZEND_DEBUG
-	for(attempt = 2; attempt <= 2 && !success; attempt++) {
-#else
-	for(attempt = 1; attempt <= 2 && !success; attempt++) {
-#endif
+	// don't run more compilers at a time than there are CPU cores
+	max_running_count = (uint32_t) qb_get_cpu_count();
+	if(max_running_count < 1) {
+		max_running_count = 1;
+	}
 
+	for(i = 0; i < function_cxt_count; i++) {
+		qb_native_compiler_context *function_cxt = &function_cxts[i];
+#if !ZEND_DEBUG
 		// first, try to load a previously created object file
-		if(attempt == 2) {
-			if(!qb_decompress_code(cxt)) {
-				php_error_docref0(NULL TSRMLS_CC, E_WARNING, "Unable to decompress C source code");
-				break;
+		if(qb_load_cached_native_code(function_cxt)) {
+			if(function_cxt->loaded_cpu_level < function_cxt->cpu_level) {
+				// the cached code was built for a lesser CPU--build code for this one for later requests
+				qb_build_object_file_in_background(function_cxt);
 			}
+			continue;
+		}
+#endif
+		if(qb_lock_object_file(function_cxt)) {
+			if(!function_cxt->background) {
+				while(running_count >= max_running_count) {
+					// wait for the earliest one to finish
+					for(; !function_cxts[next_index].compiling; next_index++);
+					qb_finish_compilation(&function_cxts[next_index]);
+					running_count--;
+				}
+			}
+			if(qb_start_compiler(function_cxt)) {
+				if(function_cxt->background) {
+					// the lock is held by the compiler until it exits
+					qb_detach_compiler(function_cxt);
+					qb_unlock_object_file(function_cxt);
+					function_cxt->compiling = FALSE;
+				} else {
+					running_count++;
+				}
+			} else {
+				qb_unlock_object_file(function_cxt);
+			}
+		} else if(!function_cxt->background) {
+			// another process is compiling the same code--wait for it
+			if(qb_wait_for_object_file_lock(function_cxt)) {
+				qb_load_native_code(function_cxt);
+				qb_unlock_object_file(function_cxt);
+			}
+		}
+	}
+
+	// wait for the rest of the compilers to finish
+	for(i = 0; i < function_cxt_count; i++) {
+		qb_native_compiler_context *function_cxt = &function_cxts[i];
+		if(function_cxt->compiling) {
+			qb_finish_compilation(function_cxt);
+		}
+	}
 
-			// launch compiler
-			if(!qb_launch_compiler(cxt)) {
-				php_error_docref0(NULL TSRMLS_CC, E_WARNING, "Unable to launch compiler");
-				break;
+	// build object files for other CPUs in the background, so they're in the cache when
+	// a machine of that type shares the cache folder
+	prebuild_levels = qb_get_prebuild_cpu_levels(TSRMLS_C);
+	if(prebuild_levels) {
+		for(i = 0; i < function_cxt_count; i++) {
+			qb_native_compiler_context *function_cxt = &function_cxts[i];
+			qb_cpu_level cpu_level = function_cxt->cpu_level;
+			for(level = QB_CPU_LEVEL_GENERIC; level < QB_CPU_LEVEL_COUNT; level++) {
+				if((prebuild_levels & (1 << level)) && level != cpu_level) {
+					function_cxt->cpu_level = (qb_cpu_level) level;
+					qb_set_object_file_paths(function_cxt);
+					qb_build_object_file_in_background(function_cxt);
+				}
 			}
+			function_cxt->cpu_level = cpu_level;
+			qb_set_object_file_paths(function_cxt);
+		}
+	}
 
-#if ZEND_DEBUG
-			// exclude macros, type declaration, and prototypes so they don't conflict with
-			// what's defined in the header files if we include generated code to debug it
-			qb_print(cxt, "#ifndef ZEND_DEBUG\n");
-#endif
-			// print macros and type definitions
-			qb_print_macros(cxt);
-			qb_print_typedefs(cxt);
+	for(i = 0; i < function_cxt_count; i++) {
+		qb_native_compiler_context *function_cxt = &function_cxts[i];
+		for(j = 0; j < function_cxt->request_count; j++) {
+			qb_native_code_request *request = &function_cxt->requests[j];
+			if(request->native_proc) {
+				request->function->native_proc = request->native_proc;
+			} else if(function_cxt->background) {
+				// keep running the bytecode until the compiler is done
+				qb_add_native_code_request(&QB_G(native_code_requests), &QB_G(native_code_request_count), request->function);
+			}
+		}
+		qb_free_function_compiler_context(function_cxt);
+	}
+	efree(function_cxts);
+}
 
-			// print prototypes of function referenced
-			qb_print_prototypes(cxt);
-#if ZEND_DEBUG
-	qb_print(cxt, "#endif\n");
-#endif
-			// print the current QB version
-			qb_print_version(cxt);
+void qb_check_native_code_requests(TSRMLS_D) {
+	qb_native_compiler_context _cxt, *cxt = &_cxt;
+	double current_time;
+	uint32_t i, j, remaining;
 
-			// print code of the qb functions themselves
-			qb_print_functions(cxt);
+	if(!QB_G(native_code_request_count)) {
+		return;
+	}
 
-#if ZEND_DEBUG
-			// print a table of the functions
-			qb_print_function_records(cxt);
+	// don't check the file system on every call
+	current_time = qb_get_high_res_timestamp();
+	if(current_time < QB_G(native_code_check_time)) {
+		return;
+	}
+	QB_G(native_code_check_time) = current_time + QB_NATIVE_CODE_CHECK_INTERVAL;
+
+	memset(cxt, 0, sizeof(qb_native_compiler_context));
+	cxt->cache_folder_path = QB_G(native_code_cache_path);
+#ifndef _MSC_VER
+	cxt->lock_fd = -1;
 #endif
-			// wait for compiler to finish and see if it emits any error messages
-			if(!qb_wait_for_compiler_response(cxt)) {
-				break;
-			}
-		}
+	SAVE_TSRMLS
+	qb_create_cache_folder(cxt);
 
-		// load the object file produced by the compiler into memory
-		if(qb_load_object_file(cxt)) {
-			if(cxt->qb_version == QB_VERSION_SIGNATURE) {
-				qb_native_code_bundle *bundle;
-				if(!QB_G(native_code_bundles)) {
-					qb_create_array((void **) &QB_G(native_code_bundles), &QB_G(native_code_bundle_count), sizeof(qb_native_code_bundle), 8);
+	for(i = 0; i < QB_G(native_code_request_count); i++) {
+		qb_native_code_request *request = &QB_G(native_code_requests)[i];
+		if(!request->native_proc && request->function) {
+			// the compiler releases the lock when it exits
+			cxt->file_id = request->function->instruction_crc64;
+			cxt->cpu_level = qb_get_cpu_level();
+			qb_set_object_file_paths(cxt);
+			if(qb_lock_object_file(cxt)) {
+				// load the code for every request with the same crc64
+				cxt->requests = request;
+				cxt->request_count = QB_G(native_code_request_count) - i;
+				if(!qb_load_native_code(cxt)) {
+					// compilation failed--stay with the bytecode
+					for(j = i; j < QB_G(native_code_request_count); j++) {
+						qb_native_code_request *other = &QB_G(native_code_requests)[j];
+						if(other->function && other->function->instruction_crc64 == cxt->file_id) {
+							other->function = NULL;
+						}
+					}
 				}
-				bundle = qb_enlarge_array((void **) &QB_G(native_code_bundles), 1);
-				bundle->memory = cxt->binary;
-				bundle->size = cxt->binary_size;
-				cxt->binary = NULL;
-				success = TRUE;
-			} else {
-				qb_detach_symbols(cxt);
+				qb_unlock_object_file(cxt);
 			}
+			efree(cxt->obj_file_path);
+			efree(cxt->lock_file_path);
+			cxt->obj_file_path = NULL;
+			cxt->lock_file_path = NULL;
 		}
-		if(!success) {
-			qb_remove_object_file(cxt);
+	}
+
+	for(i = 0, remaining = 0; i < QB_G(native_code_request_count); i++) {
+		qb_native_code_request *request = &QB_G(native_code_requests)[i];
+		if(request->native_proc && !request->function->in_use) {
+			// swap in the native code, unless the function is running (or is a suspended generator)
+			// copies pick it up when they're acquired
+			request->function->native_proc = request->native_proc;
+		} else if(request->function) {
+			QB_G(native_code_requests)[remaining++] = *request;
 		}
-	} 
+	}
+	QB_G(native_code_request_count) = remaining;
+	if(!remaining) {
+		qb_destroy_array((void **) &QB_G(native_code_requests));
+		QB_G(native_code_requests) = NULL;
+	}
+	qb_free_native_compiler_context(cxt);
 }
 
 void qb_initialize_native_compiler_context(qb_native_compiler_context *cxt, qb_build_context *build_cxt TSRMLS_DC) {
@@ -1364,9 +1845,17 @@ void qb_initialize_native_compiler_context(qb_native_compiler_context *cxt, qb_b
 	cxt->print_source = QB_G(show_native_source);
 	cxt->compiler_contexts = build_cxt->compiler_contexts;
 	cxt->compiler_context_count = build_cxt->compiler_context_count;
+#ifndef _MSC_VER
+	cxt->lock_fd = -1;
+#endif
 	SAVE_TSRMLS
 
+	// compile in the background if it's okay to run the bytecode in the meantime
+	cxt->background = QB_G(native_compile_in_background) && QB_G(allow_bytecode_interpretation);
+
 	cxt->cache_folder_path = QB_G(native_code_cache_path);
+	cxt->cpu_level = qb_get_cpu_level();
+	cxt->loaded_cpu_level = cxt->cpu_level;
 }
 
 void qb_free_native_compiler_context(qb_native_compiler_context *cxt) {
@@ -1389,7 +1878,17 @@ void qb_free_native_compiler_context(qb_native_compiler_context *cxt) {
 	if(cxt->c_file_path) {
 		efree(cxt->c_file_path);
 	}
+	if(cxt->lock_file_path) {
+		efree(cxt->lock_file_path);
+	}
+	qb_unlock_object_file(cxt);
 
+#ifdef HAVE_LIBTCC
+	if(cxt->source) {
+		// allocated by open_memstream()
+		free(cxt->source);
+	}
+#endif
 #ifdef __GNUC__
 	if(cxt->binary) {
 		munmap(cxt->binary, cxt->binary_size);
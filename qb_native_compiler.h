@@ -26,6 +26,11 @@
 typedef struct qb_native_compiler_context	qb_native_compiler_context;
 
 typedef enum qb_access_method				qb_access_method; 
+typedef enum qb_cpu_level					qb_cpu_level;
+
+// increment when the layout of structures used by native code changes, so stale object files are rebuilt
+#define QB_NATIVE_CODE_REVISION				1
+#define QB_NATIVE_CODE_SIGNATURE			(QB_VERSION_SIGNATURE ^ (QB_NATIVE_CODE_REVISION << 24))
 
 enum qb_access_method {
 	QB_SCALAR_LITERAL = 0,
@@ -39,6 +44,19 @@ enum qb_access_method {
 	QB_ARRAY_UNUSED = -1,
 };
 
+// instruction set extensions native code can be compiled for; object files are keyed by level
+enum qb_cpu_level {
+	QB_CPU_LEVEL_GENERIC = 0,
+	QB_CPU_LEVEL_SSE2,
+	QB_CPU_LEVEL_AVX2,
+	QB_CPU_LEVEL_AVX512,
+
+	QB_CPU_LEVEL_COUNT,
+};
+
+// how often to check whether code compiled in the background is ready, in seconds
+#define QB_NATIVE_CODE_CHECK_INTERVAL	0.1
+
 #define QB_NATIVE_FUNCTION_RET 			void
 #define QB_NATIVE_FUNCTION_ATTR
 #define QB_NATIVE_FUNCTION_ARGS 		qb_interpreter_context *__restrict cxt
@@ -54,6 +72,9 @@ struct qb_native_compiler_context {
 	uint32_t compiler_context_count;
 	qb_data_pool *pool;
 
+	qb_native_code_request *requests;
+	uint32_t request_count;
+
 	qb_op **ops;
 	uint32_t op_count;
 	qb_variable **variables;
@@ -88,19 +109,33 @@ struct qb_native_compiler_context {
 	char *cache_folder_path;
 	char *obj_file_path;
 	char *c_file_path;
+	char *lock_file_path;
 	uint64_t file_id;
 	uint32_t qb_version;
+	qb_cpu_level cpu_level;
+	qb_cpu_level loaded_cpu_level;
 
 #ifdef _MSC_VER
 	HANDLE msc_thread;
 	HANDLE msc_process;
+	HANDLE lock_file;
+#else
+	pid_t compiler_pid;
+	int lock_fd;
 #endif
 
 	char *binary;
 	uint32_t binary_size;
 
+#ifdef HAVE_LIBTCC
+	char *source;
+	size_t source_length;
+#endif
+
 	int32_t print_errors;
 	int32_t print_source;
+	int32_t background;
+	int32_t compiling;
 
 #ifdef ZTS
 	void ***tsrm_ls;
@@ -113,10 +148,15 @@ struct qb_native_compiler_context {
 extern qb_native_symbol global_native_symbols[];
 extern uint32_t global_native_symbol_count;
 
+void qb_initialize_native_compiler(void);
+void qb_free_native_compiler(void);
 void qb_free_native_code(qb_native_code_bundle *bundle);
 void qb_compile_to_native_code(qb_native_compiler_context *cxt);
 void qb_initialize_native_compiler_context(qb_native_compiler_context *cxt, qb_build_context *build_cxt TSRMLS_DC);
 void qb_free_native_compiler_context(qb_native_compiler_context *cxt);
+void qb_check_native_code_requests(TSRMLS_D);
+qb_cpu_level qb_get_cpu_level(void);
+const char * qb_get_cpu_level_name(qb_cpu_level level);
 
 #endif
 
@@ -22,6 +22,7 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <sys/file.h>
 #include <unistd.h>
 #include <fcntl.h>
 
@@ -29,6 +30,11 @@
 
 #define LP64_USE_PIC	1
 
+#ifndef MAP_FIXED_NOREPLACE
+// older kernels treat the address as a hint, and we check where the mapping ends up anyway
+#define MAP_FIXED_NOREPLACE		0
+#endif
+
 static void qb_create_cache_folder(qb_native_compiler_context *cxt) {
 	uint32_t len = (uint32_t) strlen(cxt->cache_folder_path);
 	if(len == 0) {
@@ -61,19 +67,36 @@ static int32_t qb_launch_compiler(qb_native_compiler_context *cxt) {
 
 	pid_t pid = fork();
 	if(pid == 0) {
+		if(cxt->background) {
+			// fork again so the compiler is adopted by init and doesn't linger as a zombie
+			if(fork() != 0) {
+				_exit(0);
+			}
+		}
+
 		// set up stdin, stdout, and stderr
 		dup2(gcc_pipe_write[0], STDIN_FILENO);
-		dup2(gcc_pipe_read[1], STDOUT_FILENO);
-		dup2(gcc_pipe_error[1], STDERR_FILENO);
-		close(gcc_pipe_write[0]);
-		close(gcc_pipe_write[1]);
-		close(gcc_pipe_read[0]);
-		close(gcc_pipe_read[1]);
-		close(gcc_pipe_error[0]);
-		close(gcc_pipe_error[1]);
+		if(cxt->background) {
+			// no one is going to read the output
+			int null_fd = open("/dev/null", O_WRONLY);
+			dup2(null_fd, STDOUT_FILENO);
+			dup2(null_fd, STDERR_FILENO);
+		} else {
+			dup2(gcc_pipe_read[1], STDOUT_FILENO);
+			dup2(gcc_pipe_error[1], STDERR_FILENO);
+		}
+
+		// close everything else except the lock, which is released when the compiler exits
+		int fd, max_fd = (int) sysconf(_SC_OPEN_MAX);
+		for(fd = STDERR_FILENO + 1; fd < max_fd; fd++) {
+			if(fd != cxt->lock_fd) {
+				close(fd);
+			}
+		}
 
 		// start gcc
 		const char *args[32];
+		const char **option;
 		int argc = 0;
 		if(strlen(compiler_path) > 0) {
 			args[argc++] = compiler_path;
@@ -82,16 +105,11 @@ static int32_t qb_launch_compiler(qb_native_compiler_context *cxt) {
 		}
 		args[argc++] = "-c";
 		args[argc++] = "-O2";										// optimization level
+		for(option = qb_cpu_level_options[cxt->cpu_level]; *option; option++) {
+			args[argc++] = *option;									// instruction set extensions of the target CPU level
+		}
 #ifdef HAVE_GCC_MARCH_NATIVE
-		args[argc++] = "-march=native";								// optimize for current CPU
-#elif defined(__SSE4__)
-		args[argc++] = "-msse4";
-#elif defined(__SSE3__)
-		args[argc++] = "-msse3";
-#elif defined(__SSE2__)
-		args[argc++] = "-msse2";
-#elif defined(__SSE__)
-		args[argc++] = "-msse";
+		args[argc++] = "-mtune=native";								// schedule for current CPU without using its extensions
 #endif
 		args[argc++] = "-pipe";										// use pipes for internal communication
 #if !ZEND_DEBUG
@@ -124,6 +142,15 @@ static int32_t qb_launch_compiler(qb_native_compiler_context *cxt) {
 	close(gcc_pipe_read[1]);
 	close(gcc_pipe_error[1]);
 
+	if(cxt->background) {
+		// reap the intermediate process
+		if(pid > 0) {
+			waitpid(pid, NULL, 0);
+		}
+	} else {
+		cxt->compiler_pid = pid;
+	}
+
 	cxt->write_stream = fdopen(gcc_pipe_write[1], "w");
 	cxt->read_stream = fdopen(gcc_pipe_read[0], "r");
 	cxt->error_stream = fdopen(gcc_pipe_error[0], "r");
@@ -147,7 +174,10 @@ static int32_t qb_wait_for_compiler_response(qb_native_compiler_context *cxt) {
 
 	// wait for the gcc to finish
 	int status;
-	wait(&status);
+	if(waitpid(cxt->compiler_pid, &status, 0) == -1) {
+		return FALSE;
+	}
+	cxt->compiler_pid = 0;
 
 	if(status == -1) {
 		return FALSE;
@@ -155,6 +185,47 @@ static int32_t qb_wait_for_compiler_response(qb_native_compiler_context *cxt) {
 	return TRUE;
 }
 
+static void qb_detach_compiler(qb_native_compiler_context *cxt) {
+	// closing the write stream lets the compiler start working
+	fclose(cxt->write_stream);
+	cxt->write_stream = NULL;
+}
+
+static int32_t qb_lock_object_file(qb_native_compiler_context *cxt) {
+	cxt->lock_fd = open(cxt->lock_file_path, O_RDWR | O_CREAT, 0666);
+	if(cxt->lock_fd == -1) {
+		return FALSE;
+	}
+	if(flock(cxt->lock_fd, LOCK_EX | LOCK_NB) == -1) {
+		// another process is compiling the code
+		close(cxt->lock_fd);
+		cxt->lock_fd = -1;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static int32_t qb_wait_for_object_file_lock(qb_native_compiler_context *cxt) {
+	cxt->lock_fd = open(cxt->lock_file_path, O_RDWR | O_CREAT, 0666);
+	if(cxt->lock_fd == -1) {
+		return FALSE;
+	}
+	if(flock(cxt->lock_fd, LOCK_EX) == -1) {
+		close(cxt->lock_fd);
+		cxt->lock_fd = -1;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static void qb_unlock_object_file(qb_native_compiler_context *cxt) {
+	// the lock stays in effect if a compiler inherited the descriptor
+	if(cxt->lock_fd != -1) {
+		close(cxt->lock_fd);
+		cxt->lock_fd = -1;
+	}
+}
+
 static int32_t qb_check_symbol_strip_trailing_tag(qb_native_compiler_context *cxt, const char *name) {
 	// icc creates extra symbols ending in ..0, ..1, etc.
 	// don't know what they are
@@ -179,32 +250,214 @@ typedef struct qb_elf_entry {
 } qb_elf_entry;
 #pragma pack(pop)
 
-static void * qb_find_symbol_plt_entry(qb_native_compiler_context *cxt, const char *name) {
-	static qb_elf_entry *procedure_linkage_table = NULL;
-	uint32_t i, name_len = (uint32_t) strlen(name);
-	long hash_value = zend_get_hash_value(name, name_len + 1);
-	if(!procedure_linkage_table) {
-		procedure_linkage_table = mmap(NULL, sizeof(qb_elf_entry) * global_native_symbol_count, PROT_EXEC | PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
-	}
-	for(i = 0; i < global_native_symbol_count; i++) {
-		qb_native_symbol *symbol = &global_native_symbols[i];
-		if(symbol->hash_value == hash_value) {
-			if(strcmp(symbol->name, name) == 0) {
-				qb_elf_entry *plt_entry = &procedure_linkage_table[i];
-				if(!plt_entry->opcode) {
-					plt_entry->opcode = 0x25FF;
-					plt_entry->rip_address = 2;
-					plt_entry->function_address = qb_get_symbol_address(cxt, symbol);
+static void * qb_get_plt_entry(qb_elf_entry *procedure_linkage_table, uint32_t *p_entry_count, void *function_address) {
+	// the table is part of the image itself, so a copy of the image mapped by another process works too
+	qb_elf_entry *plt_entry;
+	uint32_t i;
+	for(i = 0; i < *p_entry_count; i++) {
+		plt_entry = &procedure_linkage_table[i];
+		if(plt_entry->function_address == function_address) {
+			return plt_entry;
+		}
+	}
+	plt_entry = &procedure_linkage_table[(*p_entry_count)++];
+	plt_entry->opcode = 0x25FF;
+	plt_entry->rip_address = 2;
+	plt_entry->padding = 0;
+	plt_entry->function_address = function_address;
+	return plt_entry;
+}
+#endif
+
+typedef struct qb_native_image_header		qb_native_image_header;
+typedef struct qb_native_image_reference	qb_native_image_reference;
+typedef struct qb_native_image_proc			qb_native_image_proc;
+
+#define QB_NATIVE_IMAGE_SIGNATURE		0x49425151	// "QQBI"
+#define QB_NATIVE_IMAGE_MAX_PROC_COUNT	16
+
+// an image file holds code that has already been relocated to a particular address, which
+// other processes can map directly, as long as the address is free and the external
+// symbols are where they were in the process that did the linking (true for workers
+// forked from the same parent)
+struct qb_native_image_header {
+	uint32_t signature;
+	uint32_t qb_version;
+	uint64_t base_address;
+	uint64_t size;
+	uint64_t code_offset;
+	uint32_t reference_offset;
+	uint32_t reference_count;
+	uint32_t proc_count;
+	uint32_t reserved;
+};
+
+struct qb_native_image_reference {
+	uint32_t symbol_index;
+	uint32_t reserved;
+	void *address;
+};
+
+struct qb_native_image_proc {
+	uint64_t crc64;
+	uint64_t offset;
+};
+
+static void qb_add_image_reference(qb_native_image_reference *references, uint32_t *p_reference_count, int32_t symbol_index, void *address) {
+	uint32_t i;
+	for(i = 0; i < *p_reference_count; i++) {
+		if(references[i].symbol_index == (uint32_t) symbol_index) {
+			return;
+		}
+	}
+	references[*p_reference_count].symbol_index = symbol_index;
+	references[*p_reference_count].reserved = 0;
+	references[*p_reference_count].address = address;
+	(*p_reference_count)++;
+}
+
+static char * qb_get_image_file_path(qb_native_compiler_context *cxt) {
+	// QBXXXX-level.o -> QBXXXX-level.img
+	char *image_file_path;
+	int len = (int) strlen(cxt->obj_file_path) - 2;
+	spprintf(&image_file_path, 0, "%.*s.img", len, cxt->obj_file_path);
+	return image_file_path;
+}
+
+static void qb_save_native_image(qb_native_compiler_context *cxt, uint32_t reference_offset, uint32_t reference_count) {
+	qb_native_image_header header;
+	qb_native_image_proc procs[QB_NATIVE_IMAGE_MAX_PROC_COUNT];
+	uint32_t i, j, proc_count = 0;
+	size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+	char *image_file_path, *temp_file_path;
+	int fd;
+
+	for(i = 0; i < cxt->request_count; i++) {
+		qb_native_code_request *request = &cxt->requests[i];
+		if(request->native_proc && request->function) {
+			uint64_t crc64 = request->function->instruction_crc64;
+			for(j = 0; j < proc_count; j++) {
+				if(procs[j].crc64 == crc64) {
+					break;
+				}
+			}
+			if(j == proc_count) {
+				if(proc_count == sizeof(procs) / sizeof(procs[0])) {
+					return;
 				}
-				if(plt_entry->function_address) {
-					return plt_entry;
+				procs[proc_count].crc64 = crc64;
+				procs[proc_count].offset = (char *) request->native_proc - cxt->binary;
+				proc_count++;
+			}
+		}
+	}
+
+	header.signature = QB_NATIVE_IMAGE_SIGNATURE;
+	header.qb_version = cxt->qb_version;
+	header.base_address = (uintptr_t) cxt->binary;
+	header.size = cxt->binary_size;
+	header.code_offset = ALIGN_TO(sizeof(header) + sizeof(qb_native_image_proc) * proc_count, page_size);
+	header.reference_offset = reference_offset;
+	header.reference_count = reference_count;
+	header.proc_count = proc_count;
+	header.reserved = 0;
+
+	// write to a temporary file first, since other processes might have the current one mapped
+	image_file_path = qb_get_image_file_path(cxt);
+	spprintf(&temp_file_path, 0, "%s.%d", image_file_path, (int) getpid());
+	fd = open(temp_file_path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if(fd != -1) {
+		int32_t success = FALSE;
+		if(write(fd, &header, sizeof(header)) == sizeof(header)
+		&& write(fd, procs, sizeof(qb_native_image_proc) * proc_count) == (ssize_t) (sizeof(qb_native_image_proc) * proc_count)
+		&& pwrite(fd, cxt->binary, cxt->binary_size, header.code_offset) == (ssize_t) cxt->binary_size) {
+			success = TRUE;
+		}
+		close(fd);
+		if(!success || rename(temp_file_path, image_file_path) == -1) {
+			unlink(temp_file_path);
+		}
+	}
+	efree(temp_file_path);
+	efree(image_file_path);
+}
+
+static int32_t qb_map_native_image(qb_native_compiler_context *cxt) {
+	qb_native_image_header header;
+	qb_native_image_proc *procs;
+	qb_native_image_reference *references;
+	size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+	struct stat stat_buf;
+	char *image_file_path, *binary;
+	uint32_t i, j, count = 0;
+	int32_t valid = TRUE;
+	int fd;
+
+	image_file_path = qb_get_image_file_path(cxt);
+	fd = open(image_file_path, O_RDONLY);
+	efree(image_file_path);
+	if(fd == -1) {
+		return FALSE;
+	}
+	if(read(fd, &header, sizeof(header)) != sizeof(header) || fstat(fd, &stat_buf) == -1
+	|| header.signature != QB_NATIVE_IMAGE_SIGNATURE || header.qb_version != QB_NATIVE_CODE_SIGNATURE
+	|| header.code_offset % page_size != 0 || (uint64_t) stat_buf.st_size < header.code_offset + header.size
+	|| header.reference_offset + (uint64_t) header.reference_count * sizeof(qb_native_image_reference) > header.size
+	|| header.proc_count > QB_NATIVE_IMAGE_MAX_PROC_COUNT
+	|| sizeof(header) + (uint64_t) header.proc_count * sizeof(qb_native_image_proc) > header.code_offset) {
+		close(fd);
+		return FALSE;
+	}
+	procs = emalloc(sizeof(qb_native_image_proc) * header.proc_count);
+	if(read(fd, procs, sizeof(qb_native_image_proc) * header.proc_count) != (ssize_t) (sizeof(qb_native_image_proc) * header.proc_count)) {
+		efree(procs);
+		close(fd);
+		return FALSE;
+	}
+
+	// the code only works at the address it was relocated to
+	binary = mmap((void *) (uintptr_t) header.base_address, header.size, PROT_EXEC | PROT_READ, MAP_SHARED | MAP_FIXED_NOREPLACE, fd, header.code_offset);
+	close(fd);
+	if(binary == MAP_FAILED) {
+		efree(procs);
+		return FALSE;
+	}
+	if(binary != (char *) (uintptr_t) header.base_address) {
+		munmap(binary, header.size);
+		efree(procs);
+		return FALSE;
+	}
+
+	// see if the functions the code calls are at the same addresses here
+	references = (qb_native_image_reference *) (binary + header.reference_offset);
+	for(i = 0; i < header.reference_count; i++) {
+		qb_native_image_reference *reference = &references[i];
+		if(reference->symbol_index >= global_native_symbol_count || qb_get_symbol_address(cxt, &global_native_symbols[reference->symbol_index]) != reference->address) {
+			valid = FALSE;
+			break;
+		}
+	}
+	if(valid) {
+		for(i = 0; i < header.proc_count; i++) {
+			for(j = 0; j < cxt->request_count; j++) {
+				qb_native_code_request *request = &cxt->requests[j];
+				if(request->function && request->function->instruction_crc64 == procs[i].crc64 && procs[i].offset < header.size) {
+					request->native_proc = binary + procs[i].offset;
+					count++;
 				}
 			}
 		}
 	}
-	return NULL;
+	efree(procs);
+	if(!count) {
+		munmap(binary, header.size);
+		return FALSE;
+	}
+	cxt->binary = binary;
+	cxt->binary_size = (uint32_t) header.size;
+	cxt->qb_version = header.qb_version;
+	return TRUE;
 }
-#endif
 
 #ifdef __LP64__
 #define EM_EXPECTED						EM_X86_64
@@ -282,12 +535,26 @@ static int32_t qb_parse_object_file(qb_native_compiler_context *cxt, int fd) {
 
 	int i, j;
 	uintptr_t address = sizeof(Elf_Ehdr);
+	uint32_t relocation_total = 0;
 	for(i = 0; i < section_count; i++) {
 		Elf_Shdr *section_header = &section_headers[i];
 		section_header->sh_addr = (section_header->sh_addralign > 1) ? ALIGN_TO(address, section_header->sh_addralign) : address;
 		address = section_header->sh_addr + section_header->sh_size;
+		if(section_header->sh_type == SHT_REL_EXPECTED) {
+			relocation_total += (uint32_t) (section_header->sh_size / sizeof(Elf_Rel));
+		}
 	}
 
+	// reserve room for the procedure linkage table and the list of external symbols used
+#ifdef LP64_USE_PIC
+	uintptr_t plt_offset = ALIGN_TO(address, 16);
+	uint32_t plt_entry_count = 0;
+	address = plt_offset + sizeof(qb_elf_entry) * relocation_total;
+#endif
+	uintptr_t reference_offset = ALIGN_TO(address, 16);
+	uint32_t reference_count = 0;
+	address = reference_offset + sizeof(qb_native_image_reference) * relocation_total;
+
 	// allocate memory
 	cxt->binary_size = address;
 	cxt->binary = mmap(NULL, cxt->binary_size, PROT_EXEC | PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
@@ -334,21 +601,19 @@ static int32_t qb_parse_object_file(qb_native_compiler_context *cxt, int fd) {
 					symbol_address = (cxt->binary + section_headers[symbol->st_shndx].sh_addr + symbol->st_value);
 				} else if(symbol_bind == STB_GLOBAL) {
 					// links to a symbol symbol
-#ifdef LP64_USE_PIC
-					if(reloc_type == R_X86_64_PLT32) {
-						symbol_address = qb_find_symbol_plt_entry(cxt, symbol_name);
-
-					} else {
-						symbol_address = qb_find_symbol(cxt, symbol_name);
-					}
-#else
-					symbol_address = qb_find_symbol(cxt, symbol_name);
-#endif
+					int32_t global_index = qb_find_symbol_index(cxt, symbol_name);
+					symbol_address = (global_index != -1) ? qb_get_symbol_address(cxt, &global_native_symbols[global_index]) : NULL;
 					if(!symbol_address) {
 						qb_report_missing_native_symbol_exception(0, symbol_name);
 						missing_symbol_count++;
 						continue;
 					}
+					qb_add_image_reference((qb_native_image_reference *) (cxt->binary + reference_offset), &reference_count, global_index, symbol_address);
+#ifdef LP64_USE_PIC
+					if(reloc_type == R_X86_64_PLT32) {
+						symbol_address = qb_get_plt_entry((qb_elf_entry *) (cxt->binary + plt_offset), &plt_entry_count, symbol_address);
+					}
+#endif
 				} else {
 					return FALSE;
 				}
@@ -437,13 +702,24 @@ static int32_t qb_parse_object_file(qb_native_compiler_context *cxt, int fd) {
 			}
 		}
 	}
+	if(count > 0 && cxt->qb_version == QB_NATIVE_CODE_SIGNATURE) {
+		// save the linked code so other processes can map it instead of linking it again
+		qb_save_native_image(cxt, (uint32_t) reference_offset, reference_count);
+	}
 	return (count > 0);
 }
 
 static int32_t qb_load_object_file(qb_native_compiler_context *cxt) {
-	// map the file into memory 
-	int fd = open(cxt->obj_file_path, O_RDONLY);
+	int fd;
 	int32_t result;
+
+	// see if the code has already been linked by another process
+	if(qb_map_native_image(cxt)) {
+		return TRUE;
+	}
+
+	// map the file into memory 
+	fd = open(cxt->obj_file_path, O_RDONLY);
 	if(fd == -1) {
 		return FALSE;
 	}
@@ -453,11 +729,15 @@ static int32_t qb_load_object_file(qb_native_compiler_context *cxt) {
 }
 
 static void qb_remove_object_file(qb_native_compiler_context *cxt) {
+	char *image_file_path;
 	if(cxt->binary) {
 		munmap(cxt->binary, cxt->binary_size);
 		cxt->binary = NULL;
 		cxt->binary_size = 0;
 	}
+	image_file_path = qb_get_image_file_path(cxt);
+	unlink(image_file_path);
+	efree(image_file_path);
 	unlink(cxt->obj_file_path);
 }
 
@@ -22,6 +22,7 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <sys/file.h>
 #include <unistd.h>
 #include <fcntl.h>
 
@@ -63,19 +64,36 @@ static int32_t qb_launch_compiler(qb_native_compiler_context *cxt) {
 
 	pid_t pid = fork();
 	if(pid == 0) {
+		if(cxt->background) {
+			// fork again so the compiler is adopted by init and doesn't linger as a zombie
+			if(fork() != 0) {
+				_exit(0);
+			}
+		}
+
 		// set up stdin, stdout, and stderr
 		dup2(gcc_pipe_write[0], STDIN_FILENO);
-		dup2(gcc_pipe_read[1], STDOUT_FILENO);
-		dup2(gcc_pipe_error[1], STDERR_FILENO);
-		close(gcc_pipe_write[0]);
-		close(gcc_pipe_write[1]);
-		close(gcc_pipe_read[0]);
-		close(gcc_pipe_read[1]);
-		close(gcc_pipe_error[0]);
-		close(gcc_pipe_error[1]);
+		if(cxt->background) {
+			// no one is going to read the output
+			int null_fd = open("/dev/null", O_WRONLY);
+			dup2(null_fd, STDOUT_FILENO);
+			dup2(null_fd, STDERR_FILENO);
+		} else {
+			dup2(gcc_pipe_read[1], STDOUT_FILENO);
+			dup2(gcc_pipe_error[1], STDERR_FILENO);
+		}
+
+		// close everything else except the lock, which is released when the compiler exits
+		int fd, max_fd = (int) sysconf(_SC_OPEN_MAX);
+		for(fd = STDERR_FILENO + 1; fd < max_fd; fd++) {
+			if(fd != cxt->lock_fd) {
+				close(fd);
+			}
+		}
 
 		// start gcc
-		const char *args[16];
+		const char *args[32];
+		const char **option;
 		int argc = 0;
 		if(strlen(compiler_path) > 0) {
 			args[argc++] = compiler_path;
@@ -84,6 +102,9 @@ static int32_t qb_launch_compiler(qb_native_compiler_context *cxt) {
 		}
 		args[argc++] = "-c";
 		args[argc++] = "-O2";										// optimization level
+		for(option = qb_cpu_level_options[cxt->cpu_level]; *option; option++) {
+			args[argc++] = *option;									// instruction set extensions of the target CPU level
+		}
 		args[argc++] = "-pipe";										// use pipes for internal communication
 #if !ZEND_DEBUG
 		args[argc++] = "-Wp,-w";									// disable preprocessor warning
@@ -107,6 +128,15 @@ static int32_t qb_launch_compiler(qb_native_compiler_context *cxt) {
 	close(gcc_pipe_read[1]);
 	close(gcc_pipe_error[1]);
 
+	if(cxt->background) {
+		// reap the intermediate process
+		if(pid > 0) {
+			waitpid(pid, NULL, 0);
+		}
+	} else {
+		cxt->compiler_pid = pid;
+	}
+
 	cxt->write_stream = fdopen(gcc_pipe_write[1], "w");
 	cxt->read_stream = fdopen(gcc_pipe_read[0], "r");
 	cxt->error_stream = fdopen(gcc_pipe_error[0], "r");
@@ -130,7 +160,10 @@ static int32_t qb_wait_for_compiler_response(qb_native_compiler_context *cxt) {
 
 	// wait for the gcc to finish
 	int status;
-	wait(&status);
+	if(waitpid(cxt->compiler_pid, &status, 0) == -1) {
+		return FALSE;
+	}
+	cxt->compiler_pid = 0;
 
 	if(status == -1) {
 		return FALSE;
@@ -138,6 +171,47 @@ static int32_t qb_wait_for_compiler_response(qb_native_compiler_context *cxt) {
 	return TRUE;
 }
 
+static void qb_detach_compiler(qb_native_compiler_context *cxt) {
+	// closing the write stream lets the compiler start working
+	fclose(cxt->write_stream);
+	cxt->write_stream = NULL;
+}
+
+static int32_t qb_lock_object_file(qb_native_compiler_context *cxt) {
+	cxt->lock_fd = open(cxt->lock_file_path, O_RDWR | O_CREAT, 0666);
+	if(cxt->lock_fd == -1) {
+		return FALSE;
+	}
+	if(flock(cxt->lock_fd, LOCK_EX | LOCK_NB) == -1) {
+		// another process is compiling the code
+		close(cxt->lock_fd);
+		cxt->lock_fd = -1;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static int32_t qb_wait_for_object_file_lock(qb_native_compiler_context *cxt) {
+	cxt->lock_fd = open(cxt->lock_file_path, O_RDWR | O_CREAT, 0666);
+	if(cxt->lock_fd == -1) {
+		return FALSE;
+	}
+	if(flock(cxt->lock_fd, LOCK_EX) == -1) {
+		close(cxt->lock_fd);
+		cxt->lock_fd = -1;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static void qb_unlock_object_file(qb_native_compiler_context *cxt) {
+	// the lock stays in effect if a compiler inherited the descriptor
+	if(cxt->lock_fd != -1) {
+		close(cxt->lock_fd);
+		cxt->lock_fd = -1;
+	}
+}
+
 #ifdef __x86_64__
 
 #pragma pack(push,1)
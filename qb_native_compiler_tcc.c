@@ -0,0 +1,160 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 5                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2012 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Chung Leong <cleong@cal.berkeley.edu>                        |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#include <sys/mman.h>
+
+#include <libtcc.h>
+
+#ifndef TCC_RELOCATE_AUTO
+#error "libtcc with the tcc_relocate(s, ptr) interface (0.9.26 or 0.9.27) is required"
+#endif
+
+#ifdef ZTS
+// libtcc keeps its compilation state in globals, so only one thread can use it at a time
+static MUTEX_T tcc_mutex;
+#endif
+
+static void qb_report_tcc_error(void *opaque, const char *message) {
+	qb_native_compiler_context *cxt = opaque;
+	if(cxt->print_errors) {
+		USE_TSRM
+		php_write((void *) message, strlen(message) TSRMLS_CC);
+		php_write("\n", 1 TSRMLS_CC);
+	}
+}
+
+static void qb_print_tcc_macros(qb_native_compiler_context *cxt) {
+	// older versions of TinyCC don't know these builtins (qb_print_macros() takes care of __builtin_bswap16)
+	qb_print(cxt, "#ifdef __TINYC__\n");
+	qb_print(cxt, "#define __builtin_bswap32(n)	((((n) & 0xFF000000U) >> 24) | (((n) & 0x00FF0000U) >> 8) | (((n) & 0x0000FF00U) << 8) | (((n) & 0x000000FFU) << 24))\n");
+	qb_print(cxt, "#define __builtin_bswap64(n)	((((uint64_t) __builtin_bswap32((uint32_t) (n))) << 32) | __builtin_bswap32((uint32_t) ((n) >> 32)))\n");
+	qb_print(cxt, "#endif\n");
+}
+
+static int32_t qb_run_tcc(qb_native_compiler_context *cxt) {
+	TCCState *state;
+	int32_t success = FALSE;
+	uint32_t i;
+
+#ifdef ZTS
+	tsrm_mutex_lock(tcc_mutex);
+#endif
+	state = tcc_new();
+	if(state) {
+		tcc_set_error_func(state, cxt, qb_report_tcc_error);
+		tcc_set_output_type(state, TCC_OUTPUT_MEMORY);
+
+		// resolve the functions the code calls to the ones linked into the extension
+		for(i = 0; i < global_native_symbol_count; i++) {
+			qb_native_symbol *symbol = &global_native_symbols[i];
+			if(!(symbol->flags & QB_NATIVE_SYMBOL_INLINE_FUNCTION)) {
+				void *address = qb_get_symbol_address(cxt, symbol);
+				if(address) {
+					tcc_add_symbol(state, symbol->name, address);
+				}
+			}
+		}
+
+		if(tcc_compile_string(state, cxt->source) == 0) {
+			int size = tcc_relocate(state, NULL);
+			if(size > 0) {
+				// place the code in memory we own, so it outlives the compiler state
+				// the memory is writable only while the code is being relocated into it
+				cxt->binary_size = (uint32_t) size;
+				cxt->binary = mmap(NULL, cxt->binary_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+				if(cxt->binary == MAP_FAILED) {
+					cxt->binary = NULL;
+				} else if(tcc_relocate(state, cxt->binary) == 0 && mprotect(cxt->binary, cxt->binary_size, PROT_EXEC | PROT_READ) == 0) {
+					success = TRUE;
+					for(i = 0; i < cxt->request_count; i++) {
+						qb_native_code_request *request = &cxt->requests[i];
+						if(!request->native_proc) {
+							char name[32];
+							void *address;
+							snprintf(name, sizeof(name), "QBN_%" PRIX64, request->function->instruction_crc64);
+							address = tcc_get_symbol(state, name);
+							if(address) {
+								qb_attach_symbol(cxt, name, address);
+							}
+							if(!request->native_proc) {
+								success = FALSE;
+							}
+						}
+					}
+				} else {
+					munmap(cxt->binary, cxt->binary_size);
+					cxt->binary = NULL;
+				}
+			}
+		}
+		tcc_delete(state);
+	}
+#ifdef ZTS
+	tsrm_mutex_unlock(tcc_mutex);
+#endif
+	return success;
+}
+
+static int32_t qb_compile_in_process(qb_native_compiler_context *cxt) {
+	USE_TSRM
+	int32_t success = FALSE;
+	uint32_t i;
+
+	for(i = 0; i < cxt->compiler_context_count; i++) {
+		qb_compiler_context *compiler_cxt = cxt->compiler_contexts[i];
+		qb_function *qfunc = compiler_cxt->compiled_function;
+		if(!qfunc->native_proc && (compiler_cxt->function_flags & QB_FUNCTION_NATIVE_IF_POSSIBLE)) {
+			qb_add_native_code_request(&cxt->requests, &cxt->request_count, qfunc);
+		}
+	}
+	if(!cxt->request_count) {
+		return TRUE;
+	}
+
+	if(!qb_decompress_code(cxt)) {
+		php_error_docref0(NULL TSRMLS_CC, E_WARNING, "Unable to decompress C source code");
+	} else {
+		// print the source code into memory
+		cxt->write_stream = open_memstream(&cxt->source, &cxt->source_length);
+		if(cxt->write_stream) {
+			qb_print_tcc_macros(cxt);
+			qb_print_source(cxt);
+			fclose(cxt->write_stream);
+			cxt->write_stream = NULL;
+
+			// the code was generated by this very process, so there's no need to check QB_VERSION
+			success = qb_run_tcc(cxt);
+			if(cxt->binary) {
+				qb_add_native_code_bundle(cxt);
+			}
+		}
+	}
+
+	for(i = 0; i < cxt->request_count; i++) {
+		qb_native_code_request *request = &cxt->requests[i];
+		if(request->native_proc) {
+			request->function->native_proc = request->native_proc;
+		}
+	}
+	qb_destroy_array((void **) &cxt->requests);
+	cxt->requests = NULL;
+	cxt->request_count = 0;
+	return success;
+}
@@ -34,7 +34,7 @@ static int32_t qb_launch_compiler(qb_native_compiler_context *cxt) {
 	USE_TSRM
 	const char *compiler_path = QB_G(compiler_path);
 	const char *compiler_env_path = QB_G(compiler_env_path);
-	const char *sse_option;
+	const char *arch_option;
 	HANDLE c_file;
 	char *command_line;
 	char *path_before = NULL;
@@ -43,13 +43,13 @@ static int32_t qb_launch_compiler(qb_native_compiler_context *cxt) {
 	PROCESS_INFORMATION pi;
 	SECURITY_ATTRIBUTES sa;
 	int file_descriptor;
-#ifndef  _WIN64
-	int cpu_flags[4];
-#endif
 	HANDLE pipe_error_write, pipe_err_read;
 
 	// open temporary c file for writing (Visual C doesn't accept input from stdin)
-	spprintf(&cxt->c_file_path, 0, "%s%cQB%" PRIX64 ".c", cxt->cache_folder_path, PHP_DIR_SEPARATOR, cxt->file_id);
+	if(cxt->c_file_path) {
+		efree(cxt->c_file_path);
+	}
+	spprintf(&cxt->c_file_path, 0, "%s%cQB%" PRIX64 "-%s.c", cxt->cache_folder_path, PHP_DIR_SEPARATOR, cxt->file_id, qb_get_cpu_level_name(cxt->cpu_level));
 	c_file = CreateFile(cxt->c_file_path, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
 	if(c_file == INVALID_HANDLE_VALUE) {
 		return FALSE;
@@ -61,11 +61,19 @@ static int32_t qb_launch_compiler(qb_native_compiler_context *cxt) {
 	sa.bInheritHandle = TRUE;
 	sa.nLength = sizeof(SECURITY_ATTRIBUTES);
 	sa.lpSecurityDescriptor = NULL;
-	if(!CreatePipe(&pipe_err_read, &pipe_error_write, &sa, 0)) {
-		return FALSE;
+	if(cxt->background) {
+		// no one is going to read the output
+		pipe_error_write = CreateFile("NUL", GENERIC_WRITE, FILE_SHARE_WRITE, &sa, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if(pipe_error_write == INVALID_HANDLE_VALUE) {
+			return FALSE;
+		}
+	} else {
+		if(!CreatePipe(&pipe_err_read, &pipe_error_write, &sa, 0)) {
+			return FALSE;
+		}
+		file_descriptor = _open_osfhandle((intptr_t) pipe_err_read, 0);
+		cxt->error_stream = _fdopen(file_descriptor, "r");
 	}
-	file_descriptor = _open_osfhandle((intptr_t) pipe_err_read, 0);
-	cxt->error_stream = _fdopen(file_descriptor, "r");
 
 	if(strlen(compiler_path) == 0) {
 		compiler_path = "cl";
@@ -81,20 +89,11 @@ static int32_t qb_launch_compiler(qb_native_compiler_context *cxt) {
 	// stop the appearance of pop up warnings
 	error_mode_before = SetErrorMode(0);
 
-#ifdef  _WIN64
-	// SSE2 is always available in x64 
-	sse_option = "";
-#else
-	// see if the CPU supports SSE
-	__cpuid(cpu_flags, 0x00000001);
-	if(cpu_flags[2] & (1 << 20) || cpu_flags[2] & (1 << 19) || cpu_flags[2] & (1 << 0) || cpu_flags[3] & (1 << 26)) {
-		sse_option = "/arch:SSE2";
-	} else if(cpu_flags[3] & (1 << 25)) {
-		sse_option = "/arch:SSE";
-	} else {
-		sse_option = "";
+	// instruction set extensions of the target CPU level
+	arch_option = qb_cpu_level_options[cxt->cpu_level][0];
+	if(!arch_option) {
+		arch_option = "";
 	}
-#endif
 
 	// /O2		maximize speed
 	// /Oy		enable frame pointer omission
@@ -104,9 +103,9 @@ static int32_t qb_launch_compiler(qb_native_compiler_context *cxt) {
 	// /w		disable all warnings
 	// /nologo	suppress startup banner
 #ifdef ZEND_DEBUG
-	spprintf(&command_line, 0, "\"%s\" /O2 /Oy /GS- /w /fp:precise %s /nologo /Fo\"%s\" /c \"%s\"", compiler_path, sse_option, cxt->obj_file_path, cxt->c_file_path);
+	spprintf(&command_line, 0, "\"%s\" /O2 /Oy /GS- /w /fp:precise %s /nologo /Fo\"%s\" /c \"%s\"", compiler_path, arch_option, cxt->obj_file_path, cxt->c_file_path);
 #else
-	spprintf(&command_line, 0, "\"%s\" /O2 /Oy /GS- /fp:precise %s /nologo /Fo\"%s\" /c \"%s\"", compiler_path, sse_option, cxt->obj_file_path, cxt->c_file_path);
+	spprintf(&command_line, 0, "\"%s\" /O2 /Oy /GS- /fp:precise %s /nologo /Fo\"%s\" /c \"%s\"", compiler_path, arch_option, cxt->obj_file_path, cxt->c_file_path);
 #endif
 
 	memset(&si, 0, sizeof(STARTUPINFO));
@@ -164,6 +163,55 @@ static int32_t qb_wait_for_compiler_response(qb_native_compiler_context *cxt) {
 	return TRUE;
 }
 
+static void qb_detach_compiler(qb_native_compiler_context *cxt) {
+	// close the write stream
+	fclose(cxt->write_stream);
+	cxt->write_stream = NULL;
+
+	// let the compiler run on its own; the c file is deleted when the object file is loaded
+	ResumeThread(cxt->msc_thread);
+	CloseHandle(cxt->msc_thread);
+	CloseHandle(cxt->msc_process);
+	cxt->msc_thread = NULL;
+	cxt->msc_process = NULL;
+}
+
+static int32_t qb_lock_object_file(qb_native_compiler_context *cxt) {
+	SECURITY_ATTRIBUTES sa;
+
+	// the handle is inherited by the compiler, so the file can't be opened again until it exits
+	sa.bInheritHandle = TRUE;
+	sa.nLength = sizeof(SECURITY_ATTRIBUTES);
+	sa.lpSecurityDescriptor = NULL;
+	cxt->lock_file = CreateFile(cxt->lock_file_path, GENERIC_WRITE, 0, &sa, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(cxt->lock_file == INVALID_HANDLE_VALUE) {
+		cxt->lock_file = NULL;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static int32_t qb_wait_for_object_file_lock(qb_native_compiler_context *cxt) {
+	USE_TSRM
+	DWORD time_limit = EG(timeout_seconds) ? EG(timeout_seconds) * 1000 : INFINITE;
+	DWORD time_waited = 0;
+	while(!qb_lock_object_file(cxt)) {
+		if(GetLastError() != ERROR_SHARING_VIOLATION || time_waited >= time_limit) {
+			return FALSE;
+		}
+		Sleep(50);
+		time_waited += 50;
+	}
+	return TRUE;
+}
+
+static void qb_unlock_object_file(qb_native_compiler_context *cxt) {
+	if(cxt->lock_file) {
+		CloseHandle(cxt->lock_file);
+		cxt->lock_file = NULL;
+	}
+}
+
 #ifdef _WIN64	
 #define IMAGE_FILE_MACHINE		IMAGE_FILE_MACHINE_AMD64
 #define SYMBOL_PREFIX_LENGTH	0
@@ -392,6 +440,13 @@ static int32_t qb_load_object_file(qb_native_compiler_context *cxt) {
 	if(file == INVALID_HANDLE_VALUE) {
 		return FALSE;
 	}
+	if(!cxt->c_file_path) {
+		// delete the c file left behind by a compiler that ran in the background
+		char *c_file_path;
+		spprintf(&c_file_path, 0, "%s%cQB%" PRIX64 "-%s.c", cxt->cache_folder_path, PHP_DIR_SEPARATOR, cxt->file_id, qb_get_cpu_level_name(cxt->cpu_level));
+		DeleteFile(c_file_path);
+		efree(c_file_path);
+	}
 	result = qb_parse_object_file(cxt, file);
 	CloseHandle(file);
 	return result;
@@ -2833,6 +2833,24 @@ qb_simple_op_factory factory_fork_count = {
 	QB_FORK_CNT_U32,
 };
 
+qb_simple_op_factory factory_fork_next = {
+	NULL,
+	qb_resolve_expression_type_index,
+	NULL,
+	qb_coerce_operands_int,
+	qb_set_result_prototype,
+	NULL,
+	qb_set_result_temporary_value,
+	NULL,
+	qb_select_opcode_simple,
+	qb_transfer_operands_all,
+	NULL,
+	0,
+	QB_RESULT_HAS_SIDE_EFFECT,
+	0,
+	QB_FORK_NEXT_U32,
+};
+
 qb_fork_decomposer factory_fork = {
 	qb_decompose_fork,
 	&factory_fork_init,
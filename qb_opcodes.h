@@ -34,6 +34,9 @@ enum qb_opcode {
 	QB_FORK_CNT_U32,
 	QB_FORK_CNT_U32_SCA = QB_FORK_CNT_U32,
 	QB_FORK_CNT_U32_ELE,
+	QB_FORK_NEXT_U32,
+	QB_FORK_NEXT_U32_SCA = QB_FORK_NEXT_U32,
+	QB_FORK_NEXT_U32_ELE,
 	QB_RESUME,
 	QB_SPOON,
 	QB_INC_IF_GT_U32_U32,
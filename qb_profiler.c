@@ -0,0 +1,416 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 5                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2012 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Chung Leong <cleong@cal.berkeley.edu>                        |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#include "qb.h"
+
+#ifdef _MSC_VER
+#	include <intrin.h>
+#	include <process.h>
+#else
+#	include <unistd.h>
+#endif
+
+extern const char compressed_table_op_names[];
+
+#ifndef _MSC_VER
+#	define QB_INSTRUCTION_HANDLER(opcode)		op_handlers[opcode]
+#	define QB_PROFILE_HANDLER_ADDRESS			profile_handler
+#else
+#	define QB_INSTRUCTION_HANDLER(opcode)		((void *) (uintptr_t) (opcode))
+#	define QB_PROFILE_HANDLER_ADDRESS			((void *) (uintptr_t) QB_PROFILE_HANDLER)
+#endif
+
+static zend_always_inline uint64_t qb_read_cycle_counter(void) {
+#if defined(_MSC_VER)
+	return __rdtsc();
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	uint32_t lo, hi;
+	__asm__ __volatile__("rdtsc" : "=a" (lo), "=d" (hi));
+	return ((uint64_t) hi << 32) | lo;
+#else
+	// nanoseconds, if there's no time-stamp counter
+	return (uint64_t) (qb_get_high_res_timestamp() * 1000000000.0);
+#endif
+}
+
+static uint32_t qb_find_instruction_index(qb_function_profile *profile, uint32_t offset, uint32_t previous_index) {
+	uint32_t low, high;
+
+	// most of the time, it's the instruction that follows the previous one
+	if(previous_index + 1 < profile->instruction_count && profile->instruction_offsets[previous_index + 1] == offset) {
+		return previous_index + 1;
+	}
+	low = 0;
+	high = profile->instruction_count;
+	while(low < high) {
+		uint32_t middle = (low + high) >> 1;
+		if(profile->instruction_offsets[middle] < offset) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+void * qb_profile_instruction(qb_interpreter_context *cxt, int8_t *ip) {
+	qb_function *qfunc = cxt->function;
+	qb_function_profile *profile = qfunc->profile;
+	uint32_t index = qb_find_instruction_index(profile, (uint32_t) (ip - qfunc->instructions), cxt->profile_instruction_index);
+
+	// forked contexts go through here too, but only the context that started the call records anything
+	if(cxt->profile) {
+		uint64_t timestamp = qb_read_cycle_counter();
+		if(cxt->profile_instruction_index != INVALID_INDEX) {
+			profile->counters[cxt->profile_instruction_index].cycle_count += timestamp - cxt->profile_timestamp;
+		}
+		profile->counters[index].execution_count++;
+		cxt->profile_timestamp = timestamp;
+	}
+	cxt->profile_instruction_index = index;
+	return QB_INSTRUCTION_HANDLER(profile->instruction_opcodes[index]);
+}
+
+static void qb_set_instruction_handler(qb_function *qfunc, void **p_handler, uint32_t index, int32_t profiling) {
+	if(profiling) {
+		*p_handler = QB_PROFILE_HANDLER_ADDRESS;
+	} else {
+		*p_handler = QB_INSTRUCTION_HANDLER(qfunc->instruction_opcodes[index]);
+	}
+}
+
+static void qb_set_jump_handler(qb_function *qfunc, int8_t *ip, int32_t profiling) {
+	// the handler is followed by the instruction pointer it goes with
+	void **p_handler = (void **) ip;
+	int8_t **p_ip = (int8_t **) (ip + sizeof(void *));
+	uint32_t index = qb_find_instruction_index(qfunc->profile, (uint32_t) (*p_ip - qfunc->instructions), INVALID_INDEX);
+	qb_set_instruction_handler(qfunc, p_handler, index, profiling);
+}
+
+static void qb_set_instruction_handlers(qb_function *qfunc, int32_t profiling) {
+	qb_function_profile *profile = qfunc->profile;
+	uint32_t i, j;
+
+	// the handler of the first instruction is at the very beginning
+	qb_set_instruction_handler(qfunc, (void **) qfunc->instructions, 0, profiling);
+
+	for(i = 0; i < profile->instruction_count; i++) {
+		qb_opcode opcode = profile->instruction_opcodes[i];
+		uint32_t op_flags = qb_get_op_flags(opcode);
+		int8_t *ip = qfunc->instructions + profile->instruction_offsets[i];
+
+		if(op_flags & QB_OP_EXIT) {
+			// nothing
+		} else if(op_flags & QB_OP_BRANCH_TABLE) {
+			// the table is placed after the operands, ahead of the line id
+			uint32_t branch_count = qb_get_switch_table_size_from_opcode(opcode);
+			ip += qb_get_instruction_length(opcode);
+			if(op_flags & QB_OP_NEED_LINE_IDENTIFIER) {
+				ip -= sizeof(uint32_t);
+			}
+			ip -= branch_count * (sizeof(void *) + sizeof(int8_t *));
+			for(j = 0; j < branch_count; j++) {
+				qb_set_jump_handler(qfunc, ip, profiling);
+				ip += sizeof(void *) + sizeof(int8_t *);
+			}
+		} else if(op_flags & QB_OP_BRANCH) {
+			qb_set_jump_handler(qfunc, ip, profiling);
+			qb_set_jump_handler(qfunc, ip + sizeof(void *) + sizeof(int8_t *), profiling);
+		} else if(op_flags & QB_OP_JUMP) {
+			qb_set_jump_handler(qfunc, ip, profiling);
+		} else if(i + 1 < profile->instruction_count) {
+			qb_set_instruction_handler(qfunc, (void **) ip, i + 1, profiling);
+		}
+	}
+
+	if(profiling) {
+		qfunc->flags |= QB_FUNCTION_PROFILED;
+	} else {
+		qfunc->flags &= ~QB_FUNCTION_PROFILED;
+	}
+}
+
+static qb_function_profile * qb_create_function_profile(qb_function *qfunc) {
+	qb_function_profile *profile;
+	uint32_t count = qfunc->instruction_opcode_count;
+	uint32_t size = sizeof(qb_function_profile) + (sizeof(qb_profile_counter) + sizeof(uint32_t) * 2 + sizeof(uint16_t)) * count;
+	uint32_t offset, i;
+	int8_t *p;
+
+	p = emalloc(size);
+	profile = (qb_function_profile *) p; p += sizeof(qb_function_profile);
+	profile->counters = (qb_profile_counter *) p; p += sizeof(qb_profile_counter) * count;
+	profile->instruction_offsets = (uint32_t *) p; p += sizeof(uint32_t) * count;
+	profile->instruction_line_ids = (uint32_t *) p; p += sizeof(uint32_t) * count;
+	profile->instruction_opcodes = (uint16_t *) p;
+	profile->instruction_count = count;
+
+	profile->zend_op_array = qfunc->zend_op_array;
+	profile->instruction_crc64 = qfunc->instruction_crc64;
+	profile->name = qfunc->name;
+	profile->class_name = (qfunc->zend_op_array && qfunc->zend_op_array->scope) ? qfunc->zend_op_array->scope->name : NULL;
+	profile->line_id = qfunc->line_id;
+	profile->flags = 0;
+	profile->call_count = 0;
+	profile->cycle_count = 0;
+
+	// the function might be freed before the profile is, so copy what's needed
+	memset(profile->counters, 0, sizeof(qb_profile_counter) * count);
+	memcpy(profile->instruction_line_ids, qfunc->instruction_line_ids, sizeof(uint32_t) * count);
+	memcpy(profile->instruction_opcodes, qfunc->instruction_opcodes, sizeof(uint16_t) * count);
+	offset = sizeof(void *);
+	for(i = 0; i < count; i++) {
+		profile->instruction_offsets[i] = offset;
+		offset += qb_get_instruction_length(profile->instruction_opcodes[i]);
+	}
+	return profile;
+}
+
+static qb_function_profile * qb_get_function_profile(qb_function *qfunc TSRMLS_DC) {
+	qb_function_profile *profile, **p_profile;
+	uint32_t i;
+
+	// copies of the function share the same profile
+	for(i = 0; i < QB_G(function_profile_count); i++) {
+		profile = QB_G(function_profiles)[i];
+		if(profile->zend_op_array == qfunc->zend_op_array && profile->instruction_crc64 == qfunc->instruction_crc64) {
+			return profile;
+		}
+	}
+	profile = qb_create_function_profile(qfunc);
+	if(!QB_G(function_profiles)) {
+		qb_create_array((void **) &QB_G(function_profiles), &QB_G(function_profile_count), sizeof(qb_function_profile *), 16);
+	}
+	p_profile = qb_enlarge_array((void **) &QB_G(function_profiles), 1);
+	*p_profile = profile;
+	return profile;
+}
+
+void qb_begin_function_profiling(qb_interpreter_context *cxt) {
+	USE_TSRM
+	qb_function *qfunc = cxt->function;
+
+	cxt->profile = NULL;
+	cxt->profile_instruction_index = INVALID_INDEX;
+	if(!qb_in_main_thread()) {
+		// profiles can only be created in the main thread
+		return;
+	}
+	if(QB_G(profiling)) {
+		if(!qfunc->profile) {
+			qfunc->profile = qb_get_function_profile(qfunc TSRMLS_CC);
+		}
+		if(qfunc->native_proc) {
+			qfunc->profile->flags |= QB_PROFILE_NATIVE;
+		} else if(!(qfunc->flags & QB_FUNCTION_PROFILED)) {
+			qb_set_instruction_handlers(qfunc, TRUE);
+		}
+		cxt->profile = qfunc->profile;
+		cxt->profile_timestamp = cxt->profile_start_timestamp = qb_read_cycle_counter();
+	} else if(qfunc->flags & QB_FUNCTION_PROFILED) {
+		// profiling was stopped--restore the original handlers
+		qb_set_instruction_handlers(qfunc, FALSE);
+	}
+}
+
+void qb_end_function_profiling(qb_interpreter_context *cxt) {
+	qb_function_profile *profile = cxt->profile;
+	if(profile) {
+		uint64_t timestamp = qb_read_cycle_counter();
+		if(cxt->profile_instruction_index != INVALID_INDEX) {
+			profile->counters[cxt->profile_instruction_index].cycle_count += timestamp - cxt->profile_timestamp;
+		}
+		profile->call_count++;
+		profile->cycle_count += timestamp - cxt->profile_start_timestamp;
+		cxt->profile = NULL;
+	}
+}
+
+void qb_reset_profile(TSRMLS_D) {
+	uint32_t i;
+	for(i = 0; i < QB_G(function_profile_count); i++) {
+		qb_function_profile *profile = QB_G(function_profiles)[i];
+		memset(profile->counters, 0, sizeof(qb_profile_counter) * profile->instruction_count);
+		profile->call_count = 0;
+		profile->cycle_count = 0;
+	}
+}
+
+static char * qb_get_profile_function_name(qb_function_profile *profile) {
+	char *name;
+	if(profile->class_name) {
+		spprintf(&name, 0, "%s::%s", profile->class_name, profile->name);
+	} else {
+		spprintf(&name, 0, "%s", profile->name);
+	}
+	return name;
+}
+
+void qb_get_profile_data(zval *array TSRMLS_DC) {
+	const char **op_names = NULL;
+	uint32_t op_name_count = 0, i, j;
+
+	array_init(array);
+	if(QB_G(function_profile_count) > 0) {
+		qb_uncompress_table(compressed_table_op_names, (void ***) &op_names, &op_name_count, 0);
+	}
+	for(i = 0; i < QB_G(function_profile_count); i++) {
+		qb_function_profile *profile = QB_G(function_profiles)[i];
+		char *name = qb_get_profile_function_name(profile);
+		zval *function_data, *line_data, *op_data;
+
+		MAKE_STD_ZVAL(function_data);
+		array_init(function_data);
+		add_assoc_string(function_data, "file", (char *) qb_get_source_file_path(FILE_ID(profile->line_id) TSRMLS_CC), TRUE);
+		add_assoc_long(function_data, "line", LINE_NUMBER(profile->line_id));
+		add_assoc_bool(function_data, "native", (profile->flags & QB_PROFILE_NATIVE) != 0);
+		add_assoc_long(function_data, "calls", (long) profile->call_count);
+		add_assoc_long(function_data, "cycles", (long) profile->cycle_count);
+
+		MAKE_STD_ZVAL(line_data);
+		array_init(line_data);
+		MAKE_STD_ZVAL(op_data);
+		array_init(op_data);
+		for(j = 0; j < profile->instruction_count; j++) {
+			qb_profile_counter *counter = &profile->counters[j];
+			if(counter->execution_count > 0) {
+				uint32_t opcode = profile->instruction_opcodes[j];
+				uint32_t line_number = LINE_NUMBER(profile->instruction_line_ids[j]);
+				zval **p_line, *line, *op;
+
+				// add the numbers to the line's total
+				if(zend_hash_index_find(Z_ARRVAL_P(line_data), line_number, (void **) &p_line) == SUCCESS) {
+					zval **p_count, **p_cycles;
+					line = *p_line;
+					zend_hash_find(Z_ARRVAL_P(line), "count", sizeof("count"), (void **) &p_count);
+					zend_hash_find(Z_ARRVAL_P(line), "cycles", sizeof("cycles"), (void **) &p_cycles);
+					Z_LVAL_PP(p_count) += (long) counter->execution_count;
+					Z_LVAL_PP(p_cycles) += (long) counter->cycle_count;
+				} else {
+					MAKE_STD_ZVAL(line);
+					array_init(line);
+					add_assoc_long(line, "count", (long) counter->execution_count);
+					add_assoc_long(line, "cycles", (long) counter->cycle_count);
+					add_index_zval(line_data, line_number, line);
+				}
+
+				MAKE_STD_ZVAL(op);
+				array_init(op);
+				add_assoc_string(op, "op", (char *) ((opcode < op_name_count) ? op_names[opcode] : "?"), TRUE);
+				add_assoc_long(op, "line", line_number);
+				add_assoc_long(op, "count", (long) counter->execution_count);
+				add_assoc_long(op, "cycles", (long) counter->cycle_count);
+				add_next_index_zval(op_data, op);
+			}
+		}
+		add_assoc_zval(function_data, "lines", line_data);
+		add_assoc_zval(function_data, "ops", op_data);
+		add_assoc_zval(array, name, function_data);
+		efree(name);
+	}
+	if(op_names) {
+		efree((void *) op_names);
+	}
+}
+
+int32_t qb_dump_profile(const char *file_path TSRMLS_DC) {
+	uint64_t total_execution_count = 0, total_cycle_count = 0;
+	uint32_t i, j;
+	int32_t success = TRUE;
+	FILE *file;
+
+	// the summary line comes first, so add up everything beforehand
+	for(i = 0; i < QB_G(function_profile_count); i++) {
+		qb_function_profile *profile = QB_G(function_profiles)[i];
+		if(profile->flags & QB_PROFILE_NATIVE) {
+			total_execution_count += profile->call_count;
+			total_cycle_count += profile->cycle_count;
+		}
+		for(j = 0; j < profile->instruction_count; j++) {
+			total_execution_count += profile->counters[j].execution_count;
+			total_cycle_count += profile->counters[j].cycle_count;
+		}
+	}
+
+	file = VCWD_FOPEN(file_path, "w");
+	if(!file) {
+		return FALSE;
+	}
+
+	// see http://valgrind.org/docs/manual/cl-format.html
+	fprintf(file, "# callgrind format\n");
+	fprintf(file, "version: 1\n");
+	fprintf(file, "creator: qb %d.%d\n", QB_MAJOR_VERSION, QB_MINOR_VERSION);
+	fprintf(file, "positions: line\n");
+	fprintf(file, "events: Executions Cycles\n");
+	fprintf(file, "summary: %" PRIu64 " %" PRIu64 "\n", total_execution_count, total_cycle_count);
+
+	for(i = 0; i < QB_G(function_profile_count); i++) {
+		qb_function_profile *profile = QB_G(function_profiles)[i];
+		uint32_t file_id = FILE_ID(profile->line_id);
+		char *name = qb_get_profile_function_name(profile);
+
+		fprintf(file, "\nfl=%s\n", qb_get_source_file_path(file_id TSRMLS_CC));
+		fprintf(file, "fn=%s\n", name);
+		efree(name);
+
+		if(profile->flags & QB_PROFILE_NATIVE) {
+			// native code isn't instrumented--only the function as a whole is timed
+			fprintf(file, "%u %" PRIu64 " %" PRIu64 "\n", LINE_NUMBER(profile->line_id), profile->call_count, profile->cycle_count);
+		}
+		for(j = 0; j < profile->instruction_count; j++) {
+			qb_profile_counter *counter = &profile->counters[j];
+			if(counter->execution_count > 0) {
+				uint32_t line_id = profile->instruction_line_ids[j];
+				if(FILE_ID(line_id) != file_id) {
+					// code inlined from a different file
+					file_id = FILE_ID(line_id);
+					fprintf(file, "fi=%s\n", qb_get_source_file_path(file_id TSRMLS_CC));
+				}
+				fprintf(file, "%u %" PRIu64 " %" PRIu64 "\n", LINE_NUMBER(line_id), counter->execution_count, counter->cycle_count);
+			}
+		}
+	}
+	if(fclose(file) != 0) {
+		success = FALSE;
+	}
+	return success;
+}
+
+void qb_save_profile(TSRMLS_D) {
+	static uint32_t dump_count = 0;
+	char *file_path;
+
+	// use the same naming scheme as Valgrind so the files are picked up by KCachegrind
+	spprintf(&file_path, 0, "%s%ccallgrind.out.%d.%u", QB_G(profile_output_path), PHP_DIR_SEPARATOR, (int) getpid(), ++dump_count);
+	if(!qb_dump_profile(file_path TSRMLS_CC)) {
+		php_error_docref0(NULL TSRMLS_CC, E_WARNING, "Unable to write profile to %s", file_path);
+	}
+	efree(file_path);
+}
+
+void qb_free_function_profiles(TSRMLS_D) {
+	uint32_t i;
+	for(i = 0; i < QB_G(function_profile_count); i++) {
+		efree(QB_G(function_profiles)[i]);
+	}
+	qb_destroy_array((void **) &QB_G(function_profiles));
+	QB_G(function_profile_count) = 0;
+}
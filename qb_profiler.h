@@ -0,0 +1,69 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 5                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2012 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Chung Leong <cleong@cal.berkeley.edu>                        |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifndef QB_PROFILER_H_
+#define QB_PROFILER_H_
+
+typedef struct qb_profile_counter			qb_profile_counter;
+
+// value of next_handler that sends an instruction through the profiler when the loop is a switch() statement
+#define QB_PROFILE_HANDLER					QB_OPCODE_COUNT
+
+enum {
+	QB_PROFILE_NATIVE				= 0x00000001,
+};
+
+struct qb_profile_counter {
+	uint64_t execution_count;
+	uint64_t cycle_count;
+};
+
+struct qb_function_profile {
+	zend_op_array *zend_op_array;
+	uint64_t instruction_crc64;
+	const char *name;
+	const char *class_name;
+	uint32_t line_id;
+	uint32_t flags;
+
+	// the function as a whole, including time spent in functions it calls
+	uint64_t call_count;
+	uint64_t cycle_count;
+
+	// individual instructions (not available for native code)
+	qb_profile_counter *counters;
+	uint32_t *instruction_offsets;
+	uint32_t *instruction_line_ids;
+	uint16_t *instruction_opcodes;
+	uint32_t instruction_count;
+};
+
+void * qb_profile_instruction(qb_interpreter_context *cxt, int8_t *ip);
+
+void qb_begin_function_profiling(qb_interpreter_context *cxt);
+void qb_end_function_profiling(qb_interpreter_context *cxt);
+
+void qb_reset_profile(TSRMLS_D);
+void qb_get_profile_data(zval *array TSRMLS_DC);
+int32_t qb_dump_profile(const char *file_path TSRMLS_DC);
+void qb_save_profile(TSRMLS_D);
+void qb_free_function_profiles(TSRMLS_D);
+
+#endif
@@ -56,32 +56,62 @@ void qb_import_segment(qb_memory_segment *segment, qb_memory_segment *other_segm
 	}
 }
 
+static void qb_check_segment_size(uint64_t byte_count) {
+#if SIZE_MAX < UINT64_MAX
+	// the size would get truncated when passed to the memory manager
+	if(byte_count > SIZE_MAX) {
+		zend_error(E_ERROR, "Possible integer overflow in memory allocation (%" PRIu64 " bytes)", byte_count);
+	}
+#endif
+}
+
+static uint64_t qb_get_segment_allocation_size(uint64_t byte_count) {
+	if(byte_count <= QB_SEGMENT_RETENTION_LIMIT) {
+		// use power-of-two size classes, so retained memory can be reused even when the size varies a bit
+		uint64_t allocation = QB_SEGMENT_MIN_ALLOCATION;
+		while(allocation < byte_count) {
+			allocation <<= 1;
+		}
+		return allocation;
+	} else {
+		return ALIGN_TO(byte_count, QB_SEGMENT_MIN_ALLOCATION);
+	}
+}
+
 static void qb_allocate_segment_memory_in_main_thread(void *param1, void *param2, int param3) {
-	qb_allocate_segment_memory(param1, param3);
+	uint64_t *p_byte_count = param2;
+	qb_allocate_segment_memory(param1, *p_byte_count);
 }
 
-void qb_allocate_segment_memory(qb_memory_segment *segment, uint32_t byte_count) {
+void qb_allocate_segment_memory(qb_memory_segment *segment, uint64_t byte_count) {
 	if(segment->flags & QB_SEGMENT_IMPORTED) {
 		qb_allocate_segment_memory(segment->imported_segment, byte_count);
 	} else {
 		if(byte_count > segment->current_allocation) {
 			if(qb_in_main_thread()) {
-				uint32_t new_allocation = ALIGN_TO(byte_count, 1024);
-				uint32_t extra = new_allocation - byte_count;
-				int8_t *memory = (segment->current_allocation > 0) ? erealloc(segment->memory, new_allocation): emalloc(new_allocation);
-				int8_t *data_end = memory + byte_count;
+				uint64_t new_allocation = qb_get_segment_allocation_size(byte_count);
+				uint64_t extra = new_allocation - byte_count;
+				int8_t *memory;
+				int8_t *data_end;
+				qb_check_segment_size(new_allocation);
+				memory = (segment->current_allocation > 0) ? erealloc(segment->memory, (size_t) new_allocation): emalloc((size_t) new_allocation);
+				data_end = memory + byte_count;
 				segment->current_allocation = new_allocation;
-				memset(data_end, 0, extra);
+				memset(data_end, 0, (size_t) extra);
 				qb_relocate_segment_memory(segment, memory);
 				segment->byte_count = byte_count;
 			} else {
-				qb_run_in_main_thread(qb_allocate_segment_memory_in_main_thread, segment, NULL, byte_count);
+				// the size is passed by pointer since it might not fit in an int
+				qb_run_in_main_thread(qb_allocate_segment_memory_in_main_thread, segment, &byte_count, 0);
 			}
+		} else {
+			// memory retained from the previous call is large enough
+			segment->byte_count = byte_count;
 		}
 	}
 }
 
-static int32_t qb_connect_segment_to_memory(qb_memory_segment *segment, int8_t *memory, uint32_t byte_count, uint32_t bytes_available, int32_t ownership) {	
+static int32_t qb_connect_segment_to_memory(qb_memory_segment *segment, int8_t *memory, uint64_t byte_count, uint64_t bytes_available, int32_t ownership) {	
 	if(segment->flags & QB_SEGMENT_IMPORTED) {
 		return qb_connect_segment_to_memory(segment->imported_segment, memory, byte_count, bytes_available, ownership);
 	} else {
@@ -104,14 +134,14 @@ static int32_t qb_connect_segment_to_memory(qb_memory_segment *segment, int8_t *
 	}
 }
 
-static void * qb_map_file_to_memory(php_stream *stream, uint32_t byte_count, int32_t write_access TSRMLS_DC);
+static void * qb_map_file_to_memory(php_stream *stream, uint64_t byte_count, int32_t write_access TSRMLS_DC);
 static void qb_unmap_file_from_memory(php_stream *stream TSRMLS_DC);
 
-static int32_t qb_connect_segment_to_file(qb_memory_segment *segment, php_stream *stream, uint32_t byte_count, int32_t write_access) {
+static int32_t qb_connect_segment_to_file(qb_memory_segment *segment, php_stream *stream, uint64_t byte_count, int32_t write_access) {
 	if(segment->flags & QB_SEGMENT_IMPORTED) {
 		return qb_connect_segment_to_file(segment->imported_segment, stream, byte_count, write_access);
 	} else {
-		uint32_t bytes_available = byte_count;
+		uint64_t bytes_available = byte_count;
 		int8_t *memory;
 		TSRMLS_FETCH();
 		if(!bytes_available) {
@@ -175,12 +205,31 @@ void qb_release_segment(qb_memory_segment *segment) {
 	segment->current_allocation = 0;
 }
 
+void qb_recycle_segment(qb_memory_segment *segment) {
+	if(!(segment->flags & (QB_SEGMENT_IMPORTED | QB_SEGMENT_BORROWED | QB_SEGMENT_MAPPED)) && segment->current_allocation <= QB_SEGMENT_RETENTION_LIMIT) {
+		// keep the memory for the next call, in the state it'd be in had it been newly allocated
+		// (the function copy is used by one thread at a time, so no locking is needed)
+		if((segment->flags & QB_SEGMENT_EMPTY_ON_RETURN) && segment->current_allocation > 0) {
+			// clear the whole allocation, since a shrunken segment leaves data beyond byte_count
+			// that would reappear when the segment grows in place during the next call
+			memset(segment->memory, 0, (size_t) segment->current_allocation);
+		}
+	} else {
+		qb_release_segment(segment);
+	}
+}
+
+typedef struct qb_segment_resize_request {
+	uint64_t new_size;
+	intptr_t offset;
+} qb_segment_resize_request;
+
 void qb_resize_segment_in_main_thread(void *param1, void *param2, int param3) {
-	intptr_t *p_offset = param2;
-	*p_offset = qb_resize_segment(param1, param3);
+	qb_segment_resize_request *request = param2;
+	request->offset = qb_resize_segment(param1, request->new_size);
 }
 
-intptr_t qb_resize_segment(qb_memory_segment *segment, uint32_t new_size) {
+intptr_t qb_resize_segment(qb_memory_segment *segment, uint64_t new_size) {
 	if(segment->flags & QB_SEGMENT_IMPORTED) {
 		return qb_resize_segment(segment->imported_segment, new_size);
 	}
@@ -188,8 +237,9 @@ intptr_t qb_resize_segment(qb_memory_segment *segment, uint32_t new_size) {
 		if(qb_in_main_thread()) {
 			int8_t *current_data_end;
 			int8_t *memory;
-			uint32_t new_allocation = ALIGN_TO(new_size, 1024);
-			uint32_t addition = new_allocation - segment->current_allocation;
+			uint64_t new_allocation = qb_get_segment_allocation_size(new_size);
+
+			qb_check_segment_size(new_allocation);
 
 			if(segment->flags & QB_SEGMENT_MAPPED) {
 				// unmap the file, enlarge it, then map it again
@@ -206,22 +256,24 @@ intptr_t qb_resize_segment(qb_memory_segment *segment, uint32_t new_size) {
 			} else {
 				// segment->memory is valid only when current_allocation > 0
 				if(segment->current_allocation > 0) {
-					memory = erealloc(segment->memory, new_allocation);
+					memory = erealloc(segment->memory, (size_t) new_allocation);
 				} else {
-					memory = emalloc(new_allocation);
+					memory = emalloc((size_t) new_allocation);
 				}
 			}
 
-			// clear the newly allcoated bytes
+			// clear everything past the current data, since a recycled segment keeps its allocation
+			// while starting out empty
 			current_data_end = memory + segment->byte_count;
-			memset(current_data_end, 0, addition);
+			memset(current_data_end, 0, (size_t) (new_allocation - segment->byte_count));
 			segment->byte_count = new_size;
 			segment->current_allocation = new_allocation;
 			return qb_relocate_segment_memory(segment, memory);
 		} else {
-			intptr_t offset;
-			qb_run_in_main_thread(qb_resize_segment_in_main_thread, segment, &offset, new_size);
-			return offset;
+			qb_segment_resize_request request;
+			request.new_size = new_size;
+			qb_run_in_main_thread(qb_resize_segment_in_main_thread, segment, &request, 0);
+			return request.offset;
 		}
 	} else {
 		segment->byte_count = new_size;
@@ -284,10 +336,10 @@ qb_storage * qb_create_storage_copy(qb_storage *base, intptr_t instruction_shift
 					} else {
 						if(dst->byte_count) {
 							// allocate new memory for the segment
-							int8_t *new_memory = emalloc(dst->byte_count);
+							int8_t *new_memory = emalloc((size_t) dst->byte_count);
 							if(!reentrance) {
 								// forking--need to copy the contents over
-								memcpy(new_memory, dst->memory, dst->byte_count);
+								memcpy(new_memory, dst->memory, (size_t) dst->byte_count);
 							}
 							qb_relocate_segment_memory(dst, new_memory);
 						}
@@ -320,25 +372,30 @@ void qb_copy_storage_contents(qb_storage *src_storage, qb_storage *dst_storage)
 		qb_memory_segment *dst = &dst_storage->segments[i];
 		if(dst->memory != src->memory) {
 			qb_resize_segment(dst, src->byte_count);
-			memcpy(dst->memory, src->memory, src->byte_count);
+			memcpy(dst->memory, src->memory, (size_t) src->byte_count);
 		}
 	}
 }
 
-static int32_t qb_capture_dimensions_from_byte_count(uint32_t byte_count, qb_dimension_mappings *m, uint32_t dimension_index) {
-	uint32_t element_count = ELEMENT_COUNT(byte_count, m->dst_element_type);
-	uint32_t correct_byte_count = BYTE_COUNT(element_count, m->dst_element_type);
+static int32_t qb_capture_dimensions_from_byte_count(uint64_t byte_count, qb_dimension_mappings *m, uint32_t dimension_index) {
+	uint64_t element_count = ELEMENT_COUNT(byte_count, m->dst_element_type);
+	uint64_t correct_byte_count = SEGMENT_BYTE_COUNT(element_count, m->dst_element_type);
 
 	if(dimension_index + 1 > MAX_DIMENSION) {
 		qb_report_too_man_dimension_exception(0);
 		return FALSE;
 	}
+	// a segment can be larger than 4G, but it can't hold more elements than a dimension can count
+	if(element_count > QB_MAX_ELEMENT_COUNT) {
+		qb_report_too_many_elements_exception(0, byte_count, m->dst_element_type);
+		return FALSE;
+	}
 	// make sure the number of bytes is a multiple of the element size
 	if(byte_count != correct_byte_count) {
 		qb_report_binary_string_size_mismatch_exception(0, byte_count, m->dst_element_type);
 	}
 	if(m->src_dimensions[dimension_index] < element_count) {
-		m->src_dimensions[dimension_index] = element_count;
+		m->src_dimensions[dimension_index] = (uint32_t) element_count;
 	}
 	m->src_dimension_count = dimension_index + 1;
 	return TRUE;
@@ -410,16 +467,16 @@ static int32_t qb_capture_dimensions_from_object(zval *zobject, qb_dimension_map
 	return TRUE;
 }
 
-void qb_copy_wrap_around(int8_t *memory, uint32_t filled_byte_count, uint32_t required_byte_count) {
+void qb_copy_wrap_around(int8_t *memory, uint64_t filled_byte_count, uint64_t required_byte_count) {
 	if(filled_byte_count) {
 		while(filled_byte_count < required_byte_count) {
-			uint32_t gap = (required_byte_count - filled_byte_count);
-			uint32_t copy_count = (gap > filled_byte_count) ? filled_byte_count : gap;
-			memcpy(memory + filled_byte_count, memory, copy_count);
+			uint64_t gap = (required_byte_count - filled_byte_count);
+			uint64_t copy_count = (gap > filled_byte_count) ? filled_byte_count : gap;
+			memcpy(memory + filled_byte_count, memory, (size_t) copy_count);
 			filled_byte_count += copy_count;
 		}
 	} else {
-		memset(memory, 0, required_byte_count);
+		memset(memory, 0, (size_t) required_byte_count);
 	}
 }
 
@@ -616,11 +673,11 @@ static int32_t qb_copy_elements_from_zval(zval *zvalue, int8_t *dst_memory, qb_d
 static int32_t qb_copy_elements_from_array(zval *zarray, int8_t *dst_memory, qb_dimension_mappings *m, uint32_t dimension_index) {
 	int8_t *dst_pointer = dst_memory;
 	uint32_t dst_element_count = (dimension_index < m->dst_dimension_count) ? m->dst_array_sizes[dimension_index] : 1;
-	uint32_t dst_byte_count = BYTE_COUNT(dst_element_count, m->dst_element_type);
+	uint64_t dst_byte_count = SEGMENT_BYTE_COUNT(dst_element_count, m->dst_element_type);
 	uint32_t src_dimension = (dimension_index < m->src_dimension_count) ? m->src_dimensions[dimension_index] : 1;
 	uint32_t src_element_element_count = (dimension_index + 1 < m->src_dimension_count) ? m->src_array_sizes[dimension_index + 1] : 1;
 	uint32_t src_element_byte_count = BYTE_COUNT(src_element_element_count, m->dst_element_type);
-	uint32_t src_byte_count = src_dimension * src_element_byte_count;
+	uint64_t src_byte_count = (uint64_t) src_dimension * src_element_byte_count;
 	uint32_t src_index = 0;
 	HashTable *ht = Z_ARRVAL_P(zarray);
 	Bucket *p;
@@ -660,7 +717,7 @@ static int32_t qb_copy_elements_from_array(zval *zarray, int8_t *dst_memory, qb_
 		if(dimension_index == 0) {
 			qb_copy_wrap_around(dst_memory, src_byte_count, dst_byte_count);
 		} else {
-			memset(dst_memory + src_byte_count, 0, dst_byte_count - src_byte_count);
+			memset(dst_memory + src_byte_count, 0, (size_t) (dst_byte_count - src_byte_count));
 		}
 	}
 	return TRUE;
@@ -669,11 +726,11 @@ static int32_t qb_copy_elements_from_array(zval *zarray, int8_t *dst_memory, qb_
 static int32_t qb_copy_elements_from_object(zval *zobject, int8_t *dst_memory, qb_dimension_mappings *m, uint32_t dimension_index) {
 	int8_t *dst_pointer = dst_memory;
 	uint32_t dst_element_count = (dimension_index < m->dst_dimension_count) ? m->dst_array_sizes[dimension_index] : 1;
-	uint32_t dst_byte_count = BYTE_COUNT(dst_element_count, m->dst_element_type);
+	uint64_t dst_byte_count = SEGMENT_BYTE_COUNT(dst_element_count, m->dst_element_type);
 	uint32_t src_dimension = (dimension_index < m->src_dimension_count) ? m->src_dimensions[dimension_index] : 1;
 	uint32_t src_element_element_count = (dimension_index + 1 < m->src_dimension_count) ? m->src_array_sizes[dimension_index + 1] : 1;
 	uint32_t src_element_byte_count = BYTE_COUNT(src_element_element_count, m->dst_element_type);
-	uint32_t src_byte_count = src_dimension * src_element_byte_count;
+	uint64_t src_byte_count = (uint64_t) src_dimension * src_element_byte_count;
 	uint32_t src_index = 0;
 	qb_index_alias_scheme *scheme = m->dst_index_alias_schemes[dimension_index];
 	TSRMLS_FETCH();
@@ -703,7 +760,7 @@ static int32_t qb_copy_elements_from_object(zval *zobject, int8_t *dst_memory, q
 		if(dimension_index == 0) {
 			qb_copy_wrap_around(dst_memory, src_byte_count, dst_byte_count);
 		} else {
-			memset(dst_memory + src_byte_count, 0, dst_byte_count - src_byte_count);
+			memset(dst_memory + src_byte_count, 0, (size_t) (dst_byte_count - src_byte_count));
 		}
 	}
 	return TRUE;
@@ -713,13 +770,13 @@ static int32_t qb_copy_elements_from_string(zval *zstring, int8_t *dst_memory, q
 	int8_t *src_memory = (int8_t *) Z_STRVAL_P(zstring);
 	uint32_t src_byte_count = Z_STRLEN_P(zstring);
 	uint32_t dst_element_count = (dimension_index < m->dst_dimension_count) ? m->dst_array_sizes[dimension_index] : 1;
-	uint32_t dst_byte_count = BYTE_COUNT(dst_element_count, m->dst_element_type);
+	uint64_t dst_byte_count = SEGMENT_BYTE_COUNT(dst_element_count, m->dst_element_type);
 	memcpy(dst_memory, src_memory, src_byte_count);
 	if(src_byte_count < dst_byte_count) {
 		if(dimension_index == 0) {
 			qb_copy_wrap_around(dst_memory, src_byte_count, dst_byte_count);
 		} else {
-			memset(dst_memory + src_byte_count, 0, dst_byte_count - src_byte_count);
+			memset(dst_memory + src_byte_count, 0, (size_t) (dst_byte_count - src_byte_count));
 		}
 	}
 	return TRUE;
@@ -735,16 +792,16 @@ static int32_t qb_copy_elements_from_long(zval *zlong, int8_t *dst_memory, qb_di
 	if(dimension_index == 0) {
 		if(m->dst_dimension_count > 0) {
 			uint32_t dst_element_count = m->dst_array_sizes[dimension_index];
-			uint32_t dst_byte_count = BYTE_COUNT(dst_element_count, m->dst_element_type);
+			uint64_t dst_byte_count = SEGMENT_BYTE_COUNT(dst_element_count, m->dst_element_type);
 			uint32_t src_byte_count = BYTE_COUNT(1, m->dst_element_type);
 			qb_copy_wrap_around(dst_memory, src_byte_count, dst_byte_count);
 		}
 	} else if(dimension_index < m->src_dimension_count) {
 		uint32_t dst_element_count = m->src_array_sizes[dimension_index];
-		uint32_t dst_byte_count = BYTE_COUNT(dst_element_count, m->dst_element_type);
+		uint64_t dst_byte_count = SEGMENT_BYTE_COUNT(dst_element_count, m->dst_element_type);
 		uint32_t src_byte_count = BYTE_COUNT(1, m->dst_element_type);
 		if(dst_byte_count < src_byte_count) {
-			memset(dst_memory + src_byte_count, 0, dst_byte_count - src_byte_count);
+			memset(dst_memory + src_byte_count, 0, (size_t) (dst_byte_count - src_byte_count));
 		}
 	}
 	return TRUE;
@@ -756,16 +813,16 @@ static int32_t qb_copy_elements_from_double(zval *zdouble, int8_t *dst_memory, q
 	if(dimension_index == 0) {
 		if(m->dst_dimension_count > 0) {
 			uint32_t dst_element_count = m->dst_array_sizes[dimension_index];
-			uint32_t dst_byte_count = BYTE_COUNT(dst_element_count, m->dst_element_type);
+			uint64_t dst_byte_count = SEGMENT_BYTE_COUNT(dst_element_count, m->dst_element_type);
 			uint32_t src_byte_count = BYTE_COUNT(1, m->dst_element_type);
 			qb_copy_wrap_around(dst_memory, src_byte_count, dst_byte_count);
 		}
 	} else if(dimension_index < m->src_dimension_count) {
 		uint32_t dst_element_count = m->src_array_sizes[dimension_index];
-		uint32_t dst_byte_count = BYTE_COUNT(dst_element_count, m->dst_element_type);
+		uint64_t dst_byte_count = SEGMENT_BYTE_COUNT(dst_element_count, m->dst_element_type);
 		uint32_t src_byte_count = BYTE_COUNT(1, m->dst_element_type);
 		if(dst_byte_count < src_byte_count) {
-			memset(dst_memory + src_byte_count, 0, dst_byte_count - src_byte_count);
+			memset(dst_memory + src_byte_count, 0, (size_t) (dst_byte_count - src_byte_count));
 		}
 	}
 	return TRUE;
@@ -774,12 +831,12 @@ static int32_t qb_copy_elements_from_double(zval *zdouble, int8_t *dst_memory, q
 static int32_t qb_copy_elements_from_null(zval *znull, int8_t *dst_memory, qb_dimension_mappings *m, uint32_t dimension_index) {
 	if(dimension_index == 0) {
 		uint32_t dst_element_count = (m->dst_dimension_count > 0) ? m->dst_array_sizes[dimension_index] : 1;
-		uint32_t dst_byte_count = BYTE_COUNT(dst_element_count, m->dst_element_type);
-		memset(dst_memory, 0, dst_byte_count);
+		uint64_t dst_byte_count = SEGMENT_BYTE_COUNT(dst_element_count, m->dst_element_type);
+		memset(dst_memory, 0, (size_t) dst_byte_count);
 	} else if(dimension_index < m->src_dimension_count) {
 		uint32_t dst_element_count = m->src_array_sizes[dimension_index];
-		uint32_t dst_byte_count = BYTE_COUNT(dst_element_count, m->dst_element_type);
-		memset(dst_memory, 0, dst_byte_count);
+		uint64_t dst_byte_count = SEGMENT_BYTE_COUNT(dst_element_count, m->dst_element_type);
+		memset(dst_memory, 0, (size_t) dst_byte_count);
 	}
 	return TRUE;
 }
@@ -1417,13 +1474,14 @@ int32_t qb_transfer_value_from_zval(qb_storage *storage, qb_address *address, zv
 	// if it's a variable-length array, adjust the size 
 	if(address->segment_selector >= QB_SELECTOR_ARRAY_START) {
 		uint32_t dst_element_count = m->dst_array_sizes[0];
-		uint32_t dst_byte_count = BYTE_COUNT(dst_element_count, m->dst_element_type);
+		uint64_t dst_byte_count = SEGMENT_BYTE_COUNT(dst_element_count, m->dst_element_type);
 		qb_memory_segment *dst_segment = &storage->segments[address->segment_selector];
 
 		// use memory from the source if possible
 		if(transfer_flags & (QB_TRANSFER_CAN_BORROW_MEMORY | QB_TRANSFER_CAN_SEIZE_MEMORY)) {
 			if(Z_TYPE_P(zvalue) == IS_STRING) {
-				if(!IS_INTERNED(Z_STRVAL_P(zvalue))) {
+				// an interned string can be used too as long as nothing is written to it
+				if(!IS_INTERNED(Z_STRVAL_P(zvalue)) || (READ_ONLY(address) && !(transfer_flags & QB_TRANSFER_CAN_SEIZE_MEMORY))) {
 					int8_t *src_memory = (int8_t *) Z_STRVAL_P(zvalue);
 					uint32_t src_bytes_available = Z_STRLEN_P(zvalue) + 1;
 					if(qb_connect_segment_to_memory(dst_segment, src_memory, dst_byte_count, src_bytes_available, (transfer_flags & QB_TRANSFER_CAN_SEIZE_MEMORY))) {
@@ -1465,13 +1523,13 @@ int32_t qb_transfer_value_from_storage_location(qb_storage *storage, qb_address
 	src_memory = ARRAY_IN(src_storage, I08, src_address);
 	if(src_address->array_index_address) {
 		uint32_t src_index = VALUE_IN(src_storage, U32, src_address->array_index_address);
-		uint32_t byte_offset = BYTE_COUNT(src_index, m->src_element_type);
+		uint64_t byte_offset = SEGMENT_BYTE_COUNT(src_index, m->src_element_type);
 		src_memory += byte_offset;
 	}
 
 	if(address->segment_selector >= QB_SELECTOR_ARRAY_START) {
 		uint32_t dst_element_count = m->dst_array_sizes[0];
-		uint32_t dst_byte_count = BYTE_COUNT(dst_element_count, m->dst_element_type);
+		uint64_t dst_byte_count = SEGMENT_BYTE_COUNT(dst_element_count, m->dst_element_type);
 		qb_memory_segment *dst_segment = &storage->segments[address->segment_selector];
 		if(transfer_flags & QB_TRANSFER_CAN_BORROW_MEMORY) {
 			if(src_address->segment_selector < QB_SELECTOR_ARRAY_START) {
@@ -1534,9 +1592,13 @@ int32_t qb_transfer_value_to_zval(qb_storage *storage, qb_address *address, zval
 			return TRUE;
 		} else if(src_segment->flags & QB_SEGMENT_BORROWED) {
 			int8_t *memory;
+			if(READ_ONLY(address)) {
+				// nothing has changed
+				return TRUE;
+			}
 			if(src_segment->byte_count == src_segment->current_allocation || (src_segment->byte_count - src_segment->current_allocation) > 1024) {
 				// allocate there's no room for null terminator or there's a lot of unused space
-				memory = erealloc(src_segment->memory, src_segment->byte_count + 1);
+				memory = erealloc(src_segment->memory, (size_t) src_segment->byte_count + 1);
 				memory[src_segment->byte_count] = '\0';
 			} else {
 				// unused space are always zeroed out so the string is terminated already
@@ -1546,7 +1608,7 @@ int32_t qb_transfer_value_to_zval(qb_storage *storage, qb_address *address, zval
 				efree(Z_STRVAL_P(zvalue));
 				Z_STRVAL_P(zvalue) = (char *) memory;
 			}
-			Z_STRLEN_P(zvalue) = src_segment->byte_count;
+			Z_STRLEN_P(zvalue) = (int) src_segment->byte_count;
 			return TRUE;
 		}
 		src_memory = src_segment->memory;
@@ -1569,7 +1631,7 @@ int32_t qb_transfer_value_to_storage_location(qb_storage *storage, qb_address *a
 	if(address->segment_selector >= QB_SELECTOR_ARRAY_START) {
 		qb_memory_segment *src_segment = &storage->segments[address->segment_selector];
 		uint32_t dst_element_count = m->dst_array_sizes[0];
-		uint32_t dst_byte_count = BYTE_COUNT(dst_element_count, m->dst_element_type);
+		uint64_t dst_byte_count = SEGMENT_BYTE_COUNT(dst_element_count, m->dst_element_type);
 		if(src_segment->flags & QB_SEGMENT_BORROWED) {
 			// nothing needs to happen
 			return TRUE;
@@ -1594,7 +1656,7 @@ int32_t qb_transfer_value_to_storage_location(qb_storage *storage, qb_address *a
 	dst_memory = ARRAY_IN(dst_storage, I08, dst_address);
 	if(dst_address->array_index_address) {
 		uint32_t dst_index = VALUE_IN(dst_storage, U32, dst_address->array_index_address);
-		uint32_t byte_offset = BYTE_COUNT(dst_index, m->src_element_type);
+		uint64_t byte_offset = SEGMENT_BYTE_COUNT(dst_index, m->src_element_type);
 		dst_memory += byte_offset;
 	}
 	if(m->src_dimension_count == 0 && m->dst_dimension_count == 0) {
@@ -39,11 +39,21 @@ enum {
 	QB_SEGMENT_IMPORTED				= 0x00000400,
 };
 
+// segments no larger than this keep their memory between calls, so hot functions don't
+// have to allocate (in the main thread) every time they're called
+#define QB_SEGMENT_RETENTION_LIMIT		262144
+
+// smallest amount of memory allocated for a segment
+#define QB_SEGMENT_MIN_ALLOCATION		1024
+
+// segments are sized in 64 bits, but element counts and dimensions are still 32-bit
+#define QB_MAX_ELEMENT_COUNT			UINT32_MAX
+
 struct qb_memory_segment {
 	int8_t *memory;
 	uint32_t flags;
-	uint32_t byte_count;						// number of bytes in this segment
-	uint32_t current_allocation;				// number of bytes allocated
+	uint64_t byte_count;						// number of bytes in this segment
+	uint64_t current_allocation;				// number of bytes allocated
 	php_stream *stream;							// memory-mapped file
 	qb_memory_segment *imported_segment;		// imported segment
 	qb_memory_segment *next_dependent;
@@ -292,7 +302,7 @@ typedef gdImage * gdImagePtr;
 
 gdImagePtr qb_get_gd_image(zval *resource);
 
-void qb_copy_wrap_around(int8_t *memory, uint32_t filled_byte_count, uint32_t required_byte_count);
+void qb_copy_wrap_around(int8_t *memory, uint64_t filled_byte_count, uint64_t required_byte_count);
 void qb_copy_elements(uint32_t source_type, int8_t *restrict source_memory, uint32_t source_count, uint32_t dest_type, int8_t *restrict dest_memory, uint32_t dest_count);
 void qb_copy_element(uint32_t source_type, int8_t *restrict source_memory, uint32_t dest_type, int8_t *restrict dest_memory);
 
@@ -301,9 +311,10 @@ int32_t qb_transfer_value_from_storage_location(qb_storage *storage, qb_address
 int32_t qb_transfer_value_to_zval(qb_storage *storage, qb_address *address, zval *zvalue);
 int32_t qb_transfer_value_to_storage_location(qb_storage *storage, qb_address *address, qb_storage *dst_storage, qb_address *dst_address);
 
-void qb_allocate_segment_memory(qb_memory_segment *segment, uint32_t byte_count);
+void qb_allocate_segment_memory(qb_memory_segment *segment, uint64_t byte_count);
 void qb_release_segment(qb_memory_segment *segment);
-intptr_t qb_resize_segment(qb_memory_segment *segment, uint32_t new_size);
+void qb_recycle_segment(qb_memory_segment *segment);
+intptr_t qb_resize_segment(qb_memory_segment *segment, uint64_t new_size);
 
 void qb_import_segment(qb_memory_segment *segment, qb_memory_segment *other_segment);
 
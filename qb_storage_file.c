@@ -46,14 +46,14 @@ static int32_t qb_capture_dimensions_from_file(php_stream *stream, qb_dimension_
 static int32_t qb_copy_elements_to_file(int8_t *src_memory, php_stream *stream, qb_dimension_mappings *m, uint32_t dimension_index) {
 	off_t position;
 	uint32_t src_element_count = (dimension_index < m->src_dimension_count) ? m->src_array_sizes[dimension_index] : 1;
-	uint32_t src_byte_count = BYTE_COUNT(src_element_count, m->src_element_type);
+	uint64_t src_byte_count = SEGMENT_BYTE_COUNT(src_element_count, m->src_element_type);
 	size_t byte_written;
 	TSRMLS_FETCH();
 	position = php_stream_tell(stream);
 	php_stream_seek(stream, 0, SEEK_SET);
-	byte_written = php_stream_write(stream, (char *) src_memory, src_byte_count);
+	byte_written = php_stream_write(stream, (char *) src_memory, (size_t) src_byte_count);
 	php_stream_seek(stream, position, SEEK_SET);
-	php_stream_truncate_set_size(stream, src_byte_count);
+	php_stream_truncate_set_size(stream, (size_t) src_byte_count);
 	if(byte_written != src_byte_count) {
 		qb_report_file_write_error(0, src_byte_count, stream);
 		return FALSE;
@@ -63,28 +63,34 @@ static int32_t qb_copy_elements_to_file(int8_t *src_memory, php_stream *stream,
 
 static int32_t qb_copy_elements_from_file(php_stream *stream, int8_t *dst_memory, qb_dimension_mappings *m, uint32_t dimension_index) {
 	off_t position;
-	uint32_t src_byte_count;
+	uint64_t src_byte_count;
 	uint32_t dst_element_count = (dimension_index < m->dst_dimension_count) ? m->dst_array_sizes[dimension_index] : 1;
-	uint32_t dst_byte_count = BYTE_COUNT(dst_element_count, m->dst_element_type);
+	uint64_t dst_byte_count = SEGMENT_BYTE_COUNT(dst_element_count, m->dst_element_type);
 	TSRMLS_FETCH();
 	position = php_stream_tell(stream);
 	php_stream_seek(stream, 0, SEEK_SET);
-	src_byte_count = php_stream_read(stream, (char *) dst_memory, dst_byte_count);
+	src_byte_count = php_stream_read(stream, (char *) dst_memory, (size_t) dst_byte_count);
 	php_stream_seek(stream, position, SEEK_SET);
 	if(src_byte_count < dst_byte_count) {
 		if(dimension_index == 0) {
 			qb_copy_wrap_around(dst_memory, src_byte_count, dst_byte_count);
 		} else {
-			memset(dst_memory + src_byte_count, 0, dst_byte_count - src_byte_count);
+			memset(dst_memory + src_byte_count, 0, (size_t) (dst_byte_count - src_byte_count));
 		}
 	}
 	return TRUE;
 }
 
-static void * qb_map_file_to_memory(php_stream *stream, uint32_t byte_count, int32_t write_access TSRMLS_DC) {
+static void * qb_map_file_to_memory(php_stream *stream, uint64_t byte_count, int32_t write_access TSRMLS_DC) {
 	if(QB_G(allow_memory_map)) {
 		php_stream_mmap_range range;
 		size_t file_size;
+#if SIZE_MAX < UINT64_MAX
+		if(byte_count > SIZE_MAX) {
+			// can't fit the file into the address space
+			return NULL;
+		}
+#endif
 		if(write_access) {
 			// make sure the file is large enough
 			off_t position;
@@ -93,10 +99,10 @@ static void * qb_map_file_to_memory(php_stream *stream, uint32_t byte_count, int
 			file_size = php_stream_tell(stream);
 			php_stream_seek(stream, position, SEEK_SET);
 			if(byte_count > file_size) {
-				php_stream_truncate_set_size(stream, byte_count);
+				php_stream_truncate_set_size(stream, (size_t) byte_count);
 			}
 		}
-		range.length = byte_count;
+		range.length = (size_t) byte_count;
 		range.offset = 0;
 		range.mode = (write_access) ? PHP_STREAM_MAP_MODE_SHARED_READWRITE : PHP_STREAM_MAP_MODE_SHARED_READONLY;
 		range.mapped = NULL;
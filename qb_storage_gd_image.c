@@ -382,7 +382,7 @@ static void qb_copy_y_pixel_from_gd_image_scanline_F64(void *param1, void *param
 }
 
 static int32_t qb_copy_elements_from_gd_image(gdImagePtr image, int8_t *dst_memory, qb_dimension_mappings *m, uint32_t dimension_index) {
-	uint32_t i, j;
+	uint32_t i;
 	qb_pixel_format pixel_format = qb_get_compatible_pixel_format(m->dst_dimension_count - dimension_index, m->dst_dimensions[m->dst_dimension_count - 1], m->dst_element_type, image->trueColor);
 	qb_pixel_format pixel_type = pixel_format & ~QB_PIXEL_ARRANGEMENT_FLAGS;
 	qb_pixel_format pixel_arrangement = pixel_format & QB_PIXEL_ARRANGEMENT_FLAGS;
@@ -401,10 +401,8 @@ static int32_t qb_copy_elements_from_gd_image(gdImagePtr image, int8_t *dst_memo
 				int32_t *p = (int32_t *) dst_memory;
 
 				for(i = 0; i < (uint32_t) image->sy; i++) {
-					for(j = 0; j < (uint32_t) image->sx; j++) {
-						p[0] = gdImageTrueColorPixel(image, j, i);
-						p += 1;
-					}
+					memcpy(p, image->tpixels[i], image->sx * sizeof(int32_t));
+					p += image->sx;
 					if((uint32_t) image->sx < dst_width) {
 						memset(p, 0, (dst_width - image->sx) * sizeof(int32_t));
 						p += (dst_width - image->sx);
@@ -473,10 +471,8 @@ static int32_t qb_copy_elements_from_gd_image(gdImagePtr image, int8_t *dst_memo
 				int8_t *p = dst_memory;
 
 				for(i = 0; i < (uint32_t) image->sy; i++) {
-					for(j = 0; j < (uint32_t) image->sx; j++) {
-						p[0] = gdImagePalettePixel(image, j, i);
-						p += 1;
-					}
+					memcpy(p, image->pixels[i], image->sx * sizeof(int8_t));
+					p += image->sx;
 					if((uint32_t) image->sx < dst_width) {
 						memset(p, 0, (dst_width - image->sx) * sizeof(int8_t));
 						p += (dst_width - image->sx);
@@ -610,7 +606,7 @@ static void qb_copy_y_pixel_to_gd_image_scanline_F64(void *param1, void *param2,
 }
 
 static int32_t qb_copy_elements_to_gd_image(int8_t *src_memory, gdImagePtr image, qb_dimension_mappings *m, uint32_t dimension_index) {
-	uint32_t i, j;
+	uint32_t i;
 	qb_pixel_format pixel_format = qb_get_compatible_pixel_format(m->src_dimension_count - dimension_index, m->src_dimensions[m->src_dimension_count - 1], m->src_element_type, image->trueColor);
 	qb_pixel_format pixel_type = pixel_format & ~QB_PIXEL_ARRANGEMENT_FLAGS;
 	qb_pixel_format pixel_arrangement = pixel_format & QB_PIXEL_ARRANGEMENT_FLAGS;
@@ -644,12 +640,9 @@ static int32_t qb_copy_elements_to_gd_image(int8_t *src_memory, gdImagePtr image
 			case QB_PIXEL_I08_4:
 			case QB_PIXEL_I32_1: {
 				int32_t *p = (int32_t *) src_memory;
-				int tpixel;
 				for(i = 0; i < (uint32_t) image->sy; i++) {
-					for(j = 0; j < (uint32_t) image->sx; j++) {
-						tpixel = *p++;
-						gdImageTrueColorPixel(image, j, i) = tpixel;
-					}
+					memcpy(image->tpixels[i], p, image->sx * sizeof(int32_t));
+					p += image->sx;
 				}
 			}	break;
 			case QB_PIXEL_F32_4: {
@@ -702,13 +695,9 @@ static int32_t qb_copy_elements_to_gd_image(int8_t *src_memory, gdImagePtr image
 		switch(pixel_type) {
 			case QB_PIXEL_I08_1: {
 				int8_t *p = src_memory;
-				unsigned char pixel;
 				for(i = 0; i < (uint32_t) image->sy; i++) {
-					for(j = 0; j < (uint32_t) image->sx; j++) {
-						pixel = p[0];
-						gdImagePalettePixel(image, j, i) = pixel;
-						p += 1;
-					}
+					memcpy(image->pixels[i], p, image->sx * sizeof(int8_t));
+					p += image->sx;
 				}
 			}	break;
 			default: {
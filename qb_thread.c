@@ -19,9 +19,13 @@
 /* $Id$ */
 
 #include "qb.h"
+#include "php_ini.h"
 
 #ifndef WIN32
 #include <signal.h>
+#include <sched.h>
+#include <sys/ipc.h>
+#include <sys/sem.h>
 #endif
 
 #ifndef WIN32
@@ -75,8 +79,7 @@ int qb_in_main_thread(void) {
 	return (current_thread->type == QB_THREAD_MAIN);
 }
 
-/*
-static long qb_atomic_increment(long *p_number) {
+static long qb_atomic_increment(volatile long *p_number) {
 	long new_value;
 #ifndef WIN32
 	new_value = __sync_add_and_fetch(p_number, 1);
@@ -86,7 +89,7 @@ static long qb_atomic_increment(long *p_number) {
 	return new_value;
 }
 
-static long qb_atomic_decrement(long *p_number) {
+static long qb_atomic_decrement(volatile long *p_number) {
 	long new_value;
 #ifndef WIN32
 	new_value = __sync_sub_and_fetch(p_number, 1);
@@ -95,7 +98,32 @@ static long qb_atomic_decrement(long *p_number) {
 #endif
 	return new_value;
 }
-*/
+
+long qb_atomic_add(volatile long *p_number, long amount) {
+	long new_value;
+#ifndef WIN32
+	new_value = __sync_add_and_fetch(p_number, amount);
+#else
+	new_value = InterlockedExchangeAdd(p_number, amount) + amount;
+#endif
+	return new_value;
+}
+
+static int qb_atomic_compare_and_swap(volatile long *p_number, long old_value, long new_value) {
+#ifndef WIN32
+	return __sync_bool_compare_and_swap(p_number, old_value, new_value);
+#else
+	return (InterlockedCompareExchange(p_number, new_value, old_value) == old_value);
+#endif
+}
+
+static void qb_memory_barrier(void) {
+#ifndef WIN32
+	__sync_synchronize();
+#else
+	MemoryBarrier();
+#endif
+}
 
 static void qb_yield_time_slice(void) {
 #ifndef WIN32
@@ -105,6 +133,14 @@ static void qb_yield_time_slice(void) {
 #endif
 }
 
+static void qb_pause(void) {
+#ifndef WIN32
+	sched_yield();
+#else
+	SwitchToThread();
+#endif
+}
+
 static int qb_initialize_mutex(qb_mutex *mutex) {
 #ifndef WIN32
 	if(pthread_mutex_init(&mutex->mutex, NULL) != 0) {
@@ -335,6 +371,7 @@ THREAD_PROC_RETURN_TYPE qb_signal_thread_proc(void *arg) {
 int qb_initialize_main_thread(qb_main_thread *thread TSRMLS_DC) {
 	thread->type = QB_THREAD_MAIN;
 	thread->worker_count = 0;
+	thread->request_count = 0;
 	if(!qb_initialize_event_sink(&thread->event_sink)) {
 		return FALSE;
 	}
@@ -361,6 +398,7 @@ static int qb_initialize_worker_thread(qb_worker_thread *thread, qb_thread *crea
 	thread->type = QB_THREAD_WORKER;
 	thread->allow_termination = FALSE;
 	thread->terminated = FALSE;
+	thread->spinning = FALSE;
 	thread->current_owner = NULL;
 	thread->current_task = NULL;
 	thread->creator = creator;
@@ -494,6 +532,8 @@ qb_task_group * qb_allocate_task_group(long task_count, long extra_bytes) {
 	qb_task_group *group = (qb_task_group *) memory;
 	group->tasks = (qb_task *) (memory + sizeof(qb_task_group));
 	group->completion_count = 0;
+	group->detached = FALSE;
+	group->token_count = 0;
 	group->task_count = 0;
 	group->task_index = 0;
 	group->owner = qb_get_current_thread();
@@ -518,10 +558,11 @@ void qb_add_task(qb_task_group *group, qb_thread_proc proc, void *param1, void *
 
 static void qb_add_task_group(qb_task_group *group) {
 	qb_lock_mutex(&pool->task_queue_mutex, FALSE);
-	if(group->task_index != group->task_count) {
+	if(group->task_index < group->task_count) {
 		if(pool->task_queue_tail) {
 			group->previous_group = pool->task_queue_tail;
 			pool->task_queue_tail->next_group = group;
+			pool->task_queue_tail = group;
 		} else {
 			pool->task_queue_head = pool->task_queue_tail = group;
 		}
@@ -532,16 +573,16 @@ static void qb_add_task_group(qb_task_group *group) {
 static void qb_remove_task_group_no_lock(qb_task_group *group) {
 	if(group->previous_group) {
 		group->previous_group->next_group = group->next_group;
-		group->previous_group = NULL;
 	} else if(pool->task_queue_head == group) {
 		pool->task_queue_head = group->next_group;
 	}
 	if(group->next_group) {
 		group->next_group->previous_group = group->previous_group;
-		group->next_group = NULL;
 	} else if(pool->task_queue_tail == group) {
 		pool->task_queue_tail = group->previous_group;
 	}
+	group->previous_group = NULL;
+	group->next_group = NULL;
 }
 
 static void qb_remove_task_group(qb_task_group *group) {
@@ -550,60 +591,211 @@ static void qb_remove_task_group(qb_task_group *group) {
 	qb_unlock_mutex(&pool->task_queue_mutex);
 }
 
-static int qb_assign_task(qb_worker_thread *worker) {
-	int task_assigned = FALSE;
-	qb_thread *thread_to_notify = NULL;
+// each worker has a deque of tasks (Chase-Lev): the worker pushes and pops at the bottom
+// while idle workers steal from the top
+static int qb_push_task(qb_task_deque *deque, qb_task *task) {
+	long bottom = deque->bottom;
+	long top = deque->top;
+	if(bottom - top >= QB_TASK_DEQUE_SIZE) {
+		return FALSE;
+	}
+	deque->tasks[bottom & (QB_TASK_DEQUE_SIZE - 1)] = task;
+	qb_memory_barrier();
+	deque->bottom = bottom + 1;
+	return TRUE;
+}
+
+static qb_task * qb_pop_task(qb_task_deque *deque) {
+	long bottom = deque->bottom - 1;
+	long top;
+	qb_task *task = NULL;
+	deque->bottom = bottom;
+	qb_memory_barrier();
+	top = deque->top;
+	if(top <= bottom) {
+		task = deque->tasks[bottom & (QB_TASK_DEQUE_SIZE - 1)];
+		if(top == bottom) {
+			// it's the last one--a thief might be going for it as well
+			if(!qb_atomic_compare_and_swap(&deque->top, top, top + 1)) {
+				task = NULL;
+			}
+			deque->bottom = bottom + 1;
+		}
+	} else {
+		deque->bottom = bottom + 1;
+	}
+	return task;
+}
+
+static qb_task * qb_steal_task(qb_task_deque *deque) {
+	long top = deque->top;
+	long bottom;
+	qb_memory_barrier();
+	bottom = deque->bottom;
+	if(top < bottom) {
+		qb_task *task = deque->tasks[top & (QB_TASK_DEQUE_SIZE - 1)];
+		if(qb_atomic_compare_and_swap(&deque->top, top, top + 1)) {
+			return task;
+		}
+	}
+	return NULL;
+}
 
+static qb_task * qb_find_task_to_steal(qb_worker_thread *worker) {
+	long count = pool->worker_count;
+	long index = (long) (worker - pool->workers);
+	long i;
+	// start with the next worker so thieves don't all go after the same one
+	for(i = 1; i < count; i++) {
+		qb_worker_thread *victim = &pool->workers[(index + i) % count];
+		if(!victim->terminated && victim->deque.top < victim->deque.bottom) {
+			qb_task *task = qb_steal_task(&victim->deque);
+			if(task) {
+				return task;
+			}
+		}
+	}
+	return NULL;
+}
+
+static void qb_set_worker_owner(qb_worker_thread *worker, qb_main_thread *main_thread) {
+	if(worker->current_owner != main_thread) {
+		if(worker->current_owner) {
+			qb_atomic_decrement(&worker->current_owner->worker_count);
+		}
+		if(main_thread) {
+			qb_atomic_increment(&main_thread->worker_count);
+		}
+		worker->current_owner = main_thread;
+	}
+}
+
+static qb_task * qb_take_queued_tasks(qb_worker_thread *worker) {
+	qb_task *task = NULL;
+	qb_task_group *group, *next_group;
+
+	if(!pool->task_queue_head) {
+		return NULL;
+	}
 	qb_lock_mutex(&pool->task_queue_mutex, FALSE);
-	if(worker->current_task) {
-		qb_main_thread *main_thread = worker->current_owner;
-		qb_task_group *group = worker->current_task->group;
-		group->completion_count++;
-		main_thread->worker_count--;
-
-		if(group->completion_count == group->task_count) {
-			thread_to_notify = group->owner;
-		}
-	}
-	if(pool->task_queue_head) {
-		qb_task_group *group;
-		for(group = pool->task_queue_head; group; group = group->next_group) {
-			qb_main_thread *main_thread = qb_get_thread_owner(group->owner);
-			if(main_thread->worker_count < pool->per_request_thread_limit) {
-				if(group->task_index < group->task_count) {
-					worker->current_task = &group->tasks[group->task_index++];
-					worker->current_owner = main_thread;
-					main_thread->worker_count++;
-					task_assigned = TRUE;
-
-					if(group->task_index == group->task_count) {
-						// no more task in this group--remove it
-						qb_remove_task_group_no_lock(group);
+	for(group = pool->task_queue_head; group && !task; group = next_group) {
+		qb_main_thread *main_thread = qb_get_thread_owner(group->owner);
+		next_group = group->next_group;
+		if(main_thread == worker->current_owner || main_thread->worker_count < pool->per_request_thread_limit) {
+			long remaining = group->task_count - group->task_index;
+			if(remaining > 0) {
+				// take a share of what's left instead of a single task, so the lock isn't
+				// acquired once per task; the extras go into the deque where others can steal them
+				long space = QB_TASK_DEQUE_SIZE - (worker->deque.bottom - worker->deque.top);
+				long batch_size = (remaining + pool->per_request_thread_limit - 1) / pool->per_request_thread_limit;
+				long start, end, i;
+				if(batch_size > space + 1) {
+					batch_size = space + 1;
+				}
+				// the owner might be claiming tasks at the same time without the lock
+				start = qb_atomic_add(&group->task_index, batch_size) - batch_size;
+				end = start + batch_size;
+				if(end > group->task_count) {
+					end = group->task_count;
+				}
+				if(start < end) {
+					for(i = end - 1; i > start; i--) {
+						qb_push_task(&worker->deque, &group->tasks[i]);
 					}
-				} else {
-					// no sure how this can happen
-					qb_remove_task_group_no_lock(group);
+					task = &group->tasks[start];
+					qb_set_worker_owner(worker, main_thread);
 				}
-				break;
+			}
+			if(group->task_index >= group->task_count) {
+				// no more task in this group--remove it
+				qb_remove_task_group_no_lock(group);
 			}
 		}
 	}
-	if(!task_assigned) {
-		worker->current_owner = NULL;
-		worker->current_task = NULL;
-	}
 	qb_unlock_mutex(&pool->task_queue_mutex);
-
-	if(thread_to_notify) {
-		qb_send_event(&thread_to_notify->event_sink, (qb_thread *) worker, QB_EVENT_TASK_GROUP_PROCESSED, FALSE);
-	}
-	return task_assigned;
+	return task;
 }
 
 static void qb_perform_task(qb_task *task, qb_thread *thread) {
 	task->proc(task->param1, task->param2, task->param3);
 }
 
+static void qb_release_thread_tokens(long count);
+
+static void qb_complete_task(qb_task *task, qb_thread *thread) {
+	// the group can be freed as soon as the last task is counted, so get what's needed beforehand
+	qb_task_group *group = task->group;
+	qb_thread *owner = group->owner;
+	long task_count = group->task_count;
+	if(group->detached) {
+		// the owner isn't necessarily listening--it's told only when it has started waiting
+		long token_count = group->token_count;
+		long completion_count = qb_atomic_increment(&group->completion_count);
+		if((completion_count & ~QB_TASK_GROUP_WAITING) == task_count) {
+			qb_release_thread_tokens(token_count);
+			if(completion_count & QB_TASK_GROUP_WAITING) {
+				qb_send_event(&owner->event_sink, thread, QB_EVENT_TASK_GROUP_PROCESSED, FALSE);
+			}
+		}
+	} else if(qb_atomic_increment(&group->completion_count) == task_count) {
+		if(owner != thread) {
+			qb_send_event(&owner->event_sink, thread, QB_EVENT_TASK_GROUP_PROCESSED, FALSE);
+		}
+	}
+}
+
+static void qb_process_tasks(qb_worker_thread *worker) {
+	// tasks can be processed while the worker is waiting for tasks it has forked itself
+	qb_main_thread *original_owner = worker->current_owner;
+	qb_task *original_task = worker->current_task;
+	long spin_count = 0;
+
+	while(!worker->terminated) {
+		qb_task *task = qb_pop_task(&worker->deque);
+		if(!task) {
+			task = qb_find_task_to_steal(worker);
+			if(!task) {
+				task = qb_take_queued_tasks(worker);
+			}
+		}
+		if(task) {
+			worker->spinning = FALSE;
+			qb_set_worker_owner(worker, qb_get_thread_owner(task->group->owner));
+			worker->current_task = task;
+			qb_atomic_decrement(&pool->pending_task_count);
+
+			qb_enable_termination(worker);
+			qb_perform_task(task, (qb_thread *) worker);
+			qb_disable_termination(worker);
+
+			qb_complete_task(task, (qb_thread *) worker);
+			spin_count = 0;
+		} else if(spin_count < QB_WORKER_SPIN_COUNT) {
+			// stay awake for a while, since more tasks are likely coming soon
+			// and waking up a sleeping thread is comparatively expensive
+			if(spin_count == 0) {
+				qb_set_worker_owner(worker, original_owner);
+				worker->spinning = TRUE;
+			}
+			qb_pause();
+			spin_count++;
+		} else {
+			// a thread adding tasks might have counted on this one noticing them
+			// look one more time after clearing the flag
+			worker->spinning = FALSE;
+			qb_memory_barrier();
+			if(spin_count == QB_WORKER_SPIN_COUNT && pool->pending_task_count > 0) {
+				spin_count++;
+			} else {
+				break;
+			}
+		}
+	}
+	worker->spinning = FALSE;
+	worker->current_task = original_task;
+	qb_set_worker_owner(worker, original_owner);
+}
+
 static void qb_handle_worker_events(qb_worker_thread *worker, qb_event_type expecting) {
 	long loop = 0;
 	for(;;) {
@@ -611,12 +803,8 @@ static void qb_handle_worker_events(qb_worker_thread *worker, qb_event_type expe
 			qb_event event = qb_wait_for_event(&worker->event_sink);
 			switch(event.type) {
 				case QB_EVENT_TASK_GROUP_ADDED: {
-					// get a task and run it
-					while(qb_assign_task(worker)) {
-						qb_enable_termination(worker);
-						qb_perform_task(worker->current_task, (qb_thread *) worker);
-						qb_disable_termination(worker);
-					}
+					// run tasks until there's none left
+					qb_process_tasks(worker);
 				}	break;
 				case QB_EVENT_TERMINATION: {
 					// exit the thread immediately
@@ -639,34 +827,46 @@ static void qb_handle_worker_events(qb_worker_thread *worker, qb_event_type expe
 	}
 }
 
+static void qb_handle_main_thread_event(qb_main_thread *thread, qb_event event) {
+	switch(event.type) {
+		case QB_EVENT_REQUEST_SENT: {
+			// handle request from a worker thread
+			qb_worker_thread *worker = (qb_worker_thread *) event.sender;
+			qb_task *task = worker->request;
+			qb_perform_task(task, (qb_thread *) thread);
+			qb_atomic_decrement(&thread->request_count);
+
+			// wake up the worker again
+			qb_send_event(&worker->event_sink, (qb_thread *) thread, QB_EVENT_REQUEST_PROCESSED, FALSE);
+		}	break;
+		case QB_EVENT_TIMEOUT: {
+			zend_timeout(0);
+		}	break;
+		default: {
+		}	break;
+	}
+}
+
 static void qb_handle_main_thread_events(qb_main_thread *thread, qb_event_type expecting) {
 	for(;;) {
 		qb_event event = qb_wait_for_event(&thread->event_sink);
-		switch(event.type) {
-			case QB_EVENT_REQUEST_SENT: {
-				// handle request from a worker thread
-				qb_worker_thread *worker = (qb_worker_thread *) event.sender;
-				qb_task *task = worker->request;
-				qb_perform_task(task, (qb_thread *) thread);
-
-				// wake up the worker again
-				qb_send_event(&worker->event_sink, (qb_thread *) thread, QB_EVENT_REQUEST_PROCESSED, FALSE);
-			}	break;
-			case QB_EVENT_TIMEOUT: {
-				zend_timeout(0);
-			}
-			case QB_EVENT_WORKER_ADDED:
-			case QB_EVENT_TASK_GROUP_PROCESSED:
-				if(expecting == event.type) {
-					// time to leave the loop
-					return;
-				}
-			default: {
-			}	break;
+		qb_handle_main_thread_event(thread, event);
+		if(expecting == event.type) {
+			// time to leave the loop
+			return;
 		}
 	}
 }
 
+static void qb_handle_main_thread_requests(qb_main_thread *thread) {
+	// workers can't deliver their requests while the main thread is busy, so they're counted beforehand;
+	// any other event received here can be dropped, since whoever waits for one checks the condition again
+	while(thread->request_count > 0) {
+		qb_event event = qb_wait_for_event(&thread->event_sink);
+		qb_handle_main_thread_event(thread, event);
+	}
+}
+
 THREAD_PROC_RETURN_TYPE qb_worker_thread_proc(void *arg) {
 	qb_worker_thread *worker = arg;
 	qb_lock_event_sink(&worker->event_sink);
@@ -690,6 +890,9 @@ void qb_add_workers(qb_main_thread *thread) {
 #endif
 	for(i = 0; i < pool->global_thread_limit; i++) {
 		qb_worker_thread *worker = &pool->workers[pool->worker_count];
+		// the deque is set up only here, since a restarted worker keeps tasks left in it
+		worker->deque.top = 0;
+		worker->deque.bottom = 0;
 		if(qb_initialize_worker_thread(worker, (qb_thread *) thread)) {
 			// wait for thread to enter main loop
 			qb_handle_main_thread_events(thread, QB_EVENT_WORKER_ADDED);
@@ -722,13 +925,144 @@ void qb_restart_workers(qb_main_thread *main_thread) {
 #endif
 }
 
+static void qb_open_thread_token_semaphore(const char *path) {
+#ifndef WIN32
+	// processes with a different limit use a different semaphore, since resetting one while tokens
+	// are out would let their return push the count past the limit
+	key_t key = ftok(path, QB_THREAD_TOKEN_PROJECT_ID);
+	int id = -1;
+	if(key != -1) {
+		key ^= (key_t) (pool->thread_token_limit << 8);
+		id = semget(key, 1, IPC_CREAT | IPC_EXCL | 0600);
+		if(id != -1) {
+			// the semaphore starts at zero; adding the tokens with semop() also sets sem_otime,
+			// which tells other processes that it's ready (SEM_UNDO is not used here, since the
+			// tokens have to stay after this process exits)
+			struct sembuf op;
+			op.sem_num = 0;
+			op.sem_op = (short) pool->thread_token_limit;
+			op.sem_flg = 0;
+			if(semop(id, &op, 1) == -1) {
+				semctl(id, 0, IPC_RMID);
+				id = -1;
+			}
+		} else if(errno == EEXIST) {
+			id = semget(key, 1, 0);
+			if(id != -1) {
+				// wait for the creator to finish initializing it
+				struct semid_ds ds;
+				union {
+					int val;
+					struct semid_ds *buf;
+					unsigned short *array;
+				} arg;
+				int attempts;
+				arg.buf = &ds;
+				for(attempts = 0; attempts < QB_THREAD_TOKEN_WAIT_COUNT; attempts++) {
+					if(semctl(id, 0, IPC_STAT, arg) == -1) {
+						id = -1;
+						break;
+					}
+					if(ds.sem_otime != 0) {
+						break;
+					}
+					qb_yield_time_slice();
+				}
+				if(attempts == QB_THREAD_TOKEN_WAIT_COUNT) {
+					id = -1;
+				}
+			}
+		}
+	}
+	// SEM_UNDO on acquisition and release gives back whatever a process is holding when it dies, 
+	// so a crashed worker doesn't shrink the budget permanently
+	pool->thread_token_semaphore = id;
+	if(id == -1) {
+		pool->thread_token_limit = 0;
+	}
+#else
+	// a named semaphore can't be resized, so the limit is made part of the name
+	char name[128];
+	snprintf(name, sizeof(name), "%s-%08lX-%ld", QB_THREAD_TOKEN_NAME, (unsigned long) zend_inline_hash_func(path, strlen(path) + 1), pool->thread_token_limit);
+	pool->thread_token_semaphore = CreateSemaphoreA(NULL, pool->thread_token_limit, pool->thread_token_limit, name);
+	if(!pool->thread_token_semaphore) {
+		pool->thread_token_limit = 0;
+	}
+#endif
+}
+
+int qb_get_thread_token_status(long *p_available, long *p_limit) {
+	if(!pool || !pool->thread_token_limit) {
+		return FALSE;
+	}
+#ifndef WIN32
+	*p_available = semctl(pool->thread_token_semaphore, 0, GETVAL);
+#else
+	// the count of a semaphore can't be read on Windows
+	*p_available = -1;
+#endif
+	*p_limit = pool->thread_token_limit;
+	return TRUE;
+}
+
+static long qb_acquire_thread_tokens(long count) {
+	if(!pool->thread_token_limit || count <= 0) {
+		return count;
+	} else {
+#ifndef WIN32
+		// take as many as are available, up to the number wanted
+		for(;;) {
+			struct sembuf op;
+			long available = semctl(pool->thread_token_semaphore, 0, GETVAL);
+			if(available <= 0) {
+				return 0;
+			}
+			op.sem_num = 0;
+			op.sem_op = (short) ((available < count) ? -available : -count);
+			op.sem_flg = IPC_NOWAIT | SEM_UNDO;
+			if(semop(pool->thread_token_semaphore, &op, 1) == 0) {
+				return -op.sem_op;
+			}
+			if(errno != EAGAIN && errno != EINTR) {
+				return 0;
+			}
+		}
+#else
+		long acquired = 0;
+		while(acquired < count && WaitForSingleObject(pool->thread_token_semaphore, 0) == WAIT_OBJECT_0) {
+			acquired++;
+		}
+		return acquired;
+#endif
+	}
+}
+
+static void qb_release_thread_tokens(long count) {
+	if(pool->thread_token_limit && count > 0) {
+#ifndef WIN32
+		struct sembuf op;
+		op.sem_num = 0;
+		op.sem_op = (short) count;
+		op.sem_flg = SEM_UNDO;
+		semop(pool->thread_token_semaphore, &op, 1);
+#else
+		ReleaseSemaphore(pool->thread_token_semaphore, count, NULL);
+#endif
+	}
+}
+
 int qb_wake_workers(qb_thread *thread, long count) {
 	long i, awaken = 0;
+	// all the idle workers needed are woken in one pass, instead of one for each task
 	for(i = 0; i < pool->worker_count && count > 0; i++) {
 		qb_worker_thread *worker = &pool->workers[i];
 		if(!worker->current_owner && !worker->terminated) {
 			// worker appears to be idle
-			if(qb_check_event_sink(&worker->event_sink)) {
+			if(worker->spinning) {
+				// it's looking for tasks already
+				count--;
+				awaken++;
+			} else if(qb_check_event_sink(&worker->event_sink)) {
 				if(qb_send_event(&worker->event_sink, thread, QB_EVENT_TASK_GROUP_ADDED, TRUE)) {
 					count--;
 					awaken++;
@@ -736,7 +1070,39 @@ int qb_wake_workers(qb_thread *thread, long count) {
 			}
 		}
 	}
-	return (awaken > 0);
+	return awaken;
+}
+
+static void qb_help_with_task_group(qb_thread *thread, qb_task_group *group, long deque_base) {
+	long index;
+	if(thread->type == QB_THREAD_WORKER) {
+		// take back the tasks that haven't been stolen
+		qb_worker_thread *worker = (qb_worker_thread *) thread;
+		while(worker->deque.bottom > deque_base) {
+			qb_task *task = qb_pop_task(&worker->deque);
+			if(!task) {
+				break;
+			}
+			qb_atomic_decrement(&pool->pending_task_count);
+			qb_perform_task(task, thread);
+			qb_complete_task(task, thread);
+		}
+	}
+	// claim what's left in the queue
+	for(;;) {
+		qb_task *task;
+		if(thread->type == QB_THREAD_MAIN) {
+			// workers waiting on the main thread would otherwise be stuck until it's done with its task
+			qb_handle_main_thread_requests((qb_main_thread *) thread);
+		}
+		if((index = qb_atomic_increment(&group->task_index) - 1) >= group->task_count) {
+			break;
+		}
+		task = &group->tasks[index];
+		qb_atomic_decrement(&pool->pending_task_count);
+		qb_perform_task(task, thread);
+		qb_complete_task(task, thread);
+	}
 }
 
 void qb_run_task_group(qb_task_group *group, int iterative) {
@@ -746,10 +1112,14 @@ void qb_run_task_group(qb_task_group *group, int iterative) {
 
 	if(main_thread->worker_count + 1 < pool->per_request_thread_limit || iterative) {
 		long count = pool->per_request_thread_limit - main_thread->worker_count;
+		long deque_base = 0, awaken = 0;
 		if(count > group->task_count) {
 			count = group->task_count;
 		}
 
+		// other processes might be using the CPUs already
+		count = qb_acquire_thread_tokens(count);
+
 #ifndef WIN32
 		if(thread->type == QB_THREAD_MAIN) {
 			pool->current_main_thread = main_thread;
@@ -757,11 +1127,28 @@ void qb_run_task_group(qb_task_group *group, int iterative) {
 		}
 #endif
 
+		qb_atomic_add(&pool->pending_task_count, group->task_count - group->task_index);
+		if(thread->type == QB_THREAD_WORKER && !iterative) {
+			// tasks forked from inside a task go into the worker's own deque
+			qb_worker_thread *worker = (qb_worker_thread *) thread;
+			deque_base = worker->deque.bottom;
+			while(group->task_index < group->task_count) {
+				if(!qb_push_task(&worker->deque, &group->tasks[group->task_index])) {
+					break;
+				}
+				group->task_index++;
+			}
+		}
+		// whatever didn't fit goes into the shared queue
 		qb_add_task_group(group);
 
-		if(qb_wake_workers(thread, count)) {
+		if(count > 0) {
+			awaken = qb_wake_workers(thread, count);
+		}
+		qb_release_thread_tokens(count - awaken);
+		if(awaken > 0) {
 			workers_available = TRUE;
-		} else {
+		} else if(iterative) {
 			// take the group off the queue
 			qb_remove_task_group(group);
 			if(group->task_index != 0) {
@@ -769,17 +1156,26 @@ void qb_run_task_group(qb_task_group *group, int iterative) {
 				// put it back into the queue
 				qb_add_task_group(group);
 				workers_available = TRUE;
+			} else {
+				qb_atomic_add(&pool->pending_task_count, -group->task_count);
 			}
 		}
+		if(!iterative) {
+			// instead of sitting idle, the thread works on the tasks too
+			qb_help_with_task_group(thread, group, deque_base);
+			qb_remove_task_group(group);
+			workers_available = TRUE;
+		}
 		if(workers_available) {
-			do {
+			while(group->completion_count < group->task_count) {
 				if(thread->type == QB_THREAD_MAIN) {
 					qb_handle_main_thread_events((qb_main_thread *) thread, QB_EVENT_TASK_GROUP_PROCESSED);
 				} else {
 					qb_handle_worker_events((qb_worker_thread*) thread, QB_EVENT_TASK_GROUP_PROCESSED);
 				}
-			} while(group->completion_count < group->task_count);
+			}
 		}
+		qb_release_thread_tokens(awaken);
 
 #ifndef WIN32
 		if(thread->type == QB_THREAD_MAIN) {
@@ -798,6 +1194,73 @@ void qb_run_task_group(qb_task_group *group, int iterative) {
 	}
 }
 
+void qb_start_task_group(qb_task_group *group) {
+	qb_thread *thread = group->owner;
+	qb_main_thread *main_thread = qb_get_thread_owner(thread);
+
+	// the group is left running in the background; qb_wait_for_task_group() must be called before it's freed
+	group->detached = TRUE;
+	if(thread->type == QB_THREAD_MAIN && main_thread->worker_count + 1 < pool->per_request_thread_limit) {
+		long count = pool->per_request_thread_limit - main_thread->worker_count;
+		long awaken = 0;
+		if(count > group->task_count) {
+			count = group->task_count;
+		}
+		count = qb_acquire_thread_tokens(count);
+		if(count > 0) {
+			// the tokens are returned by the worker completing the last task
+			group->token_count = count;
+			qb_atomic_add(&pool->pending_task_count, group->task_count - group->task_index);
+			qb_add_task_group(group);
+			awaken = qb_wake_workers(thread, count);
+			if(awaken > 0) {
+				return;
+			}
+			qb_remove_task_group(group);
+			if(group->task_index != 0) {
+				// a worker has just become available and took one (or more) of the tasks
+				qb_add_task_group(group);
+				return;
+			}
+			qb_atomic_add(&pool->pending_task_count, -group->task_count);
+			group->token_count = 0;
+			qb_release_thread_tokens(count);
+		}
+	}
+	// no worker is free--run everything now
+	while(group->task_index < group->task_count) {
+		qb_task *task = &group->tasks[group->task_index++];
+		qb_perform_task(task, thread);
+		group->completion_count++;
+	}
+}
+
+int qb_is_task_group_completed(qb_task_group *group) {
+	return (group->completion_count & ~QB_TASK_GROUP_WAITING) >= group->task_count;
+}
+
+void qb_wait_for_task_group(qb_task_group *group) {
+	qb_thread *thread = group->owner;
+	if(group->detached && !(group->completion_count & QB_TASK_GROUP_WAITING)) {
+		// let the worker know that an event is expected, then check whether it's done already
+		long completion_count = qb_atomic_add(&group->completion_count, QB_TASK_GROUP_WAITING);
+		if(completion_count - QB_TASK_GROUP_WAITING < group->task_count) {
+#ifndef WIN32
+			qb_main_thread *main_thread = (qb_main_thread *) thread;
+			pool->current_main_thread = main_thread;
+			qb_disable_time_out_signal(main_thread);
+#endif
+			while(!qb_is_task_group_completed(group)) {
+				qb_handle_main_thread_events((qb_main_thread *) thread, QB_EVENT_TASK_GROUP_PROCESSED);
+			}
+#ifndef WIN32
+			qb_enable_time_out_signal(main_thread);
+			pool->current_main_thread = NULL;
+#endif
+		}
+	}
+}
+
 void qb_run_in_main_thread(qb_thread_proc proc, void *param1, void *param2, int param3) {
 	qb_thread *current_thread = qb_get_current_thread();
 	if(current_thread && current_thread->type != QB_THREAD_MAIN) {
@@ -810,6 +1273,7 @@ void qb_run_in_main_thread(qb_thread_proc proc, void *param1, void *param2, int
 		task.param3 = param3;
 		task.group = NULL;
 		worker->request = &task;
+		qb_atomic_increment(&main_thread->request_count);
 
 		// disable termination so threads aren't kill in the middle of pthread functions
 		qb_disable_termination(worker);
@@ -827,6 +1291,26 @@ void qb_run_in_main_thread(qb_thread_proc proc, void *param1, void *param2, int
 	}
 }
 
+static void qb_discard_tasks(qb_worker_thread *worker, qb_main_thread *main_thread) {
+	// the worker has exited, so this thread can act as the deque's owner; thieves that got
+	// started before the worker was flagged as terminated are dealt with by the usual protocol
+	qb_task *tasks[QB_TASK_DEQUE_SIZE];
+	qb_task *task;
+	long i, count = 0;
+	while((task = qb_pop_task(&worker->deque))) {
+		if(qb_get_thread_owner(task->group->owner) != main_thread) {
+			tasks[count++] = task;
+		} else {
+			qb_atomic_decrement(&pool->pending_task_count);
+		}
+	}
+	// put the tasks belonging to other requests back in their original order
+	// they will be picked up when the worker is restarted
+	for(i = count - 1; i >= 0; i--) {
+		qb_push_task(&worker->deque, tasks[i]);
+	}
+}
+
 void qb_terminate_associated_workers(qb_main_thread *main_thread) {
 	qb_task_group *group, *queue_head = NULL, *queue_tail = NULL, *next_group;
 	long i;
@@ -837,6 +1321,9 @@ void qb_terminate_associated_workers(qb_main_thread *main_thread) {
 	for(group = pool->task_queue_head; group; group = group->next_group) {
 		qb_main_thread *owner_main_thread = qb_get_thread_owner(group->owner);
 		if(owner_main_thread == main_thread) {
+			if(group->task_index < group->task_count) {
+				qb_atomic_add(&pool->pending_task_count, group->task_index - group->task_count);
+			}
 			qb_remove_task_group_no_lock(group);
 
 			// stick the removed groups into a list so we can free them later
@@ -873,12 +1360,18 @@ void qb_terminate_associated_workers(qb_main_thread *main_thread) {
 					qb_wait_for_worker_termination(worker);
 					workers_terminated++;
 
+					// drop tasks in its deque belonging to this main thread
+					qb_discard_tasks(worker, main_thread);
+
 					// free the resources
 					qb_free_worker_thread(worker);
 				}
 			}
 		}
 		main_thread->worker_count = 0;
+
+		// requests from the terminated workers will never arrive
+		main_thread->request_count = 0;
 		qb_lock_event_sink(&main_thread->event_sink);
 	}
 
@@ -892,10 +1385,12 @@ void qb_terminate_associated_workers(qb_main_thread *main_thread) {
 		fflush(stdout);
 	}
 
-	// free the group
+	// free the group (detached ones are freed by whoever started them)
 	for(group = queue_head; group; group = next_group) {
 		next_group = group->next_group;
-		qb_free_task_group(group);
+		if(!group->detached) {
+			qb_free_task_group(group);
+		}
 	}
 }
 
@@ -913,9 +1408,33 @@ int qb_initialize_thread_pool(TSRMLS_D) {
 		pool->worker_count = 0;
 		pool->task_queue_head = NULL;
 		pool->task_queue_tail = NULL;
+		pool->pending_task_count = 0;
 
 		qb_initialize_mutex(&pool->task_queue_mutex);
 
+		pool->thread_token_limit = (pool->global_thread_limit > 0) ? QB_G(machine_thread_limit) : 0;
+		if(pool->thread_token_limit > QB_THREAD_TOKEN_MAX) {
+			pool->thread_token_limit = QB_THREAD_TOKEN_MAX;
+		}
+#ifdef SEMVMX
+		if(pool->thread_token_limit > SEMVMX) {
+			// the count also has to fit in the semaphore itself
+			pool->thread_token_limit = SEMVMX;
+		}
+#endif
+		if(pool->thread_token_limit > 0) {
+			// processes loading the same php.ini share the budget unless a file is specified
+			const char *token_path = QB_G(machine_thread_token_path);
+			if(!token_path[0] && php_ini_opened_path) {
+				token_path = php_ini_opened_path;
+			}
+			if(token_path[0]) {
+				qb_open_thread_token_semaphore(token_path);
+			} else {
+				pool->thread_token_limit = 0;
+			}
+		}
+
 #ifndef WIN32
 		pool->current_main_thread = NULL;
 		pool->signal_thread = 0;
@@ -953,18 +1472,116 @@ void qb_free_thread_pool(void) {
 			}
 		}
 		qb_free_mutex(&pool->task_queue_mutex);
+#ifdef WIN32
+		if(pool->thread_token_limit) {
+			CloseHandle(pool->thread_token_semaphore);
+		}
+#endif
+	}
+}
+
+#if defined(__linux__)
+static long qb_read_cgroup_cpu_limit(const char *folder) {
+	// cgroup v2 keeps quota and period in one file, v1 in two
+	char path[PATH_MAX];
+	long quota = -1, period = 0;
+	FILE *f;
+	snprintf(path, sizeof(path), "%s/cpu.max", folder);
+	if((f = fopen(path, "r"))) {
+		char quota_buffer[32];
+		if(fscanf(f, "%31s %ld", quota_buffer, &period) == 2 && strcmp(quota_buffer, "max") != 0) {
+			quota = atol(quota_buffer);
+		}
+		fclose(f);
+	} else {
+		snprintf(path, sizeof(path), "%s/cpu.cfs_quota_us", folder);
+		if((f = fopen(path, "r"))) {
+			if(fscanf(f, "%ld", &quota) != 1) {
+				quota = -1;
+			}
+			fclose(f);
+		}
+		snprintf(path, sizeof(path), "%s/cpu.cfs_period_us", folder);
+		if((f = fopen(path, "r"))) {
+			if(fscanf(f, "%ld", &period) != 1) {
+				period = 0;
+			}
+			fclose(f);
+		}
+	}
+	if(quota > 0 && period > 0) {
+		// round up, so a quota of 1.5 CPUs still gets two threads
+		return (quota + period - 1) / period;
+	}
+	return 0;
+}
+
+static long qb_get_cgroup_cpu_limit(void) {
+	// look at the process's own cgroup first (v2), then the root of the mounted hierarchy,
+	// which is the container's cgroup when it has its own namespace
+	static const char *root_folders[] = { "/sys/fs/cgroup", "/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct" };
+	long limit = 0;
+	uint32_t i;
+	FILE *f = fopen("/proc/self/cgroup", "r");
+	if(f) {
+		char line[PATH_MAX];
+		while(!limit && fgets(line, sizeof(line), f)) {
+			if(strncmp(line, "0::/", 4) == 0) {
+				char folder[PATH_MAX];
+				line[strcspn(line, "\n")] = '\0';
+				if(line[4] != '\0') {
+					snprintf(folder, sizeof(folder), "/sys/fs/cgroup%s", line + 3);
+					limit = qb_read_cgroup_cpu_limit(folder);
+				}
+			}
+		}
+		fclose(f);
+	}
+	for(i = 0; i < sizeof(root_folders) / sizeof(root_folders[0]) && !limit; i++) {
+		limit = qb_read_cgroup_cpu_limit(root_folders[i]);
 	}
+	return limit;
 }
+#endif
 
 long qb_get_cpu_count(void) {
 	static long count = 0;
 	if(!count) {
 #if defined(__linux__)
+		long limit;
+#ifdef CPU_COUNT
+		cpu_set_t set;
+#endif
 		count = sysconf( _SC_NPROCESSORS_ONLN );
+#ifdef CPU_COUNT
+		// the process might be restricted to some of the CPUs
+		CPU_ZERO(&set);
+		if(sched_getaffinity(0, sizeof(set), &set) == 0) {
+			long allowed = CPU_COUNT(&set);
+			if(allowed > 0 && allowed < count) {
+				count = allowed;
+			}
+		}
+#endif
+		// or it might be in a container with a CPU quota
+		limit = qb_get_cgroup_cpu_limit();
+		if(limit > 0 && limit < count) {
+			count = limit;
+		}
 #elif defined(WIN32)
 		SYSTEM_INFO sysinfo;
+		DWORD_PTR process_mask, system_mask;
 		GetSystemInfo(&sysinfo);
 		count = sysinfo.dwNumberOfProcessors;
+		if(GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+			long allowed = 0;
+			for(; process_mask; process_mask &= process_mask - 1) {
+				allowed++;
+			}
+			if(allowed > 0 && allowed < count) {
+				count = allowed;
+			}
+		}
 #endif
 	}
 	return count;
@@ -33,12 +33,36 @@
 #define QB_GLOBAL_THREAD_COUNT_MULTIPLIER		1
 #endif
 
+// must be a power of two
+#define QB_TASK_DEQUE_SIZE						256
+
+// added to the completion count of a detached group once its owner is waiting for it
+#define QB_TASK_GROUP_WAITING					0x40000000
+
+// number of times an idle worker checks for new tasks before going to sleep
+#define QB_WORKER_SPIN_COUNT					64
+
+// identifies the semaphore holding the machine-wide worker thread budget (qb.machine_thread_limit),
+// together with the file given by qb.machine_thread_token_path
+#ifndef WIN32
+#define QB_THREAD_TOKEN_PROJECT_ID				'Q'
+#else
+#define QB_THREAD_TOKEN_NAME					"Local\\QBThreadTokens"
+#endif
+
+// largest machine-wide budget, limited by what sem_op can hold
+#define QB_THREAD_TOKEN_MAX						SHRT_MAX
+
+// number of times a process checks whether another has finished setting up the token semaphore
+#define QB_THREAD_TOKEN_WAIT_COUNT				1000
+
 typedef struct qb_condition			qb_condition;
 typedef struct qb_mutex				qb_mutex;
 typedef struct qb_event				qb_event;
 typedef struct qb_event_sink		qb_event_sink;
 typedef struct qb_task				qb_task;
 typedef struct qb_task_group		qb_task_group;
+typedef struct qb_task_deque		qb_task_deque;
 
 typedef struct qb_thread			qb_thread;
 typedef struct qb_worker_thread		qb_worker_thread;
@@ -108,14 +132,22 @@ struct qb_task {
 struct qb_task_group {
 	qb_task *tasks;
 	long task_count;
-	long task_index;
-	long completion_count;
+	volatile long task_index;
+	volatile long completion_count;
 	qb_thread *owner;
+	int detached;
+	long token_count;
 	void *extra_memory;
 	qb_task_group *previous_group;
 	qb_task_group *next_group;
 };
 
+struct qb_task_deque {
+	volatile long top;
+	volatile long bottom;
+	qb_task * volatile tasks[QB_TASK_DEQUE_SIZE];
+};
+
 struct qb_thread {
 	qb_thread_type type;
 	qb_event_sink event_sink;
@@ -137,10 +169,12 @@ struct qb_worker_thread {
 
 	int allow_termination;
 	volatile int terminated;
+	volatile int spinning;
 	qb_thread *creator;
 	qb_main_thread *current_owner;
 	qb_task *current_task;
 	qb_task *request;
+	qb_task_deque deque;
 };
 
 struct qb_main_thread {
@@ -152,7 +186,8 @@ struct qb_main_thread {
 	HANDLE thread;
 #endif
 
-	long worker_count;
+	volatile long worker_count;
+	volatile long request_count;
 #ifndef WIN32
 	sigset_t signal_mask;
 #endif
@@ -169,10 +204,19 @@ struct qb_thread_pool {
 	qb_task_group *task_queue_head;
 	qb_task_group *task_queue_tail;
 	qb_mutex task_queue_mutex;
+	volatile long pending_task_count;
 
 	long global_thread_limit;
 	long per_request_thread_limit;
 
+	// every running worker holds a token shared with other processes
+	long thread_token_limit;
+#ifndef WIN32
+	int thread_token_semaphore;
+#else
+	HANDLE thread_token_semaphore;
+#endif
+
 #ifndef WIN32
 	qb_main_thread *current_main_thread;
 	pthread_t signal_thread;
@@ -180,6 +224,8 @@ struct qb_thread_pool {
 };
 
 long qb_get_cpu_count(void);
+int qb_get_thread_token_status(long *p_available, long *p_limit);
+long qb_atomic_add(volatile long *p_number, long amount);
 
 int qb_initialize_main_thread(qb_main_thread *thread TSRMLS_DC);
 void qb_free_main_thread(qb_main_thread *thread);
@@ -192,6 +238,9 @@ qb_task_group * qb_allocate_task_group(long task_count, long extra_bytes);
 void qb_free_task_group(qb_task_group *group);
 void qb_add_task(qb_task_group *group, qb_thread_proc proc, void *param1, void *param2, int param3);
 void qb_run_task_group(qb_task_group *group, int iterative);
+void qb_start_task_group(qb_task_group *group);
+int qb_is_task_group_completed(qb_task_group *group);
+void qb_wait_for_task_group(qb_task_group *group);
 void qb_run_in_main_thread(qb_thread_proc proc, void *param1, void *param2, int param3);
 void qb_terminate_associated_workers(qb_main_thread *main_thread);
 
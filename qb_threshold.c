@@ -0,0 +1,384 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 5                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2012 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Chung Leong <cleong@cal.berkeley.edu>                        |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#include "qb.h"
+#include <ctype.h>
+
+#ifdef _MSC_VER
+#	include <process.h>
+#	include <intrin.h>
+#else
+#	include <unistd.h>
+#endif
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#	include <cpuid.h>
+#endif
+
+extern const char compressed_table_op_names[];
+
+uint32_t global_multithreading_thresholds[QB_OPCODE_COUNT];
+
+// same layout as qb_instruction_ARR, qb_instruction_ARR_ARR, etc. (and qb_instruction_ARR_SCA, since a scalar result only uses the data pointer)
+typedef struct qb_calibration_instruction {
+	void *next_handler;
+	qb_pointer_ARR operands[4];
+} qb_calibration_instruction;
+
+void qb_initialize_multithreading_thresholds(void) {
+	uint32_t i;
+	for(i = 0; i < global_multithreading_threshold_count; i++) {
+		const qb_multithreading_threshold *t = &global_multithreading_threshold_info[i];
+		global_multithreading_thresholds[t->opcode] = t->default_value;
+	}
+}
+
+static void qb_get_cpu_model(char *buffer, size_t buffer_size) {
+	buffer[0] = '\0';
+#if (defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))) || (defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64)))
+	{
+		// the brand string (e.g. "Intel(R) Xeon(R) CPU E5-2680 v4 @ 2.40GHz") is spread across three leaves
+		uint32_t regs[13];
+#if defined(_MSC_VER)
+		__cpuid((int *) regs, 0x80000000);
+#else
+		__cpuid(0x80000000, regs[0], regs[1], regs[2], regs[3]);
+#endif
+		if(regs[0] >= 0x80000004) {
+			uint32_t i;
+			for(i = 0; i < 3; i++) {
+#if defined(_MSC_VER)
+				__cpuid((int *) &regs[i * 4], 0x80000002 + i);
+#else
+				__cpuid(0x80000002 + i, regs[i * 4], regs[i * 4 + 1], regs[i * 4 + 2], regs[i * 4 + 3]);
+#endif
+			}
+			regs[12] = 0;
+			strlcpy(buffer, (const char *) regs, buffer_size);
+		}
+	}
+#elif defined(__linux__)
+	{
+		// use whatever identifies the processor in /proc/cpuinfo
+		FILE *file = fopen("/proc/cpuinfo", "r");
+		if(file) {
+			char line[256];
+			while(fgets(line, sizeof(line), file)) {
+				if(strncmp(line, "model name", 10) == 0 || strncmp(line, "CPU part", 8) == 0 || strncmp(line, "cpu\t", 4) == 0) {
+					char *value = strchr(line, ':');
+					if(value) {
+						strlcpy(buffer, value + 1, buffer_size);
+						break;
+					}
+				}
+			}
+			fclose(file);
+		}
+	}
+#endif
+	{
+		// trim the spaces around the name as well as the newline
+		size_t start = strspn(buffer, " \t"), length = strlen(buffer + start);
+		while(length > 0 && isspace((unsigned char) buffer[start + length - 1])) {
+			length--;
+		}
+		memmove(buffer, buffer + start, length);
+		buffer[length] = '\0';
+	}
+	if(!buffer[0]) {
+		strlcpy(buffer, "unknown", buffer_size);
+	}
+}
+
+static char * qb_get_threshold_file_path(TSRMLS_D) {
+	// the values are only good for the machine and the version of qb that measured them
+	char *path, cpu_model[64];
+	qb_get_cpu_model(cpu_model, sizeof(cpu_model));
+	spprintf(&path, 0, "%s%cmultithreading_thresholds_%s_%08x_%ld.txt", QB_G(threshold_cache_path), PHP_DIR_SEPARATOR, PHP_QB_VERSION, (uint32_t) zend_inline_hash_func(cpu_model, strlen(cpu_model)), QB_G(thread_count));
+	return path;
+}
+
+static const char ** qb_get_op_names(uint32_t *p_count) {
+	const char **op_names = NULL;
+	qb_uncompress_table(compressed_table_op_names, (void ***) &op_names, p_count, 0);
+	return op_names;
+}
+
+static int32_t qb_read_threshold_file(TSRMLS_D) {
+	const char **op_names;
+	uint32_t op_name_count, read_count = 0;
+	char *file_path = qb_get_threshold_file_path(TSRMLS_C);
+	FILE *file = VCWD_FOPEN(file_path, "r");
+	efree(file_path);
+	if(!file) {
+		return FALSE;
+	}
+	op_names = qb_get_op_names(&op_name_count);
+	if(op_names) {
+		char line[256], name[128];
+		uint32_t value, i;
+		while(fgets(line, sizeof(line), file)) {
+			if(line[0] != ';' && sscanf(line, "%127s %u", name, &value) == 2) {
+				for(i = 0; i < global_multithreading_threshold_count; i++) {
+					const qb_multithreading_threshold *t = &global_multithreading_threshold_info[i];
+					if(t->opcode < op_name_count && op_names[t->opcode] && strcmp(op_names[t->opcode], name) == 0) {
+						global_multithreading_thresholds[t->opcode] = (value) ? value : QB_THRESHOLD_NEVER;
+						read_count++;
+						break;
+					}
+				}
+			}
+		}
+		efree((void *) op_names);
+	}
+	fclose(file);
+	return (read_count > 0);
+}
+
+void qb_save_multithreading_thresholds(TSRMLS_D) {
+	const char **op_names;
+	uint32_t op_name_count;
+	char *file_path, *temp_file_path;
+	FILE *file;
+	int32_t success = TRUE;
+
+	op_names = qb_get_op_names(&op_name_count);
+	if(!op_names) {
+		return;
+	}
+	VCWD_MKDIR(QB_G(threshold_cache_path), 0777);
+	file_path = qb_get_threshold_file_path(TSRMLS_C);
+
+	// write to a temporary file first, so other processes never see a partial file
+	spprintf(&temp_file_path, 0, "%s.%d", file_path, (int) getpid());
+	file = VCWD_FOPEN(temp_file_path, "w");
+	if(file) {
+		uint32_t i;
+		char cpu_model[64];
+		qb_get_cpu_model(cpu_model, sizeof(cpu_model));
+		if(fprintf(file, "; qb %s, %s, %ld threads\n", PHP_QB_VERSION, cpu_model, QB_G(thread_count)) < 0) {
+			success = FALSE;
+		}
+		for(i = 0; i < global_multithreading_threshold_count && success; i++) {
+			const qb_multithreading_threshold *t = &global_multithreading_threshold_info[i];
+			uint32_t value = global_multithreading_thresholds[t->opcode];
+			if(t->opcode < op_name_count && op_names[t->opcode]) {
+				if(fprintf(file, "%s\t%u\n", op_names[t->opcode], (value != QB_THRESHOLD_NEVER) ? value : 0) < 0) {
+					success = FALSE;
+				}
+			}
+		}
+		if(fclose(file) != 0) {
+			success = FALSE;
+		}
+		if(success) {
+			VCWD_UNLINK(file_path);
+			success = (VCWD_RENAME(temp_file_path, file_path) == 0);
+		}
+		if(!success) {
+			VCWD_UNLINK(temp_file_path);
+		}
+	}
+	efree(temp_file_path);
+	efree(file_path);
+	efree((void *) op_names);
+}
+
+void qb_load_multithreading_thresholds(TSRMLS_D) {
+	if(QB_G(threshold_cache_path) && QB_G(threshold_cache_path)[0]) {
+		if(!qb_read_threshold_file(TSRMLS_C)) {
+			if(QB_G(calibrate_thresholds)) {
+				if(qb_calibrate_multithreading_thresholds(TSRMLS_C)) {
+					qb_save_multithreading_thresholds(TSRMLS_C);
+				}
+			}
+		}
+	} else if(QB_G(calibrate_thresholds)) {
+		qb_calibrate_multithreading_thresholds(TSRMLS_C);
+	}
+}
+
+static void qb_fill_calibration_buffer(int8_t *buffer, qb_primitive_type type, uint32_t count) {
+	uint32_t i;
+	// use ones, which are valid input for every op (division, logarithm, arccosine, etc.)
+	switch(type) {
+		case QB_TYPE_F64: for(i = 0; i < count; i++) ((float64_t *) buffer)[i] = 1; break;
+		case QB_TYPE_F32: for(i = 0; i < count; i++) ((float32_t *) buffer)[i] = 1; break;
+		case QB_TYPE_S64:
+		case QB_TYPE_U64: for(i = 0; i < count; i++) ((int64_t *) buffer)[i] = 1; break;
+		case QB_TYPE_S32:
+		case QB_TYPE_U32: for(i = 0; i < count; i++) ((int32_t *) buffer)[i] = 1; break;
+		case QB_TYPE_S16:
+		case QB_TYPE_U16: for(i = 0; i < count; i++) ((int16_t *) buffer)[i] = 1; break;
+		case QB_TYPE_S08:
+		case QB_TYPE_U08: for(i = 0; i < count; i++) ((int8_t *) buffer)[i] = 1; break;
+	}
+}
+
+static int qb_compare_ratios(const void *p1, const void *p2) {
+	double r1 = *((const double *) p1);
+	double r2 = *((const double *) p2);
+	return (r1 < r2) ? -1 : (r1 > r2) ? 1 : 0;
+}
+
+static double qb_time_operation(qb_interpreter_context *cxt, const qb_multithreading_threshold *t, qb_calibration_instruction *instr, uint32_t thread_count) {
+	qb_thread_proc control_func = (qb_thread_proc) t->control_func;
+	double start_time, end_time;
+	cxt->thread_count = thread_count;
+	start_time = qb_get_high_res_timestamp();
+	control_func(cxt, instr, 0);
+	end_time = qb_get_high_res_timestamp();
+	return end_time - start_time;
+}
+
+// return the median ratio between the time it takes with multiple threads and the time it takes with one
+static double qb_measure_multithreading_benefit(qb_interpreter_context *cxt, const qb_multithreading_threshold *t, qb_calibration_instruction *instr, uint32_t thread_count) {
+	double ratios[QB_CALIBRATION_ITERATIONS];
+	uint32_t i;
+
+	// get the data into the cache first
+	qb_time_operation(cxt, t, instr, 0);
+	for(i = 0; i < QB_CALIBRATION_ITERATIONS; i++) {
+		double mt_time = qb_time_operation(cxt, t, instr, thread_count);
+		double st_time = qb_time_operation(cxt, t, instr, 0);
+		ratios[i] = (st_time > 0) ? mt_time / st_time : HUGE_VAL;
+	}
+	qsort(ratios, QB_CALIBRATION_ITERATIONS, sizeof(double), qb_compare_ratios);
+	return ratios[QB_CALIBRATION_ITERATIONS >> 1];
+}
+
+// see find_optimal() in code_gen/threshold/determine.php
+static uint32_t qb_find_multithreading_threshold(qb_interpreter_context *cxt, const qb_multithreading_threshold *t, int8_t **buffers, uint32_t thread_count) {
+	qb_calibration_instruction _instr, *instr = &_instr;
+	uint32_t indices[4], counts[4];
+	uint32_t result_size = t->operand_sizes[t->operand_count - 1];
+	uint32_t max_size = 1, count, i;
+	double ratio, previous_ratio = 1;
+
+	for(i = 0; i < t->operand_count; i++) {
+		if(t->operand_sizes[i] > max_size) {
+			max_size = t->operand_sizes[i];
+		}
+		indices[i] = 0;
+		instr->operands[i].data_pointer = buffers[i];
+		instr->operands[i].index_pointer = &indices[i];
+		instr->operands[i].count_pointer = &counts[i];
+	}
+	instr->next_handler = NULL;
+
+	// count is the number of elements in the largest operand, so the buffers never have to be bigger than the maximum
+	for(count = QB_CALIBRATION_MIN_COUNT; count <= QB_CALIBRATION_MAX_COUNT; count *= 2) {
+		uint32_t unit_count = count / max_size;
+		for(i = 0; i < t->operand_count; i++) {
+			counts[i] = unit_count * t->operand_sizes[i];
+			qb_fill_calibration_buffer(buffers[i], t->operand_types[i], counts[i]);
+		}
+		ratio = qb_measure_multithreading_benefit(cxt, t, instr, thread_count);
+		if(ratio < 0.80) {
+			if(previous_ratio < 0.83 && fabs(previous_ratio - 0.80) < fabs(ratio - 0.80)) {
+				unit_count /= 2;
+			}
+			return unit_count * result_size;
+		}
+		previous_ratio = ratio;
+	}
+	return QB_THRESHOLD_NEVER;
+}
+
+int32_t qb_calibrate_multithreading_thresholds(TSRMLS_D) {
+	qb_interpreter_context _cxt, *cxt = &_cxt;
+	int8_t *buffers[4];
+	uint32_t thread_count = QB_G(thread_count);
+	uint32_t i, buffer_count = 0;
+	volatile uint32_t current_opcode = QB_OPCODE_COUNT;
+	volatile uint32_t current_threshold = 0;
+	int32_t bailed_out = FALSE;
+
+	if(thread_count <= 1) {
+		return FALSE;
+	}
+
+	// make sure the main thread is initialized
+	if(QB_G(main_thread).type == QB_THREAD_UNINITIALIZED) {
+		qb_initialize_main_thread(&QB_G(main_thread) TSRMLS_CC);
+	}
+	for(i = 0; i < 4; i++) {
+		buffers[i] = malloc(QB_CALIBRATION_MAX_COUNT * sizeof(float64_t));
+		if(!buffers[i]) {
+			break;
+		}
+		buffer_count++;
+	}
+	if(buffer_count == 4) {
+		memset(cxt, 0, sizeof(qb_interpreter_context));
+		SAVE_TSRMLS
+
+		zend_try {
+			for(i = 0; i < global_multithreading_threshold_count; i++) {
+				const qb_multithreading_threshold *t = &global_multithreading_threshold_info[i];
+				if(t->operand_count > 0) {
+					uint32_t threshold;
+					current_opcode = t->opcode;
+					current_threshold = global_multithreading_thresholds[t->opcode];
+
+					// make the op split whenever the thread count is non-zero
+					global_multithreading_thresholds[t->opcode] = 1;
+					threshold = qb_find_multithreading_threshold(cxt, t, buffers, thread_count);
+					global_multithreading_thresholds[t->opcode] = threshold;
+					current_opcode = QB_OPCODE_COUNT;
+				}
+			}
+		} zend_catch {
+			// a timeout most likely
+			bailed_out = TRUE;
+		} zend_end_try();
+
+		if(bailed_out) {
+			if(current_opcode != QB_OPCODE_COUNT) {
+				global_multithreading_thresholds[current_opcode] = current_threshold;
+			}
+			for(i = 0; i < buffer_count; i++) {
+				free(buffers[i]);
+			}
+			zend_bailout();
+		}
+	}
+	for(i = 0; i < buffer_count; i++) {
+		free(buffers[i]);
+	}
+	return (buffer_count == 4);
+}
+
+void qb_get_multithreading_thresholds(zval *array TSRMLS_DC) {
+	const char **op_names;
+	uint32_t op_name_count, i;
+
+	array_init(array);
+	op_names = qb_get_op_names(&op_name_count);
+	if(op_names) {
+		for(i = 0; i < global_multithreading_threshold_count; i++) {
+			const qb_multithreading_threshold *t = &global_multithreading_threshold_info[i];
+			uint32_t value = global_multithreading_thresholds[t->opcode];
+			if(t->opcode < op_name_count && op_names[t->opcode]) {
+				add_assoc_long(array, (char *) op_names[t->opcode], (value != QB_THRESHOLD_NEVER) ? value : 0);
+			}
+		}
+		efree((void *) op_names);
+	}
+}
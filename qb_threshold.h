@@ -0,0 +1,56 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 5                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2012 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Chung Leong <cleong@cal.berkeley.edu>                        |
+  +----------------------------------------------------------------------+
+*/
+
+/* $Id$ */
+
+#ifndef QB_THRESHOLD_H_
+#define QB_THRESHOLD_H_
+
+typedef struct qb_multithreading_threshold	qb_multithreading_threshold;
+
+// value placed in the table when splitting an op never pays off
+#define QB_THRESHOLD_NEVER					0xFFFFFFFF
+
+#define QB_CALIBRATION_MIN_COUNT			1024
+#define QB_CALIBRATION_MAX_COUNT			(1024 * 1024 * 2)
+#define QB_CALIBRATION_ITERATIONS			5
+
+struct qb_multithreading_threshold {
+	uint32_t opcode;
+	uint32_t default_value;
+	void *control_func;
+
+	// zero when the op can't be timed with dummy data
+	uint32_t operand_count;
+	qb_primitive_type operand_types[4];
+	uint32_t operand_sizes[4];
+};
+
+extern const qb_multithreading_threshold global_multithreading_threshold_info[];
+extern uint32_t global_multithreading_threshold_count;
+
+// indexed by opcode; read by the controller functions
+extern uint32_t global_multithreading_thresholds[];
+
+void qb_initialize_multithreading_thresholds(void);
+void qb_load_multithreading_thresholds(TSRMLS_D);
+void qb_save_multithreading_thresholds(TSRMLS_D);
+int32_t qb_calibrate_multithreading_thresholds(TSRMLS_D);
+void qb_get_multithreading_thresholds(zval *array TSRMLS_DC);
+
+#endif
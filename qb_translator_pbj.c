@@ -1650,9 +1650,38 @@ static void qb_perform_loop(qb_pbj_translator_context *cxt, qb_address *index_ad
 static void qb_perform_fork(qb_pbj_translator_context *cxt, qb_address *id_address, qb_address *count_address) {
 	qb_operand fork_operands[1] = { { QB_OPERAND_ADDRESS, { count_address } } };
 	qb_operand fork_result = { QB_OPERAND_ADDRESS, { id_address } };
+	qb_set_source_op_index(cxt->compiler_context, cxt->loop_op_index, 0);
 	qb_produce_op(cxt->compiler_context, &factory_fork, fork_operands, 1, &fork_result, NULL, 0, &cxt->result_prototypes[cxt->loop_op_index++]);
 }
 
+static void qb_perform_fork_next(qb_pbj_translator_context *cxt, qb_address *index_address, qb_address *count_address) {
+	qb_operand operands[1] = { { QB_OPERAND_ADDRESS, { count_address } } };
+	qb_operand result = { QB_OPERAND_ADDRESS, { index_address } };
+	qb_set_source_op_index(cxt->compiler_context, cxt->loop_op_index, 0);
+	qb_produce_op(cxt->compiler_context, &factory_fork_next, operands, 1, &result, NULL, 0, &cxt->result_prototypes[cxt->loop_op_index++]);
+}
+
+static void qb_perform_branch_if_less_than(qb_pbj_translator_context *cxt, qb_address *index_address, qb_address *limit_address, uint32_t false_target_op_index) {
+	qb_operand operands[2] = { { QB_OPERAND_ADDRESS, { index_address } }, { QB_OPERAND_ADDRESS, { limit_address } } };
+	qb_operand condition = { QB_OPERAND_EMPTY, { NULL } };
+	qb_operand result = { QB_OPERAND_NONE, { NULL } };
+	uint32_t target_indices[2];
+	qb_set_source_op_index(cxt->compiler_context, cxt->loop_op_index, 0);
+	qb_produce_op(cxt->compiler_context, &factory_less_than, operands, 2, &condition, NULL, 0, &cxt->result_prototypes[cxt->loop_op_index++]);
+
+	// continue to the next op if the condition is true
+	target_indices[0] = JUMP_TARGET_INDEX(cxt->loop_op_index + 1, 0);
+	target_indices[1] = JUMP_TARGET_INDEX(false_target_op_index, 0);
+	qb_set_source_op_index(cxt->compiler_context, cxt->loop_op_index, 0);
+	qb_produce_op(cxt->compiler_context, &factory_branch_on_true, &condition, 1, &result, target_indices, 2, &cxt->result_prototypes[cxt->loop_op_index++]);
+}
+
+static void qb_perform_jump(qb_pbj_translator_context *cxt, uint32_t target_op_index) {
+	uint32_t target_indices[1] = { JUMP_TARGET_INDEX(target_op_index, 0) };
+	qb_set_source_op_index(cxt->compiler_context, cxt->loop_op_index, 0);
+	qb_produce_op(cxt->compiler_context, &factory_jump, NULL, 0, NULL, target_indices, 1, &cxt->result_prototypes[cxt->loop_op_index++]);
+}
+
 static void qb_perform_spoon(qb_pbj_translator_context *cxt) {
 	qb_set_source_op_index(cxt->compiler_context, cxt->loop_op_index, 0);
 	qb_produce_op(cxt->compiler_context, &factory_spoon, NULL, 0, NULL, NULL, 0, &cxt->result_prototypes[cxt->loop_op_index++]);
@@ -1688,6 +1717,13 @@ static void qb_perform_pad_3x3_matrix(qb_pbj_translator_context *cxt, qb_address
 	}
 }
 
+// number of ops making up the branch out of the row loop (the comparison and the branch itself)
+#define QB_PBJ_ROW_EXIT_OP_COUNT		2
+// number of ops before the PB instructions in the pixel loop (zeroing of the active pixel)
+#define QB_PBJ_PIXEL_LOOP_HEAD_OP_COUNT	1
+// number of ops after the PB instructions, up to the spoon (pixel copy, increment of x, pixel loop, jump back to the row loop)
+#define QB_PBJ_PIXEL_LOOP_TAIL_OP_COUNT	4
+
 static int32_t qb_start_pbj_filter_loop(qb_pbj_translator_context *cxt) {
 	qb_address *start_coord_address;
 	uint32_t i;
@@ -1717,19 +1753,33 @@ static int32_t qb_start_pbj_filter_loop(qb_pbj_translator_context *cxt) {
 	start_coord_address = qb_obtain_constant_F32(cxt->compiler_context, 0.5);
 
 	if(cxt->thread_count > 1) {
-		// fork multiple copies of function if multiple CPUs are available
-		qb_perform_fork(cxt, cxt->y_address, cxt->output_image_height_address);
+		// fork one copy of function per CPU; the copies take rows from a shared counter,
+		// so a copy that finishes its rows early will pick up more instead of sitting idle
+		qb_address *thread_count_address = qb_obtain_constant_U32(cxt->compiler_context, cxt->thread_count);
+		qb_perform_fork(cxt, cxt->y_address, thread_count_address);
+
+		// get the next row; the outer loop starts here
+		cxt->outer_loop_start_index = cxt->loop_op_index;
+		qb_perform_fork_next(cxt, cxt->y_address, cxt->output_image_height_address);
 		qb_perform_addition(cxt, cxt->y_address, start_coord_address, cxt->out_coord_y_address);
+
+		// set x to zero
+		qb_perform_assignment(cxt, cxt->x_address, cxt->compiler_context->zero_address);
+		qb_perform_assignment(cxt, cxt->out_coord_x_address, start_coord_address);
+
+		// leave the loop when all the rows are taken, jumping to the spoon at the end of qb_end_pbj_filter_loop()
+		cxt->outer_loop_end_index = cxt->loop_op_index + QB_PBJ_ROW_EXIT_OP_COUNT + QB_PBJ_PIXEL_LOOP_HEAD_OP_COUNT + cxt->pbj_op_count + QB_PBJ_PIXEL_LOOP_TAIL_OP_COUNT;
+		qb_perform_branch_if_less_than(cxt, cxt->y_address, cxt->output_image_height_address, cxt->outer_loop_end_index);
 	} else {
 		// set y to zero
 		qb_perform_assignment(cxt, cxt->y_address, cxt->compiler_context->zero_address);
 		qb_perform_assignment(cxt, cxt->out_coord_y_address, start_coord_address);
-	}
 
-	// set x to zero; the outer loop starts here
-	cxt->outer_loop_start_index = cxt->loop_op_index;
-	qb_perform_assignment(cxt, cxt->x_address, cxt->compiler_context->zero_address);
-	qb_perform_assignment(cxt, cxt->out_coord_x_address, start_coord_address);
+		// set x to zero; the outer loop starts here
+		cxt->outer_loop_start_index = cxt->loop_op_index;
+		qb_perform_assignment(cxt, cxt->x_address, cxt->compiler_context->zero_address);
+		qb_perform_assignment(cxt, cxt->out_coord_x_address, start_coord_address);
+	}
 
 	// initialize the active pixel to zero; the inner loop starts here
 	cxt->inner_loop_start_index = cxt->loop_op_index;
@@ -1753,7 +1803,15 @@ static int32_t qb_end_pbj_filter_loop(qb_pbj_translator_context *cxt) {
 	qb_perform_loop(cxt, cxt->x_address, cxt->output_image_width_address, cxt->inner_loop_start_index);
 
 	if(cxt->thread_count > 1) {
+		// go get another row
+		qb_perform_jump(cxt, cxt->outer_loop_start_index);
+
 		// reconverge forked copies
+		if(cxt->loop_op_index != cxt->outer_loop_end_index) {
+			// the op counts above don't match what's emitted
+			qb_report_internal_error(cxt->compiler_context->line_id, "Incorrect jump target");
+			return FALSE;
+		}
 		qb_perform_spoon(cxt);
 	} else {
 		// increment _OutCoord.y
@@ -1789,7 +1847,7 @@ int32_t qb_survey_pbj_instructions(qb_pbj_translator_context *cxt) {
 	qb_remove_redundant_pbj_ops(cxt);
 
 	// initialize result prototypes
-	qb_enlarge_array((void **) &cxt->result_prototypes, cxt->pbj_op_count + 16 + cxt->texture_count);
+	qb_enlarge_array((void **) &cxt->result_prototypes, cxt->pbj_op_count + 24 + cxt->texture_count);
 	for(i = 0; i < cxt->result_prototype_count; i++) {
 		qb_result_prototype *prototype = &cxt->result_prototypes[i];
 		prototype->preliminary_type = prototype->final_type = QB_TYPE_UNKNOWN;
@@ -297,6 +297,7 @@ struct qb_pbj_translator_context {
 
 	uint32_t loop_op_index;
 	uint32_t outer_loop_start_index;
+	uint32_t outer_loop_end_index;
 	uint32_t inner_loop_start_index;
 
 	qb_address *x_address;
@@ -63,10 +63,14 @@ typedef enum qb_primitive_type				qb_primitive_type;
 #define STORAGE_TYPE_MATCH(type1, type2)	((type1 == type2) || ((type1 & ~QB_TYPE_UNSIGNED) == (type2 & ~QB_TYPE_UNSIGNED) && (type1 < QB_TYPE_F32)))
 
 #define BYTE_COUNT(element_count, type)		((uint32_t) ((element_count) << type_size_shifts[type]))
+#define SEGMENT_BYTE_COUNT(element_count, type)	(((uint64_t) (element_count)) << type_size_shifts[type])
 #define ELEMENT_COUNT(byte_count, type)		((byte_count) >> type_size_shifts[type])
 
 #define SHIFT_POINTER(p, shift)				*((uintptr_t *) &(p)) += shift
 
+// true when the array at p1 is either the same one at p2 or doesn't overlap with it (both have count elements)
+#define QB_SEPARATE_OR_IDENTICAL(p1, p2, count)		((p1) == (p2) || (p1) + (count) <= (p2) || (p2) + (count) <= (p1))
+
 #define INVALID_INDEX						((uint32_t) -1)
 
 enum qb_primitive_type {
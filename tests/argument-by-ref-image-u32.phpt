@@ -0,0 +1,46 @@
+--TEST--
+Argument by reference test (image, U32)
+--SKIPIF--
+<?php 
+	if(!function_exists('imagecreatetruecolor')) print 'skip GD not available';
+?>
+--FILE--
+<?php
+
+/**
+ * A test function
+ * 
+ * @engine	qb
+ * @param	uint32[][]	$a
+ * 
+ * @return	void
+ * 
+ */
+function test_function(&$a) {
+	$a ^= 0x00FFFFFF;
+}
+
+$image = imagecreatetruecolor(3, 2);
+imagesetpixel($image, 0, 0, 0x000000);
+imagesetpixel($image, 1, 0, 0xFF0000);
+imagesetpixel($image, 2, 0, 0x00FF00);
+imagesetpixel($image, 0, 1, 0x0000FF);
+imagesetpixel($image, 1, 1, 0x123456);
+imagesetpixel($image, 2, 1, 0xFFFFFF);
+
+test_function($image);
+
+for($y = 0; $y < 2; $y++) {
+	for($x = 0; $x < 3; $x++) {
+		printf("%06X\n", imagecolorat($image, $x, $y));
+	}
+}
+
+?>
+--EXPECT--
+FFFFFF
+00FFFF
+FF00FF
+FFFF00
+EDCBA9
+000000
@@ -0,0 +1,27 @@
+--TEST--
+Read-only argument test (interned string)
+--FILE--
+<?php
+
+/**
+ * A test function
+ * 
+ * @engine	qb
+ * @param	uint8[]	$a
+ * 
+ * @return	uint32
+ * 
+ */
+function test_function($a) {
+	return array_sum($a);
+}
+
+echo test_function("ABCD"), "\n";
+echo test_function("ABCD"), "\n";
+echo "ABCD\n";
+
+?>
+--EXPECT--
+266
+266
+ABCD
@@ -0,0 +1,39 @@
+--TEST--
+Variable-length array reuse after shrinking test
+--FILE--
+<?php
+
+/**
+ * A test function
+ *
+ * @engine	qb
+ * @param	int32		$n
+ * @param	int32		$m
+ * @local	int32[]		$a
+ * @local	uint32		$i
+ *
+ * @return	void
+ *
+ */
+function test_function($n, $m) {
+	array_resize($a, $n);
+	echo "$a\n";
+	for($i = 0; $i < $n; $i++) {
+		$a[$i] = $i + 1;
+	}
+	echo "$a\n";
+	array_resize($a, $m);
+	echo "$a\n";
+}
+
+test_function(6, 2);
+test_function(4, 4);
+
+?>
+--EXPECT--
+[0, 0, 0, 0, 0, 0]
+[1, 2, 3, 4, 5, 6]
+[1, 2]
+[0, 0, 0, 0]
+[1, 2, 3, 4]
+[1, 2, 3, 4]
@@ -0,0 +1,41 @@
+--TEST--
+Variable-length array reuse between calls test
+--FILE--
+<?php
+
+/**
+ * A test function
+ *
+ * @engine	qb
+ * @param	int32		$n
+ * @local	int32[]		$a
+ * @local	uint32		$i
+ *
+ * @return	void
+ *
+ */
+function test_function($n) {
+	echo "$a\n";
+	array_resize($a, $n);
+	echo "$a\n";
+	for($i = 0; $i < $n; $i++) {
+		$a[$i] = $i + 1;
+	}
+	echo "$a\n";
+}
+
+test_function(4);
+test_function(2);
+test_function(6);
+
+?>
+--EXPECT--
+[]
+[0, 0, 0, 0]
+[1, 2, 3, 4]
+[]
+[0, 0]
+[1, 2]
+[]
+[0, 0, 0, 0, 0, 0]
+[1, 2, 3, 4, 5, 6]
@@ -0,0 +1,30 @@
+--TEST--
+Variable-length array reuse between calls test (growth)
+--FILE--
+<?php
+
+/**
+ * A test function
+ *
+ * @engine	qb
+ * @param	int32		$n
+ * @local	int32[]		$a
+ *
+ * @return	void
+ *
+ */
+function test_function($n) {
+	$a[$n - 1] = $n;
+	echo array_sum($a), " ", count($a), "\n";
+}
+
+// the retained memory is smaller than what the later calls need
+test_function(1024);
+test_function(2048);
+test_function(3000);
+
+?>
+--EXPECT--
+1024 1024
+2048 2048
+3000 3000
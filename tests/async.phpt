@@ -0,0 +1,35 @@
+--TEST--
+Asynchronous call test
+--FILE--
+<?php
+
+/**
+ * A test function
+ *
+ * @engine	qb
+ * @param	int32[]	$a
+ * @param	int32	$b
+ *
+ * @return	int32
+ *
+ */
+function test_function($a, $b) {
+	return array_sum($a) * $b;
+}
+
+$a = range(1, 100);
+$call = qb_async('test_function', $a, 2);
+
+// changes made after the call has started shouldn't affect it
+$a[0] = 1000;
+
+$result = qb_wait($call);
+var_dump($result);
+var_dump(qb_done($call));
+var_dump(qb_wait($call));
+
+?>
+--EXPECT--
+int(10100)
+bool(true)
+int(10100)
@@ -0,0 +1,30 @@
+--TEST--
+Bound check elimination test (constant elements)
+--FILE--
+<?php
+
+/**
+ * A test function
+ *
+ * @engine	qb
+ * @param	int32[]	$out
+ * @local	uint32[2]	$map
+ *
+ * @return	void
+ *
+ */
+function test_function($out) {
+	$map[0] = 1;
+	$map[1] = 7;
+	if($map[0] < count($out)) {
+		echo $out[$map[0]], "\n";
+		echo $out[$map[1]], "\n";
+	}
+}
+
+test_function(array(10, 20, 30));
+
+?>
+--EXPECTREGEX--
+20
+.*Fatal error.*line 18
@@ -0,0 +1,26 @@
+--TEST--
+Bound check elimination test (out of bound)
+--FILE--
+<?php
+
+/**
+ * A test function
+ *
+ * @engine	qb
+ * @local	int32[10]	$a
+ * @local	int32	$i
+ *
+ * @return	void
+ *
+ */
+function test_function() {
+	for($i = 0; $i <= 10; $i++) {
+		$a[$i] = $i;
+	}
+}
+
+test_function();
+
+?>
+--EXPECTREGEX--
+.*Fatal error.*line 15
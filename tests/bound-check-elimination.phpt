@@ -0,0 +1,46 @@
+--TEST--
+Bound check elimination test
+--FILE--
+<?php
+
+/**
+ * A test function
+ *
+ * @engine	qb
+ * @param	int32[]	$b
+ * @local	int32[100]	$a
+ * @local	int32[10][3]	$c
+ * @local	int32	$(i|j|sum)
+ *
+ * @return	void
+ *
+ */
+function test_function($b) {
+	for($i = 0; $i < 100; $i++) {
+		$a[$i] = ($i * 37) % 100;
+	}
+	$sum = 0;
+	for($i = 1; $i < 100; $i++) {
+		$sum += $a[$i - 1] * $a[($i * 13) % 100];
+	}
+	echo $sum, "\n";
+	$sum = 0;
+	for($i = 0; $i < count($b); $i++) {
+		$sum += $b[$i];
+	}
+	echo $sum, "\n";
+	for($i = 0; $i < 10; $i++) {
+		for($j = 0; $j < 3; $j++) {
+			$c[$i][$j] = $i * $j;
+		}
+	}
+	echo $c[9], "\n";
+}
+
+test_function(array(1, 2, 3, 4, 5));
+
+?>
+--EXPECT--
+243400
+15
+[0, 9, 18]
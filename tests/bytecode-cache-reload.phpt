@@ -0,0 +1,56 @@
+--TEST--
+Bytecode cache reload test
+--FILE--
+<?php
+
+$cache_path = __DIR__ . "/bytecode-cache-reload";
+$script_path = __DIR__ . "/bytecode-cache-reload.inc";
+file_put_contents($script_path, '<?php
+
+define(\'FACTOR\', (int) $argv[1]);
+
+/**
+ * @engine qb
+ * @param float32[4]	$a
+ * @return float32[4]
+ */
+function test_function($a) {
+	return $a * FACTOR;
+}
+
+echo test_function(array(1, 2, 3, 4)), "\n";
+
+?>
+');
+
+// run the script in separate processes, the first one saving the function and the rest loading it
+$command = getenv('TEST_PHP_EXECUTABLE') . " " . getenv('TEST_PHP_EXTRA_ARGS') . " -d qb.bytecode_cache_path=" . escapeshellarg($cache_path) . " " . escapeshellarg($script_path);
+echo shell_exec("$command 2");
+$files = glob("$cache_path/QB*.qbc");
+echo count($files), "\n";
+$inode = fileinode($files[0]);
+
+echo shell_exec("$command 2");
+clearstatcache();
+echo (fileinode($files[0]) == $inode) ? "Loaded" : "Saved again", "\n";
+
+// a different value for the constant should lead to a different cache file
+echo shell_exec("$command 3");
+echo count(glob("$cache_path/QB*.qbc")), "\n";
+
+?>
+--CLEAN--
+<?php
+foreach(glob(__DIR__ . "/bytecode-cache-reload/*") as $path) {
+	unlink($path);
+}
+@rmdir(__DIR__ . "/bytecode-cache-reload");
+@unlink(__DIR__ . "/bytecode-cache-reload.inc");
+?>
+--EXPECT--
+[2, 4, 6, 8]
+1
+[2, 4, 6, 8]
+Loaded
+[3, 6, 9, 12]
+2
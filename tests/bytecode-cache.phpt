@@ -0,0 +1,31 @@
+--TEST--
+Bytecode cache test
+--INI--
+qb.bytecode_cache_path={PWD}/bytecode-cache
+--FILE--
+<?php
+
+/**
+ * @engine qb
+ * @param float32[4]	$a
+ * @param float32		$b
+ * @return float32[4]
+ */
+function test_function($a, $b = 2) {
+	return $a * $b;
+}
+
+echo test_function(array(1, 2, 3, 4)), "\n";
+echo count(glob(__DIR__ . "/bytecode-cache/QB*.qbc")), "\n";
+
+?>
+--CLEAN--
+<?php
+foreach(glob(__DIR__ . "/bytecode-cache/*") as $path) {
+	unlink($path);
+}
+@rmdir(__DIR__ . "/bytecode-cache");
+?>
+--EXPECT--
+[2, 4, 6, 8]
+1
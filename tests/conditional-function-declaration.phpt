@@ -0,0 +1,48 @@
+--TEST--
+Conditional function declaration test
+--FILE--
+<?php
+
+/**
+ * @engine	qb
+ * @param	int32	$a
+ * @return	int32
+ */
+function test_function($a) {
+	return $a * 2;
+}
+
+echo test_function(4), "\n";
+
+if(function_exists('test_function')) {
+	/**
+	 * @engine	qb
+	 * @param	int32	$a
+	 * @return	int32
+	 */
+	function test_function2($a) {
+		return $a * 3;
+	}
+}
+
+echo test_function2(4), "\n";
+
+class TestClass {
+
+	/**
+	 * @engine	qb
+	 * @param	int32	$a
+	 * @return	int32
+	 */
+	static public function test_method($a) {
+		return $a * 4;
+	}
+}
+
+echo TestClass::test_method(4), "\n";
+
+?>
+--EXPECT--
+8
+12
+16
@@ -0,0 +1,58 @@
+--TEST--
+Fork next test
+--INI--
+qb.thread_count=4
+--FILE--
+<?php
+
+/**
+ * A test function
+ * 
+ * @engine	qb
+ * @local	uint32			$(i|id|r|total)
+ *
+ * @shared	uint32[1000]	$hits
+ * @shared	uint32[500]		$more_hits
+ * @shared	uint32[200]		$round_hits
+ * 
+ * @return	void
+ * 
+ */
+function test_function() {
+	$id = fork(4);
+	while(($i = fork_next(1000)) < 1000) {
+		$hits[$i] += 1;
+	}
+	// a second loop gets a counter of its own
+	while(($i = fork_next(500)) < 500) {
+		$more_hits[$i] += 1;
+	}
+	// so do loops that run repeatedly, including ones past the number of counters
+	for($r = 0; $r < 20; $r++) {
+		while(($i = fork_next(10)) < 10) {
+			$round_hits[$r * 10 + $i] += 1;
+		}
+	}
+	spoon();
+	$total = array_sum($hits);
+	echo min($hits), " ", max($hits), " ", $total, "\n";
+	$total = array_sum($more_hits);
+	echo min($more_hits), " ", max($more_hits), " ", $total, "\n";
+	$total = array_sum($round_hits);
+	echo min($round_hits), " ", max($round_hits), " ", $total, "\n";
+
+	// without a fork, the iterations are handed out in order
+	while(($i = fork_next(3)) < 3) {
+		echo $i, " ";
+	}
+	echo "\n";
+}
+
+test_function();
+
+?>
+--EXPECT--
+1 1 1000
+1 1 500
+1 1 200
+0 1 2 
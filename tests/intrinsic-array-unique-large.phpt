@@ -0,0 +1,49 @@
+--TEST--
+Unique/intersect/diff on large arrays test
+--FILE--
+<?php
+
+/**
+  * @engine	qb
+  * @local	int32[100]		$a
+  * @local	int32[100]		$b
+  * @local	float64[100]	$c
+  * @local	int32[100][2]	$d
+  * @local	int32[8]		$e
+  * @local	int32[3][2]		$f
+  * @local	int32			$i
+  */
+function test_function() {
+	for($i = 0; $i < 100; $i++) {
+		$a[$i] = ($i * 7) % 13;
+		$b[$i] = $i % 40;
+		$c[$i] = ($i % 9) * 0.5;
+		$d[$i] = array($i % 3, $i % 5);
+	}
+	$e = array(3, 45, 12, 39, 7, 100, -1, 12);
+	$f = array(array(2, 7), array(1, 4), array(3, 0));
+	echo array_unique($a), "\n";
+	echo array_unique($c), "\n";
+	echo count(array_unique($d)), "\n";
+	echo array_intersect($e, $b), "\n";
+	echo array_diff($e, $b), "\n";
+	foreach(array_intersect($f, $d) as $row) {
+		echo "$row\n";
+	}
+	foreach(array_diff($f, $d) as $row) {
+		echo "$row\n";
+	}
+}
+
+test_function();
+
+?>
+--EXPECT--
+[0, 7, 1, 8, 2, 9, 3, 10, 4, 11, 5, 12, 6]
+[0, 0.5, 1, 1.5, 2, 2.5, 3, 3.5, 4]
+15
+[3, 12, 39, 7, 12]
+[45, 100, -1]
+[1, 4]
+[2, 7]
+[3, 0]
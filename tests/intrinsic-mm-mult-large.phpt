@@ -0,0 +1,63 @@
+--TEST--
+Matrix-matrix multiplication test (large matrices)
+--FILE--
+<?php
+
+/**
+ * A test function
+ * 
+ * @engine	qb
+ * @local	float64[70][50]		$m1
+ * @local	float64[50][90]		$m2
+ * @local	float64[70][90]		$r1
+ * @local	float64[50][70]		$n1
+ * @local	float64[90][50]		$n2
+ * @local	float64[90][70]		$r2
+ * @local	float64				$(sum|total)
+ * @local	uint32				$(i|j|k|errors)
+ * 
+ * @return	void
+ * 
+ */
+function test_function() {
+	for($i = 0; $i < 70; $i++) {
+		for($j = 0; $j < 50; $j++) {
+			$m1[$i][$j] = ($i + $j) % 7;
+			$n1[$j][$i] = ($i + $j) % 7;
+		}
+	}
+	for($i = 0; $i < 50; $i++) {
+		for($j = 0; $j < 90; $j++) {
+			$m2[$i][$j] = ($i * $j) % 5;
+			$n2[$j][$i] = ($i * $j) % 5;
+		}
+	}
+	$r1 = mm_mult($m1, $m2);
+	$r2 = mm_mult_cm($n1, $n2);
+	$errors = 0;
+	$total = 0;
+	for($i = 0; $i < 70; $i++) {
+		for($j = 0; $j < 90; $j++) {
+			$sum = 0;
+			for($k = 0; $k < 50; $k++) {
+				$sum += $m1[$i][$k] * $m2[$k][$j];
+			}
+			$total += $r1[$i][$j];
+			if($r1[$i][$j] != $sum) {
+				$errors++;
+			}
+			if($r2[$j][$i] != $sum) {
+				$errors++;
+			}
+		}
+	}
+	echo "$total\n";
+	echo "$errors\n";
+}
+
+test_function();
+
+?>
+--EXPECT--
+1512000
+0
@@ -0,0 +1,55 @@
+--TEST--
+Loop idiom recognition test (op listing)
+--INI--
+qb.show_opcodes=1
+--FILE--
+<?php
+
+/**
+ * A test function
+ *
+ * @engine	qb
+ * @local	int32[64]	$(a|b|c)
+ * @local	int32	$(i|sum)
+ *
+ * @return	void
+ *
+ */
+function test_function() {
+	// uses the counter as a value--stays a loop
+	for($i = 0; $i < 64; $i++) {
+		$a[$i] = $i;
+	}
+	// map and reduction--become whole-array ops
+	for($i = 0; $i < 64; $i++) {
+		$b[$i] = $a[$i] * 2 + 1;
+	}
+	$sum = 0;
+	for($i = 0; $i < 64; $i++) {
+		$sum += $b[$i];
+	}
+	// loop-carried dependency--stays a loop
+	$c[0] = 0;
+	for($i = 1; $i < 64; $i++) {
+		$c[$i] = $c[$i - 1] + $a[$i];
+	}
+	echo $sum, " ", $c[63], "\n";
+}
+
+ob_start();
+qb_compile();
+$listing = ob_get_clean();
+
+// ops in loops that were converted work on slices, so the elements no longer show up in the listing
+echo (strpos($listing, '$b[$i]') === false) ? "converted" : "not converted", "\n";
+echo (strpos($listing, '$a[$i]') === false) ? "converted" : "not converted", "\n";
+echo (strpos($listing, '$c[') === false) ? "converted" : "not converted", "\n";
+
+test_function();
+
+?>
+--EXPECT--
+converted
+not converted
+not converted
+4096 2016
@@ -0,0 +1,58 @@
+--TEST--
+Loop idiom recognition test
+--FILE--
+<?php
+
+/**
+ * A test function
+ *
+ * @engine	qb
+ * @local	int32[64]	$(a|b|c|d)
+ * @local	int32	$(i|k|sum)
+ *
+ * @return	void
+ *
+ */
+function test_function() {
+	$k = 3;
+	for($i = 0; $i < 64; $i++) {
+		$c[$i] = 0;
+		$d[$i] = 0;
+	}
+	for($i = 60; $i < 64; $i++) {
+		$d[$i] = 5;
+	}
+	for($i = 0; $i < 64; $i++) {
+		$a[$i] = ($i * 7) % 64;
+	}
+	for($i = 0; $i < 64; $i++) {
+		$b[$i] = $a[$i];
+	}
+	for($i = 8; $i < 64; $i++) {
+		$c[$i] = $a[$i] * $k + 1;
+	}
+	for($i = 0; $i < 64; $i++) {
+		$b[$i] = -$b[$i];
+	}
+	$sum = 0;
+	for($i = 0; $i < 64; $i++) {
+		$sum += $c[$i];
+	}
+	echo $sum, "\n";
+	$sum = 0;
+	for($i = 0; $i < 64; $i++) {
+		$sum += $b[$i];
+	}
+	echo $sum, "\n";
+	echo $d[59], " ", $d[60], " ", $d[63], "\n";
+	echo $b[5], " ", $c[7], " ", $c[8], " ", $c[63], " ", $i, "\n";
+}
+
+test_function();
+
+?>
+--EXPECT--
+5516
+-2016
+0 5 5
+-35 0 169 172 64
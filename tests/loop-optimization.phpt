@@ -0,0 +1,49 @@
+--TEST--
+Loop optimization test
+--FILE--
+<?php
+
+/**
+ * A test function
+ *
+ * @engine	qb
+ * @local	int32[48]	$a
+ * @local	int32[]	$b
+ * @local	int32	$(x|y|i|width|height|sum|stride|count)
+ *
+ * @return	void
+ *
+ */
+function test_function() {
+	$width = 8;
+	$height = 6;
+	for($y = 0; $y < $height; $y++) {
+		for($x = 0; $x < $width; $x++) {
+			$a[$y * $width + $x] = $x * 3 + $y * ($width - 1);
+		}
+	}
+	$sum = 0;
+	$stride = 5;
+	for($i = 0; $i < 40; $i += 2) {
+		if($i % 3 == 0) {
+			continue;
+		}
+		$sum += $a[$i] * ($width + $height) + $i * $stride;
+	}
+	$count = 0;
+	for($i = 0; $i < 10; $i++) {
+		$b[] = $i * $i;
+		$count += count($b) * 2;
+	}
+	echo $a[0], " ", $a[47], " ", $a[21], "\n";
+	echo $sum, "\n";
+	echo $count, " ", count($b), " ", $b[9], "\n";
+}
+
+test_function();
+
+?>
+--EXPECT--
+0 56 29
+5512
+110 10 81
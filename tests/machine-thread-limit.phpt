@@ -0,0 +1,52 @@
+--TEST--
+Machine thread limit test
+--SKIPIF--
+<?php
+if(substr(PHP_OS, 0, 3) == 'WIN') print 'skip semaphore count is not readable on Windows';
+?>
+--FILE--
+<?php
+
+$script_path = __DIR__ . "/machine-thread-limit.inc";
+file_put_contents($script_path, '<?php
+
+/**
+ * @engine	qb
+ * @local	int32[600000]	$a
+ * @local	int32	$i
+ * @return	int32
+ */
+function test_function() {
+	for($i = 0; $i < 600000; $i++) {
+		$a[$i] = $i % 1000 - 500;
+	}
+	return array_sum($a);
+}
+
+echo test_function(), " ";
+
+ob_start();
+phpinfo(INFO_MODULES);
+preg_match("/Machine thread tokens => (.*)/", ob_get_clean(), $m);
+echo $m[1], "\n";
+
+?>
+');
+
+// processes sharing the token file share the budget; those with a different limit get their own
+$command = getenv('TEST_PHP_EXECUTABLE') . " " . getenv('TEST_PHP_EXTRA_ARGS') . " -d qb.thread_count=4 -d qb.calibrate_thresholds=0 -d qb.machine_thread_token_path=" . escapeshellarg(__FILE__);
+echo shell_exec("$command -d qb.machine_thread_limit=3 " . escapeshellarg($script_path));
+echo shell_exec("$command -d qb.machine_thread_limit=5 " . escapeshellarg($script_path));
+echo shell_exec("$command -d qb.machine_thread_limit=5 " . escapeshellarg($script_path));
+echo shell_exec("$command -d qb.machine_thread_limit=2 " . escapeshellarg($script_path));
+
+?>
+--CLEAN--
+<?php
+@unlink(__DIR__ . "/machine-thread-limit.inc");
+?>
+--EXPECT--
+-300000 3 / 3
+-300000 5 / 5
+-300000 5 / 5
+-300000 2 / 2
@@ -0,0 +1,38 @@
+--TEST--
+Map test
+--FILE--
+<?php
+
+/**
+ * A test function
+ *
+ * @engine	qb
+ * @param	int32[]	$a
+ * @param	int32	$b
+ *
+ * @return	int32
+ *
+ */
+function test_function($a, $b = 1) {
+	return array_sum($a) * $b;
+}
+
+$sets = array();
+for($i = 1; $i <= 5; $i++) {
+	$sets[] = array(range(1, $i), $i);
+}
+$sets['last'] = array(array(10, 20));
+
+print_r(qb_map('test_function', $sets));
+
+?>
+--EXPECT--
+Array
+(
+    [0] => 1
+    [1] => 6
+    [2] => 18
+    [3] => 40
+    [4] => 75
+    [last] => 30
+)
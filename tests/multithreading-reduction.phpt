@@ -0,0 +1,50 @@
+--TEST--
+Multithreaded reduction test
+--INI--
+qb.thread_count=4
+qb.calibrate_thresholds=0
+--FILE--
+<?php
+
+/**
+ * A test function
+ * 
+ * @engine	qb
+ * @local	int32[600000]	$a
+ * @local	float64[100000]	$(x|y)
+ * @local	int32	$i
+ * 
+ * @return	void
+ * 
+ */
+function test_function() {
+	for($i = 0; $i < 600000; $i++) {
+		$a[$i] = $i % 1000 - 500;
+	}
+	$a[550000] = 7777;
+	for($i = 0; $i < 100000; $i++) {
+		$x[$i] = 1;
+		$y[$i] = $i % 4;
+	}
+	echo array_sum($a), "\n";
+	echo max($a), "\n";
+	echo min($a), "\n";
+	echo array_search($a, 7777), "\n";
+	echo array_search($a, 12345), "\n";
+	echo dot($x, $y), "\n";
+}
+
+test_function();
+
+$thresholds = qb_get_multithreading_thresholds();
+echo $thresholds['ASUM_S32_S32_SCA'], "\n";
+
+?>
+--EXPECT--
+-291723
+7777
+-500
+550000
+-1
+150000
+262144
@@ -0,0 +1,67 @@
+--TEST--
+Multithreaded sort test
+--INI--
+qb.thread_count=4
+--FILE--
+<?php
+
+/**
+ * A test function
+ *
+ * @engine	qb
+ * @local	int32[200000]	$a
+ * @local	float64[200000]	$b
+ * @local	int32[100000][2]	$(c|d)
+ * @local	int32	$(i|errors)
+ *
+ * @return	void
+ *
+ */
+function test_function() {
+	for($i = 0; $i < 200000; $i++) {
+		$a[$i] = ($i * 7919) % 200000 - 100000;
+		$b[$i] = (($i * 9973) % 200000) / 8;
+	}
+	for($i = 0; $i < 100000; $i++) {
+		$c[$i][0] = $i % 7;
+		$c[$i][1] = 100000 - $i;
+		$d[$i][0] = $i % 7;
+		$d[$i][1] = 100000 - $i;
+	}
+	sort($a);
+	rsort($b);
+	sort($c);
+	rsort($d);
+	$errors = 0;
+	for($i = 1; $i < 200000; $i++) {
+		if($a[$i - 1] + 1 != $a[$i]) {
+			$errors++;
+		}
+		if($b[$i - 1] < $b[$i]) {
+			$errors++;
+		}
+	}
+	for($i = 1; $i < 100000; $i++) {
+		if($c[$i - 1][0] > $c[$i][0] || ($c[$i - 1][0] == $c[$i][0] && $c[$i - 1][1] > $c[$i][1])) {
+			$errors++;
+		}
+		if($d[$i - 1][0] < $d[$i][0] || ($d[$i - 1][0] == $d[$i][0] && $d[$i - 1][1] < $d[$i][1])) {
+			$errors++;
+		}
+	}
+	echo $a[0], " ", $a[199999], "\n";
+	echo $b[0], " ", $b[199999], "\n";
+	echo $c[0], " ", $c[99999], "\n";
+	echo $d[0], " ", $d[99999], "\n";
+	echo $errors, "\n";
+}
+
+test_function();
+
+?>
+--EXPECT--
+-100000 99999
+24999.875 0
+[0, 5] [6, 99994]
+[6, 99994] [0, 5]
+0
@@ -0,0 +1,17 @@
+--TEST--
+Multithreading thresholds test
+--INI--
+qb.calibrate_thresholds=0
+--FILE--
+<?php
+
+$thresholds = qb_get_multithreading_thresholds();
+echo $thresholds['ADD_F32_F32_F32_MIO'], "\n";
+echo (count($thresholds) > 300) ? "OK" : "Missing", "\n";
+echo isset($thresholds['ADD_F32_F32_F32']) ? "Unexpected" : "OK", "\n";
+
+?>
+--EXPECT--
+524288
+OK
+OK
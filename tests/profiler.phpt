@@ -0,0 +1,48 @@
+--TEST--
+Profiler test
+--FILE--
+<?php
+
+/**
+ * @engine qb
+ * @param int32 $n
+ * @return int32
+ */
+function test_function($n) {
+	$total = 0;
+	for($i = 0; $i < $n; $i++) {
+		$total += $i;
+	}
+	return $total;
+}
+
+qb_profile_start();
+echo test_function(100), "\n";
+qb_profile_stop();
+
+$data = qb_profile_get_data();
+$profile = $data['test_function'];
+echo $profile['calls'], "\n";
+echo (count($profile['ops']) > 0) ? "OK" : "Missing", "\n";
+echo isset($profile['lines'][11]) ? "OK" : "Missing", "\n";
+
+$path = dirname(__FILE__) . "/profiler.out";
+qb_profile_dump($path);
+$text = file_get_contents($path);
+echo (strpos($text, "# callgrind format") === 0) ? "OK" : "Bad format", "\n";
+echo (strpos($text, "fn=test_function") !== false) ? "OK" : "Missing", "\n";
+unlink($path);
+
+qb_profile_reset();
+$data = qb_profile_get_data();
+echo $data['test_function']['calls'], "\n";
+
+?>
+--EXPECT--
+4950
+1
+OK
+OK
+OK
+OK
+0